@@ -144,8 +144,9 @@ class Complex {
 
   template <typename OtherType>
   inline Complex<Type>& operator*=(const Complex<OtherType>& other) {
-    this->r = this->r * other.r - this->i * other.i;
-    this->i = this->r * other.i + this->i * other.r;
+    Type new_r = this->r * other.r - this->i * other.i;
+    this->i    = this->r * other.i + this->i * other.r;
+    this->r    = new_r;
     return *this;
   }
 
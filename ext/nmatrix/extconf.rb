@@ -101,7 +101,7 @@ $CXXFLAGS = ["-Wall -Werror=return-type",$CXXFLAGS].join(" ")
 $CPPFLAGS = ["-Wall -Werror=return-type",$CPPFLAGS].join(" ")
 
 # When adding objects here, make sure their directories are included in CLEANOBJS down at the bottom of extconf.rb.
-basenames = %w{nmatrix ruby_constants data/data util/io math util/sl_list storage/common storage/storage storage/dense/dense storage/yale/yale storage/list/list}
+basenames = %w{nmatrix ruby_constants data/data util/io math util/sl_list storage/common storage/storage storage/dense/dense storage/yale/yale storage/list/list storage/bsr/bsr}
 $objs = basenames.map { |b| "#{b}.o"   }
 $srcs = basenames.map { |b| "#{b}.cpp" }
 
@@ -177,10 +177,11 @@ Dir.chdir("storage") do
   Dir.mkdir("yale")  unless Dir.exists?("yale")
   Dir.mkdir("list")  unless Dir.exists?("list")
   Dir.mkdir("dense") unless Dir.exists?("dense")
+  Dir.mkdir("bsr")   unless Dir.exists?("bsr")
 end
 
 # to clean up object files in subdirectories:
 open('Makefile', 'a') do |f|
-  clean_objs_paths = %w{data storage storage/dense storage/yale storage/list util}.map { |d| "#{d}/*.#{CONFIG["OBJEXT"]}" }
+  clean_objs_paths = %w{data storage storage/dense storage/yale storage/list storage/bsr util}.map { |d| "#{d}/*.#{CONFIG["OBJEXT"]}" }
   f.write("CLEANOBJS := $(CLEANOBJS) #{clean_objs_paths.join(' ')}")
 end
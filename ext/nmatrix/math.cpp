@@ -143,11 +143,28 @@
 #include "math/nrm2.h"
 #include "math/getrf.h"
 #include "math/getrs.h"
+#include "math/getri.h"
+#include "math/potrf.h"
+#include "math/potrs.h"
+#include "math/potri.h"
+#include "math/geqrf.h"
+#include "math/syev.h"
+#include "math/gesvj.h"
+#include "math/lanczos.h"
+#include "math/krylov.h"
 #include "math/rot.h"
 #include "math/rotg.h"
 #include "math/math.h"
 #include "math/util.h"
 #include "storage/dense/dense.h"
+#include "storage/yale/yale.h"
+#include "storage/yale/math/spmv.h"
+#include "storage/yale/math/ilu.h"
+#include "storage/yale/math/ordering.h"
+#include "storage/yale/math/cholesky.h"
+#include "storage/yale/math/lu.h"
+#include "storage/yale/math/triangular.h"
+#include "storage/yale/math/spgemm.h"
 
 #include "nmatrix.h"
 #include "ruby_constants.h"
@@ -179,6 +196,41 @@ extern "C" {
   static VALUE nm_has_clapack(VALUE self);
   static VALUE nm_clapack_getrf(VALUE self, VALUE order, VALUE m, VALUE n, VALUE a, VALUE lda);
   static VALUE nm_clapack_getrs(VALUE self, VALUE order, VALUE trans, VALUE n, VALUE nrhs, VALUE a, VALUE lda, VALUE ipiv, VALUE b, VALUE ldb);
+  static VALUE nm_clapack_getri(VALUE self, VALUE order, VALUE n, VALUE a, VALUE lda, VALUE ipiv);
+  static VALUE nm_clapack_potrf(VALUE self, VALUE order, VALUE uplo, VALUE n, VALUE a, VALUE lda);
+  static VALUE nm_clapack_potrs(VALUE self, VALUE order, VALUE uplo, VALUE n, VALUE nrhs, VALUE a, VALUE lda, VALUE b, VALUE ldb);
+  static VALUE nm_clapack_potri(VALUE self, VALUE order, VALUE uplo, VALUE n, VALUE a, VALUE lda);
+  static VALUE nm_clapack_geqrf(VALUE self, VALUE order, VALUE m, VALUE n, VALUE a, VALUE lda, VALUE tau);
+  static VALUE nm_clapack_ormqr(VALUE self, VALUE order, VALUE side, VALUE trans, VALUE m, VALUE n, VALUE k, VALUE a, VALUE lda, VALUE tau, VALUE c, VALUE ldc);
+  static VALUE nm_clapack_gels(VALUE self, VALUE order, VALUE trans, VALUE m, VALUE n, VALUE nrhs, VALUE a, VALUE lda, VALUE b, VALUE ldb);
+  static VALUE nm_getrs_rowmajor(VALUE self, VALUE a, VALUE ipiv, VALUE b);
+  static VALUE nm_potrs_rowmajor(VALUE self, VALUE uplo, VALUE a, VALUE b);
+  static VALUE nm_geqrs_rowmajor(VALUE self, VALUE a, VALUE tau, VALUE b);
+  static VALUE nm_syev_rowmajor(VALUE self, VALUE uplo, VALUE a, VALUE il, VALUE w, VALUE z);
+  static VALUE nm_gesvj_rowmajor(VALUE self, VALUE a, VALUE s, VALUE v);
+
+  /* Sparse iterative methods. */
+  static VALUE nm_lanczos(VALUE self, VALUE op, VALUE x, VALUE which, VALUE ncv, VALUE maxiter, VALUE tol, VALUE w, VALUE z);
+  static VALUE nm_krylov(VALUE self, VALUE method, VALUE a, VALUE b, VALUE x, VALUE tol, VALUE maxiter, VALUE restart,
+                         VALUE pkind, VALUE pfactor);
+  static VALUE nm_factor_preconditioner(VALUE self, VALUE kind, VALUE a, VALUE f);
+  static VALUE nm_precondition(VALUE self, VALUE kind, VALUE f, VALUE x);
+
+  /* Sparse direct methods. */
+  static VALUE nm_minimum_degree(VALUE self, VALUE a, VALUE perm);
+  static VALUE nm_reverse_cuthill_mckee(VALUE self, VALUE a, VALUE perm);
+  static VALUE nm_cholesky_symbolic(VALUE self, VALUE a, VALUE perm, VALUE parent, VALUE colptr);
+  static VALUE nm_cholesky_numeric(VALUE self, VALUE a, VALUE perm, VALUE parent, VALUE colptr, VALUE li, VALUE lx);
+  static VALUE nm_cholesky_solve(VALUE self, VALUE perm, VALUE colptr, VALUE li, VALUE lx, VALUE b);
+  static VALUE nm_lu_numeric(VALUE self, VALUE a, VALUE q, VALUE tol, VALUE lp, VALUE li, VALUE lx, VALUE up, VALUE ui,
+                             VALUE ux, VALUE pinv);
+  static VALUE nm_lu_solve(VALUE self, VALUE q, VALUE pinv, VALUE lp, VALUE li, VALUE lx, VALUE up, VALUE ui, VALUE ux,
+                           VALUE b);
+  static VALUE nm_triangular_levels(VALUE self, VALUE a, VALUE uplo, VALUE level_ptr, VALUE order);
+  static VALUE nm_triangular_solve(VALUE self, VALUE a, VALUE uplo, VALUE diag, VALUE nlevels, VALUE level_ptr,
+                                   VALUE order, VALUE b);
+  static VALUE nm_spgemm_symbolic(VALUE self, VALUE a, VALUE b, VALUE ija);
+  static VALUE nm_spgemm_numeric(VALUE self, VALUE a, VALUE b, VALUE ija, VALUE c, VALUE install);
   static VALUE nm_clapack_laswp(VALUE self, VALUE n, VALUE a, VALUE lda, VALUE k1, VALUE k2, VALUE ipiv, VALUE incx);
 } // end of extern "C" block
 
@@ -223,14 +275,14 @@ namespace nm {
     }
 
     /*
-     * Calculates in-place inverse of A_elements. Uses Gauss-Jordan elimination technique.
-     * In-place inversion of the matrix saves on memory and time.
+     * Calculates in-place inverse of A_elements, using Gauss-Jordan elimination. Only used for dtypes getrf can't
+     * handle (Ruby objects, and integers, which the Ruby side never inverts in place anyway).
      *
      * args - M - Shape of the matrix
      *        a_elements - A duplicate of the original expressed as a contiguos array
      */
     template <typename DType>
-    void inverse(const int M, void* a_elements) {
+    void inverse_gauss_jordan(const int M, void* a_elements) {
       DType* matrix   = reinterpret_cast<DType*>(a_elements);
       int* row_index = new int[M]; // arrays for keeping track of column scrambling
       int* col_index = new int[M];
@@ -299,6 +351,28 @@ namespace nm {
       delete[] col_index;
     }
 
+    /*
+     * Calculates in-place inverse of A_elements by LU factorization (getrf) followed by getri. The row-major matrix is
+     * factored and inverted as its column-major transpose, and inv(A**T) read back as row-major is inv(A).
+     *
+     * Raises ZeroDivisionError if the matrix is singular.
+     */
+    template <typename DType>
+    typename std::enable_if<!std::is_integral<DType>::value && !std::is_same<DType, RubyObject>::value>::type
+    inverse(const int M, void* a_elements) {
+      DType* A    = reinterpret_cast<DType*>(a_elements);
+      int*   ipiv = NM_ALLOCA_N(int, M);
+
+      if (getrf_nothrow<false,DType>(M, M, A, M, ipiv) || getri<DType>(M, A, M, ipiv))
+        rb_raise(rb_eZeroDivError, "Expected Non-Singular Matrix.");
+    }
+
+    template <typename DType>
+    typename std::enable_if<std::is_integral<DType>::value || std::is_same<DType, RubyObject>::value>::type
+    inverse(const int M, void* a_elements) {
+      inverse_gauss_jordan<DType>(M, a_elements);
+    }
+
     /*
      * Reduce a square matrix to hessenberg form with householder transforms
      *
@@ -476,6 +550,276 @@ namespace nm {
                   reinterpret_cast<const DType*>(a), lda, reinterpret_cast<DType*>(b), ldb);
     }
 
+
+    /*
+     * A private copy of the IJA and A arrays of the Yale matrix s (or nothing, for NULL), taken with the GVL held, for
+     * the kernels which read s without it: another thread's []= could otherwise reallocate the arrays under them.
+     */
+    template <typename DType>
+    struct YaleCopy {
+      size_t             n, m;
+      std::vector<IType> ija;
+      std::vector<DType> a;
+
+      YaleCopy(const YALE_STORAGE* s) : n(0), m(0) {
+        if (!s) return;
+
+        const size_t size = nm_yale_storage_get_size(s);
+        const DType* sa   = reinterpret_cast<const DType*>(s->a);
+
+        n = s->shape[0];
+        m = s->shape[1];
+        ija.assign(s->ija, s->ija + size);
+        a.assign(sa, sa + size);
+      }
+    };
+
+    /*
+     * A square Yale matrix (with a zero default value), as copied by YaleCopy, as an operator for the iterative methods.
+     */
+    template <typename DType>
+    struct YaleOperator {
+      const YaleCopy<DType>* s;
+
+      bool operator()(const DType* x, DType* y) const {
+        nm::yale_storage::spmv<DType>(s->n, s->m, &s->ija[0], &s->a[0], x, y);
+        return true;
+      }
+    };
+
+    /*
+     * A Ruby object responding to call as an operator for the iterative methods. Each application copies the input into
+     * the dense vector x, calls callable.call(x), and copies out the result, which must be a dense, non-reference NMatrix
+     * of x's dtype and size (the Ruby side casts it). An exception leaves its tag in state for the caller to re-raise once
+     * the iteration has cleaned up after itself.
+     */
+    template <typename DType>
+    struct CallableOperator {
+      VALUE callable, x;
+      int   state;
+
+      static VALUE call(VALUE self) {
+        CallableOperator* op = reinterpret_cast<CallableOperator*>(self);
+        return rb_funcall(op->callable, rb_intern("call"), 1, op->x);
+      }
+
+      bool operator()(const DType* in, DType* out) {
+        const size_t n = NM_DENSE_COUNT(x);
+        std::copy(in, in + n, reinterpret_cast<DType*>(NM_STORAGE_DENSE(x)->elements));
+
+        VALUE y = rb_protect(call, reinterpret_cast<VALUE>(this), &state);
+        if (state) return false;
+
+        if (!NM_IsNMatrix(y) || NM_STYPE(y) != nm::DENSE_STORE || NM_DTYPE(y) != NM_DTYPE(x) || NM_SRC(y) != NM_STORAGE(y) ||
+            NM_DENSE_COUNT(y) != n) {
+          state = -1;
+          return false;
+        }
+
+        const DType* result = reinterpret_cast<const DType*>(NM_STORAGE_DENSE(y)->elements);
+        std::copy(result, result + n, out);
+        return true;
+      }
+    };
+
+    /*
+     * Runs lanczos on the Yale matrix or callable op -- without the GVL, on a copy, for a Yale matrix, but with it for a
+     * callable, which is Ruby. Returns lanczos's result, with the state of a callable's exception (or -1 for a bad return value)
+     * in state.
+     */
+    template <typename DType>
+    static int lanczos_operator(VALUE op, VALUE x, int k, bool largest, int ncv, int maxiter, double tol, void* w,
+                                void* z, int& state) {
+      typedef typename RealDType<DType>::type RDType;
+
+      const int    n  = NM_DENSE_COUNT(x);
+      const DType* x0 = reinterpret_cast<const DType*>(NM_STORAGE_DENSE(x)->elements);
+      std::vector<DType> v0(x0, x0 + n);
+      int napply, info;
+
+      state = 0;
+      if (NM_IsNMatrix(op)) {
+        YaleCopy<DType>     copy(nm_yale_storage_direct(NM_STORAGE(op)));
+        YaleOperator<DType> yale = { &copy };
+        without_gvl<DType>([&] {
+          info = lanczos<DType>(n, yale, k, largest, ncv, maxiter, tol, &v0[0], reinterpret_cast<RDType*>(w),
+                                reinterpret_cast<DType*>(z), napply);
+        });
+        return info;
+      } else {
+        CallableOperator<DType> callable = { op, x, 0 };
+        info = lanczos<DType>(n, callable, k, largest, ncv, maxiter, tol, &v0[0], reinterpret_cast<RDType*>(w),
+                                  reinterpret_cast<DType*>(z), napply);
+        state = callable.state;
+        return info;
+      }
+    }
+
+    /*
+     * The preconditioners for the iterative methods. kind is 0 for none, 1 for Jacobi, where a is the dense diagonal
+     * of A, or 2 and 3 for ILU(0) and IC(0), where ija and a are the arrays of the Yale matrix factored by ilu0 or ic0.
+     */
+    template <typename DType>
+    struct YalePreconditioner {
+      int          kind;
+      size_t       n;
+      const IType* ija;
+      const DType* a;
+
+      bool operator()(const DType* r, DType* z) const {
+        std::copy(r, r + n, z);
+        apply(z);
+        return true;
+      }
+
+      void apply(DType* x) const {
+        if (kind == 1) {
+          for (size_t i = 0; i < n; ++i) x[i] /= a[i];
+        } else if (kind == 2) {
+          nm::yale_storage::ilu0_solve<DType>(n, ija, a, x);
+        } else if (kind == 3) {
+          nm::yale_storage::ic0_solve<DType>(n, ija, a, x);
+        }
+      }
+    };
+
+    /*
+     * Sets up the preconditioner of the given kind (as for YalePreconditioner) from the Yale matrix s: copies its
+     * diagonal into the dense d for Jacobi, or factors s in place for ILU(0) and IC(0). Returns 0, or
+     * i+1 if the pivot of row i was zero (or, for IC(0), not positive).
+     */
+    template <typename DType>
+    static int factor_preconditioner(int kind, YALE_STORAGE* s, void* d) {
+      const size_t n = s->shape[0];
+      DType*       a = reinterpret_cast<DType*>(s->a);
+
+      if (kind == 1) {
+        DType* diag = reinterpret_cast<DType*>(d);
+        for (size_t i = 0; i < n; ++i) {
+          if (exactly_zero(a[i])) return i + 1;
+          diag[i] = a[i];
+        }
+        return 0;
+      }
+
+      return kind == 2 ? nm::yale_storage::ilu0<DType>(n, s->ija, a) : nm::yale_storage::ic0<DType>(n, s->ija, a);
+    }
+
+    /*
+     * Applies the preconditioner of the given kind, from f (the dense diagonal, or the factored Yale matrix), to x.
+     */
+    template <typename DType>
+    static void precondition(int kind, const void* f, size_t n, void* x) {
+      const YALE_STORAGE*       s    = kind > 1 ? reinterpret_cast<const YALE_STORAGE*>(f) : NULL;
+      YalePreconditioner<DType> prec = { kind, n, s ? s->ija : NULL,
+                                         reinterpret_cast<const DType*>(s ? s->a : f) };
+      prec.apply(reinterpret_cast<DType*>(x));
+    }
+
+    /*
+     * Runs cg, bicgstab or gmres (which = 0, 1 or 2) on the square Yale matrix a, the right-hand side b and the initial
+     * guess x, which it overwrites with the solution, preconditioned as given by pkind and pf (see YalePreconditioner).
+     * Returns the solver's result. a, and the factored pf, are copied first, since the solver runs without the GVL.
+     */
+    template <typename DType>
+    static int krylov_yale(int which, const YALE_STORAGE* a, const void* b, void* x, double tol, int maxiter,
+                           int restart, int pkind, const void* pf, std::vector<double>& history) {
+      const int    n  = a->shape[0];
+      const DType* bb = reinterpret_cast<const DType*>(b);
+      DType*       xx = reinterpret_cast<DType*>(x);
+
+      YaleCopy<DType>           ac(a), fc(pkind > 1 ? reinterpret_cast<const YALE_STORAGE*>(pf) : NULL);
+      YaleOperator<DType>       op   = { &ac };
+      YalePreconditioner<DType> prec = { pkind, size_t(n), pkind > 1 ? &fc.ija[0] : NULL,
+                                         pkind > 1 ? &fc.a[0] : reinterpret_cast<const DType*>(pf) };
+
+      return krylov<DType>(which, n, op, prec, bb, xx, tol, maxiter, restart, history);
+    }
+
+    /*
+     * The numeric factorizations below run without the GVL on a copy of s, and the factor solves on the factor arrays,
+     * which belong to the Factorization; the Ruby side has allocated everything they write to. The triangular solve and
+     * the product read their Yale operands in place, so they keep the GVL.
+     */
+    template <typename DType>
+    static int64_t sparse_cholesky_numeric(const YALE_STORAGE* s, const int64_t* perm, const int64_t* parent,
+                                           const int64_t* colptr, int64_t* li, void* lx) {
+      YaleCopy<DType> c(s);
+      int64_t info;
+      without_gvl<DType>([&] {
+        info = nm::yale_storage::cholesky_numeric<DType>(c.n, &c.ija[0], &c.a[0], perm, parent, colptr, li,
+                                                         reinterpret_cast<DType*>(lx));
+      });
+      return info;
+    }
+
+    template <typename DType>
+    static int64_t sparse_lu_numeric(const YALE_STORAGE* s, const int64_t* q, double tol, int64_t* lp, int64_t* li,
+                                     void* lx, int64_t lcap, int64_t* up, int64_t* ui, void* ux, int64_t ucap,
+                                     int64_t* pinv) {
+      YaleCopy<DType> c(s);
+      int64_t info;
+      without_gvl<DType>([&] {
+        info = nm::yale_storage::lu_numeric<DType>(c.n, &c.ija[0], &c.a[0], q, tol, lp, li, reinterpret_cast<DType*>(lx),
+                                                   lcap, up, ui, reinterpret_cast<DType*>(ux), ucap, pinv);
+      });
+      return info;
+    }
+
+    /*
+     * Solves with a sparse factorization for each column of the row-major n-by-nrhs b, in place. factors holds the
+     * arrays of the factorization, in the order cholesky_solve or lu_solve take them.
+     */
+    template <typename DType>
+    static void sparse_factor_solve(bool lu, int64_t n, const int64_t* const* index, const void* const* values,
+                                    void* b, size_t nrhs) {
+      DType* bb = reinterpret_cast<DType*>(b);
+      std::vector<DType> x(n), work(n);
+
+      without_gvl<DType>([&] {
+        for (size_t c = 0; c < nrhs; ++c) {
+          for (int64_t i = 0; i < n; ++i) x[i] = bb[i*nrhs + c];
+
+          if (lu) {
+            nm::yale_storage::lu_solve<DType>(n, index[0], index[1], index[2], index[3],
+                                              reinterpret_cast<const DType*>(values[0]), index[4], index[5],
+                                              reinterpret_cast<const DType*>(values[1]), &x[0], &work[0]);
+          } else {
+            nm::yale_storage::cholesky_solve<DType>(n, index[0], index[1], index[2],
+                                                    reinterpret_cast<const DType*>(values[0]), &x[0], &work[0]);
+          }
+
+          for (int64_t i = 0; i < n; ++i) bb[i*nrhs + c] = x[i];
+        }
+      });
+    }
+
+    template <typename DType>
+    static size_t sparse_triangular_solve(const YALE_STORAGE* s, bool lower, bool unit, int64_t nlevels,
+                                          const int64_t* level_ptr, const int64_t* order, void* b, size_t nrhs) {
+      return nm::yale_storage::triangular_solve<DType>(s->shape[0], s->ija, reinterpret_cast<const DType*>(s->a),
+                                                       lower, unit, nlevels, level_ptr, order,
+                                                       reinterpret_cast<DType*>(b), nrhs);
+    }
+
+    /*
+     * Which of the diagonal entries of the Yale matrix s are nonzero (one flag for each of the first min(n, m) rows).
+     */
+    template <typename DType>
+    static void yale_diagonal_pattern(const YALE_STORAGE* s, char* nz) {
+      const DType* a = reinterpret_cast<const DType*>(s->a);
+      for (size_t i = 0; i < std::min(s->shape[0], s->shape[1]); ++i) nz[i] = !exactly_zero(a[i]);
+    }
+
+    template <typename DType>
+    static bool sparse_spgemm_numeric(const YALE_STORAGE* a, const YALE_STORAGE* b, const int64_t* ic, void* c) {
+      std::vector<int64_t> pos(b->shape[1]);
+      return nm::yale_storage::spgemm_numeric<DType>(a->shape[0], a->shape[1], b->shape[1], a->ija,
+                                                     reinterpret_cast<const DType*>(a->a), b->ija,
+                                                     reinterpret_cast<const DType*>(b->a), ic,
+                                                     reinterpret_cast<DType*>(c), pos.empty() ? NULL : &pos[0]);
+    }
+
   }
 } // end of namespace nm::math
 
@@ -496,6 +840,42 @@ void nm_math_init_blas() {
   /* ATLAS-CLAPACK Functions that are implemented internally */
   rb_define_singleton_method(cNMatrix_Internal_LAPACK, "clapack_getrf", (METHOD)nm_clapack_getrf, 5);
   rb_define_singleton_method(cNMatrix_Internal_LAPACK, "clapack_getrs", (METHOD)nm_clapack_getrs, 9);
+  rb_define_singleton_method(cNMatrix_Internal_LAPACK, "clapack_getri", (METHOD)nm_clapack_getri, 5);
+  rb_define_singleton_method(cNMatrix_Internal_LAPACK, "clapack_potrf", (METHOD)nm_clapack_potrf, 5);
+  rb_define_singleton_method(cNMatrix_Internal_LAPACK, "clapack_potrs", (METHOD)nm_clapack_potrs, 8);
+  rb_define_singleton_method(cNMatrix_Internal_LAPACK, "clapack_potri", (METHOD)nm_clapack_potri, 5);
+  rb_define_singleton_method(cNMatrix_Internal_LAPACK, "clapack_geqrf", (METHOD)nm_clapack_geqrf, 6);
+  rb_define_singleton_method(cNMatrix_Internal_LAPACK, "clapack_ormqr", (METHOD)nm_clapack_ormqr, 11);
+  rb_define_singleton_method(cNMatrix_Internal_LAPACK, "clapack_gels", (METHOD)nm_clapack_gels, 9);
+
+  /* Solvers for factorizations kept by NMatrix::Factorization */
+  rb_define_singleton_method(cNMatrix_Internal_LAPACK, "getrs_rowmajor", (METHOD)nm_getrs_rowmajor, 3);
+  rb_define_singleton_method(cNMatrix_Internal_LAPACK, "potrs_rowmajor", (METHOD)nm_potrs_rowmajor, 3);
+  rb_define_singleton_method(cNMatrix_Internal_LAPACK, "geqrs_rowmajor", (METHOD)nm_geqrs_rowmajor, 3);
+
+  /* Symmetric/Hermitian eigensolver behind NMatrix#eigh */
+  rb_define_singleton_method(cNMatrix_Internal_LAPACK, "syev_rowmajor", (METHOD)nm_syev_rowmajor, 5);
+
+  /* Jacobi SVD of the small projected matrices in NMatrix#svd_truncated */
+  rb_define_singleton_method(cNMatrix_Internal_LAPACK, "gesvj_rowmajor", (METHOD)nm_gesvj_rowmajor, 3);
+
+  VALUE cNMatrix_Internal_Sparse = rb_define_module_under(cNMatrix_Internal, "Sparse");
+
+  rb_define_singleton_method(cNMatrix_Internal_Sparse, "lanczos", (METHOD)nm_lanczos, 8);
+  rb_define_singleton_method(cNMatrix_Internal_Sparse, "krylov", (METHOD)nm_krylov, 9);
+  rb_define_singleton_method(cNMatrix_Internal_Sparse, "factor_preconditioner", (METHOD)nm_factor_preconditioner, 3);
+  rb_define_singleton_method(cNMatrix_Internal_Sparse, "precondition", (METHOD)nm_precondition, 3);
+  rb_define_singleton_method(cNMatrix_Internal_Sparse, "minimum_degree", (METHOD)nm_minimum_degree, 2);
+  rb_define_singleton_method(cNMatrix_Internal_Sparse, "reverse_cuthill_mckee", (METHOD)nm_reverse_cuthill_mckee, 2);
+  rb_define_singleton_method(cNMatrix_Internal_Sparse, "cholesky_symbolic", (METHOD)nm_cholesky_symbolic, 4);
+  rb_define_singleton_method(cNMatrix_Internal_Sparse, "cholesky_numeric", (METHOD)nm_cholesky_numeric, 6);
+  rb_define_singleton_method(cNMatrix_Internal_Sparse, "cholesky_solve", (METHOD)nm_cholesky_solve, 5);
+  rb_define_singleton_method(cNMatrix_Internal_Sparse, "lu_numeric", (METHOD)nm_lu_numeric, 10);
+  rb_define_singleton_method(cNMatrix_Internal_Sparse, "lu_solve", (METHOD)nm_lu_solve, 9);
+  rb_define_singleton_method(cNMatrix_Internal_Sparse, "triangular_levels", (METHOD)nm_triangular_levels, 4);
+  rb_define_singleton_method(cNMatrix_Internal_Sparse, "triangular_solve", (METHOD)nm_triangular_solve, 7);
+  rb_define_singleton_method(cNMatrix_Internal_Sparse, "spgemm_symbolic", (METHOD)nm_spgemm_symbolic, 3);
+  rb_define_singleton_method(cNMatrix_Internal_Sparse, "spgemm_numeric", (METHOD)nm_spgemm_numeric, 5);
   rb_define_singleton_method(cNMatrix_Internal_LAPACK, "clapack_laswp", (METHOD)nm_clapack_laswp, 7);
 
   VALUE cNMatrix_Internal_BLAS = rb_define_module_under(cNMatrix_Internal, "BLAS");
@@ -925,6 +1305,16 @@ static VALUE nm_cblas_trsm(VALUE self,
   return Qtrue;
 }
 
+/*
+ * Checks the leading dimension ld given to one of the clapack_ functions against the min rows (or columns) it must
+ * span, before the kernel runs without the GVL and so can no longer raise. Returns it as an int.
+ */
+static int leading_dimension(VALUE ld, int min, const char* name) {
+  int l = FIX2INT(ld);
+  if (l < std::max(min, 1)) rb_raise(rb_eArgError, "%s must be at least max(1, %d), not %d", name, min, l);
+  return l;
+}
+
 /* Call any of the clapack_xgetrf functions as directly as possible.
  *
  * The clapack_getrf functions (dgetrf, sgetrf, cgetrf, and zgetrf) compute an LU factorization of a general M-by-N
@@ -970,7 +1360,9 @@ static VALUE nm_clapack_getrf(VALUE self, VALUE order, VALUE m, VALUE n, VALUE a
     rb_raise(nm_eDataTypeError, "this matrix operation undefined for integer matrices");
   } else {
     // Call either our version of getrf or the LAPACK version.
-    ttable[NM_DTYPE(a)](blas_order_sym(order), M, N, NM_STORAGE_DENSE(a)->elements, FIX2INT(lda), ipiv);
+    const enum CBLAS_ORDER o = blas_order_sym(order);
+    ttable[NM_DTYPE(a)](o, M, N, NM_STORAGE_DENSE(a)->elements, leading_dimension(lda, o == CblasRowMajor ? N : M, "lda"),
+                        ipiv);
   }
 
   // Result will be stored in a. We return ipiv as an array.
@@ -1014,14 +1406,1180 @@ static VALUE nm_clapack_getrs(VALUE self, VALUE order, VALUE trans, VALUE n, VAL
   } else {
 
     // Call either our version of getrs or the LAPACK version.
-    ttable[NM_DTYPE(a)](blas_order_sym(order), blas_transpose_sym(trans), FIX2INT(n), FIX2INT(nrhs), NM_STORAGE_DENSE(a)->elements, FIX2INT(lda),
-                        ipiv_, NM_STORAGE_DENSE(b)->elements, FIX2INT(ldb));
+    const int N = FIX2INT(n);
+    ttable[NM_DTYPE(a)](blas_order_sym(order), blas_transpose_sym(trans), N, FIX2INT(nrhs), NM_STORAGE_DENSE(a)->elements,
+                        leading_dimension(lda, N, "lda"), ipiv_, NM_STORAGE_DENSE(b)->elements, leading_dimension(ldb, N, "ldb"));
+  }
+
+  // b is both returned and modified directly in the argument list.
+  return b;
+}
+
+/*
+ * Call any of the clapack_xgetri functions as directly as possible.
+ *
+ * Computes the inverse of a matrix, in place, from the LU factorization and pivots given by clapack_getrf (in the
+ * same order). Raises ZeroDivisionError if the matrix is singular.
+ *
+ * See: http://www.netlib.org/lapack/double/dgetri.f
+ */
+static VALUE nm_clapack_getri(VALUE self, VALUE order, VALUE n, VALUE a, VALUE lda, VALUE ipiv) {
+  static int (*ttable[nm::NUM_DTYPES])(const enum CBLAS_ORDER, const int n, void* a, const int lda, const int* ipiv) = {
+      NULL, NULL, NULL, NULL, NULL, // integers not allowed due to division
+      nm::math::clapack_getri<float>,
+      nm::math::clapack_getri<double>,
+      nm::math::clapack_getri<nm::Complex64>,
+      nm::math::clapack_getri<nm::Complex128>,
+      nm::math::clapack_getri<nm::RubyObject>
+  };
+
+  // Allocate the C version of the pivot index array
+  int* ipiv_;
+  if (TYPE(ipiv) != T_ARRAY) {
+    rb_raise(rb_eArgError, "ipiv must be of type Array");
+  } else {
+    ipiv_ = NM_ALLOCA_N(int, RARRAY_LEN(ipiv));
+    for (int index = 0; index < RARRAY_LEN(ipiv); ++index) {
+      ipiv_[index] = FIX2INT( RARRAY_PTR(ipiv)[index] );
+    }
+  }
+
+  if (!ttable[NM_DTYPE(a)]) {
+    rb_raise(nm_eDataTypeError, "this matrix operation undefined for integer matrices");
+  } else if (ttable[NM_DTYPE(a)](blas_order_sym(order), FIX2INT(n), NM_STORAGE_DENSE(a)->elements,
+                                 leading_dimension(lda, FIX2INT(n), "lda"), ipiv_)) {
+    rb_raise(rb_eZeroDivError, "Expected Non-Singular Matrix.");
+  }
+
+  return a;
+}
+
+/*
+ * Call any of the clapack_xpotrf functions as directly as possible.
+ *
+ * Computes the Cholesky factorization of a symmetric (Hermitian) positive-definite matrix, in place in the triangle
+ * given by uplo. Only that triangle is read. Raises ArgumentError if the matrix is not positive-definite.
+ *
+ * See: http://www.netlib.org/lapack/double/dpotrf.f
+ */
+static VALUE nm_clapack_potrf(VALUE self, VALUE order, VALUE uplo, VALUE n, VALUE a, VALUE lda) {
+  static int (*ttable[nm::NUM_DTYPES])(const enum CBLAS_ORDER, const enum CBLAS_UPLO, const int n, void* a, const int lda) = {
+      NULL, NULL, NULL, NULL, NULL, // integers not allowed due to division
+      nm::math::clapack_potrf<float>,
+      nm::math::clapack_potrf<double>,
+      nm::math::clapack_potrf<nm::Complex64>,
+      nm::math::clapack_potrf<nm::Complex128>,
+      NULL
+  };
+
+  if (!ttable[NM_DTYPE(a)]) {
+    rb_raise(nm_eDataTypeError, "this matrix operation undefined for integer and object matrices");
+  }
+
+  int info = ttable[NM_DTYPE(a)](blas_order_sym(order), blas_uplo_sym(uplo), FIX2INT(n), NM_STORAGE_DENSE(a)->elements, FIX2INT(lda));
+  if (info) {
+    rb_raise(rb_eArgError, "matrix is not positive-definite (leading minor of order %d)", info);
+  }
+
+  return a;
+}
+
+/*
+ * Call any of the clapack_xpotrs functions as directly as possible.
+ *
+ * Solves A*X = B given the Cholesky factorization of A from clapack_potrf (in the same order and triangle). As with
+ * ATLAS, each right-hand side is a row of b, so a row-major n-by-nrhs B must be transposed before and after.
+ *
+ * See: http://www.netlib.org/lapack/double/dpotrs.f
+ */
+static VALUE nm_clapack_potrs(VALUE self, VALUE order, VALUE uplo, VALUE n, VALUE nrhs, VALUE a, VALUE lda, VALUE b, VALUE ldb) {
+  static int (*ttable[nm::NUM_DTYPES])(const enum CBLAS_ORDER Order, const enum CBLAS_UPLO Uplo, const int N,
+                                       const int NRHS, const void* A, const int lda, void* B, const int ldb) = {
+      NULL, NULL, NULL, NULL, NULL, // integers not allowed due to division
+      nm::math::clapack_potrs<float>,
+      nm::math::clapack_potrs<double>,
+      nm::math::clapack_potrs<nm::Complex64>,
+      nm::math::clapack_potrs<nm::Complex128>,
+      NULL
+  };
+
+  if (!ttable[NM_DTYPE(a)]) {
+    rb_raise(nm_eDataTypeError, "this matrix operation undefined for integer and object matrices");
+  } else if (NM_DTYPE(a) != NM_DTYPE(b)) {
+    rb_raise(nm_eDataTypeError, "a and b must have the same dtype");
+  }
+
+  ttable[NM_DTYPE(a)](blas_order_sym(order), blas_uplo_sym(uplo), FIX2INT(n), FIX2INT(nrhs), NM_STORAGE_DENSE(a)->elements, FIX2INT(lda),
+                      NM_STORAGE_DENSE(b)->elements, FIX2INT(ldb));
+
+  // b is both returned and modified directly in the argument list.
+  return b;
+}
+
+/*
+ * Call any of the clapack_xpotri functions as directly as possible.
+ *
+ * Computes the inverse of a symmetric (Hermitian) positive-definite matrix, in place in the triangle given by uplo,
+ * from its Cholesky factorization by clapack_potrf. The other triangle is left alone. Raises ZeroDivisionError if the
+ * factor is singular.
+ *
+ * See: http://www.netlib.org/lapack/double/dpotri.f
+ */
+static VALUE nm_clapack_potri(VALUE self, VALUE order, VALUE uplo, VALUE n, VALUE a, VALUE lda) {
+  static int (*ttable[nm::NUM_DTYPES])(const enum CBLAS_ORDER, const enum CBLAS_UPLO, const int n, void* a, const int lda) = {
+      NULL, NULL, NULL, NULL, NULL, // integers not allowed due to division
+      nm::math::clapack_potri<float>,
+      nm::math::clapack_potri<double>,
+      nm::math::clapack_potri<nm::Complex64>,
+      nm::math::clapack_potri<nm::Complex128>,
+      NULL
+  };
+
+  if (!ttable[NM_DTYPE(a)]) {
+    rb_raise(nm_eDataTypeError, "this matrix operation undefined for integer and object matrices");
+  } else if (ttable[NM_DTYPE(a)](blas_order_sym(order), blas_uplo_sym(uplo), FIX2INT(n), NM_STORAGE_DENSE(a)->elements,
+                                 leading_dimension(lda, FIX2INT(n), "lda"))) {
+    rb_raise(rb_eZeroDivError, "Expected Non-Singular Matrix.");
+  }
+
+  return a;
+}
+
+/*
+ * Call any of the clapack_xgeqrf functions as directly as possible.
+ *
+ * Computes the QR factorization of an m-by-n matrix in place: R on and above the diagonal, and below it the
+ * Householder vectors whose min(m,n) scalar factors are written to tau (a dense NMatrix of the same dtype).
+ *
+ * See: http://www.netlib.org/lapack/complex16/zgeqrf.f
+ */
+static VALUE nm_clapack_geqrf(VALUE self, VALUE order, VALUE m, VALUE n, VALUE a, VALUE lda, VALUE tau) {
+  static void (*ttable[nm::NUM_DTYPES])(const enum CBLAS_ORDER, const int m, const int n, void* a, const int lda, void* tau) = {
+      NULL, NULL, NULL, NULL, NULL, // integers not allowed due to division
+      nm::math::clapack_geqrf<float>,
+      nm::math::clapack_geqrf<double>,
+      nm::math::clapack_geqrf<nm::Complex64>,
+      nm::math::clapack_geqrf<nm::Complex128>,
+      NULL
+  };
+
+  if (!ttable[NM_DTYPE(a)]) {
+    rb_raise(nm_eDataTypeError, "this matrix operation undefined for integer and object matrices");
+  } else if (NM_DTYPE(a) != NM_DTYPE(tau)) {
+    rb_raise(nm_eDataTypeError, "a and tau must have the same dtype");
+  } else if (NM_DENSE_COUNT(tau) < (size_t)std::min(FIX2INT(m), FIX2INT(n))) {
+    rb_raise(rb_eArgError, "tau must have at least min(m,n) entries");
+  }
+
+  const enum CBLAS_ORDER o = blas_order_sym(order);
+  ttable[NM_DTYPE(a)](o, FIX2INT(m), FIX2INT(n), NM_STORAGE_DENSE(a)->elements,
+                      leading_dimension(lda, o == CblasRowMajor ? FIX2INT(n) : FIX2INT(m), "lda"),
+                      NM_STORAGE_DENSE(tau)->elements);
+
+  return a;
+}
+
+/*
+ * Call any of the clapack_xormqr (xunmqr for the complex dtypes) functions as directly as possible.
+ *
+ * Overwrites the m-by-n matrix c with op(Q)*c (side :left) or c*op(Q) (side :right), where Q is defined by k
+ * reflectors from clapack_geqrf in a and tau. op(Q) is Q for trans false, and Q**H for :transpose or
+ * :complex_conjugate.
+ *
+ * See: http://www.netlib.org/lapack/complex16/zunmqr.f
+ */
+static VALUE nm_clapack_ormqr(VALUE self, VALUE order, VALUE side, VALUE trans, VALUE m, VALUE n, VALUE k, VALUE a, VALUE lda, VALUE tau, VALUE c, VALUE ldc) {
+  static void (*ttable[nm::NUM_DTYPES])(const enum CBLAS_ORDER, const enum CBLAS_SIDE, const enum CBLAS_TRANSPOSE,
+                                        const int m, const int n, const int k, void* a, const int lda, void* tau,
+                                        void* c, const int ldc) = {
+      NULL, NULL, NULL, NULL, NULL, // integers not allowed due to division
+      nm::math::clapack_ormqr<float>,
+      nm::math::clapack_ormqr<double>,
+      nm::math::clapack_ormqr<nm::Complex64>,
+      nm::math::clapack_ormqr<nm::Complex128>,
+      NULL
+  };
+
+  if (!ttable[NM_DTYPE(a)]) {
+    rb_raise(nm_eDataTypeError, "this matrix operation undefined for integer and object matrices");
+  } else if (NM_DTYPE(a) != NM_DTYPE(tau) || NM_DTYPE(a) != NM_DTYPE(c)) {
+    rb_raise(nm_eDataTypeError, "a, tau and c must have the same dtype");
+  }
+
+  const enum CBLAS_ORDER o  = blas_order_sym(order);
+  const enum CBLAS_SIDE  s  = blas_side_sym(side);
+  const int              mm = FIX2INT(m), nn = FIX2INT(n), kk = FIX2INT(k), nq = s == CblasLeft ? mm : nn;
+  const bool             rm = o == CblasRowMajor;
+
+  ttable[NM_DTYPE(a)](o, s, blas_transpose_sym(trans), mm, nn, kk, NM_STORAGE_DENSE(a)->elements,
+                      leading_dimension(lda, rm ? kk : nq, "lda"), NM_STORAGE_DENSE(tau)->elements,
+                      NM_STORAGE_DENSE(c)->elements, leading_dimension(ldc, rm ? nn : mm, "ldc"));
+
+  // c is both returned and modified directly in the argument list.
+  return c;
+}
+
+/*
+ * Call any of the clapack_xgels functions as directly as possible.
+ *
+ * Solves the overdetermined (m >= n) least-squares problem min ||B - A*X|| by QR factorization of A, overwriting a
+ * with its factorization and the first n rows of the m-by-nrhs matrix b with X. Only trans = false is supported.
+ * Raises ZeroDivisionError if A does not have full rank.
+ *
+ * See: http://www.netlib.org/lapack/complex16/zgels.f
+ */
+static VALUE nm_clapack_gels(VALUE self, VALUE order, VALUE trans, VALUE m, VALUE n, VALUE nrhs, VALUE a, VALUE lda, VALUE b, VALUE ldb) {
+  static int (*ttable[nm::NUM_DTYPES])(const enum CBLAS_ORDER, const int m, const int n, const int nrhs, void* a,
+                                       const int lda, void* b, const int ldb) = {
+      NULL, NULL, NULL, NULL, NULL, // integers not allowed due to division
+      nm::math::clapack_gels<float>,
+      nm::math::clapack_gels<double>,
+      nm::math::clapack_gels<nm::Complex64>,
+      nm::math::clapack_gels<nm::Complex128>,
+      NULL
+  };
+
+  if (!ttable[NM_DTYPE(a)]) {
+    rb_raise(nm_eDataTypeError, "this matrix operation undefined for integer and object matrices");
+  } else if (NM_DTYPE(a) != NM_DTYPE(b)) {
+    rb_raise(nm_eDataTypeError, "a and b must have the same dtype");
+  } else if (blas_transpose_sym(trans) != CblasNoTrans) {
+    rb_raise(rb_eNotImpError, "only the untransposed least-squares problem is implemented");
+  } else if (FIX2INT(m) < FIX2INT(n)) {
+    rb_raise(rb_eNotImpError, "underdetermined (m < n) least-squares problems are not implemented");
+  }
+
+  const enum CBLAS_ORDER o  = blas_order_sym(order);
+  const int              mm = FIX2INT(m), nn = FIX2INT(n), nr = FIX2INT(nrhs);
+  const bool             rm = o == CblasRowMajor;
+
+  if (ttable[NM_DTYPE(a)](o, mm, nn, nr, NM_STORAGE_DENSE(a)->elements, leading_dimension(lda, rm ? nn : mm, "lda"),
+                          NM_STORAGE_DENSE(b)->elements, leading_dimension(ldb, rm ? nr : mm, "ldb"))) {
+    rb_raise(rb_eZeroDivError, "matrix does not have full rank");
   }
 
   // b is both returned and modified directly in the argument list.
   return b;
 }
 
+/*
+ * Shared argument checks for getrs_rowmajor and potrs_rowmajor: a must be a square dense factor, and b a dense,
+ * unsliced n-by-nrhs matrix (or length-n vector) of the same dtype. Returns nrhs.
+ */
+static int factored_solve_nrhs(VALUE a, VALUE b) {
+  if (NM_STYPE(a) != nm::DENSE_STORE || NM_STYPE(b) != nm::DENSE_STORE) {
+    rb_raise(nm_eStorageTypeError, "factored solves only work on dense matrices");
+  } else if (NM_DIM(a) != 2 || NM_SHAPE0(a) != NM_SHAPE1(a)) {
+    rb_raise(nm_eShapeError, "factor must be square");
+  } else if (NM_DIM(b) > 2 || NM_SHAPE0(b) != NM_SHAPE0(a)) {
+    rb_raise(nm_eShapeError, "number of rows of b must equal number of cols of the factor");
+  } else if (NM_DTYPE(a) != NM_DTYPE(b)) {
+    rb_raise(nm_eDataTypeError, "factor and b must have the same dtype");
+  } else if (NM_SRC(b) != NM_STORAGE(b)) {
+    rb_raise(rb_eArgError, "b must not be a slice reference");
+  }
+
+  return NM_DIM(b) == 2 ? NM_SHAPE1(b) : 1;
+}
+
+/*
+ * call-seq:
+ *     getrs_rowmajor(lu, ipiv, b) -> b
+ *
+ * Solves A*X = B in place, given the LU factorization lu of A from clapack_getrf(:row, ...) and its (0-based) pivots
+ * as an :int32 NMatrix. Unlike clapack_getrs, b is an ordinary row-major matrix whose columns are the right-hand
+ * sides (or a single vector), so it does not need to be transposed.
+ *
+ * Raises ZeroDivisionError if the factorization is singular.
+ */
+static VALUE nm_getrs_rowmajor(VALUE self, VALUE a, VALUE ipiv, VALUE b) {
+  static int (*ttable[nm::NUM_DTYPES])(const int N, const int NRHS, const void* A, const int lda, const int* ipiv,
+                                       void* B, const int ldb) = {
+      NULL, NULL, NULL, NULL, NULL, // integers not allowed due to division
+      nm::math::getrs_rowmajor<float>,
+      nm::math::getrs_rowmajor<double>,
+      nm::math::getrs_rowmajor<nm::Complex64>,
+      nm::math::getrs_rowmajor<nm::Complex128>,
+      NULL
+  };
+
+  int nrhs = factored_solve_nrhs(a, b), n = NM_SHAPE0(a);
+
+  if (!ttable[NM_DTYPE(a)]) {
+    rb_raise(nm_eDataTypeError, "this matrix operation undefined for integer and object matrices");
+  } else if (NM_STYPE(ipiv) != nm::DENSE_STORE || NM_DTYPE(ipiv) != nm::INT32 || NM_DENSE_COUNT(ipiv) != (size_t)n) {
+    rb_raise(rb_eArgError, "ipiv must be a dense :int32 NMatrix with one entry per row");
+  }
+
+  if (ttable[NM_DTYPE(a)](n, nrhs, NM_STORAGE_DENSE(a)->elements, n, reinterpret_cast<const int*>(NM_STORAGE_DENSE(ipiv)->elements),
+                          NM_STORAGE_DENSE(b)->elements, nrhs)) {
+    rb_raise(rb_eZeroDivError, "Expected Non-Singular Matrix.");
+  }
+
+  return b;
+}
+
+/*
+ * call-seq:
+ *     potrs_rowmajor(uplo, factor, b) -> b
+ *
+ * Solves A*X = B in place, given the Cholesky factor of A from clapack_potrf(:row, uplo, ...). As with getrs_rowmajor,
+ * b is an ordinary row-major matrix whose columns are the right-hand sides (or a single vector).
+ */
+static VALUE nm_potrs_rowmajor(VALUE self, VALUE uplo, VALUE a, VALUE b) {
+  static int (*ttable[nm::NUM_DTYPES])(const enum CBLAS_UPLO, const int N, const int NRHS, const void* A, const int lda,
+                                       void* B, const int ldb) = {
+      NULL, NULL, NULL, NULL, NULL, // integers not allowed due to division
+      nm::math::potrs_rowmajor<float>,
+      nm::math::potrs_rowmajor<double>,
+      nm::math::potrs_rowmajor<nm::Complex64>,
+      nm::math::potrs_rowmajor<nm::Complex128>,
+      NULL
+  };
+
+  int nrhs = factored_solve_nrhs(a, b), n = NM_SHAPE0(a);
+
+  if (!ttable[NM_DTYPE(a)]) {
+    rb_raise(nm_eDataTypeError, "this matrix operation undefined for integer and object matrices");
+  }
+
+  ttable[NM_DTYPE(a)](blas_uplo_sym(uplo), n, nrhs, NM_STORAGE_DENSE(a)->elements, n, NM_STORAGE_DENSE(b)->elements, nrhs);
+
+  return b;
+}
+
+/*
+ * call-seq:
+ *     geqrs_rowmajor(qr, tau, b) -> b
+ *
+ * Least-squares solution of A*X = B in place, given the QR factorization qr of the m-by-n (m >= n) matrix A and tau
+ * from clapack_geqrf(:row, ...). b is an ordinary row-major m-by-nrhs matrix (or length-m vector) whose columns are
+ * the right-hand sides; its first n rows are overwritten with X.
+ *
+ * Raises ZeroDivisionError if A does not have full rank.
+ */
+static VALUE nm_geqrs_rowmajor(VALUE self, VALUE a, VALUE tau, VALUE b) {
+  static int (*ttable[nm::NUM_DTYPES])(const int M, const int N, const int NRHS, const void* A, const void* tau, void* B) = {
+      NULL, NULL, NULL, NULL, NULL, // integers not allowed due to division
+      nm::math::geqrs_rowmajor<float>,
+      nm::math::geqrs_rowmajor<double>,
+      nm::math::geqrs_rowmajor<nm::Complex64>,
+      nm::math::geqrs_rowmajor<nm::Complex128>,
+      NULL
+  };
+
+  if (NM_STYPE(a) != nm::DENSE_STORE || NM_STYPE(tau) != nm::DENSE_STORE || NM_STYPE(b) != nm::DENSE_STORE) {
+    rb_raise(nm_eStorageTypeError, "factored solves only work on dense matrices");
+  } else if (NM_DIM(a) != 2 || NM_SHAPE0(a) < NM_SHAPE1(a)) {
+    rb_raise(nm_eShapeError, "factor must have at least as many rows as columns");
+  } else if (NM_DIM(b) > 2 || NM_SHAPE0(b) != NM_SHAPE0(a)) {
+    rb_raise(nm_eShapeError, "number of rows of b must equal number of rows of the factor");
+  } else if (NM_DTYPE(a) != NM_DTYPE(b) || NM_DTYPE(a) != NM_DTYPE(tau)) {
+    rb_raise(nm_eDataTypeError, "factor, tau and b must have the same dtype");
+  } else if (NM_DENSE_COUNT(tau) < NM_SHAPE1(a)) {
+    rb_raise(rb_eArgError, "tau must have one entry per column of the factor");
+  } else if (NM_SRC(b) != NM_STORAGE(b)) {
+    rb_raise(rb_eArgError, "b must not be a slice reference");
+  } else if (!ttable[NM_DTYPE(a)]) {
+    rb_raise(nm_eDataTypeError, "this matrix operation undefined for integer and object matrices");
+  }
+
+  int nrhs = NM_DIM(b) == 2 ? NM_SHAPE1(b) : 1;
+
+  if (ttable[NM_DTYPE(a)](NM_SHAPE0(a), NM_SHAPE1(a), nrhs, NM_STORAGE_DENSE(a)->elements, NM_STORAGE_DENSE(tau)->elements,
+                          NM_STORAGE_DENSE(b)->elements)) {
+    rb_raise(rb_eZeroDivError, "matrix does not have full rank");
+  }
+
+  return b;
+}
+
+/*
+ * call-seq:
+ *     syev_rowmajor(uplo, a, il, w, z) -> w
+ *
+ * Eigenvalues il, il+1, ... (0-based, in ascending order) of the symmetric or Hermitian matrix a, of which only the
+ * triangle given by uplo is read; as many as w has entries. They are written to w, which must be a dense NMatrix of
+ * a's real dtype (:float32 or :float64). If z is not nil, it must be a dense n-by-m NMatrix of a's dtype, and its
+ * columns are overwritten with the corresponding eigenvectors.
+ */
+static VALUE nm_syev_rowmajor(VALUE self, VALUE uplo, VALUE a, VALUE il, VALUE w, VALUE z) {
+  static int (*ttable[nm::NUM_DTYPES])(const enum CBLAS_UPLO, const int N, const void* A, const int lda, const int il,
+                                       const int iu, void* w, void* z) = {
+      NULL, NULL, NULL, NULL, NULL, // integers not allowed due to division
+      nm::math::syev_rowmajor<float>,
+      nm::math::syev_rowmajor<double>,
+      nm::math::syev_rowmajor<nm::Complex64>,
+      nm::math::syev_rowmajor<nm::Complex128>,
+      NULL
+  };
+
+  if (NM_STYPE(a) != nm::DENSE_STORE || NM_STYPE(w) != nm::DENSE_STORE || (z != Qnil && NM_STYPE(z) != nm::DENSE_STORE)) {
+    rb_raise(nm_eStorageTypeError, "eigensolver only works on dense matrices");
+  } else if (!ttable[NM_DTYPE(a)]) {
+    rb_raise(nm_eDataTypeError, "this matrix operation undefined for integer and object matrices");
+  } else if (NM_DIM(a) != 2 || NM_SHAPE0(a) != NM_SHAPE1(a)) {
+    rb_raise(nm_eShapeError, "matrix must be square");
+  } else if (NM_SRC(a) != NM_STORAGE(a) || (z != Qnil && NM_SRC(z) != NM_STORAGE(z))) {
+    rb_raise(rb_eArgError, "a and z must not be slice references");
+  }
+
+  const int    n     = NM_SHAPE0(a), first = FIX2INT(il), m = NM_DENSE_COUNT(w);
+  nm::dtype_t  rtype = (NM_DTYPE(a) == nm::FLOAT32 || NM_DTYPE(a) == nm::COMPLEX64) ? nm::FLOAT32 : nm::FLOAT64;
+
+  if (NM_DTYPE(w) != rtype) {
+    rb_raise(nm_eDataTypeError, "w must have the real dtype that goes with a's dtype");
+  } else if (first < 0 || first + m > n) {
+    rb_raise(rb_eRangeError, "eigenvalues %d..%d requested from a %dx%d matrix", first, first + m - 1, n, n);
+  } else if (z != Qnil && (NM_DTYPE(z) != NM_DTYPE(a) || NM_DIM(z) != 2 || NM_SHAPE0(z) != (size_t)n || NM_SHAPE1(z) != (size_t)m)) {
+    rb_raise(nm_eShapeError, "z must be an n-by-m matrix of a's dtype");
+  }
+
+  if (ttable[NM_DTYPE(a)](blas_uplo_sym(uplo), n, NM_STORAGE_DENSE(a)->elements, n, first, first + m - 1,
+                          NM_STORAGE_DENSE(w)->elements, z == Qnil ? NULL : NM_STORAGE_DENSE(z)->elements)) {
+    rb_raise(rb_eRuntimeError, "eigenvalue iteration failed to converge");
+  }
+
+  return w;
+}
+
+/*
+ * call-seq:
+ *     gesvj_rowmajor(a, s, v) -> s
+ *
+ * Singular value decomposition A = U * diag(s) * V**H of the m-by-n (m >= n) matrix a by one-sided Jacobi rotations.
+ * a is overwritten with the m-by-n U; the singular values, in descending order, are written to s, which must be a
+ * dense NMatrix of a's real dtype (:float32 or :float64) with n entries. If v is not nil, it must be a dense n-by-n
+ * NMatrix of a's dtype, and is overwritten with V.
+ */
+static VALUE nm_gesvj_rowmajor(VALUE self, VALUE a, VALUE s, VALUE v) {
+  static int (*ttable[nm::NUM_DTYPES])(const int M, const int N, void* a, void* s, void* v) = {
+      NULL, NULL, NULL, NULL, NULL, // integers not allowed due to division
+      nm::math::gesvj_rowmajor<float>,
+      nm::math::gesvj_rowmajor<double>,
+      nm::math::gesvj_rowmajor<nm::Complex64>,
+      nm::math::gesvj_rowmajor<nm::Complex128>,
+      NULL
+  };
+
+  if (NM_STYPE(a) != nm::DENSE_STORE || NM_STYPE(s) != nm::DENSE_STORE || (v != Qnil && NM_STYPE(v) != nm::DENSE_STORE)) {
+    rb_raise(nm_eStorageTypeError, "singular value decomposition only works on dense matrices");
+  } else if (!ttable[NM_DTYPE(a)]) {
+    rb_raise(nm_eDataTypeError, "this matrix operation undefined for integer and object matrices");
+  } else if (NM_DIM(a) != 2 || NM_SHAPE0(a) < NM_SHAPE1(a)) {
+    rb_raise(nm_eShapeError, "matrix must have at least as many rows as columns");
+  } else if (NM_SRC(a) != NM_STORAGE(a) || (v != Qnil && NM_SRC(v) != NM_STORAGE(v))) {
+    rb_raise(rb_eArgError, "a and v must not be slice references");
+  }
+
+  const int   m     = NM_SHAPE0(a), n = NM_SHAPE1(a);
+  nm::dtype_t rtype = (NM_DTYPE(a) == nm::FLOAT32 || NM_DTYPE(a) == nm::COMPLEX64) ? nm::FLOAT32 : nm::FLOAT64;
+
+  if (NM_DTYPE(s) != rtype || NM_DENSE_COUNT(s) != (size_t)n) {
+    rb_raise(nm_eDataTypeError, "s must have a's real dtype and one entry per column of a");
+  } else if (v != Qnil && (NM_DTYPE(v) != NM_DTYPE(a) || NM_DIM(v) != 2 || NM_SHAPE0(v) != (size_t)n || NM_SHAPE1(v) != (size_t)n)) {
+    rb_raise(nm_eShapeError, "v must be an n-by-n matrix of a's dtype");
+  }
+
+  if (ttable[NM_DTYPE(a)](m, n, NM_STORAGE_DENSE(a)->elements, NM_STORAGE_DENSE(s)->elements,
+                          v == Qnil ? NULL : NM_STORAGE_DENSE(v)->elements)) {
+    rb_raise(rb_eRuntimeError, "singular value iteration failed to converge");
+  }
+
+  return s;
+}
+
+/*
+ * call-seq:
+ *     lanczos(op, x, which, ncv, maxiter, tol, w, z) -> w
+ *
+ * The k largest (which = :largest) or smallest (:smallest) eigenvalues of a Hermitian operator, and optionally their
+ * eigenvectors, by thick-restart Lanczos with locking (see nm::math::lanczos) with ncv basis vectors (k < ncv <= n),
+ * restarting at most maxiter times in all. tol is the residual norm wanted, relative to the largest eigenvalue
+ * magnitude (0 for the square root of the machine epsilon).
+ *
+ * op is either a square Yale NMatrix, whose default value must be zero, or a Ruby object whose call method takes a
+ * dense n-by-1 NMatrix and returns the operator applied to it as a dense, non-reference NMatrix of the same dtype and
+ * size. x is such an n-by-1 NMatrix holding the start vector; it is also the argument passed to op.call.
+ *
+ * w gets the k eigenvalues, in ascending order, and must be a dense NMatrix of the real dtype that goes with x's dtype.
+ * If z is not nil, it must be a dense n-by-k NMatrix of x's dtype, and gets the eigenvectors.
+ */
+static VALUE nm_lanczos(VALUE self, VALUE op, VALUE x, VALUE which, VALUE ncv, VALUE maxiter, VALUE tol, VALUE w, VALUE z) {
+  static int (*ttable[nm::NUM_DTYPES])(VALUE op, VALUE x, int k, bool largest, int ncv, int maxiter, double tol, void* w,
+                                       void* z, int& state) = {
+      NULL, NULL, NULL, NULL, NULL, // integers not allowed due to division
+      nm::math::lanczos_operator<float>,
+      nm::math::lanczos_operator<double>,
+      nm::math::lanczos_operator<nm::Complex64>,
+      nm::math::lanczos_operator<nm::Complex128>,
+      NULL
+  };
+
+  if (NM_STYPE(x) != nm::DENSE_STORE || NM_STYPE(w) != nm::DENSE_STORE || (z != Qnil && NM_STYPE(z) != nm::DENSE_STORE)) {
+    rb_raise(nm_eStorageTypeError, "x, w and z must be dense matrices");
+  } else if (!ttable[NM_DTYPE(x)]) {
+    rb_raise(nm_eDataTypeError, "this matrix operation undefined for integer and object matrices");
+  } else if (NM_SRC(x) != NM_STORAGE(x) || (z != Qnil && NM_SRC(z) != NM_STORAGE(z))) {
+    rb_raise(rb_eArgError, "x and z must not be slice references");
+  }
+
+  const size_t n     = NM_DENSE_COUNT(x), k = NM_DENSE_COUNT(w);
+  const int    m     = FIX2INT(ncv);
+  nm::dtype_t  rtype = (NM_DTYPE(x) == nm::FLOAT32 || NM_DTYPE(x) == nm::COMPLEX64) ? nm::FLOAT32 : nm::FLOAT64;
+
+  if (NM_IsNMatrix(op)) {
+    if (NM_STYPE(op) != nm::YALE_STORE || NM_SRC(op) != NM_STORAGE(op)) {
+      rb_raise(nm_eStorageTypeError, "operator must be a yale matrix (and not a slice reference) or respond to call");
+    } else if (NM_DIM(op) != 2 || NM_SHAPE0(op) != n || NM_SHAPE1(op) != n) {
+      rb_raise(nm_eShapeError, "operator must be an n-by-n matrix");
+    } else if (NM_DTYPE(op) != NM_DTYPE(x)) {
+      rb_raise(nm_eDataTypeError, "operator and x must have the same dtype");
+    }
+  } else if (!rb_respond_to(op, rb_intern("call"))) {
+    rb_raise(rb_eArgError, "operator must be a yale matrix or respond to call");
+  }
+
+  if (NM_DTYPE(w) != rtype) {
+    rb_raise(nm_eDataTypeError, "w must have the real dtype that goes with x's dtype");
+  } else if (k < 1 || (size_t)m <= k || (size_t)m > n) {
+    rb_raise(rb_eArgError, "need 0 < k < ncv <= n, but k=%lu, ncv=%d and n=%lu", k, m, n);
+  } else if (z != Qnil && (NM_DTYPE(z) != NM_DTYPE(x) || NM_DIM(z) != 2 || NM_SHAPE0(z) != n || NM_SHAPE1(z) != k)) {
+    rb_raise(nm_eShapeError, "z must be an n-by-k matrix of x's dtype");
+  }
+
+  int state;
+  int info = ttable[NM_DTYPE(x)](op, x, k, rb_to_id(which) == rb_intern("largest"), m, FIX2INT(maxiter), NUM2DBL(tol),
+                                 NM_STORAGE_DENSE(w)->elements, z == Qnil ? NULL : NM_STORAGE_DENSE(z)->elements, state);
+
+  if (state > 0) {
+    rb_jump_tag(state);
+  } else if (state < 0) {
+    rb_raise(rb_eTypeError, "operator must return a dense n-by-1 NMatrix of x's dtype");
+  } else if (info) {
+    rb_raise(rb_eRuntimeError, "Lanczos iteration did not converge");
+  }
+
+  return w;
+}
+
+/*
+ * The preconditioner kind (as for nm::math::YalePreconditioner) named by the symbol kind, which may be nil for none.
+ */
+static int preconditioner_kind(VALUE kind) {
+  if (kind == Qnil) return 0;
+
+  ID id = rb_to_id(kind);
+  if (id == rb_intern("jacobi"))   return 1;
+  else if (id == rb_intern("ilu")) return 2;
+  else if (id == rb_intern("ic"))  return 3;
+
+  rb_raise(rb_eArgError, "preconditioner must be :jacobi, :ilu or :ic");
+  return 0;
+}
+
+/*
+ * Checks that the preconditioner factor f, of the given kind, fits an n-by-n system of dtype dtype, and returns its
+ * data: the elements of a dense n-by-1 matrix for Jacobi, or the storage of a non-reference Yale matrix otherwise.
+ */
+static const void* preconditioner_data(int kind, VALUE f, size_t n, nm::dtype_t dtype) {
+  if (!kind) return NULL;
+
+  if (NM_DTYPE(f) != dtype) {
+    rb_raise(nm_eDataTypeError, "preconditioner must have the matrix's dtype");
+  } else if (NM_SRC(f) != NM_STORAGE(f)) {
+    rb_raise(rb_eArgError, "preconditioner must not be a slice reference");
+  }
+
+  if (kind == 1) {
+    if (NM_STYPE(f) != nm::DENSE_STORE || NM_DENSE_COUNT(f) != n) {
+      rb_raise(nm_eShapeError, "Jacobi preconditioner must be a dense matrix with n entries");
+    }
+    return NM_STORAGE_DENSE(f)->elements;
+  }
+
+  if (NM_STYPE(f) != nm::YALE_STORE || NM_DIM(f) != 2 || NM_SHAPE0(f) != n || NM_SHAPE1(f) != n) {
+    rb_raise(nm_eShapeError, "incomplete factorization must be an n-by-n yale matrix");
+  }
+  return nm_yale_storage_direct(NM_STORAGE(f));
+}
+
+/*
+ * call-seq:
+ *     krylov(method, a, b, x, tol, maxiter, restart, pkind, pfactor) -> [info, residuals]
+ *
+ * Solves a * x = b by :cg, :bicgstab or :gmres (restarted every restart iterations), where a is a square Yale matrix
+ * whose default value is zero, and b and x are dense n-by-1 matrices of a's dtype. x holds the initial guess, and is
+ * overwritten with the solution. The iteration stops once |b - a * x| <= tol * |b| (0 for the square root of the
+ * machine epsilon), or after maxiter iterations.
+ *
+ * pkind is nil, or :jacobi, :ilu or :ic for a preconditioner set up by factor_preconditioner in pfactor.
+ *
+ * info is 0 on convergence, 1 if maxiter was reached, or 2 if the method broke down; residuals is an Array of the
+ * relative residual norms, starting with the initial guess's.
+ */
+static VALUE nm_krylov(VALUE self, VALUE method, VALUE a, VALUE b, VALUE x, VALUE tol, VALUE maxiter, VALUE restart,
+                       VALUE pkind, VALUE pfactor) {
+  static int (*ttable[nm::NUM_DTYPES])(int which, const YALE_STORAGE* a, const void* b, void* x, double tol,
+                                       int maxiter, int restart, int pkind, const void* pf,
+                                       std::vector<double>& history) = {
+      NULL, NULL, NULL, NULL, NULL, // integers not allowed due to division
+      nm::math::krylov_yale<float>,
+      nm::math::krylov_yale<double>,
+      nm::math::krylov_yale<nm::Complex64>,
+      nm::math::krylov_yale<nm::Complex128>,
+      NULL
+  };
+
+  ID id = rb_to_id(method);
+  int which;
+  if (id == rb_intern("cg"))            which = 0;
+  else if (id == rb_intern("bicgstab")) which = 1;
+  else if (id == rb_intern("gmres"))    which = 2;
+  else rb_raise(rb_eArgError, "method must be :cg, :bicgstab or :gmres");
+
+  if (NM_STYPE(a) != nm::YALE_STORE || NM_SRC(a) != NM_STORAGE(a)) {
+    rb_raise(nm_eStorageTypeError, "a must be a yale matrix, and not a slice reference");
+  } else if (NM_STYPE(b) != nm::DENSE_STORE || NM_STYPE(x) != nm::DENSE_STORE) {
+    rb_raise(nm_eStorageTypeError, "b and x must be dense matrices");
+  } else if (NM_SRC(b) != NM_STORAGE(b) || NM_SRC(x) != NM_STORAGE(x)) {
+    rb_raise(rb_eArgError, "b and x must not be slice references");
+  } else if (!ttable[NM_DTYPE(a)]) {
+    rb_raise(nm_eDataTypeError, "this matrix operation undefined for integer and object matrices");
+  } else if (NM_DTYPE(b) != NM_DTYPE(a) || NM_DTYPE(x) != NM_DTYPE(a)) {
+    rb_raise(nm_eDataTypeError, "a, b and x must have the same dtype");
+  }
+
+  const size_t n = NM_SHAPE0(a);
+  if (NM_DIM(a) != 2 || NM_SHAPE1(a) != n || NM_DENSE_COUNT(b) != n || NM_DENSE_COUNT(x) != n) {
+    rb_raise(nm_eShapeError, "a must be n-by-n, and b and x must have n entries");
+  } else if (FIX2INT(restart) < 1) {
+    rb_raise(rb_eArgError, "restart must be positive");
+  } else if (FIX2INT(maxiter) < 0) {
+    rb_raise(rb_eArgError, "maxiter must not be negative");
+  }
+
+  const int   kind = preconditioner_kind(pkind);
+  const void* pf   = preconditioner_data(kind, pfactor, n, NM_DTYPE(a));
+
+  std::vector<double> history;
+  int info = ttable[NM_DTYPE(a)](which, nm_yale_storage_direct(NM_STORAGE(a)), NM_STORAGE_DENSE(b)->elements, NM_STORAGE_DENSE(x)->elements,
+                                 NUM2DBL(tol), FIX2INT(maxiter), FIX2INT(restart), kind, pf, history);
+
+  VALUE residuals = rb_ary_new2(history.size());
+  for (size_t i = 0; i < history.size(); ++i) rb_ary_push(residuals, rb_float_new(history[i]));
+
+  return rb_ary_new3(2, INT2FIX(info), residuals);
+}
+
+/*
+ * call-seq:
+ *     factor_preconditioner(kind, a, f) -> f
+ *
+ * Sets up a preconditioner for the square Yale matrix a, whose default value must be zero. For kind :jacobi, f is a
+ * dense n-by-1 matrix of a's dtype, which gets a's diagonal. For :ilu and :ic, f must be a copy of a (not a slice
+ * reference), which is overwritten with its ILU(0) or IC(0) factorization; IC(0) only reads the lower triangle.
+ *
+ * Raises ZeroDivisionError on a zero pivot, or, for :ic, ArgumentError on a pivot that isn't positive.
+ */
+static VALUE nm_factor_preconditioner(VALUE self, VALUE kind, VALUE a, VALUE f) {
+  static int (*ttable[nm::NUM_DTYPES])(int kind, YALE_STORAGE* s, void* d) = {
+      NULL, NULL, NULL, NULL, NULL, // integers not allowed due to division
+      nm::math::factor_preconditioner<float>,
+      nm::math::factor_preconditioner<double>,
+      nm::math::factor_preconditioner<nm::Complex64>,
+      nm::math::factor_preconditioner<nm::Complex128>,
+      NULL
+  };
+
+  const int k = preconditioner_kind(kind);
+  if (!k) {
+    rb_raise(rb_eArgError, "preconditioner must be :jacobi, :ilu or :ic");
+  } else if (NM_STYPE(a) != nm::YALE_STORE || NM_SRC(a) != NM_STORAGE(a) || NM_DIM(a) != 2 || NM_SHAPE0(a) != NM_SHAPE1(a)) {
+    rb_raise(nm_eStorageTypeError, "a must be a square yale matrix, and not a slice reference");
+  } else if (!ttable[NM_DTYPE(a)]) {
+    rb_raise(nm_eDataTypeError, "this matrix operation undefined for integer and object matrices");
+  }
+
+  const size_t n = NM_SHAPE0(a);
+  preconditioner_data(k, f, n, NM_DTYPE(a));
+
+  int info = ttable[NM_DTYPE(a)](k, nm_yale_storage_direct(NM_STORAGE(k == 1 ? a : f)),
+                                 k == 1 ? NM_STORAGE_DENSE(f)->elements : NULL);
+  if (info && k == 3) {
+    rb_raise(rb_eArgError, "matrix is not positive-definite (pivot of row %d)", info - 1);
+  } else if (info) {
+    rb_raise(rb_eZeroDivError, "zero pivot in row %d", info - 1);
+  }
+
+  return f;
+}
+
+/*
+ * call-seq:
+ *     precondition(kind, f, x) -> x
+ *
+ * Overwrites the dense n-by-1 x with M**-1 * x, where M is the preconditioner of the given kind set up in f by
+ * factor_preconditioner.
+ */
+static VALUE nm_precondition(VALUE self, VALUE kind, VALUE f, VALUE x) {
+  static void (*ttable[nm::NUM_DTYPES])(int kind, const void* f, size_t n, void* x) = {
+      NULL, NULL, NULL, NULL, NULL, // integers not allowed due to division
+      nm::math::precondition<float>,
+      nm::math::precondition<double>,
+      nm::math::precondition<nm::Complex64>,
+      nm::math::precondition<nm::Complex128>,
+      NULL
+  };
+
+  if (NM_STYPE(x) != nm::DENSE_STORE || NM_SRC(x) != NM_STORAGE(x)) {
+    rb_raise(nm_eStorageTypeError, "x must be a dense matrix, and not a slice reference");
+  } else if (!ttable[NM_DTYPE(x)]) {
+    rb_raise(nm_eDataTypeError, "this matrix operation undefined for integer and object matrices");
+  }
+
+  const size_t n = NM_DENSE_COUNT(x);
+  const int    k = preconditioner_kind(kind);
+  ttable[NM_DTYPE(x)](k, preconditioner_data(k, f, n, NM_DTYPE(x)), n, NM_STORAGE_DENSE(x)->elements);
+
+  return x;
+}
+
+/*
+ * The elements of v, which must be a dense, non-reference :int64 NMatrix with at least n entries.
+ */
+static int64_t* int64_elements(VALUE v, size_t n, const char* name) {
+  if (NM_STYPE(v) != nm::DENSE_STORE || NM_SRC(v) != NM_STORAGE(v) || NM_DTYPE(v) != nm::INT64) {
+    rb_raise(nm_eStorageTypeError, "%s must be a dense :int64 matrix, and not a slice reference", name);
+  } else if (NM_DENSE_COUNT(v) < n) {
+    rb_raise(nm_eShapeError, "%s must have at least %lu entries", name, n);
+  }
+  return reinterpret_cast<int64_t*>(NM_STORAGE_DENSE(v)->elements);
+}
+
+/*
+ * The elements of v, which must be a dense, non-reference NMatrix of the given dtype with at least n entries.
+ */
+static void* dtype_elements(VALUE v, size_t n, nm::dtype_t dtype, const char* name) {
+  if (NM_STYPE(v) != nm::DENSE_STORE || NM_SRC(v) != NM_STORAGE(v)) {
+    rb_raise(nm_eStorageTypeError, "%s must be a dense matrix, and not a slice reference", name);
+  } else if (NM_DTYPE(v) != dtype) {
+    rb_raise(nm_eDataTypeError, "%s has the wrong dtype", name);
+  } else if (NM_DENSE_COUNT(v) < n) {
+    rb_raise(nm_eShapeError, "%s must have at least %lu entries", name, n);
+  }
+  return NM_STORAGE_DENSE(v)->elements;
+}
+
+/*
+ * Checks that a is a square, non-reference Yale matrix, and returns its order.
+ */
+static size_t square_yale_order(VALUE a) {
+  if (NM_STYPE(a) != nm::YALE_STORE || NM_SRC(a) != NM_STORAGE(a)) {
+    rb_raise(nm_eStorageTypeError, "a must be a yale matrix, and not a slice reference");
+  } else if (NM_DIM(a) != 2 || NM_SHAPE0(a) != NM_SHAPE1(a)) {
+    rb_raise(nm_eShapeError, "a must be square");
+  }
+  return NM_SHAPE0(a);
+}
+
+/*
+ * call-seq:
+ *     minimum_degree(a, perm) -> perm
+ *
+ * Fills the :int64 perm with a minimum degree ordering of the square Yale matrix a (see
+ * nm::yale_storage::minimum_degree): perm[k] is the row and column to eliminate k-th.
+ */
+static VALUE nm_minimum_degree(VALUE self, VALUE a, VALUE perm) {
+  const size_t n = square_yale_order(a);
+  int64_t*     p = int64_elements(perm, n, "perm");
+
+  std::vector<size_t> order(n);
+  nm::yale_storage::minimum_degree(n, nm_yale_storage_direct(NM_STORAGE(a))->ija, n ? &order[0] : NULL);
+  std::copy(order.begin(), order.end(), p);
+
+  return perm;
+}
+
+/*
+ * call-seq:
+ *     reverse_cuthill_mckee(a, perm) -> perm
+ *
+ * Fills the :int64 perm with a reverse Cuthill-McKee ordering of the square Yale matrix a (see
+ * nm::yale_storage::reverse_cuthill_mckee), which reduces its bandwidth: perm[k] is the row and column to put k-th.
+ */
+static VALUE nm_reverse_cuthill_mckee(VALUE self, VALUE a, VALUE perm) {
+  const size_t n = square_yale_order(a);
+  int64_t*     p = int64_elements(perm, n, "perm");
+
+  std::vector<size_t> order(n);
+  nm::yale_storage::reverse_cuthill_mckee(n, nm_yale_storage_direct(NM_STORAGE(a))->ija, n ? &order[0] : NULL);
+  std::copy(order.begin(), order.end(), p);
+
+  return perm;
+}
+
+/*
+ * call-seq:
+ *     cholesky_symbolic(a, perm, parent, colptr) -> Integer
+ *
+ * Symbolic Cholesky factorization of the square Yale matrix a in the order perm: fills the :int64 parent (n
+ * entries) with the elimination tree and colptr (n+1 entries) with L's column pointers, and returns the number of
+ * entries in L. Only a's sparsity pattern is used.
+ */
+static VALUE nm_cholesky_symbolic(VALUE self, VALUE a, VALUE perm, VALUE parent, VALUE colptr) {
+  const size_t n = square_yale_order(a);
+
+  int64_t nnz = nm::yale_storage::cholesky_symbolic(n, nm_yale_storage_direct(NM_STORAGE(a))->ija,
+                                                    int64_elements(perm, n, "perm"), int64_elements(parent, n, "parent"),
+                                                    int64_elements(colptr, n+1, "colptr"));
+  return LL2NUM(nnz);
+}
+
+/*
+ * call-seq:
+ *     cholesky_numeric(a, perm, parent, colptr, li, lx) -> lx
+ *
+ * Numeric Cholesky factorization of the Hermitian positive definite Yale matrix a, which must have the sparsity
+ * pattern cholesky_symbolic was given: fills li (:int64) and lx (a's dtype) with L's row indices and values.
+ */
+static VALUE nm_cholesky_numeric(VALUE self, VALUE a, VALUE perm, VALUE parent, VALUE colptr, VALUE li, VALUE lx) {
+  static int64_t (*ttable[nm::NUM_DTYPES])(const YALE_STORAGE* s, const int64_t* perm, const int64_t* parent,
+                                           const int64_t* colptr, int64_t* li, void* lx) = {
+      NULL, NULL, NULL, NULL, NULL, // integers not allowed due to division
+      nm::math::sparse_cholesky_numeric<float>,
+      nm::math::sparse_cholesky_numeric<double>,
+      nm::math::sparse_cholesky_numeric<nm::Complex64>,
+      nm::math::sparse_cholesky_numeric<nm::Complex128>,
+      NULL
+  };
+
+  const size_t n = square_yale_order(a);
+  if (!ttable[NM_DTYPE(a)]) {
+    rb_raise(nm_eDataTypeError, "this matrix operation undefined for integer and object matrices");
+  }
+
+  const int64_t* cp  = int64_elements(colptr, n+1, "colptr");
+  const size_t   nnz = cp[n];
+
+  int64_t info = ttable[NM_DTYPE(a)](nm_yale_storage_direct(NM_STORAGE(a)), int64_elements(perm, n, "perm"),
+                                     int64_elements(parent, n, "parent"), cp, int64_elements(li, nnz, "li"),
+                                     dtype_elements(lx, nnz, NM_DTYPE(a), "lx"));
+  if (info < 0) {
+    rb_raise(rb_eArgError, "sparsity pattern differs from the one the symbolic factorization was done for");
+  } else if (info > 0) {
+    rb_raise(rb_eArgError, "matrix is not positive-definite (pivot %ld)", (long)info);
+  }
+
+  return lx;
+}
+
+/*
+ * call-seq:
+ *     cholesky_solve(perm, colptr, li, lx, b) -> b
+ *
+ * Overwrites the dense n-by-m b (of lx's dtype) with A**-1 * b, from the sparse Cholesky factorization of A.
+ */
+static VALUE nm_cholesky_solve(VALUE self, VALUE perm, VALUE colptr, VALUE li, VALUE lx, VALUE b) {
+  static void (*ttable[nm::NUM_DTYPES])(bool lu, int64_t n, const int64_t* const* index, const void* const* values,
+                                        void* b, size_t nrhs) = {
+      NULL, NULL, NULL, NULL, NULL, // integers not allowed due to division
+      nm::math::sparse_factor_solve<float>,
+      nm::math::sparse_factor_solve<double>,
+      nm::math::sparse_factor_solve<nm::Complex64>,
+      nm::math::sparse_factor_solve<nm::Complex128>,
+      NULL
+  };
+
+  if (!ttable[NM_DTYPE(lx)]) {
+    rb_raise(nm_eDataTypeError, "this matrix operation undefined for integer and object matrices");
+  }
+
+  const size_t   n    = NM_DENSE_COUNT(perm);
+  const int64_t* cp   = int64_elements(colptr, n+1, "colptr");
+  const size_t   nnz  = cp[n];
+  const size_t   nrhs = NM_DENSE_COUNT(b) / (n ? n : 1);
+
+  if (NM_SHAPE0(b) != n) rb_raise(nm_eShapeError, "b must have n rows");
+
+  const int64_t* index[]  = { int64_elements(perm, n, "perm"), cp, int64_elements(li, nnz, "li") };
+  const void*    values[] = { dtype_elements(lx, nnz, NM_DTYPE(lx), "lx") };
+  ttable[NM_DTYPE(lx)](false, n, index, values, dtype_elements(b, n * nrhs, NM_DTYPE(lx), "b"), nrhs);
+
+  return b;
+}
+
+/*
+ * call-seq:
+ *     lu_numeric(a, q, tol, lp, li, lx, up, ui, ux, pinv) -> true or false
+ *
+ * Sparse LU factorization of the square Yale matrix a in the column order q, with pivot tolerance tol (see
+ * nm::yale_storage::lu_numeric). L goes into lp (:int64, n+1 entries), li (:int64) and lx (a's dtype), U likewise into
+ * up, ui and ux, and the row pivoting into the :int64 pinv. Returns false if li and lx, or ui and ux, weren't big
+ * enough, in which case they must be made bigger and the call repeated.
+ */
+static VALUE nm_lu_numeric(VALUE self, VALUE a, VALUE q, VALUE tol, VALUE lp, VALUE li, VALUE lx, VALUE up, VALUE ui,
+                           VALUE ux, VALUE pinv) {
+  static int64_t (*ttable[nm::NUM_DTYPES])(const YALE_STORAGE* s, const int64_t* q, double tol, int64_t* lp,
+                                           int64_t* li, void* lx, int64_t lcap, int64_t* up, int64_t* ui, void* ux,
+                                           int64_t ucap, int64_t* pinv) = {
+      NULL, NULL, NULL, NULL, NULL, // integers not allowed due to division
+      nm::math::sparse_lu_numeric<float>,
+      nm::math::sparse_lu_numeric<double>,
+      nm::math::sparse_lu_numeric<nm::Complex64>,
+      nm::math::sparse_lu_numeric<nm::Complex128>,
+      NULL
+  };
+
+  const size_t n = square_yale_order(a);
+  if (!ttable[NM_DTYPE(a)]) {
+    rb_raise(nm_eDataTypeError, "this matrix operation undefined for integer and object matrices");
+  }
+
+  const size_t lcap = std::min(NM_DENSE_COUNT(li), NM_DENSE_COUNT(lx)),
+               ucap = std::min(NM_DENSE_COUNT(ui), NM_DENSE_COUNT(ux));
+
+  int64_t info = ttable[NM_DTYPE(a)](nm_yale_storage_direct(NM_STORAGE(a)), int64_elements(q, n, "q"), NUM2DBL(tol),
+                                     int64_elements(lp, n+1, "lp"), int64_elements(li, 0, "li"),
+                                     dtype_elements(lx, 0, NM_DTYPE(a), "lx"), lcap,
+                                     int64_elements(up, n+1, "up"), int64_elements(ui, 0, "ui"),
+                                     dtype_elements(ux, 0, NM_DTYPE(a), "ux"), ucap, int64_elements(pinv, n, "pinv"));
+  if (info > 0) {
+    rb_raise(rb_eZeroDivError, "matrix is singular");
+  }
+
+  return info == 0 ? Qtrue : Qfalse;
+}
+
+/*
+ * call-seq:
+ *     lu_solve(q, pinv, lp, li, lx, up, ui, ux, b) -> b
+ *
+ * Overwrites the dense n-by-m b (of lx's dtype) with A**-1 * b, from the sparse LU factorization of A.
+ */
+static VALUE nm_lu_solve(VALUE self, VALUE q, VALUE pinv, VALUE lp, VALUE li, VALUE lx, VALUE up, VALUE ui, VALUE ux,
+                         VALUE b) {
+  static void (*ttable[nm::NUM_DTYPES])(bool lu, int64_t n, const int64_t* const* index, const void* const* values,
+                                        void* b, size_t nrhs) = {
+      NULL, NULL, NULL, NULL, NULL, // integers not allowed due to division
+      nm::math::sparse_factor_solve<float>,
+      nm::math::sparse_factor_solve<double>,
+      nm::math::sparse_factor_solve<nm::Complex64>,
+      nm::math::sparse_factor_solve<nm::Complex128>,
+      NULL
+  };
+
+  if (!ttable[NM_DTYPE(lx)]) {
+    rb_raise(nm_eDataTypeError, "this matrix operation undefined for integer and object matrices");
+  }
+
+  const size_t   n    = NM_DENSE_COUNT(q);
+  const int64_t* l    = int64_elements(lp, n+1, "lp");
+  const int64_t* u    = int64_elements(up, n+1, "up");
+  const size_t   nrhs = NM_DENSE_COUNT(b) / (n ? n : 1);
+
+  if (NM_SHAPE0(b) != n) rb_raise(nm_eShapeError, "b must have n rows");
+
+  const int64_t* index[]  = { int64_elements(q, n, "q"), int64_elements(pinv, n, "pinv"), l,
+                              int64_elements(li, l[n], "li"), u, int64_elements(ui, u[n], "ui") };
+  const void*    values[] = { dtype_elements(lx, l[n], NM_DTYPE(lx), "lx"), dtype_elements(ux, u[n], NM_DTYPE(lx), "ux") };
+  ttable[NM_DTYPE(lx)](true, n, index, values, dtype_elements(b, n * nrhs, NM_DTYPE(lx), "b"), nrhs);
+
+  return b;
+}
+
+/*
+ * Whether uplo is :lower (true) or :upper (false).
+ */
+static bool lower_sym(VALUE uplo) {
+  if (rb_to_id(uplo) == nm_rb_lower)      return true;
+  else if (rb_to_id(uplo) == nm_rb_upper) return false;
+  rb_raise(rb_eArgError, "uplo must be :lower or :upper");
+  return true;
+}
+
+/*
+ * call-seq:
+ *     triangular_levels(a, uplo, level_ptr, order) -> Integer
+ *
+ * Dependency levels for solving with the lower or upper triangle (+uplo+) of the square Yale matrix a (see
+ * nm::yale_storage::triangular_levels): fills the :int64 level_ptr (n+1 entries) and order (n entries), and returns
+ * the number of levels.
+ */
+static VALUE nm_triangular_levels(VALUE self, VALUE a, VALUE uplo, VALUE level_ptr, VALUE order) {
+  const size_t n = square_yale_order(a);
+
+  int64_t nlevels = nm::yale_storage::triangular_levels(n, nm_yale_storage_direct(NM_STORAGE(a))->ija, lower_sym(uplo),
+                                                        int64_elements(level_ptr, n+1, "level_ptr"),
+                                                        int64_elements(order, n, "order"));
+  return LL2NUM(nlevels);
+}
+
+/*
+ * call-seq:
+ *     triangular_solve(a, uplo, diag, nlevels, level_ptr, order, b) -> b
+ *
+ * Overwrites the dense n-by-m b (of a's dtype) with T**-1 * b, where T is the lower or upper triangle (+uplo+) of the
+ * square Yale matrix a, with its own diagonal (+diag+ :nonunit) or ones (:unit), using the levels from
+ * triangular_levels. Raises ArgumentError if those are malformed or don't fit a's sparsity pattern, and
+ * ZeroDivisionError on a zero on the diagonal.
+ */
+static VALUE nm_triangular_solve(VALUE self, VALUE a, VALUE uplo, VALUE diag, VALUE nlevels, VALUE level_ptr,
+                                 VALUE order, VALUE b) {
+  static size_t (*ttable[nm::NUM_DTYPES])(const YALE_STORAGE* s, bool lower, bool unit, int64_t nlevels,
+                                          const int64_t* level_ptr, const int64_t* order, void* b, size_t nrhs) = {
+      NULL, NULL, NULL, NULL, NULL, // integers not allowed due to division
+      nm::math::sparse_triangular_solve<float>,
+      nm::math::sparse_triangular_solve<double>,
+      nm::math::sparse_triangular_solve<nm::Complex64>,
+      nm::math::sparse_triangular_solve<nm::Complex128>,
+      NULL
+  };
+
+  const size_t n = square_yale_order(a);
+  if (!ttable[NM_DTYPE(a)]) {
+    rb_raise(nm_eDataTypeError, "this matrix operation undefined for integer and object matrices");
+  }
+  if (NM_SHAPE0(b) != n) rb_raise(nm_eShapeError, "b must have n rows");
+
+  const int64_t l    = NUM2LL(nlevels);
+  const size_t  nrhs = NM_DENSE_COUNT(b) / (n ? n : 1);
+  const bool    low  = lower_sym(uplo);
+
+  if (l < 0 || (size_t)l > n) rb_raise(rb_eArgError, "schedule has %lld levels for %lu rows", (long long)l, (unsigned long)n);
+
+  const YALE_STORAGE* s   = nm_yale_storage_direct(NM_STORAGE(a));
+  const int64_t*      lp  = int64_elements(level_ptr, l+1, "level_ptr"),
+               *      ord = int64_elements(order, n, "order");
+
+  switch (nm::yale_storage::triangular_schedule_check(n, s->ija, low, l, lp, ord)) {
+  case 1:
+    rb_raise(rb_eArgError, "malformed schedule: level_ptr must rise from 0 to n and order must be a permutation of 0...n");
+  case 2:
+    rb_raise(rb_eArgError, "schedule doesn't fit the sparsity pattern of the matrix");
+  }
+
+  size_t info = ttable[NM_DTYPE(a)](s, low, blas_diag_sym(diag) == CblasUnit, l, lp, ord,
+                                    dtype_elements(b, n * nrhs, NM_DTYPE(a), "b"), nrhs);
+  if (info) {
+    rb_raise(rb_eZeroDivError, "zero on the diagonal in row %lu", info - 1);
+  }
+
+  return b;
+}
+
+/*
+ * Checks that a and b are non-reference Yale matrices that can be multiplied, a*b.
+ */
+static void check_yale_product(VALUE a, VALUE b) {
+  if (NM_STYPE(a) != nm::YALE_STORE || NM_SRC(a) != NM_STORAGE(a) ||
+      NM_STYPE(b) != nm::YALE_STORE || NM_SRC(b) != NM_STORAGE(b)) {
+    rb_raise(nm_eStorageTypeError, "a and b must be yale matrices, and not slice references");
+  } else if (NM_DIM(a) != 2 || NM_DIM(b) != 2 || NM_SHAPE1(a) != NM_SHAPE0(b)) {
+    rb_raise(nm_eShapeError, "the number of columns of a must equal the number of rows of b");
+  }
+}
+
+/*
+ * call-seq:
+ *     spgemm_symbolic(a, b, ija) -> Integer
+ *
+ * The pattern of the product of the Yale matrices a and b (see nm::yale_storage::spgemm_symbolic). Returns the length
+ * of its ija array, and if ija (:int64) isn't nil, fills it in.
+ */
+static VALUE nm_spgemm_symbolic(VALUE self, VALUE a, VALUE b, VALUE ija) {
+  static void (*ttable[nm::NUM_DTYPES])(const YALE_STORAGE* s, char* nz) = {
+      nm::math::yale_diagonal_pattern<uint8_t>,
+      nm::math::yale_diagonal_pattern<int8_t>,
+      nm::math::yale_diagonal_pattern<int16_t>,
+      nm::math::yale_diagonal_pattern<int32_t>,
+      nm::math::yale_diagonal_pattern<int64_t>,
+      nm::math::yale_diagonal_pattern<float>,
+      nm::math::yale_diagonal_pattern<double>,
+      nm::math::yale_diagonal_pattern<nm::Complex64>,
+      nm::math::yale_diagonal_pattern<nm::Complex128>,
+      NULL
+  };
+
+  check_yale_product(a, b);
+  if (!ttable[NM_DTYPE(a)] || !ttable[NM_DTYPE(b)]) {
+    rb_raise(nm_eDataTypeError, "this matrix operation undefined for object matrices");
+  }
+
+  const size_t        n  = NM_SHAPE0(a), m = NM_SHAPE1(a), l = NM_SHAPE1(b);
+  const YALE_STORAGE* as = nm_yale_storage_direct(NM_STORAGE(a)),
+                    * bs = nm_yale_storage_direct(NM_STORAGE(b));
+  std::vector<char> adiag(m + 1), bdiag(l + 1);
+  ttable[NM_DTYPE(a)](as, &adiag[0]);
+  ttable[NM_DTYPE(b)](bs, &bdiag[0]);
+
+  int64_t* ic = NULL;
+  if (!NIL_P(ija)) {
+    ic = int64_elements(ija, nm::yale_storage::spgemm_symbolic(n, m, l, as->ija, &adiag[0], bs->ija, &bdiag[0], NULL),
+                        "ija");
+  }
+
+  return SIZET2NUM(nm::yale_storage::spgemm_symbolic(n, m, l, as->ija, &adiag[0], bs->ija, &bdiag[0], ic));
+}
+
+/*
+ * call-seq:
+ *     spgemm_numeric(a, b, ija, c, install) -> c
+ *
+ * Overwrites the values of the Yale matrix c with those of a*b, where ija is the pattern from spgemm_symbolic. If
+ * install is true, c's own pattern is replaced by ija first; otherwise it must already be ija. Raises ArgumentError
+ * if a or b has entries outside the patterns ija was found for.
+ */
+static VALUE nm_spgemm_numeric(VALUE self, VALUE a, VALUE b, VALUE ija, VALUE c, VALUE install) {
+  static bool (*ttable[nm::NUM_DTYPES])(const YALE_STORAGE* a, const YALE_STORAGE* b, const int64_t* ic, void* c) = {
+      nm::math::sparse_spgemm_numeric<uint8_t>,
+      nm::math::sparse_spgemm_numeric<int8_t>,
+      nm::math::sparse_spgemm_numeric<int16_t>,
+      nm::math::sparse_spgemm_numeric<int32_t>,
+      nm::math::sparse_spgemm_numeric<int64_t>,
+      nm::math::sparse_spgemm_numeric<float>,
+      nm::math::sparse_spgemm_numeric<double>,
+      nm::math::sparse_spgemm_numeric<nm::Complex64>,
+      nm::math::sparse_spgemm_numeric<nm::Complex128>,
+      NULL
+  };
+
+  check_yale_product(a, b);
+  const nm::dtype_t dtype = NM_DTYPE(a);
+  if (!ttable[dtype]) {
+    rb_raise(nm_eDataTypeError, "this matrix operation undefined for object matrices");
+  } else if (NM_DTYPE(b) != dtype || NM_DTYPE(c) != dtype) {
+    rb_raise(nm_eDataTypeError, "a, b and c must have the same dtype");
+  } else if (NM_STYPE(c) != nm::YALE_STORE || NM_SRC(c) != NM_STORAGE(c)) {
+    rb_raise(nm_eStorageTypeError, "c must be a yale matrix, and not a slice reference");
+  } else if (NM_DIM(c) != 2 || NM_SHAPE0(c) != NM_SHAPE0(a) || NM_SHAPE1(c) != NM_SHAPE1(b)) {
+    rb_raise(nm_eShapeError, "c must have as many rows as a and as many columns as b");
+  }
+
+  const size_t   n    = NM_SHAPE0(a);
+  const int64_t  size = int64_elements(ija, n+1, "ija")[n];
+  const int64_t* ic   = int64_elements(ija, size, "ija");
+  YALE_STORAGE*  s    = nm_yale_storage_direct(NM_STORAGE(c)); // no lazily-deleted entries left to outlive the pattern
+
+  if (RTEST(install)) {
+    NM_FREE(s->ija);
+    NM_FREE(s->a);
+    s->ija      = NM_ALLOC_N(size_t, size);
+    s->a        = NM_ALLOC_N(char, size * DTYPE_SIZES[dtype]);
+    s->capacity = size;
+    s->ndnz     = size - n - 1;
+    std::copy(ic, ic + size, s->ija);
+  } else if ((int64_t)s->ija[n] != size || !std::equal(ic, ic + size, s->ija)) {
+    rb_raise(rb_eArgError, "c's sparsity pattern isn't the one the product was planned for");
+  }
+
+  if (!ttable[dtype](nm_yale_storage_direct(NM_STORAGE(a)), nm_yale_storage_direct(NM_STORAGE(b)), ic, s->a)) {
+    rb_raise(rb_eArgError, "a or b has entries outside the sparsity pattern the product was planned for");
+  }
+
+  return c;
+}
+
 /*
  * Simple way to check from within Ruby code if clapack functions are available, without
  * having to wait around for an exception to be thrown.
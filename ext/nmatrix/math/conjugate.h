@@ -0,0 +1,90 @@
+/////////////////////////////////////////////////////////////////////
+// = NMatrix
+//
+// A linear algebra library for scientific computation in Ruby.
+// NMatrix is part of SciRuby.
+//
+// NMatrix was originally inspired by and derived from NArray, by
+// Masahiro Tanaka: http://narray.rubyforge.org
+//
+// == Copyright Information
+//
+// SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+// NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+//
+// Please see LICENSE.txt for additional copyright notices.
+//
+// == Contributing
+//
+// By contributing source code to SciRuby, you agree to be bound by
+// our Contributor Agreement:
+//
+// * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+//
+// == conjugate.h
+//
+// Complex conjugate, real and imaginary parts, squared modulus and exact
+// zero test for a value of any dtype, and the real dtype that goes with
+// each dtype, for the kernels that need conjugate transposes (potrf,
+// geqrf, syev, gesvj, lanczos, gemm with ConjTrans).
+//
+
+#ifndef CONJUGATE_H
+#define CONJUGATE_H
+
+#include "data/complex.h"
+
+namespace nm { namespace math {
+
+/*
+ * The real dtype of a dtype: float for Complex64, double for Complex128, and the dtype itself otherwise.
+ */
+template <typename DType> struct RealDType { typedef DType type; };
+template <> struct RealDType<Complex64>  { typedef float type; };
+template <> struct RealDType<Complex128> { typedef double type; };
+
+/*
+ * Complex conjugate, which is a no-op for the other dtypes.
+ */
+template <typename DType>
+inline DType conjugate_value(const DType& x) { return x; }
+template <typename Type>
+inline Complex<Type> conjugate_value(const Complex<Type>& x) { return x.conjugate(); }
+
+/*
+ * Real part, which is the value itself for the other dtypes.
+ */
+template <typename DType>
+inline DType real_value(const DType& x) { return x; }
+template <typename Type>
+inline Type real_value(const Complex<Type>& x) { return x.r; }
+
+/*
+ * Imaginary part, which is zero for the other dtypes.
+ */
+template <typename DType>
+inline DType imag_value(const DType& x) { return 0; }
+template <typename Type>
+inline Type imag_value(const Complex<Type>& x) { return x.i; }
+
+/*
+ * Squared modulus of a value of any dtype, in double precision.
+ */
+template <typename DType>
+inline double abs2(const DType& x) {
+  const double re = real_value(x), im = imag_value(x);
+  return re * re + im * im;
+}
+
+/*
+ * Whether a value is exactly zero. Complex's == only compares to within EPSILON, which is far too coarse for deciding
+ * to skip work on an entry.
+ */
+template <typename DType>
+inline bool exactly_zero(const DType& x) { return x == 0; }
+template <typename Type>
+inline bool exactly_zero(const Complex<Type>& x) { return x.r == 0 && x.i == 0; }
+
+}} // end of namespace nm::math
+
+#endif // CONJUGATE_H
@@ -32,6 +32,7 @@
 
 #include "cblas_enums.h"
 #include "math/long_dtype.h"
+#include "math/conjugate.h"
 
 namespace nm { namespace math {
 /*
@@ -41,6 +42,8 @@ namespace nm { namespace math {
  *
  * Template parameters: LT -- long version of type T. Type T is the matrix dtype.
  *
+ * CblasConjTrans conjugates as well as transposes (a no-op for the real dtypes).
+ *
  * This version throws no errors. Use gemm<DType> instead for error checking.
  */
 template <typename DType>
@@ -84,8 +87,25 @@ inline void gemm_nothrow(const enum CBLAS_TRANSPOSE TransA, const enum CBLAS_TRA
           }
         }
 
-        for (int l = 0; l < K; ++l) {
-          if (B[l+j*ldb] != 0) {
+        DType* c = C + j*ldc;
+        int    l = 0;
+
+        // Take four columns of A at a time, so that each pass over this column of C does four updates.
+        for (; l + 4 <= K; l += 4) {
+          const DType* b = B + l + j*ldb;
+          if (exactly_zero(b[0]) && exactly_zero(b[1]) && exactly_zero(b[2]) && exactly_zero(b[3])) continue;
+
+          typename LongDType<DType>::type t0 = *alpha * b[0], t1 = *alpha * b[1],
+                                          t2 = *alpha * b[2], t3 = *alpha * b[3];
+          const DType *a0 = A + l*lda, *a1 = a0 + lda, *a2 = a1 + lda, *a3 = a2 + lda;
+
+          for (int i = 0; i < M; ++i) {
+            c[i] += a0[i] * t0 + a1[i] * t1 + a2[i] * t2 + a3[i] * t3;
+          }
+        }
+
+        for (; l < K; ++l) {
+          if (!exactly_zero(B[l+j*ldb])) {
             temp = *alpha * B[l+j*ldb];
             for (int i = 0; i < M; ++i) {
               C[i+j*ldc] += A[i+l*lda] * temp;
@@ -100,8 +120,14 @@ inline void gemm_nothrow(const enum CBLAS_TRANSPOSE TransA, const enum CBLAS_TRA
       for (int j = 0; j < N; ++j) {
         for (int i = 0; i < M; ++i) {
           temp = 0;
-          for (int l = 0; l < K; ++l) {
-            temp += A[l+i*lda] * B[l+j*ldb];
+          if (TransA == CblasConjTrans) {
+            for (int l = 0; l < K; ++l) {
+              temp += conjugate_value(A[l+i*lda]) * B[l+j*ldb];
+            }
+          } else {
+            for (int l = 0; l < K; ++l) {
+              temp += A[l+i*lda] * B[l+j*ldb];
+            }
           }
 
           if (*beta == 0) {
@@ -129,8 +155,8 @@ inline void gemm_nothrow(const enum CBLAS_TRANSPOSE TransA, const enum CBLAS_TRA
       }
 
       for (int l = 0; l < K; ++l) {
-        if (B[j+l*ldb] != 0) {
-          temp = *alpha * B[j+l*ldb];
+        if (!exactly_zero(B[j+l*ldb])) {
+          temp = *alpha * (TransB == CblasConjTrans ? conjugate_value(B[j+l*ldb]) : B[j+l*ldb]);
           for (int i = 0; i < M; ++i) {
             C[i+j*ldc] += A[i+l*lda] * temp;
           }
@@ -146,7 +172,8 @@ inline void gemm_nothrow(const enum CBLAS_TRANSPOSE TransA, const enum CBLAS_TRA
       for (int i = 0; i < M; ++i) {
         temp = 0;
         for (int l = 0; l < K; ++l) {
-          temp += A[l+i*lda] * B[j+l*ldb];
+          temp += (TransA == CblasConjTrans ? conjugate_value(A[l+i*lda]) : A[l+i*lda]) *
+                  (TransB == CblasConjTrans ? conjugate_value(B[j+l*ldb]) : B[j+l*ldb]);
         }
 
         if (*beta == 0) {
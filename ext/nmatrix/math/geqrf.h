@@ -0,0 +1,476 @@
+/////////////////////////////////////////////////////////////////////
+// = NMatrix
+//
+// A linear algebra library for scientific computation in Ruby.
+// NMatrix is part of SciRuby.
+//
+// NMatrix was originally inspired by and derived from NArray, by
+// Masahiro Tanaka: http://narray.rubyforge.org
+//
+// == Copyright Information
+//
+// SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+// NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+//
+// Please see LICENSE.txt for additional copyright notices.
+//
+// == Contributing
+//
+// By contributing source code to SciRuby, you agree to be bound by
+// our Contributor Agreement:
+//
+// * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+//
+// == geqrf.h
+//
+// geqrf, ormqr and gels functions in native C++: Householder QR
+// factorization, multiplication by its Q, and least-squares solves
+// built on them. Modeled after LAPACK's zgeqrf.f, zunmqr.f and
+// zgels.f.
+//
+
+#ifndef GEQRF_H
+#define GEQRF_H
+
+#include <cmath>
+#include <vector>
+
+#include "math/conjugate.h"
+#include "math/gemm.h"
+#include "math/nrm2.h"
+#include "math/scal.h"
+#include "math/getrf.h"
+
+namespace nm { namespace math {
+
+/*
+ * Block size used by geqrf and ormqr.
+ */
+const int GEQRF_NB = 32;
+
+/*
+ * Generates an elementary reflector H = I - tau * v * v**H with v = (1; x'), such that H**H * (alpha; x) = (beta; 0)
+ * and beta is real (LAPACK's larfg). alpha and x are overwritten with beta and x'. Returns tau, which is zero (H = I)
+ * when there is nothing to annihilate.
+ */
+template <typename DType>
+inline DType larfg(const int N, DType* alpha, DType* x, const int incx) {
+  typedef typename RealDType<DType>::type RDType;
+
+  if (N <= 0) return 0;
+
+  const double xnorm = nrm2<RDType, DType>(N-1, x, incx),
+               alphr = real_value(*alpha),
+               alphi = imag_value(*alpha);
+
+  if (xnorm == 0 && alphi == 0) return 0;
+
+  const double beta = -std::copysign(std::sqrt(alphr*alphr + alphi*alphi + xnorm*xnorm), alphr);
+  const DType  tau  = (DType(beta) - *alpha) * DType(1 / beta);
+
+  scal<DType>(N-1, numeric_inverse(*alpha - DType(beta)), x, incx);
+  *alpha = beta;
+
+  return tau;
+}
+
+/*
+ * C := H * C, where H = I - tau * v * v**H and C is a column-major M-by-N matrix (LAPACK's larf, left side). Pass
+ * conj(tau) to apply H**H instead.
+ */
+template <typename DType>
+inline void larf_left(const int M, const int N, const DType* v, const DType tau, DType* C, const int ldc) {
+  if (exactly_zero(tau)) return;
+
+  for (int j = 0; j < N; ++j) {
+    DType* c = C + j*ldc;
+    DType  w = 0;
+
+    for (int i = 0; i < M; ++i) w += conjugate_value(v[i]) * c[i];
+    w *= tau;
+    for (int i = 0; i < M; ++i) c[i] -= v[i] * w;
+  }
+}
+
+/*
+ * Unblocked QR factorization of a column-major M-by-N matrix, in place (LAPACK's geqr2). On return, R is on and above
+ * the diagonal, and the Householder vectors of Q = H(0) * H(1) * ... * H(k-1) are below it, with their unit leading
+ * entries implied.
+ */
+template <typename DType>
+inline void geqr2(const int M, const int N, DType* A, const int lda, DType* tau) {
+  const int K = std::min(M, N);
+
+  for (int i = 0; i < K; ++i) {
+    DType* aii = A + i + i*lda;
+
+    tau[i] = larfg<DType>(M-i, aii, aii + 1, 1);
+
+    if (i+1 < N) {
+      DType beta = *aii;
+      *aii       = 1;
+      larf_left<DType>(M-i, N-i-1, aii, conjugate_value(tau[i]), aii + lda, lda);
+      *aii       = beta;
+    }
+  }
+}
+
+/*
+ * Forms the K-by-K upper triangular factor T of the block reflector H = H(0) * ... * H(K-1) = I - V * T * V**H, where
+ * the columns of the column-major M-by-K matrix V are Householder vectors as geqr2 leaves them (LAPACK's larft,
+ * forward and columnwise).
+ */
+template <typename DType>
+inline void larft(const int M, const int K, const DType* V, const int ldv, const DType* tau, DType* T, const int ldt) {
+  for (int i = 0; i < K; ++i) {
+    DType* t = T + i*ldt;
+
+    if (exactly_zero(tau[i])) {
+      for (int j = 0; j <= i; ++j) t[j] = 0;
+      continue;
+    }
+
+    // T(0:i-1,i) := -tau(i) * V(i:M-1,0:i-1)**H * V(i:M-1,i)
+    const DType* vi = V + i*ldv;
+    for (int j = 0; j < i; ++j) {
+      const DType* vj = V + j*ldv;
+      DType        z  = conjugate_value(vj[i]);
+
+      for (int r = i+1; r < M; ++r) z += conjugate_value(vj[r]) * vi[r];
+      t[j] = -tau[i] * z;
+    }
+
+    // T(0:i-1,i) := T(0:i-1,0:i-1) * T(0:i-1,i)
+    for (int j = 0; j < i; ++j) {
+      DType z = 0;
+      for (int l = j; l < i; ++l) z += T[j + l*ldt] * t[l];
+      t[j] = z;
+    }
+
+    t[i] = tau[i];
+  }
+}
+
+/*
+ * C := H * C or H**H * C, where H = I - V * T * V**H is a block reflector from larft and C is a column-major M-by-N
+ * matrix (LAPACK's larfb, left side). V must be stored explicitly (unit diagonal, zeros above it) as an M-by-K matrix
+ * with leading dimension M; work must hold N*K values.
+ */
+template <typename DType>
+inline void larfb_left(const bool conj_trans, const int M, const int N, const int K, const DType* V, const DType* T,
+                       const int ldt, DType* C, const int ldc, DType* work) {
+  const DType one = 1, zero = 0, neg_one = -1;
+
+  // W := C**H * V
+  gemm<DType>(CblasColMajor, CblasConjTrans, CblasNoTrans, N, K, M, &one, C, ldc, V, M, &zero, work, N);
+
+  // W := W * T (for H**H) or W * T**H (for H), in place.
+  if (conj_trans) {
+    for (int j = K-1; j >= 0; --j) {
+      DType* w = work + j*N;
+      for (int i = 0; i < N; ++i) w[i] *= T[j + j*ldt];
+      for (int l = 0; l < j; ++l) {
+        const DType  tlj = T[l + j*ldt];
+        const DType* wl  = work + l*N;
+        for (int i = 0; i < N; ++i) w[i] += wl[i] * tlj;
+      }
+    }
+  } else {
+    for (int j = 0; j < K; ++j) {
+      DType* w = work + j*N;
+      DType  tjj = conjugate_value(T[j + j*ldt]);
+      for (int i = 0; i < N; ++i) w[i] *= tjj;
+      for (int l = j+1; l < K; ++l) {
+        const DType  tjl = conjugate_value(T[j + l*ldt]);
+        const DType* wl  = work + l*N;
+        for (int i = 0; i < N; ++i) w[i] += wl[i] * tjl;
+      }
+    }
+  }
+
+  // C := C - V * W**H
+  gemm<DType>(CblasColMajor, CblasNoTrans, CblasConjTrans, M, N, K, &neg_one, V, M, work, N, &one, C, ldc);
+}
+
+/*
+ * Copies the Householder vectors in columns 0..K-1 of the column-major M-by-K panel A into V (leading dimension M),
+ * filling in the implied unit diagonal and the zeros above it.
+ */
+template <typename DType>
+inline void larf_copy_vectors(const int M, const int K, const DType* A, const int lda, DType* V) {
+  for (int j = 0; j < K; ++j) {
+    const DType* a = A + j*lda;
+    DType*       v = V + j*M;
+
+    for (int i = 0; i < j; ++i) v[i] = 0;
+    v[j] = 1;
+    for (int i = j+1; i < M; ++i) v[i] = a[i];
+  }
+}
+
+/*
+ * Blocked QR factorization of a column-major M-by-N matrix, in place (LAPACK's geqrf); the result is laid out as by
+ * geqr2. Each panel of GEQRF_NB columns is factored by geqr2 and then applied to the trailing columns at once, as a
+ * block reflector, through two gemm calls.
+ */
+template <typename DType>
+inline void geqrf(const int M, const int N, DType* A, const int lda, DType* tau) {
+  const int K = std::min(M, N);
+
+  if (K <= GEQRF_NB) {
+    geqr2<DType>(M, N, A, lda, tau);
+    return;
+  }
+
+  const int nb = GEQRF_NB;
+  std::vector<DType> V(M * nb), T(nb * nb), work(N * nb);
+
+  for (int i = 0; i < K; i += nb) {
+    const int ib = std::min(nb, K - i);
+    DType*    Ai = A + i + i*lda;
+
+    geqr2<DType>(M-i, ib, Ai, lda, tau + i);
+
+    if (i + ib < N) {
+      larft<DType>(M-i, ib, Ai, lda, tau + i, &T[0], nb);
+      larf_copy_vectors<DType>(M-i, ib, Ai, lda, &V[0]);
+      larfb_left<DType>(true, M-i, N-i-ib, ib, &V[0], &T[0], nb, Ai + ib*lda, lda, &work[0]);
+    }
+  }
+}
+
+/*
+ * C := Q * C or Q**H * C, where C is a column-major M-by-N matrix and Q = H(0) * ... * H(K-1) is the M-by-M orthogonal
+ * (unitary) matrix whose K reflectors geqrf left in the column-major M-by-K matrix A (LAPACK's ormqr/unmqr, left
+ * side).
+ */
+template <typename DType>
+inline void ormqr_left(const bool conj_trans, const int M, const int N, const int K, const DType* A, const int lda,
+                       const DType* tau, DType* C, const int ldc) {
+  if (!M || !N || !K) return;
+
+  const int nb = std::min(GEQRF_NB, K);
+  std::vector<DType> V(M * nb), T(nb * nb), work(N * nb);
+
+  // Q**H applies H(0)**H first; Q applies H(K-1) first.
+  const int last  = ((K - 1) / nb) * nb;
+  const int start = conj_trans ? 0    : last,
+            step  = conj_trans ? nb   : -nb;
+
+  for (int i = start; i >= 0 && i < K; i += step) {
+    const int    ib = std::min(nb, K - i);
+    const DType* Ai = A + i + i*lda;
+
+    larft<DType>(M-i, ib, Ai, lda, tau + i, &T[0], nb);
+    larf_copy_vectors<DType>(M-i, ib, Ai, lda, &V[0]);
+    larfb_left<DType>(conj_trans, M-i, N, ib, &V[0], &T[0], nb, C + i, ldc, &work[0]);
+  }
+}
+
+/*
+ * Least-squares solution of an overdetermined (M >= N) system from the QR factorization of A by geqrf, minimizing
+ * ||B - A*X|| for each column of the column-major M-by-NRHS matrix B (as LAPACK's testing routine zgeqrs does). The
+ * first N rows of B are overwritten with X = R \ (Q**H * B), and the rest with the remainder of Q**H * B.
+ *
+ * Returns 0, or i if R(i-1,i-1) is exactly zero, in which case A does not have full rank and B holds Q**H * B.
+ */
+template <typename DType>
+inline int geqrs(const int M, const int N, const int NRHS, const DType* A, const int lda, const DType* tau, DType* B, const int ldb) {
+  ormqr_left<DType>(true, M, NRHS, std::min(M, N), A, lda, tau, B, ldb);
+
+  for (int i = 0; i < N; ++i)
+    if (exactly_zero(A[i + i*lda])) return i+1;
+
+  // Back substitution with R, a column of A at a time.
+  for (int j = 0; j < NRHS; ++j) {
+    DType* b = B + j*ldb;
+
+    for (int k = N-1; k >= 0; --k) {
+      const DType* a = A + k*lda;
+      if (exactly_zero(b[k])) continue;
+
+      b[k] /= a[k];
+      for (int i = 0; i < k; ++i) b[i] -= b[k] * a[i];
+    }
+  }
+
+  return 0;
+}
+
+/*
+ * Least-squares solution of an overdetermined (M >= N) system by QR factorization (LAPACK's gels, no transpose). A is
+ * overwritten with its factorization and B as by geqrs.
+ */
+template <typename DType>
+inline int gels(const int M, const int N, const int NRHS, DType* A, const int lda, DType* B, const int ldb) {
+  std::vector<DType> tau(std::max(std::min(M, N), 1));
+
+  geqrf<DType>(M, N, A, lda, &tau[0]);
+  return geqrs<DType>(M, N, NRHS, A, lda, &tau[0], B, ldb);
+}
+
+/*
+ * Copies an M-by-N matrix between its row-major form (leading dimension ld) and a column-major one with leading
+ * dimension M, in the direction given by to_column_major.
+ */
+template <typename DType>
+inline void qr_copy_layout(const bool to_column_major, const int M, const int N, DType* row_major, const int ld, DType* col_major) {
+  for (int i = 0; i < M; ++i) {
+    DType* r = row_major + i*ld;
+    if (to_column_major) for (int j = 0; j < N; ++j) col_major[i + j*M] = r[j];
+    else                 for (int j = 0; j < N; ++j) r[j] = col_major[i + j*M];
+  }
+}
+
+/*
+ * Function signature conversion for calling LAPACK's geqrf functions as directly as possible.
+ *
+ * For documentation: http://www.netlib.org/lapack/complex16/zgeqrf.f
+ *
+ * As with LAPACKE_?geqrf, a row-major A is factored as the M-by-N matrix it represents, through a column-major copy,
+ * and comes back in the same layout as a column-major result: R on and above the diagonal, reflectors below it. The
+ * factorization runs without the GVL.
+ */
+template <typename DType>
+inline void clapack_geqrf(const enum CBLAS_ORDER order, const int m, const int n, void* a, const int lda, void* tau) {
+  DType* A = reinterpret_cast<DType*>(a);
+  DType* t = reinterpret_cast<DType*>(tau);
+
+  if (order == CblasColMajor) {
+    without_gvl<DType>([&] { geqrf<DType>(m, n, A, lda, t); });
+    return;
+  }
+
+  DType* work = NM_ALLOC_N(DType, std::max(m * n, 1));
+  without_gvl<DType>([&] {
+    qr_copy_layout<DType>(true, m, n, A, lda, work);
+    geqrf<DType>(m, n, work, m, t);
+    qr_copy_layout<DType>(false, m, n, A, lda, work);
+  });
+  NM_FREE(work);
+}
+
+/*
+ * Function signature conversion for calling LAPACK's ormqr (unmqr for the complex dtypes) functions as directly as
+ * possible: C := op(Q) * C or C * op(Q), where op(Q) is Q or Q**H and Q is from clapack_geqrf's k reflectors in a.
+ *
+ * For documentation: http://www.netlib.org/lapack/complex16/zunmqr.f
+ *
+ * C * op(Q) is computed as (op(Q)**H * C**H)**H. Row-major matrices go through column-major copies, and the work is
+ * done without the GVL.
+ */
+template <typename DType>
+inline void clapack_ormqr(const enum CBLAS_ORDER order, const enum CBLAS_SIDE side, const enum CBLAS_TRANSPOSE trans,
+                          const int m, const int n, const int k, void* a, const int lda, void* tau, void* c, const int ldc) {
+  DType* A = reinterpret_cast<DType*>(a);
+  DType* C = reinterpret_cast<DType*>(c);
+  const DType* t = reinterpret_cast<const DType*>(tau);
+
+  const int  nq         = side == CblasLeft ? m : n; // order of Q
+  const bool conj_trans = trans != CblasNoTrans,
+             row_major  = order == CblasRowMajor;
+
+  DType*    Aq   = row_major ? NM_ALLOC_N(DType, std::max(nq * k, 1)) : A;
+  const int ldq  = row_major ? nq : lda;
+  DType*    work = side == CblasLeft && !row_major ? NULL : NM_ALLOC_N(DType, std::max(m * n, 1));
+
+  without_gvl<DType>([&] {
+    if (row_major) qr_copy_layout<DType>(true, nq, k, A, lda, Aq);
+
+    if (side == CblasLeft) {
+      if (!row_major) {
+        ormqr_left<DType>(conj_trans, m, n, k, Aq, ldq, t, C, ldc);
+      } else {
+        qr_copy_layout<DType>(true, m, n, C, ldc, work);
+        ormqr_left<DType>(conj_trans, m, n, k, Aq, ldq, t, work, m);
+        qr_copy_layout<DType>(false, m, n, C, ldc, work);
+      }
+    } else {
+      // work := C**H, which is n-by-m.
+      for (int i = 0; i < m; ++i)
+        for (int j = 0; j < n; ++j)
+          work[j + i*n] = conjugate_value(row_major ? C[i*ldc + j] : C[i + j*ldc]);
+
+      ormqr_left<DType>(!conj_trans, n, m, k, Aq, ldq, t, work, n);
+
+      for (int i = 0; i < m; ++i)
+        for (int j = 0; j < n; ++j)
+          (row_major ? C[i*ldc + j] : C[i + j*ldc]) = conjugate_value(work[j + i*n]);
+    }
+  });
+
+  if (work)      NM_FREE(work);
+  if (row_major) NM_FREE(Aq);
+}
+
+/*
+ * Function signature conversion for calling LAPACK's gels functions as directly as possible. Only the overdetermined
+ * (m >= n), untransposed case is supported; the caller checks that.
+ *
+ * For documentation: http://www.netlib.org/lapack/complex16/zgels.f
+ *
+ * b is max(m,n)-by-nrhs, and its first n rows are overwritten with the solution. Row-major matrices go through
+ * column-major copies, and the work is done without the GVL.
+ */
+template <typename DType>
+inline int clapack_gels(const enum CBLAS_ORDER order, const int m, const int n, const int nrhs, void* a, const int lda,
+                        void* b, const int ldb) {
+  DType* A = reinterpret_cast<DType*>(a);
+  DType* B = reinterpret_cast<DType*>(b);
+
+  int info;
+
+  if (order == CblasColMajor) {
+    without_gvl<DType>([&] { info = gels<DType>(m, n, nrhs, A, lda, B, ldb); });
+    return info;
+  }
+
+  DType* Ac = NM_ALLOC_N(DType, std::max(m * n, 1));
+  DType* Bc = NM_ALLOC_N(DType, std::max(m * nrhs, 1));
+
+  without_gvl<DType>([&] {
+    qr_copy_layout<DType>(true, m, n, A, lda, Ac);
+    qr_copy_layout<DType>(true, m, nrhs, B, ldb, Bc);
+
+    info = gels<DType>(m, n, nrhs, Ac, m, Bc, m);
+
+    qr_copy_layout<DType>(false, m, n, A, lda, Ac);
+    qr_copy_layout<DType>(false, m, nrhs, B, ldb, Bc);
+  });
+
+  NM_FREE(Bc);
+  NM_FREE(Ac);
+
+  return info;
+}
+
+/*
+ * geqrs for a row-major M-by-N QR factorization from clapack_geqrf(:row, ...) and an ordinary row-major M-by-NRHS
+ * matrix b whose columns are the right-hand sides, for NMatrix::Factorization::QR. Runs without the GVL.
+ */
+template <typename DType>
+inline int geqrs_rowmajor(const int M, const int N, const int NRHS, const void* a, const void* tau, void* b) {
+  DType* A  = const_cast<DType*>(reinterpret_cast<const DType*>(a));
+  DType* B  = reinterpret_cast<DType*>(b);
+  DType* Ac = NM_ALLOC_N(DType, std::max(M * N, 1));
+  DType* Bc = NM_ALLOC_N(DType, std::max(M * NRHS, 1));
+  int    info;
+
+  without_gvl<DType>([&] {
+    qr_copy_layout<DType>(true, M, N, A, N, Ac);
+    qr_copy_layout<DType>(true, M, NRHS, B, NRHS, Bc);
+
+    info = geqrs<DType>(M, N, NRHS, Ac, M, reinterpret_cast<const DType*>(tau), Bc, M);
+
+    qr_copy_layout<DType>(false, M, NRHS, B, NRHS, Bc);
+  });
+
+  NM_FREE(Bc);
+  NM_FREE(Ac);
+
+  return info;
+}
+
+} } // end nm::math
+
+#endif // GEQRF_H
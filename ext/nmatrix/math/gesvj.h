@@ -0,0 +1,170 @@
+/////////////////////////////////////////////////////////////////////
+// = NMatrix
+//
+// A linear algebra library for scientific computation in Ruby.
+// NMatrix is part of SciRuby.
+//
+// NMatrix was originally inspired by and derived from NArray, by
+// Masahiro Tanaka: http://narray.rubyforge.org
+//
+// == Copyright Information
+//
+// SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+// NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+//
+// Please see LICENSE.txt for additional copyright notices.
+//
+// == Contributing
+//
+// By contributing source code to SciRuby, you agree to be bound by
+// our Contributor Agreement:
+//
+// * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+//
+// == gesvj.h
+//
+// gesvj function in native C++: singular value decomposition of a
+// tall matrix by one-sided Jacobi rotations, after LAPACK's zgesvj.f
+// (without its preconditioning). It is meant for the small projected
+// matrices of NMatrix#svd_truncated, where its high relative accuracy
+// matters more than its speed.
+//
+
+#ifndef GESVJ_H
+#define GESVJ_H
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <vector>
+
+#include "math/long_dtype.h"
+#include "math/conjugate.h"
+
+namespace nm { namespace math {
+
+/*
+ * Maximum number of sweeps gesvj makes before giving up.
+ */
+const int GESVJ_MAX_SWEEPS = 60;
+
+/*
+ * Singular value decomposition A = U * diag(s) * V**H of the row-major M-by-N matrix a, with M >= N. The columns of
+ * A are rotated, a pair at a time, until they are mutually orthogonal; their norms are then the singular values.
+ *
+ * a is overwritten with U (M-by-N, with orthonormal columns, except that a column belonging to a zero singular value
+ * is zero), s gets the singular values in descending order (in the real dtype that goes with DType), and, if v is
+ * non-NULL, it gets the row-major N-by-N unitary V.
+ *
+ * Returns 0, or nonzero if the rotations did not converge.
+ */
+template <typename DType>
+inline int gesvj(const int M, const int N, void* a, void* s, void* v) {
+  typedef typename RealDType<DType>::type RDType;
+
+  DType*  A   = reinterpret_cast<DType*>(a);
+  RDType* S   = reinterpret_cast<RDType*>(s);
+  DType*  VR  = reinterpret_cast<DType*>(v);
+
+  if (N == 0) return 0;
+
+  // Column-major copies of A and of V, which starts as the identity.
+  std::vector<DType> G(M * N), V(N * N);
+  for (int i = 0; i < M; ++i)
+    for (int j = 0; j < N; ++j) G[i + j*M] = A[i*N + j];
+  std::fill(V.begin(), V.end(), DType(0));
+  for (int j = 0; j < N; ++j) V[j + j*N] = 1;
+
+  const double tol = std::numeric_limits<RDType>::epsilon() * std::sqrt(double(M));
+  int          info = 1;
+
+  for (int sweep = 0; sweep < GESVJ_MAX_SWEEPS; ++sweep) {
+    bool rotated = false;
+
+    for (int p = 0; p < N - 1; ++p) {
+      for (int q = p + 1; q < N; ++q) {
+        DType* gp = &G[p*M];
+        DType* gq = &G[q*M];
+
+        double alpha = 0, beta = 0;
+        typename LongDType<DType>::type gamma = 0;
+        for (int i = 0; i < M; ++i) {
+          alpha += abs2(gp[i]);
+          beta  += abs2(gq[i]);
+          gamma += conjugate_value(gp[i]) * gq[i];
+        }
+
+        const double g = std::hypot(double(real_value(gamma)), double(imag_value(gamma)));
+        if (g == 0 || g <= tol * std::sqrt(alpha) * std::sqrt(beta)) continue;
+        rotated = true;
+
+        // Rotate (gp, gq) so that gp**H * gq = 0. e is the phase of gamma, which reduces the complex case to a real
+        // rotation of gp and conj(e) * gq.
+        const double zeta = (beta - alpha) / (2 * g),
+                     t    = std::copysign(1.0, zeta) / (std::abs(zeta) + std::sqrt(1 + zeta * zeta)),
+                     c    = 1 / std::sqrt(1 + t * t),
+                     sn   = c * t;
+        const DType  e    = DType(gamma) * DType(1 / g),
+                     cc   = DType(c),
+                     ps   = DType(sn) * conjugate_value(e),
+                     qs   = DType(sn) * e;
+
+        for (int i = 0; i < M; ++i) {
+          const DType x = gp[i], y = gq[i];
+          gp[i] = cc * x - ps * y;
+          gq[i] = qs * x + cc * y;
+        }
+
+        DType* vp = &V[p*N];
+        DType* vq = &V[q*N];
+        for (int i = 0; i < N; ++i) {
+          const DType x = vp[i], y = vq[i];
+          vp[i] = cc * x - ps * y;
+          vq[i] = qs * x + cc * y;
+        }
+      }
+    }
+
+    if (!rotated) {
+      info = 0;
+      break;
+    }
+  }
+
+  // The singular values are the column norms; sort them into descending order.
+  std::vector<double> norms(N);
+  std::vector<int>    order(N);
+  for (int j = 0; j < N; ++j) {
+    double sum = 0;
+    for (int i = 0; i < M; ++i) sum += abs2(G[i + j*M]);
+    norms[j] = std::sqrt(sum);
+    order[j] = j;
+  }
+  std::stable_sort(order.begin(), order.end(), [&norms](int x, int y) { return norms[x] > norms[y]; });
+
+  for (int j = 0; j < N; ++j) {
+    const int    k    = order[j];
+    const DType  inv  = norms[k] == 0 ? DType(0) : DType(1 / norms[k]);
+
+    S[j] = norms[k];
+    for (int i = 0; i < M; ++i) A[i*N + j] = G[i + k*M] * inv;
+    if (VR)
+      for (int i = 0; i < N; ++i) VR[i*N + j] = V[i + k*N];
+  }
+
+  return info;
+}
+
+/*
+ * gesvj, without the GVL, for NMatrix::Internal::LAPACK.gesvj_rowmajor.
+ */
+template <typename DType>
+inline int gesvj_rowmajor(const int M, const int N, void* a, void* s, void* v) {
+  int info;
+  without_gvl<DType>([&] { info = gesvj<DType>(M, N, a, s, v); });
+  return info;
+}
+
+} } // end nm::math
+
+#endif // GESVJ_H
@@ -77,107 +77,119 @@ template <> inline float numeric_inverse(const float& n) { return 1 / n; }
 template <> inline double numeric_inverse(const double& n) { return 1 / n; }
 
 /*
- * Templated version of row-order and column-order getrf, derived from ATL_getrfR.c (from ATLAS 3.8.0).
- *
- * 1. Row-major factorization of form
- *   A = L * U * P
- * where P is a column-permutation matrix, L is lower triangular (lower
- * trapazoidal if M > N), and U is upper triangular with unit diagonals (upper
- * trapazoidal if M < N).  This is the recursive Level 3 BLAS version.
- *
- * 2. Column-major factorization of form
- *   A = P * L * U
- * where P is a row-permutation matrix, L is lower triangular with unit diagonal
- * elements (lower trapazoidal if M > N), and U is upper triangular (upper
- * trapazoidal if M < N).  This is the recursive Level 3 BLAS version.
+ * Panel width of the blocked factorization below. Each panel is factored column by column, and everything to its right
+ * is then updated with one TRSM and one GEMM, which is where nearly all of the work ends up.
+ */
+const int GETRF_NB = 64;
+
+/*
+ * Unblocked column-major LU of an M-by-N panel with partial pivoting, as in LAPACK's getf2. Pivots are 0-based and
+ * relative to the panel, and interchanges are applied only within the panel's own columns.
  *
- * Template argument determines whether 1 or 2 is utilized.
+ * Returns 0, or i if U(i-1,i-1) is exactly zero.
  */
-template <bool RowMajor, typename DType>
-inline int getrf_nothrow(const int M, const int N, DType* A, const int lda, int* ipiv) {
+template <typename DType>
+inline int getf2(const int M, const int N, DType* A, const int lda, int* ipiv) {
   const int MN = std::min(M, N);
   int ierr = 0;
 
-  // Symbols used by ATLAS in the several versions of this function:
-  // Row   Col      Us
-  // Nup   Nleft    N_ul
-  // Ndown Nright   N_dr
-  // We're going to use N_ul, N_dr
-
-  DType neg_one = -1, one = 1;
-
-  if (MN > 1) {
-    int N_ul = MN >> 1;
+  for (int k = 0; k < MN; ++k) {
+    DType* col = A + k*lda;
+    int p = ipiv[k] = k + nm::math::imax<DType>(M-k, col + k, 1);
 
-    // FIXME: Figure out how ATLAS #defines NB
-#ifdef NB
-    if (N_ul > NB) N_ul = ATL_MulByNB(ATL_DivByNB(N_ul));
-#endif
-
-    int N_dr;
-    if (RowMajor) {
-      N_dr = M - N_ul;
-    } else {
-      N_dr = N - N_ul;
+    // Always interchange, even for a zero pivot, so that the rest of the matrix (which is swapped by laswp) agrees.
+    if (p != k) {
+      for (int j = 0; j < N; ++j) std::swap(A[k + j*lda], A[p + j*lda]);
     }
 
-    int i = RowMajor ? getrf_nothrow<true,DType>(N_ul, N, A, lda, ipiv) : getrf_nothrow<false,DType>(M, N_ul, A, lda, ipiv);
+    if (col[k] != 0) {
+      DType inv = nm::math::numeric_inverse(col[k]);
+      for (int i = k+1; i < M; ++i) col[i] *= inv;
 
-    if (i) if (!ierr) ierr = i;
+    } else if (!ierr) ierr = k + 1;
 
-    DType *Ar, *Ac, *An;
-    if (RowMajor) {
-      Ar = &(A[N_ul * lda]),
-      Ac = &(A[N_ul]);
-      An = &(Ar[N_ul]);
-
-      nm::math::laswp<DType>(N_dr, Ar, lda, 0, N_ul, ipiv, 1);
+    // Rank-1 update of the rest of the panel.
+    for (int j = k+1; j < N; ++j) {
+      DType* cj = A + j*lda;
+      for (int i = k+1; i < M; ++i) cj[i] -= col[i] * cj[k];
+    }
+  }
 
-      nm::math::trsm<DType>(CblasRowMajor, CblasRight, CblasUpper, CblasNoTrans, CblasUnit, N_dr, N_ul, one, A, lda, Ar, lda);
-      nm::math::gemm<DType>(CblasRowMajor, CblasNoTrans, CblasNoTrans, N_dr, N-N_ul, N_ul, &neg_one, Ar, lda, Ac, lda, &one, An, lda);
+  return ierr;
+}
 
-      i = getrf_nothrow<true,DType>(N_dr, N-N_ul, An, lda, ipiv+N_ul);
-    } else {
-      Ar = NULL;
-      Ac = &(A[N_ul * lda]);
-      An = &(Ac[N_ul]);
+/*
+ * Blocked, right-looking column-major LU (LAPACK's getrf):
+ *   A = P * L * U
+ * where P is a row-permutation matrix, L is lower triangular with unit diagonal elements (lower trapazoidal if M > N),
+ * and U is upper triangular (upper trapazoidal if M < N). Pivots are 0-based.
+ */
+template <typename DType>
+inline int getrf_panels(const int M, const int N, DType* A, const int lda, int* ipiv) {
+  const int MN = std::min(M, N);
+  int ierr = 0;
 
-      nm::math::laswp<DType>(N_dr, Ac, lda, 0, N_ul, ipiv, 1);
+  DType neg_one = -1, one = 1;
 
-      nm::math::trsm<DType>(CblasColMajor, CblasLeft, CblasLower, CblasNoTrans, CblasUnit, N_ul, N_dr, one, A, lda, Ac, lda);
-      nm::math::gemm<DType>(CblasColMajor, CblasNoTrans, CblasNoTrans, M-N_ul, N_dr, N_ul, &neg_one, &(A[N_ul]), lda, Ac, lda, &one, An, lda);
+  for (int j = 0; j < MN; j += GETRF_NB) {
+    const int jb  = std::min(GETRF_NB, MN - j);
+    DType*    Ajj = A + j + j*lda;
 
-      i = getrf_nothrow<false,DType>(M-N_ul, N_dr, An, lda, ipiv+N_ul);
-    }
+    int i = getf2<DType>(M-j, jb, Ajj, lda, ipiv+j);
+    if (i && !ierr) ierr = j + i;
 
-    if (i) if (!ierr) ierr = N_ul + i;
+    for (i = j; i < j+jb; ++i) ipiv[i] += j;
 
-    for (i = N_ul; i != MN; i++) {
-      ipiv[i] += N_ul;
-    }
+    // Apply the panel's interchanges to the columns on either side of it.
+    nm::math::laswp<DType>(j, A, lda, j, j+jb, ipiv, 1);
 
-    nm::math::laswp<DType>(N_ul, A, lda, N_ul, MN, ipiv, 1);  /* apply pivots */
+    if (j+jb < N) {
+      DType* Ar = A + (j+jb)*lda;
 
-  } else if (MN == 1) { // there's another case for the colmajor version, but it doesn't seem to be necessary.
+      nm::math::laswp<DType>(N-j-jb, Ar, lda, j, j+jb, ipiv, 1);
 
-    int i;
-    if (RowMajor) {
-      i = *ipiv = nm::math::imax<DType>(N, A, 1); // cblas_iamax(N, A, 1);
-    } else {
-      i = *ipiv = nm::math::imax<DType>(M, A, 1);
+      // U12 := inv(L11) * A12, then A22 := A22 - L21 * U12.
+      nm::math::trsm<DType>(CblasColMajor, CblasLeft, CblasLower, CblasNoTrans, CblasUnit, jb, N-j-jb, one, Ajj, lda, Ar + j, lda);
+      if (j+jb < M)
+        nm::math::gemm<DType>(CblasColMajor, CblasNoTrans, CblasNoTrans, M-j-jb, N-j-jb, jb, &neg_one, Ajj + jb, lda, Ar + j, lda, &one, Ar + j + jb, lda);
     }
+  }
 
-    DType tmp = A[i];
-    if (tmp != 0) {
-
-      nm::math::scal<DType>((RowMajor ? N : M), nm::math::numeric_inverse(tmp), A, 1);
-      A[i] = *A;
-      *A   = tmp;
+  return ierr;
+}
 
-    } else ierr = 1;
+/*
+ * getrf_panels, without the GVL.
+ */
+template <typename DType>
+inline int getrf_blocked(const int M, const int N, DType* A, const int lda, int* ipiv) {
+  int ierr;
+  without_gvl<DType>([&] { ierr = getrf_panels<DType>(M, N, A, lda, ipiv); });
+  return ierr;
+}
 
-  }
-  return(ierr);
+/*
+ * Row-order and column-order getrf.
+ *
+ * 1. Row-major factorization of form
+ *   A = L * U * P
+ * where P is a column-permutation matrix, L is lower triangular (lower
+ * trapazoidal if M > N), and U is upper triangular with unit diagonals (upper
+ * trapazoidal if M < N).
+ *
+ * 2. Column-major factorization of form
+ *   A = P * L * U
+ * where P is a row-permutation matrix, L is lower triangular with unit diagonal
+ * elements (lower trapazoidal if M > N), and U is upper triangular (upper
+ * trapazoidal if M < N).
+ *
+ * A row-major M-by-N matrix is, in memory, the column-major N-by-M matrix A**T, and factoring that as in 2 gives
+ * exactly the factorization in 1. So both go through the blocked column-major version.
+ */
+template <bool RowMajor, typename DType>
+inline int getrf_nothrow(const int M, const int N, DType* A, const int lda, int* ipiv) {
+  if (RowMajor) return getrf_blocked<DType>(N, M, A, lda, ipiv);
+  else          return getrf_blocked<DType>(M, N, A, lda, ipiv);
 }
 
 
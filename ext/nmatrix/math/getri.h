@@ -0,0 +1,184 @@
+/////////////////////////////////////////////////////////////////////
+// = NMatrix
+//
+// A linear algebra library for scientific computation in Ruby.
+// NMatrix is part of SciRuby.
+//
+// NMatrix was originally inspired by and derived from NArray, by
+// Masahiro Tanaka: http://narray.rubyforge.org
+//
+// == Copyright Information
+//
+// SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+// NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+//
+// Please see LICENSE.txt for additional copyright notices.
+//
+// == Contributing
+//
+// By contributing source code to SciRuby, you agree to be bound by
+// our Contributor Agreement:
+//
+// * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+//
+// == getri.h
+//
+// getri function in native C++, along with the triangular inverse
+// (trtri) it's built on. Modeled after LAPACK's dgetri.f and
+// dtrtri.f.
+//
+
+#ifndef GETRI_H
+#define GETRI_H
+
+#include "math/getrf.h"
+
+namespace nm { namespace math {
+
+/*
+ * Block size used by trtri and getri.
+ */
+const int GETRI_NB = 64;
+
+/*
+ * B := A * B, where A is an M-by-M upper triangular (non-unit) column-major matrix and B is M-by-N. This is the one
+ * case of TRMM that trtri needs.
+ */
+template <typename DType>
+inline void trmm_left_upper(const int M, const int N, const DType* A, const int lda, DType* B, const int ldb) {
+  for (int j = 0; j < N; ++j) {
+    DType* b = B + j*ldb;
+
+    for (int k = 0; k < M; ++k) {
+      const DType* a = A + k*lda;
+      DType temp     = b[k];
+
+      for (int i = 0; i < k; ++i) b[i] += temp * a[i];
+      b[k] = temp * a[k];
+    }
+  }
+}
+
+/*
+ * Unblocked inverse of an upper triangular, non-unit, column-major N-by-N matrix, in place (LAPACK's trti2).
+ */
+template <typename DType>
+inline void trti2(const int N, DType* A, const int lda) {
+  for (int j = 0; j < N; ++j) {
+    DType* col = A + j*lda;
+
+    col[j] = numeric_inverse(col[j]);
+    DType ajj = -col[j];
+
+    // Elements 0..j-1 of column j.
+    trmm_left_upper<DType>(j, 1, A, lda, col, lda);
+    for (int i = 0; i < j; ++i) col[i] *= ajj;
+  }
+}
+
+/*
+ * Blocked inverse of an upper triangular, non-unit, column-major N-by-N matrix, in place (LAPACK's trtri).
+ *
+ * Returns 0, or i if A(i-1,i-1) is exactly zero, in which case A is singular and is left unmodified.
+ */
+template <typename DType>
+inline int trtri(const int N, DType* A, const int lda) {
+  for (int i = 0; i < N; ++i)
+    if (A[i + i*lda] == 0) return i+1;
+
+  const DType neg_one = -1;
+
+  for (int j = 0; j < N; j += GETRI_NB) {
+    const int jb = std::min(GETRI_NB, N - j);
+    DType*   Aj  = A + j*lda;
+
+    // Rows 0..j-1 of this block column: inv(U11) * U12 * -inv(U22).
+    if (j) {
+      trmm_left_upper<DType>(j, jb, A, lda, Aj, lda);
+      nm::math::trsm<DType>(CblasColMajor, CblasRight, CblasUpper, CblasNoTrans, CblasNonUnit, j, jb, neg_one, Aj + j, lda, Aj, lda);
+    }
+
+    trti2<DType>(jb, Aj + j, lda);
+  }
+
+  return 0;
+}
+
+/*
+ * Inverse of a general column-major N-by-N matrix from its LU factorization (as computed by getrf), in place. This
+ * solves inv(A) * L = inv(U) for inv(A), a block column at a time from the right, and then undoes the pivoting. work
+ * has room for N * min(GETRI_NB, N) entries.
+ *
+ * Returns 0, or i if U(i-1,i-1) is exactly zero, in which case A is singular.
+ */
+template <typename DType>
+inline int getri_work(const int N, DType* A, const int lda, const int* ipiv, DType* work) {
+  int ierr = trtri<DType>(N, A, lda);
+  if (ierr) return ierr;
+
+  const DType neg_one = -1, one = 1;
+  const int   nb      = std::min(GETRI_NB, N);
+
+  for (int j = ((N - 1) / nb) * nb; j >= 0; j -= nb) {
+    const int jb = std::min(nb, N - j);
+
+    // Move the strictly lower part of this block column of L into work, leaving zeros behind.
+    for (int jj = j; jj < j+jb; ++jj) {
+      DType* w   = work + (jj-j)*N;
+      DType* col = A + jj*lda;
+      for (int i = jj+1; i < N; ++i) {
+        w[i]   = col[i];
+        col[i] = 0;
+      }
+    }
+
+    // This block column of inv(A).
+    if (j+jb < N)
+      nm::math::gemm<DType>(CblasColMajor, CblasNoTrans, CblasNoTrans, N, jb, N-j-jb, &neg_one, A + (j+jb)*lda, lda, work + j+jb, N, &one, A + j*lda, lda);
+    nm::math::trsm<DType>(CblasColMajor, CblasRight, CblasLower, CblasNoTrans, CblasUnit, N, jb, one, work + j, N, A + j*lda, lda);
+  }
+
+  // Apply the column interchanges.
+  for (int j = N-2; j >= 0; --j) {
+    int jp = ipiv[j];
+    if (jp != j) {
+      for (int i = 0; i < N; ++i) std::swap(A[i + j*lda], A[i + jp*lda]);
+    }
+  }
+
+  return 0;
+}
+
+/*
+ * getri_work, without the GVL.
+ */
+template <typename DType>
+inline int getri(const int N, DType* A, const int lda, const int* ipiv) {
+  if (N == 0) return 0;
+
+  DType* work = NM_ALLOC_N(DType, N * std::min(GETRI_NB, N));
+  int    ierr;
+
+  without_gvl<DType>([&] { ierr = getri_work<DType>(N, A, lda, ipiv, work); });
+
+  NM_FREE(work);
+  return ierr;
+}
+
+/*
+ * Function signature conversion for calling LAPACK's getri functions as directly as possible.
+ *
+ * For documentation: http://www.netlib.org/lapack/double/dgetri.f
+ *
+ * A row-major matrix is, in memory, its column-major transpose, and clapack_getrf's row-major factorization is the
+ * column-major one of that transpose. So both orders come out right from the column-major getri: it gives
+ * inv(A**T) = inv(A)**T, which is inv(A) when read back as row-major.
+ */
+template <typename DType>
+inline int clapack_getri(const enum CBLAS_ORDER order, const int n, void* a, const int lda, const int* ipiv) {
+  return getri<DType>(n, reinterpret_cast<DType*>(a), lda, ipiv);
+}
+
+} } // end nm::math
+
+#endif // GETRI_H
@@ -59,6 +59,8 @@
 #ifndef GETRS_H
 #define GETRS_H
 
+#include "math/getrf.h"
+
 namespace nm { namespace math {
 
 
@@ -102,17 +104,88 @@ int getrs(const enum CBLAS_ORDER Order, const enum CBLAS_TRANSPOSE Trans, const
 }
 
 
+/*
+ * Solves A*X = B using the LU factorization of A given by getrf_nothrow<true> (i.e. clapack_getrf(:row, ...)), where,
+ * unlike ATLAS's row-major getrs, B is an ordinary row-major N-by-NRHS matrix whose columns are the right-hand sides.
+ *
+ * In memory that factorization is the column-major A**T = P * L * U, so A*X = B is U**T * L**T * P**T * X = B. All three
+ * steps work on whole rows of B, so nothing has to be transposed.
+ *
+ * Returns 0, or i if U(i-1,i-1) is exactly zero, in which case B is left unmodified.
+ */
+template <typename DType>
+int getrs_rows(const int N, const int NRHS, const void* a, const int lda, const int* ipiv, void* b, const int ldb) {
+  const DType* A = reinterpret_cast<const DType*>(a);
+  DType*       B = reinterpret_cast<DType*>(b);
+
+  for (int i = 0; i < N; ++i)
+    if (A[i + i*lda] == 0) return i+1;
+
+  // U**T * Y = B
+  for (int i = 0; i < N; ++i) {
+    const DType* ci = A + i*lda;
+    DType*       bi = B + i*ldb;
+
+    for (int k = 0; k < i; ++k) {
+      const DType* bk = B + k*ldb;
+      DType        t  = ci[k];
+      for (int r = 0; r < NRHS; ++r) bi[r] -= t * bk[r];
+    }
+
+    DType inv = numeric_inverse(ci[i]);
+    for (int r = 0; r < NRHS; ++r) bi[r] *= inv;
+  }
+
+  // L**T * Z = Y, where L has a unit diagonal.
+  for (int i = N-1; i >= 0; --i) {
+    const DType* ci = A + i*lda;
+    DType*       bi = B + i*ldb;
+
+    for (int k = i+1; k < N; ++k) {
+      const DType* bk = B + k*ldb;
+      DType        t  = ci[k];
+      for (int r = 0; r < NRHS; ++r) bi[r] -= t * bk[r];
+    }
+  }
+
+  // X = P * Z
+  for (int i = N-1; i >= 0; --i) {
+    if (ipiv[i] != i) {
+      DType *bi = B + i*ldb, *bp = B + ipiv[i]*ldb;
+      for (int r = 0; r < NRHS; ++r) std::swap(bi[r], bp[r]);
+    }
+  }
+
+  return 0;
+}
+
+/*
+ * getrs_rows, without the GVL.
+ */
+template <typename DType>
+int getrs_rowmajor(const int N, const int NRHS, const void* a, const int lda, const int* ipiv, void* b, const int ldb) {
+  int info;
+  without_gvl<DType>([&] { info = getrs_rows<DType>(N, NRHS, a, lda, ipiv, b, ldb); });
+  return info;
+}
+
+
 /*
 * Function signature conversion for calling LAPACK's getrs functions as directly as possible.
 *
 * For documentation: http://www.netlib.org/lapack/double/dgetrs.f
 *
-* This function should normally go in math.cpp, but we need it to be available to nmatrix.cpp.
+* This function should normally go in math.cpp, but we need it to be available to nmatrix.cpp. The solve runs without
+* the GVL.
 */
 template <typename DType>
 inline int clapack_getrs(const enum CBLAS_ORDER order, const enum CBLAS_TRANSPOSE trans, const int n, const int nrhs,
                          const void* a, const int lda, const int* ipiv, void* b, const int ldb) {
-  return getrs<DType>(order, trans, n, nrhs, reinterpret_cast<const DType*>(a), lda, ipiv, reinterpret_cast<DType*>(b), ldb);
+  int info;
+  without_gvl<DType>([&] {
+    info = getrs<DType>(order, trans, n, nrhs, reinterpret_cast<const DType*>(a), lda, ipiv, reinterpret_cast<DType*>(b), ldb);
+  });
+  return info;
 }
 
 
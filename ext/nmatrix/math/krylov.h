@@ -0,0 +1,347 @@
+/////////////////////////////////////////////////////////////////////
+// = NMatrix
+//
+// A linear algebra library for scientific computation in Ruby.
+// NMatrix is part of SciRuby.
+//
+// NMatrix was originally inspired by and derived from NArray, by
+// Masahiro Tanaka: http://narray.rubyforge.org
+//
+// == Copyright Information
+//
+// SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+// NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+//
+// Please see LICENSE.txt for additional copyright notices.
+//
+// == Contributing
+//
+// By contributing source code to SciRuby, you agree to be bound by
+// our Contributor Agreement:
+//
+// * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+//
+// == krylov.h
+//
+// Krylov subspace solvers for A * x = b: conjugate gradients for
+// Hermitian positive definite A, and BiCGSTAB and restarted GMRES for
+// general A. Like lanczos, they only apply A (and the preconditioner)
+// to vectors.
+//
+
+#ifndef KRYLOV_H
+#define KRYLOV_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "math/long_dtype.h"
+#include "math/conjugate.h"
+#include "math/math.h"
+
+namespace nm { namespace math {
+
+/*
+ * x**H * y, accumulated in the long dtype.
+ */
+template <typename DType>
+inline DType krylov_dot(const int N, const DType* x, const DType* y) {
+  typename LongDType<DType>::type sum = 0;
+  for (int i = 0; i < N; ++i) sum += conjugate_value(x[i]) * y[i];
+  return DType(sum);
+}
+
+template <typename DType>
+inline double krylov_norm(const int N, const DType* x) {
+  double sum = 0;
+  for (int i = 0; i < N; ++i) sum += abs2(x[i]);
+  return std::sqrt(sum);
+}
+
+/*
+ * r := b - A * x, returning the norm of r, or -1 if op failed.
+ */
+template <typename DType, typename Op>
+inline double krylov_residual(const int N, Op& op, const DType* b, const DType* x, DType* r) {
+  if (!op(x, r)) return -1;
+  for (int i = 0; i < N; ++i) r[i] = b[i] - r[i];
+  return krylov_norm<DType>(N, r);
+}
+
+/*
+ * The shared interface of cg, bicgstab and gmres, which solve the N-by-N system A * x = b with the operator op
+ * (op(x, y) sets y := A * x) and the preconditioner prec (prec(r, z) sets z := M**-1 * r, for some M that approximates
+ * A), either of which may return false to abandon the iteration.
+ *
+ * x holds the initial guess on entry and the solution on exit. The iteration stops once the residual norm
+ * |b - A * x| is at most tol * |b|; tol <= 0 means the square root of the machine epsilon. maxiter limits the number of
+ * iterations, each of which applies op once (twice for bicgstab). The relative residual norms, starting with the
+ * initial guess's, are appended to history, so history.size() - 1 iterations were done. None of them allocate: work
+ * (of krylov_work_size entries, zeroed) is their scratch space, and history must have room for maxiter+1 more entries.
+ *
+ * Returns 0 on convergence, 1 if maxiter iterations weren't enough, 2 if the method broke down (which for cg means A
+ * or M is not positive definite), or -1 if op or prec returned false.
+ */
+
+/*
+ * Preconditioned conjugate gradients, for Hermitian positive definite A and M.
+ */
+template <typename DType, typename Op, typename Prec>
+inline int cg(const int N, Op& op, Prec& prec, const DType* b, DType* x, double tol, const int maxiter, DType* work,
+              std::vector<double>& history) {
+  typedef typename RealDType<DType>::type RDType;
+  if (tol <= 0) tol = std::sqrt(double(std::numeric_limits<RDType>::epsilon()));
+
+  DType *r = work, *z = r + N, *p = z + N, *q = p + N;
+
+  const double bnorm = krylov_norm<DType>(N, b);
+  if (bnorm == 0) {
+    std::fill(x, x + N, DType(0));
+    history.push_back(0);
+    return 0;
+  }
+
+  double rnorm = krylov_residual<DType>(N, op, b, x, r);
+  if (rnorm < 0) return -1;
+  history.push_back(rnorm / bnorm);
+
+  if (!prec(r, z)) return -1;
+  std::copy(z, z + N, p);
+  DType rz = krylov_dot<DType>(N, r, z);
+
+  for (int iter = 0; ; ++iter) {
+    if (rnorm <= tol * bnorm) return 0;
+    if (iter >= maxiter)      return 1;
+
+    if (!op(p, q)) return -1;
+    const DType pq = krylov_dot<DType>(N, p, q);
+    if (real_value(pq) <= 0 || real_value(rz) <= 0) return 2;
+
+    const DType alpha = rz / pq;
+    for (int i = 0; i < N; ++i) {
+      x[i] += alpha * p[i];
+      r[i] -= alpha * q[i];
+    }
+
+    rnorm = krylov_norm<DType>(N, r);
+    history.push_back(rnorm / bnorm);
+
+    if (!prec(r, z)) return -1;
+    const DType rz_next = krylov_dot<DType>(N, r, z),
+                beta    = rz_next / rz;
+    rz = rz_next;
+
+    for (int i = 0; i < N; ++i) p[i] = z[i] + beta * p[i];
+  }
+}
+
+/*
+ * BiCGSTAB (van der Vorst, 1992), right-preconditioned, for general A.
+ */
+template <typename DType, typename Op, typename Prec>
+inline int bicgstab(const int N, Op& op, Prec& prec, const DType* b, DType* x, double tol, const int maxiter,
+                    DType* work, std::vector<double>& history) {
+  typedef typename RealDType<DType>::type RDType;
+  if (tol <= 0) tol = std::sqrt(double(std::numeric_limits<RDType>::epsilon()));
+
+  DType *r = work, *r0 = r + N, *p = r0 + N, *v = p + N, *s = v + N, *t = s + N, *phat = t + N, *shat = phat + N;
+
+  const double bnorm = krylov_norm<DType>(N, b);
+  if (bnorm == 0) {
+    std::fill(x, x + N, DType(0));
+    history.push_back(0);
+    return 0;
+  }
+
+  double rnorm = krylov_residual<DType>(N, op, b, x, r);
+  if (rnorm < 0) return -1;
+  history.push_back(rnorm / bnorm);
+
+  std::copy(r, r + N, r0);
+  DType rho = 1, alpha = 1, omega = 1;
+
+  for (int iter = 0; ; ++iter) {
+    if (rnorm <= tol * bnorm) return 0;
+    if (iter >= maxiter)      return 1;
+
+    const DType rho_next = krylov_dot<DType>(N, r0, r);
+    if (exactly_zero(rho_next)) return 2;
+
+    const DType beta = (rho_next / rho) * (alpha / omega);
+    rho = rho_next;
+    for (int i = 0; i < N; ++i) p[i] = r[i] + beta * (p[i] - omega * v[i]);
+
+    if (!prec(p, phat) || !op(phat, v)) return -1;
+    const DType r0v = krylov_dot<DType>(N, r0, v);
+    if (exactly_zero(r0v)) return 2;
+    alpha = rho / r0v;
+
+    for (int i = 0; i < N; ++i) s[i] = r[i] - alpha * v[i];
+
+    // Half a step may already be enough.
+    const double snorm = krylov_norm<DType>(N, s);
+    if (snorm <= tol * bnorm) {
+      for (int i = 0; i < N; ++i) x[i] += alpha * phat[i];
+      history.push_back(snorm / bnorm);
+      return 0;
+    }
+
+    if (!prec(s, shat) || !op(shat, t)) return -1;
+    const double tt = krylov_norm<DType>(N, t);
+    if (tt == 0) return 2;
+    omega = krylov_dot<DType>(N, t, s) / DType(tt * tt);
+
+    for (int i = 0; i < N; ++i) {
+      x[i] += alpha * phat[i] + omega * shat[i];
+      r[i]  = s[i] - omega * t[i];
+    }
+
+    rnorm = krylov_norm<DType>(N, r);
+    history.push_back(rnorm / bnorm);
+
+    if (exactly_zero(omega) && rnorm > tol * bnorm) return 2;
+  }
+}
+
+/*
+ * GMRES restarted every restart iterations (Saad and Schultz, 1986), right-preconditioned, for general A. The basis is
+ * orthogonalized by modified Gram-Schmidt and the least squares problem updated with Givens rotations, so each
+ * iteration's residual norm comes for free.
+ */
+template <typename DType, typename Op, typename Prec>
+inline int gmres(const int N, Op& op, Prec& prec, const DType* b, DType* x, double tol, const int maxiter,
+                 const int restart, DType* work, double* cs, std::vector<double>& history) {
+  typedef typename RealDType<DType>::type RDType;
+  if (tol <= 0) tol = std::sqrt(double(std::numeric_limits<RDType>::epsilon()));
+
+  const int M = restart;
+  DType *V = work, *H = V + size_t(N) * (M+1), *sn = H + size_t(M+1) * M, *g = sn + M, *y = g + M+1, *u = y + M,
+        *z = u + N;
+
+  const double bnorm = krylov_norm<DType>(N, b);
+  if (bnorm == 0) {
+    std::fill(x, x + N, DType(0));
+    history.push_back(0);
+    return 0;
+  }
+
+  double rnorm = krylov_residual<DType>(N, op, b, x, V);
+  if (rnorm < 0) return -1;
+  history.push_back(rnorm / bnorm);
+
+  int iter = 0;
+  for (;;) {
+    if (rnorm <= tol * bnorm) return 0;
+    if (iter >= maxiter)      return 1;
+
+    // V(:,0) holds the current residual; start the cycle from it.
+    for (int i = 0; i < N; ++i) V[i] /= DType(rnorm);
+    std::fill(g, g + M+1, DType(0));
+    g[0] = rnorm;
+
+    int j = 0;
+    while (j < M && iter < maxiter) {
+      DType* vj  = &V[size_t(j) * N];
+      DType* w   = vj + N;
+      DType* hj  = &H[size_t(j) * (M+1)]; // column j of H
+
+      if (!prec(vj, z) || !op(z, w)) return -1;
+
+      for (int i = 0; i <= j; ++i) {
+        const DType* vi = &V[size_t(i) * N];
+        hj[i] = krylov_dot<DType>(N, vi, w);
+        for (int l = 0; l < N; ++l) w[l] -= hj[i] * vi[l];
+      }
+      const double h = krylov_norm<DType>(N, w);
+      hj[j+1] = h;
+
+      // Apply the earlier rotations to the new column, then one that zeroes its subdiagonal.
+      for (int i = 0; i < j; ++i) {
+        const DType t = cs[i] * hj[i] + sn[i] * hj[i+1];
+        hj[i+1]       = cs[i] * hj[i+1] - conjugate_value(sn[i]) * hj[i];
+        hj[i]         = t;
+      }
+
+      const double a = std::sqrt(abs2(hj[j])), d = std::sqrt(a * a + h * h);
+      if (d == 0) return 2;
+      if (a == 0) {
+        cs[j] = 0;
+        sn[j] = 1;
+      } else {
+        cs[j] = a / d;
+        sn[j] = hj[j] / DType(a) * DType(h / d);
+      }
+
+      hj[j]   = cs[j] * hj[j] + sn[j] * DType(h);
+      hj[j+1] = 0;
+      g[j+1]  = -conjugate_value(sn[j]) * g[j];
+      g[j]    = cs[j] * g[j];
+
+      ++j;
+      ++iter;
+      rnorm = std::sqrt(abs2(g[j]));
+      history.push_back(rnorm / bnorm);
+
+      if (rnorm <= tol * bnorm || h == 0) break;
+      for (int l = 0; l < N; ++l) w[l] /= DType(h);
+    }
+
+    // Solve the j-by-j upper triangular system H * y = g, and x += M**-1 * V * y.
+    for (int i = j-1; i >= 0; --i) {
+      DType sum = g[i];
+      for (int c = i+1; c < j; ++c) sum -= H[size_t(c) * (M+1) + i] * y[c];
+      y[i] = sum / H[size_t(i) * (M+1) + i];
+    }
+
+    std::fill(u, u + N, DType(0));
+    for (int c = 0; c < j; ++c) {
+      const DType* vc = &V[size_t(c) * N];
+      for (int l = 0; l < N; ++l) u[l] += y[c] * vc[l];
+    }
+    if (!prec(u, z)) return -1;
+    for (int l = 0; l < N; ++l) x[l] += z[l];
+
+    // Restart from the true residual, which also guards against the updated one drifting.
+    rnorm = krylov_residual<DType>(N, op, b, x, V);
+    if (rnorm < 0) return -1;
+    history.back() = rnorm / bnorm;
+  }
+}
+
+/*
+ * The number of DType entries of scratch space cg, bicgstab or gmres (which = 0, 1 or 2) need.
+ */
+inline size_t krylov_work_size(const int which, const size_t N, const size_t restart) {
+  if (which == 0) return 4 * N;
+  if (which == 1) return 8 * N;
+  return N * (restart+1) + (restart+1) * restart + 3 * restart + 1 + 2 * N;
+}
+
+/*
+ * Runs cg, bicgstab or gmres (which = 0, 1 or 2) with the GVL released, so op and prec mustn't touch Ruby. The scratch
+ * space and room in history are allocated first, while the GVL is still held.
+ */
+template <typename DType, typename Op, typename Prec>
+inline int krylov(const int which, const int N, Op& op, Prec& prec, const DType* b, DType* x, double tol,
+                  const int maxiter, const int restart, std::vector<double>& history) {
+  std::vector<DType>  work(krylov_work_size(which, N, restart));
+  std::vector<double> cs(which == 2 ? restart : 0);
+  history.reserve(history.size() + maxiter + 1);
+
+  int info;
+  without_gvl<DType>([&] {
+    switch (which) {
+    case 0:  info = cg<DType>(N, op, prec, b, x, tol, maxiter, &work[0], history);                      break;
+    case 1:  info = bicgstab<DType>(N, op, prec, b, x, tol, maxiter, &work[0], history);                break;
+    default: info = gmres<DType>(N, op, prec, b, x, tol, maxiter, restart, &work[0], &cs[0], history);
+    }
+  });
+
+  return info;
+}
+
+} } // end nm::math
+
+#endif // KRYLOV_H
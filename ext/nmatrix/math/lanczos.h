@@ -0,0 +1,286 @@
+/////////////////////////////////////////////////////////////////////
+// = NMatrix
+//
+// A linear algebra library for scientific computation in Ruby.
+// NMatrix is part of SciRuby.
+//
+// NMatrix was originally inspired by and derived from NArray, by
+// Masahiro Tanaka: http://narray.rubyforge.org
+//
+// == Copyright Information
+//
+// SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+// NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+//
+// Please see LICENSE.txt for additional copyright notices.
+//
+// == Contributing
+//
+// By contributing source code to SciRuby, you agree to be bound by
+// our Contributor Agreement:
+//
+// * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+//
+// == lanczos.h
+//
+// A few extreme eigenpairs of a large symmetric or Hermitian operator
+// by thick-restart Lanczos (Wu and Simon, 2000) with full
+// reorthogonalization and locking of converged Ritz vectors. The
+// operator is only ever applied to vectors, so it may be a sparse
+// matrix or a matrix-free callback.
+//
+
+#ifndef LANCZOS_H
+#define LANCZOS_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "math/conjugate.h"
+#include "math/gemm.h"
+#include "math/syev.h"
+
+namespace nm { namespace math {
+
+/*
+ * Fills x with pseudo-random values in [-1, 1), advancing seed. The Lanczos start and restart vectors only need to be
+ * reproducible and not orthogonal to anything in particular.
+ */
+template <typename DType>
+inline void lanczos_random_fill(const int N, DType* x, unsigned long long& seed) {
+  for (int i = 0; i < N; ++i) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    x[i] = DType(double(seed >> 11) / 4503599627370496.0 - 1.0); // 2**52
+  }
+}
+
+/*
+ * w := w - X * (X**H * w) - V * (V**H * w) twice (classical Gram-Schmidt with one reorthogonalization), where X is a
+ * column-major N-by-L and V a column-major N-by-J matrix, whose columns together are orthonormal. The coefficients
+ * for V of the two passes are summed into h, if it is non-NULL. Returns the norm of the new w.
+ */
+template <typename DType>
+inline double lanczos_orthogonalize(const int N, const int L, const DType* X, const int J, const DType* V, DType* w,
+                                    DType* h, DType* work) {
+  const DType one = 1, minus_one = -1, zero = 0;
+
+  if (h) std::fill(h, h + J, zero);
+
+  for (int pass = 0; pass < 2; ++pass) {
+    if (L) {
+      gemm_nothrow<DType>(CblasConjTrans, CblasNoTrans, L, 1, N, &one, X, N, w, N, &zero, work, L);
+      gemm_nothrow<DType>(CblasNoTrans, CblasNoTrans, N, 1, L, &minus_one, X, N, work, L, &one, w, N);
+    }
+    if (J) {
+      gemm_nothrow<DType>(CblasConjTrans, CblasNoTrans, J, 1, N, &one, V, N, w, N, &zero, work, J);
+      gemm_nothrow<DType>(CblasNoTrans, CblasNoTrans, N, 1, J, &minus_one, V, N, work, J, &one, w, N);
+      if (h) for (int i = 0; i < J; ++i) h[i] += work[i];
+    }
+  }
+
+  double sum = 0;
+  for (int i = 0; i < N; ++i) sum += abs2(w[i]);
+  return std::sqrt(sum);
+}
+
+/*
+ * One run of thick-restart Lanczos for the K largest (or smallest) eigenvalues of the N-by-N Hermitian operator op,
+ * restricted to the orthogonal complement of the L locked vectors in the columns of the column-major N-by-L matrix X,
+ * with a Krylov basis of M vectors (K <= M <= N - L).
+ *
+ * Each cycle extends the basis to M vectors, takes the Ritz pairs of the projected M-by-M matrix (with syev), and,
+ * unless the wanted ones have converged, restarts from the Ritz vectors nearest the wanted end of the spectrum plus the
+ * last basis vector. A Ritz pair has converged when its residual norm, which Lanczos gives for free, is at most
+ * tol * anorm, where anorm is the largest Ritz value magnitude seen so far, in this run or an earlier one.
+ *
+ * V must have room for M+1 vectors, the first holding the start vector (a random one is used if it has nothing
+ * outside X). The Ritz values go to theta in ascending order, and those of the wanted end to the columns of the
+ * column-major N-by-K matrix Y. iter counts the cycles against maxiter across runs, and napply the applications of op.
+ *
+ * Returns 0, 1 if the wanted pairs had not converged after maxiter cycles, or -1 if op returned false.
+ */
+template <typename DType, typename Op>
+inline int lanczos_run(const int N, Op& op, const int L, const DType* X, const int K, const bool largest, const int M,
+                       const int maxiter, const double tol, DType* V, typename RealDType<DType>::type* theta, DType* Y,
+                       double& anorm, int& iter, int& napply, unsigned long long& seed) {
+  typedef typename RealDType<DType>::type RDType;
+
+  const double eps = std::numeric_limits<RDType>::epsilon();
+
+  std::vector<DType> H(M * M), S(M * M), h(M+1), work(std::max(L, M) + 1);
+
+  double beta = lanczos_orthogonalize<DType>(N, L, X, 0, NULL, V, NULL, &work[0]);
+  while (beta == 0) {
+    lanczos_random_fill<DType>(N, V, seed);
+    beta = lanczos_orthogonalize<DType>(N, L, X, 0, NULL, V, NULL, &work[0]);
+  }
+  for (int i = 0; i < N; ++i) V[i] *= DType(1 / beta);
+
+  int j0 = 0;
+
+  for (;;) {
+    // Extend the basis to M vectors, filling in columns j0..M-1 of the projected matrix.
+    for (int j = j0; j < M; ++j) {
+      DType* vj  = V + size_t(j) * N;
+      DType* vj1 = vj + N;
+
+      if (!op(vj, vj1)) return -1;
+      ++napply;
+
+      double av = 0;
+      for (int i = 0; i < N; ++i) av += abs2(vj1[i]);
+      av = std::sqrt(av);
+
+      beta = lanczos_orthogonalize<DType>(N, L, X, j+1, V, vj1, &h[0], &work[0]);
+      for (int i = 0; i <= j; ++i) H[i*M + j] = h[i];
+
+      if (beta <= eps * std::sqrt(double(j+1)) * av) {
+        // The basis spans an invariant subspace; carry on from a new vector orthogonal to it.
+        beta = 0;
+        if (L + j+1 < N) {
+          double r = 0;
+          while (r == 0) {
+            lanczos_random_fill<DType>(N, vj1, seed);
+            r = lanczos_orthogonalize<DType>(N, L, X, j+1, V, vj1, NULL, &work[0]);
+          }
+          for (int i = 0; i < N; ++i) vj1[i] *= DType(1 / r);
+        }
+      } else {
+        for (int i = 0; i < N; ++i) vj1[i] *= DType(1 / beta);
+      }
+    }
+
+    // Ritz pairs, from the upper triangle of the projected matrix.
+    if (syev<DType>(CblasUpper, M, &H[0], M, 0, M-1, theta, &S[0])) return 1;
+
+    for (int i = 0; i < M; ++i) anorm = std::max(anorm, std::abs(double(theta[i])));
+
+    const int first = largest ? M-K : 0;
+    int       nconv = 0;
+    for (int i = first; i < first + K; ++i) {
+      const double bound = beta * std::sqrt(abs2(S[(M-1)*M + i]));
+      if (bound <= tol * anorm) ++nconv;
+    }
+
+    if (nconv == K || ++iter >= maxiter) {
+      // Y := V * S(:, first:first+K-1).
+      std::vector<DType> Sk(M * K);
+      for (int c = 0; c < K; ++c)
+        for (int r = 0; r < M; ++r) Sk[r + c*M] = S[r*M + first + c];
+
+      const DType one = 1, zero = 0;
+      gemm_nothrow<DType>(CblasNoTrans, CblasNoTrans, N, K, M, &one, V, N, &Sk[0], M, &zero, Y, N);
+      return nconv == K ? 0 : 1;
+    }
+
+    // Thick restart: keep the P Ritz vectors nearest the wanted end, followed by the last basis vector. In that basis,
+    // the projected matrix starts out as diag(theta); the next step fills in its coupling to the new vector.
+    const int P    = std::min(M-1, K + std::max(1, (M-K)/2) + std::min(nconv, (M-K)/4)),
+              keep = largest ? M-P : 0;
+
+    std::vector<DType> Sk(M * P), W(size_t(N) * P);
+    for (int c = 0; c < P; ++c)
+      for (int r = 0; r < M; ++r) Sk[r + c*M] = S[r*M + keep + c];
+
+    const DType one = 1, zero = 0;
+    gemm_nothrow<DType>(CblasNoTrans, CblasNoTrans, N, P, M, &one, V, N, &Sk[0], M, &zero, &W[0], N);
+
+    std::copy(W.begin(), W.end(), V);
+    std::copy(V + size_t(M) * N, V + size_t(M+1) * N, V + size_t(P) * N);
+
+    std::fill(H.begin(), H.end(), zero);
+    for (int i = 0; i < P; ++i) H[i*M + i] = theta[keep + i];
+    j0 = P;
+  }
+}
+
+/*
+ * The K largest (or smallest) eigenvalues of the N-by-N Hermitian operator op, and optionally their eigenvectors, with
+ * a Krylov basis of NCV vectors (K < NCV <= N). op(x, y) must set y := A * x and return true, or return false to
+ * abandon the iteration.
+ *
+ * A single Krylov sequence only ever sees one vector of each eigenspace, so a run of lanczos_run alone would skip the
+ * second copy of a repeated eigenvalue. The Ritz vectors it converges to are therefore locked, and further runs look
+ * for the extreme eigenvalue of the operator on their orthogonal complement, starting from a random vector. Anything
+ * they find that beats the K-th best locked value is locked in turn; the pairs are only reported as converged once a
+ * run finds nothing better.
+ *
+ * A Ritz pair has converged when its residual norm is at most tol * |A|, with |A| estimated by the largest Ritz value;
+ * tol <= 0 means the square root of the machine epsilon. (A residual relative to the Ritz value itself can't be
+ * reached for eigenvalues near zero.) The eigenvalues are then accurate to about the square of that.
+ *
+ * v0 is the start vector of the first run (a random one is used if it is zero). The eigenvalues go to w in ascending
+ * order and, if Z is non-NULL, the eigenvectors to the columns of the row-major N-by-K matrix Z. maxiter bounds the
+ * restarts of all runs together, and napply counts the applications of op.
+ *
+ * Returns 0, 1 if the wanted pairs had not converged after maxiter cycles, or -1 if op returned false.
+ */
+template <typename DType, typename Op>
+inline int lanczos(const int N, Op& op, const int K, const bool largest, const int NCV, const int maxiter, double tol,
+                   const DType* v0, typename RealDType<DType>::type* w, DType* Z, int& napply) {
+  typedef typename RealDType<DType>::type RDType;
+
+  if (tol <= 0) tol = std::sqrt(std::numeric_limits<RDType>::epsilon());
+
+  std::vector<DType>  X, V(size_t(N) * (NCV+1)), Y(size_t(N) * K);
+  std::vector<RDType> lambda, theta(NCV);
+  unsigned long long  seed  = 1;
+  double              anorm = 0;
+  int                 iter  = 0, info = 0;
+
+  napply = 0;
+  std::copy(v0, v0 + N, V.begin());
+
+  // Wanted first: ascending for the smallest, descending for the largest.
+  const RDType sign = largest ? -1 : 1;
+
+  for (int run = 0; ; ++run) {
+    const int L  = lambda.size(),
+              M  = std::min(NCV, N - L),
+              Kr = run == 0 ? K : 1;
+    if (M < 1) break;
+    if (run > 0) lanczos_random_fill<DType>(N, &V[0], seed);
+
+    info = lanczos_run<DType>(N, op, L, L ? &X[0] : NULL, Kr, largest, M, maxiter, tol, &V[0], &theta[0], &Y[0],
+                              anorm, iter, napply, seed);
+    if (info < 0) return info;
+
+    // The K-th best locked value; a new pair is only kept if it beats that by more than the convergence tolerance.
+    std::vector<RDType> best(lambda);
+    for (size_t i = 0; i < best.size(); ++i) best[i] *= sign;
+    std::sort(best.begin(), best.end());
+    const double bar = L < K ? std::numeric_limits<double>::infinity() : double(best[K-1]) - tol * anorm;
+
+    int nlocked = 0;
+    for (int c = 0; c < Kr; ++c) {
+      const RDType t = theta[largest ? M-Kr+c : c];
+      if (run > 0 && double(sign * t) >= bar) continue;
+
+      lambda.push_back(t);
+      X.insert(X.end(), Y.begin() + size_t(c) * N, Y.begin() + size_t(c+1) * N);
+      ++nlocked;
+    }
+
+    if (info || nlocked == 0) break;
+  }
+
+  // The K best locked pairs, reported in ascending order of eigenvalue.
+  std::vector<int> idx(lambda.size());
+  for (size_t i = 0; i < idx.size(); ++i) idx[i] = i;
+  std::sort(idx.begin(), idx.end(), [&](int a, int b) { return sign * lambda[a] < sign * lambda[b]; });
+  idx.resize(K);
+  if (largest) std::reverse(idx.begin(), idx.end());
+
+  for (int c = 0; c < K; ++c) {
+    w[c] = lambda[idx[c]];
+    if (Z) for (int i = 0; i < N; ++i) Z[size_t(i)*K + c] = X[size_t(idx[c])*N + i];
+  }
+
+  return info ? 1 : 0;
+}
+
+} } // end nm::math
+
+#endif // LANCZOS_H
@@ -71,7 +71,11 @@
 #include "cblas_enums.h"
 
 #include <algorithm> // std::min, std::max
+#include <exception> // std::exception_ptr
 #include <limits> // std::numeric_limits
+#include <type_traits> // std::is_same
+
+#include <ruby/thread.h> // rb_thread_call_without_gvl
 
 /*
  * Project Includes
@@ -118,6 +122,56 @@ namespace nm {
  * Functions
  */
 
+template <typename F>
+struct KernelCall {
+  F*                 f;
+  std::exception_ptr error;
+};
+
+/*
+ * Runs the kernel without the GVL. Nothing may unwind through rb_thread_call_without_gvl, so anything f throws (say
+ * std::bad_alloc) is kept for without_gvl to rethrow once the GVL is held again.
+ */
+template <typename F>
+static void* call_kernel(void* data) {
+  KernelCall<F>* call = reinterpret_cast<KernelCall<F>*>(data);
+  try {
+    (*call->f)();
+  } catch (...) {
+    call->error = std::current_exception();
+  }
+  return NULL;
+}
+
+/*
+ * Calls the kernel f() with the GVL released, so other Ruby threads can run while it does. f mustn't touch Ruby (no
+ * objects, no allocation with NM_ALLOC, no rb_raise); arithmetic on nm::RubyObject does, so for that dtype f() is
+ * called with the GVL held.
+ *
+ * The dense and BSR kernels -- the factorizations, solves and eigen/singular value routines and the BSR product --
+ * go through this once their Ruby-side buffers are allocated and checked, at the entry point the Ruby bindings call,
+ * never from inside another kernel (the GVL can only be released once). Dense elements are never reallocated, so they
+ * are read and written in place; another thread writing the same matrices meanwhile gets no memory errors, but leaves
+ * the result undefined. Yale IJA and A arrays are different: another thread's []=, or the compaction which flushes
+ * lazy deletions, may reallocate them at any time. So the iterative methods and the sparse numeric factorizations
+ * release the GVL only over a private copy of their Yale operands, while the other kernels over Yale storage (the
+ * ILU(0)/IC(0) setup, sparse triangular solve and product) keep it, as do the symbolic sparse passes and the cblas_*
+ * and clapack_laswp wrappers.
+ *
+ * No unblocking function is given, so a kernel can't be interrupted: Thread#raise, Thread#kill and ^C take effect
+ * once it returns. Releasing the GVL only lets other Ruby threads run; each kernel is still single-threaded.
+ */
+template <typename DType, typename F>
+inline void without_gvl(F f) {
+  if (std::is_same<DType, nm::RubyObject>::value) {
+    f();
+  } else {
+    KernelCall<F> call = { &f, std::exception_ptr() };
+    rb_thread_call_without_gvl(call_kernel<F>, reinterpret_cast<void*>(&call), NULL, NULL);
+    if (call.error) std::rethrow_exception(call.error);
+  }
+}
+
 // Yale: numeric matrix multiply c=a*b
 template <typename DType>
 inline void numbmm(const unsigned int n, const unsigned int m, const unsigned int l, const IType* ia, const IType* ja, const DType* a, const bool diaga,
@@ -85,6 +85,8 @@ ReturnDType nrm2(const int N, const DType* X, const int incX) {
 
   for (int i = 0; i < N; ++i) {
     absxi = std::abs(X[i*incX]);
+    if (absxi == 0) continue; // as in dnrm2.f; a leading zero would otherwise give 0/0
+
     if (scale < absxi) {
       temp  = scale / absxi;
       scale = absxi;
@@ -99,21 +101,15 @@ ReturnDType nrm2(const int N, const DType* X, const int incX) {
 }
 
 
-template <typename FloatDType>
-static inline void nrm2_complex_helper(const FloatDType& xr, const FloatDType& xi, double& scale, double& ssq) {
-  double absx = std::abs(xr);
-  if (scale < absx) {
-    double temp  = scale / absx;
-    scale = absx;
-    ssq   = 1.0 + ssq * (temp * temp);
-  } else {
-    double temp = absx / scale;
-    ssq += temp * temp;
-  }
+/*
+ * Adds one real value to a running (scale, ssq) sum of squares, skipping zeros as dnrm2.f does (a leading zero would
+ * otherwise give 0/0).
+ */
+static inline void nrm2_scaled_add(const double absx, double& scale, double& ssq) {
+  if (absx == 0) return;
 
-  absx = std::abs(xi);
   if (scale < absx) {
-    double temp  = scale / absx;
+    double temp = scale / absx;
     scale = absx;
     ssq   = 1.0 + ssq * (temp * temp);
   } else {
@@ -122,14 +118,20 @@ static inline void nrm2_complex_helper(const FloatDType& xr, const FloatDType& x
   }
 }
 
+template <typename FloatDType>
+static inline void nrm2_complex_helper(const FloatDType& xr, const FloatDType& xi, double& scale, double& ssq) {
+  nrm2_scaled_add(std::abs(xr), scale, ssq);
+  nrm2_scaled_add(std::abs(xi), scale, ssq);
+}
+
 template <>
 float nrm2(const int N, const Complex64* X, const int incX) {
-  double scale = 0, ssq = 1, temp;
+  double scale = 0, ssq = 1;
 
   if ((N < 1) || (incX < 1))    return 0.0;
 
   for (int i = 0; i < N; ++i) {
-    nrm2_complex_helper<float>(X[i*incX].r, X[i*incX].i, scale, temp);
+    nrm2_complex_helper<float>(X[i*incX].r, X[i*incX].i, scale, ssq);
   }
 
   return scale * std::sqrt( ssq );
@@ -137,12 +139,12 @@ float nrm2(const int N, const Complex64* X, const int incX) {
 
 template <>
 double nrm2(const int N, const Complex128* X, const int incX) {
-  double scale = 0, ssq = 1, temp;
+  double scale = 0, ssq = 1;
 
   if ((N < 1) || (incX < 1))    return 0.0;
 
   for (int i = 0; i < N; ++i) {
-    nrm2_complex_helper<double>(X[i*incX].r, X[i*incX].i, scale, temp);
+    nrm2_complex_helper<double>(X[i*incX].r, X[i*incX].i, scale, ssq);
   }
 
   return scale * std::sqrt( ssq );
@@ -0,0 +1,206 @@
+/////////////////////////////////////////////////////////////////////
+// = NMatrix
+//
+// A linear algebra library for scientific computation in Ruby.
+// NMatrix is part of SciRuby.
+//
+// NMatrix was originally inspired by and derived from NArray, by
+// Masahiro Tanaka: http://narray.rubyforge.org
+//
+// == Copyright Information
+//
+// SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+// NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+//
+// Please see LICENSE.txt for additional copyright notices.
+//
+// == Contributing
+//
+// By contributing source code to SciRuby, you agree to be bound by
+// our Contributor Agreement:
+//
+// * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+//
+// == potrf.h
+//
+// potrf function in native C++: Cholesky factorization of a symmetric
+// (Hermitian) positive-definite matrix. Modeled after LAPACK's
+// dpotrf.f.
+//
+
+#ifndef POTRF_H
+#define POTRF_H
+
+#include <cmath>
+#include <vector>
+
+#include "math/conjugate.h"
+#include "math/getrf.h"
+
+namespace nm { namespace math {
+
+/*
+ * Block size used by the Cholesky factorization.
+ */
+const int POTRF_NB = 64;
+
+/*
+ * Blocked, right-looking Cholesky factorization of a column-major N-by-N Hermitian positive-definite matrix,
+ *   A = L * L**H
+ * reading and writing only the lower triangle. Each block column is factored left-looking, which leaves it solved
+ * against its own diagonal block, and then subtracted from the rest of the lower triangle.
+ *
+ * Returns 0, or i if the leading minor of order i is not positive-definite, in which case the factorization stops.
+ */
+template <typename DType>
+inline int potrf_lower(const int N, DType* A, const int lda) {
+  for (int j0 = 0; j0 < N; j0 += POTRF_NB) {
+    const int jb = std::min(POTRF_NB, N - j0);
+
+    for (int j = j0; j < j0 + jb; ++j) {
+      DType* col = A + j*lda;
+
+      for (int k = j0; k < j; ++k) {
+        const DType* ck = A + k*lda;
+        DType t = conjugate_value(ck[j]);
+        for (int i = j; i < N; ++i) col[i] -= ck[i] * t;
+      }
+
+      double d = real_value(col[j]);
+      if (!(d > 0)) return j + 1;
+      d = std::sqrt(d);
+
+      col[j] = d;
+      DType inv = numeric_inverse(DType(d));
+      for (int i = j+1; i < N; ++i) col[i] *= inv;
+    }
+
+    // Trailing update, A22 := A22 - L21 * L21**H, four columns of the panel at a time.
+    for (int j = j0 + jb; j < N; ++j) {
+      DType* col = A + j*lda;
+      int    k   = j0;
+
+      for (; k + 4 <= j0 + jb; k += 4) {
+        const DType *c0 = A + k*lda, *c1 = c0 + lda, *c2 = c1 + lda, *c3 = c2 + lda;
+        DType t0 = conjugate_value(c0[j]), t1 = conjugate_value(c1[j]),
+              t2 = conjugate_value(c2[j]), t3 = conjugate_value(c3[j]);
+
+        for (int i = j; i < N; ++i) col[i] -= c0[i] * t0 + c1[i] * t1 + c2[i] * t2 + c3[i] * t3;
+      }
+
+      for (; k < j0 + jb; ++k) {
+        const DType* ck = A + k*lda;
+        DType t = conjugate_value(ck[j]);
+        for (int i = j; i < N; ++i) col[i] -= ck[i] * t;
+      }
+    }
+  }
+
+  return 0;
+}
+
+/*
+ * Blocked Cholesky factorization of a column-major N-by-N Hermitian positive-definite matrix,
+ *   A = U**H * U
+ * reading and writing only the upper triangle. This is the mirror image of potrf_lower: each block row is factored
+ * with dot products down the (contiguous) columns of U, and the trailing update goes through a conjugate-transposed
+ * copy of the block row.
+ *
+ * Returns 0, or i if the leading minor of order i is not positive-definite, in which case the factorization stops.
+ */
+template <typename DType>
+inline int potrf_upper(const int N, DType* A, const int lda) {
+  std::vector<DType> work(N * POTRF_NB);
+
+  for (int i0 = 0; i0 < N; i0 += POTRF_NB) {
+    const int ib = std::min(POTRF_NB, N - i0);
+
+    for (int i = i0; i < i0 + ib; ++i) {
+      const DType* ci = A + i*lda;
+
+      for (int j = i; j < N; ++j) {
+        DType* cj  = A + j*lda;
+        DType  sum = 0;
+        for (int k = i0; k < i; ++k) sum += conjugate_value(ci[k]) * cj[k];
+        cj[i] -= sum;
+      }
+
+      double d = real_value(ci[i]);
+      if (!(d > 0)) return i + 1;
+      d = std::sqrt(d);
+
+      A[i + i*lda] = d;
+      DType inv = numeric_inverse(DType(d));
+      for (int j = i+1; j < N; ++j) A[i + j*lda] *= inv;
+    }
+
+    // Trailing update, A22 := A22 - U12**H * U12. U12**H goes into work first so that, as in potrf_lower, this is
+    // done four contiguous columns at a time.
+    const int i1 = i0 + ib, m = N - i1;
+    if (!m) break;
+
+    for (int i = 0; i < m; ++i) {
+      const DType* ci = A + (i1+i)*lda;
+      for (int k = 0; k < ib; ++k) work[i + k*m] = conjugate_value(ci[i0+k]);
+    }
+
+    for (int j = i1; j < N; ++j) {
+      const DType* u12 = A + j*lda + i0;
+      DType*       c   = A + j*lda + i1;
+      int          k   = 0;
+
+      for (; k + 4 <= ib; k += 4) {
+        const DType *w0 = &work[k*m], *w1 = w0 + m, *w2 = w1 + m, *w3 = w2 + m;
+        DType t0 = u12[k], t1 = u12[k+1], t2 = u12[k+2], t3 = u12[k+3];
+
+        for (int i = 0; i <= j-i1; ++i) c[i] -= w0[i] * t0 + w1[i] * t1 + w2[i] * t2 + w3[i] * t3;
+      }
+
+      for (; k < ib; ++k) {
+        const DType* w = &work[k*m];
+        DType t = u12[k];
+        for (int i = 0; i <= j-i1; ++i) c[i] -= w[i] * t;
+      }
+    }
+  }
+
+  return 0;
+}
+
+/*
+ * Column-major Cholesky factorization of the triangle given by uplo.
+ */
+template <typename DType>
+inline int potrf(const enum CBLAS_UPLO uplo, const int N, DType* A, const int lda) {
+  if (uplo == CblasLower) return potrf_lower<DType>(N, A, lda);
+  else                    return potrf_upper<DType>(N, A, lda);
+}
+
+/*
+ * A row-major Hermitian matrix is, in memory, the column-major matrix A**T = conj(A), with its upper and lower
+ * triangles exchanged. The column-major factorization of conj(A) is the conjugate of A's, and conjugating it again
+ * is exactly the transpose of the row-major storage -- so a row-major factorization is just the column-major one of
+ * the other triangle. potrs and potri rely on the same correspondence.
+ */
+inline enum CBLAS_UPLO column_major_uplo(const enum CBLAS_ORDER order, const enum CBLAS_UPLO uplo) {
+  if (order == CblasColMajor) return uplo;
+  return uplo == CblasUpper ? CblasLower : CblasUpper;
+}
+
+/*
+ * Function signature conversion for calling LAPACK's potrf functions as directly as possible.
+ *
+ * For documentation: http://www.netlib.org/lapack/double/dpotrf.f
+ *
+ * The factorization runs without the GVL.
+ */
+template <typename DType>
+inline int clapack_potrf(const enum CBLAS_ORDER order, const enum CBLAS_UPLO uplo, const int n, void* a, const int lda) {
+  int info;
+  without_gvl<DType>([&] { info = potrf<DType>(column_major_uplo(order, uplo), n, reinterpret_cast<DType*>(a), lda); });
+  return info;
+}
+
+} } // end nm::math
+
+#endif // POTRF_H
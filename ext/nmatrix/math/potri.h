@@ -0,0 +1,143 @@
+/////////////////////////////////////////////////////////////////////
+// = NMatrix
+//
+// A linear algebra library for scientific computation in Ruby.
+// NMatrix is part of SciRuby.
+//
+// NMatrix was originally inspired by and derived from NArray, by
+// Masahiro Tanaka: http://narray.rubyforge.org
+//
+// == Copyright Information
+//
+// SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+// NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+//
+// Please see LICENSE.txt for additional copyright notices.
+//
+// == Contributing
+//
+// By contributing source code to SciRuby, you agree to be bound by
+// our Contributor Agreement:
+//
+// * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+//
+// == potri.h
+//
+// potri function in native C++: inverse of a Hermitian positive-
+// definite matrix from its Cholesky factorization. Modeled after
+// LAPACK's dpotri.f, dtrtri.f and dlauum.f.
+//
+
+#ifndef POTRI_H
+#define POTRI_H
+
+#include "math/potrf.h"
+#include "math/getri.h"
+
+namespace nm { namespace math {
+
+/*
+ * Inverse of a lower triangular, non-unit, column-major N-by-N matrix, in place, from the bottom right corner up.
+ *
+ * Returns 0, or i if L(i-1,i-1) is exactly zero, in which case L is singular and is left unmodified.
+ */
+template <typename DType>
+inline int trtri_lower(const int N, DType* A, const int lda) {
+  for (int i = 0; i < N; ++i)
+    if (A[i + i*lda] == 0) return i+1;
+
+  for (int j = N-1; j >= 0; --j) {
+    DType* col = A + j*lda;
+
+    col[j] = numeric_inverse(col[j]);
+    DType ajj = -col[j];
+
+    // Elements j+1..N-1 of column j: inv(L22) * L21 * -inv(L11).
+    for (int k = N-1; k > j; --k) {
+      const DType* ck   = A + k*lda;
+      DType        temp = col[k];
+      for (int i = k+1; i < N; ++i) col[i] += temp * ck[i];
+      col[k] = temp * ck[k];
+    }
+    for (int i = j+1; i < N; ++i) col[i] *= ajj;
+  }
+
+  return 0;
+}
+
+/*
+ * L**H * L for lower triangular L, in place in the lower triangle (LAPACK's lauum). Row i of the product only needs
+ * rows i and beyond of L, so rows are overwritten from the top down, each with its diagonal element last.
+ */
+template <typename DType>
+inline void lauum_lower(const int N, DType* A, const int lda) {
+  for (int i = 0; i < N; ++i) {
+    const DType* ci = A + i*lda;
+
+    for (int j = 0; j <= i; ++j) {
+      const DType* cj  = A + j*lda;
+      DType        sum = 0;
+      for (int k = i; k < N; ++k) sum += conjugate_value(ci[k]) * cj[k];
+      A[i + j*lda] = sum;
+    }
+  }
+}
+
+/*
+ * U * U**H for upper triangular U, in place in the upper triangle. Column j of the product only needs columns j and
+ * beyond of U, so columns are overwritten from the left.
+ */
+template <typename DType>
+inline void lauum_upper(const int N, DType* A, const int lda) {
+  for (int j = 0; j < N; ++j) {
+    DType* cj = A + j*lda;
+
+    DType t = conjugate_value(cj[j]);
+    for (int i = 0; i <= j; ++i) cj[i] *= t;
+
+    for (int k = j+1; k < N; ++k) {
+      const DType* ck = A + k*lda;
+      t = conjugate_value(ck[j]);
+      for (int i = 0; i <= j; ++i) cj[i] += ck[i] * t;
+    }
+  }
+}
+
+/*
+ * Inverse of a Hermitian positive-definite column-major matrix from its Cholesky factorization, in place in the
+ * triangle given by uplo: inv(A) = inv(L)**H * inv(L), or inv(U) * inv(U)**H.
+ *
+ * Returns 0, or i if the factor's i'th diagonal element is exactly zero.
+ */
+template <typename DType>
+inline int potri(const enum CBLAS_UPLO uplo, const int N, DType* A, const int lda) {
+  int ierr;
+
+  if (uplo == CblasLower) {
+    if ((ierr = trtri_lower<DType>(N, A, lda))) return ierr;
+    lauum_lower<DType>(N, A, lda);
+  } else {
+    if ((ierr = trtri<DType>(N, A, lda))) return ierr;
+    lauum_upper<DType>(N, A, lda);
+  }
+
+  return 0;
+}
+
+/*
+ * Function signature conversion for calling LAPACK's potri functions as directly as possible.
+ *
+ * For documentation: http://www.netlib.org/lapack/double/dpotri.f
+ *
+ * The inversion runs without the GVL.
+ */
+template <typename DType>
+inline int clapack_potri(const enum CBLAS_ORDER order, const enum CBLAS_UPLO uplo, const int n, void* a, const int lda) {
+  int info;
+  without_gvl<DType>([&] { info = potri<DType>(column_major_uplo(order, uplo), n, reinterpret_cast<DType*>(a), lda); });
+  return info;
+}
+
+} } // end nm::math
+
+#endif // POTRI_H
@@ -0,0 +1,219 @@
+/////////////////////////////////////////////////////////////////////
+// = NMatrix
+//
+// A linear algebra library for scientific computation in Ruby.
+// NMatrix is part of SciRuby.
+//
+// NMatrix was originally inspired by and derived from NArray, by
+// Masahiro Tanaka: http://narray.rubyforge.org
+//
+// == Copyright Information
+//
+// SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+// NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+//
+// Please see LICENSE.txt for additional copyright notices.
+//
+// == Contributing
+//
+// By contributing source code to SciRuby, you agree to be bound by
+// our Contributor Agreement:
+//
+// * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+//
+// == potrs.h
+//
+// potrs function in native C++: solves A*X = B for a Hermitian
+// positive-definite A, given its Cholesky factorization from potrf.
+// Modeled after LAPACK's dpotrs.f.
+//
+
+#ifndef POTRS_H
+#define POTRS_H
+
+#include "math/potrf.h"
+
+namespace nm { namespace math {
+
+/*
+ * Solves A*X = B using the column-major Cholesky factor of A in the triangle given by uplo. Each of the NRHS
+ * right-hand sides is a contiguous vector of length N, the r'th starting at B + r*ldb.
+ */
+template <typename DType>
+inline int potrs(const enum CBLAS_UPLO uplo, const int N, const int NRHS, const DType* A, const int lda, DType* B,
+                 const int ldb)
+{
+  for (int r = 0; r < NRHS; ++r) {
+    DType* x = B + r*ldb;
+
+    if (uplo == CblasLower) {
+      // L * y = b, a column at a time.
+      for (int j = 0; j < N; ++j) {
+        const DType* cj = A + j*lda;
+        x[j] *= numeric_inverse(cj[j]);
+        DType t = x[j];
+        for (int i = j+1; i < N; ++i) x[i] -= cj[i] * t;
+      }
+
+      // L**H * x = y, as dot products down the columns of L.
+      for (int i = N-1; i >= 0; --i) {
+        const DType* ci  = A + i*lda;
+        DType        sum = x[i];
+        for (int k = i+1; k < N; ++k) sum -= conjugate_value(ci[k]) * x[k];
+        x[i] = sum * numeric_inverse(ci[i]);
+      }
+
+    } else {
+      // U**H * y = b, as dot products down the columns of U.
+      for (int i = 0; i < N; ++i) {
+        const DType* ci  = A + i*lda;
+        DType        sum = x[i];
+        for (int k = 0; k < i; ++k) sum -= conjugate_value(ci[k]) * x[k];
+        x[i] = sum * numeric_inverse(ci[i]);
+      }
+
+      // U * x = y, a column at a time.
+      for (int j = N-1; j >= 0; --j) {
+        const DType* cj = A + j*lda;
+        x[j] *= numeric_inverse(cj[j]);
+        DType t = x[j];
+        for (int i = 0; i < j; ++i) x[i] -= cj[i] * t;
+      }
+    }
+  }
+
+  return 0;
+}
+
+/*
+ * Function signature conversion for calling LAPACK's potrs functions as directly as possible.
+ *
+ * For documentation: http://www.netlib.org/lapack/double/dpotrs.f
+ *
+ * As in ATLAS, each right-hand side is a row of B for either order. A row-major factor is the column-major factor of
+ * conj(A) (see clapack_potrf), so for that order B is conjugated before and after the solve. The solve runs without
+ * the GVL.
+ */
+template <typename DType>
+inline int clapack_potrs(const enum CBLAS_ORDER order, const enum CBLAS_UPLO uplo, const int n, const int nrhs,
+                         const void* a, const int lda, void* b, const int ldb) {
+  DType* B = reinterpret_cast<DType*>(b);
+  int    info;
+
+  without_gvl<DType>([&] {
+    if (order == CblasRowMajor) {
+      for (int r = 0; r < nrhs; ++r)
+        for (int i = 0; i < n; ++i) B[i + r*ldb] = conjugate_value(B[i + r*ldb]);
+    }
+
+    info = potrs<DType>(column_major_uplo(order, uplo), n, nrhs, reinterpret_cast<const DType*>(a), lda, B, ldb);
+
+    if (order == CblasRowMajor) {
+      for (int r = 0; r < nrhs; ++r)
+        for (int i = 0; i < n; ++i) B[i + r*ldb] = conjugate_value(B[i + r*ldb]);
+    }
+  });
+
+  return info;
+}
+
+/*
+ * Solves A*X = B using the row-major Cholesky factor of A given by clapack_potrf(:row, uplo, ...), where B is an
+ * ordinary row-major N-by-NRHS matrix whose columns are the right-hand sides. Each step updates whole rows of B, so
+ * nothing has to be transposed.
+ *
+ * The factor is the column-major one of conj(A), in the other triangle (see clapack_potrf); like clapack_potrs, this
+ * conjugates B before and after.
+ */
+template <typename DType>
+int potrs_rows(const enum CBLAS_UPLO uplo, const int N, const int NRHS, const void* a, const int lda, void* b,
+               const int ldb)
+{
+  const DType* A = reinterpret_cast<const DType*>(a);
+  DType*       B = reinterpret_cast<DType*>(b);
+
+  for (int i = 0; i < N; ++i)
+    for (int r = 0; r < NRHS; ++r) B[i*ldb + r] = conjugate_value(B[i*ldb + r]);
+
+  if (column_major_uplo(CblasRowMajor, uplo) == CblasLower) {
+    // L * Y = B
+    for (int k = 0; k < N; ++k) {
+      const DType* ck  = A + k*lda;
+      DType*       bk  = B + k*ldb;
+      DType        inv = numeric_inverse(ck[k]);
+      for (int r = 0; r < NRHS; ++r) bk[r] *= inv;
+
+      for (int i = k+1; i < N; ++i) {
+        DType* bi = B + i*ldb;
+        DType  t  = ck[i];
+        for (int r = 0; r < NRHS; ++r) bi[r] -= t * bk[r];
+      }
+    }
+
+    // L**H * X = Y
+    for (int i = N-1; i >= 0; --i) {
+      const DType* ci = A + i*lda;
+      DType*       bi = B + i*ldb;
+
+      for (int k = i+1; k < N; ++k) {
+        const DType* bk = B + k*ldb;
+        DType        t  = conjugate_value(ci[k]);
+        for (int r = 0; r < NRHS; ++r) bi[r] -= t * bk[r];
+      }
+
+      DType inv = numeric_inverse(ci[i]);
+      for (int r = 0; r < NRHS; ++r) bi[r] *= inv;
+    }
+
+  } else {
+    // U**H * Y = B
+    for (int i = 0; i < N; ++i) {
+      const DType* ci = A + i*lda;
+      DType*       bi = B + i*ldb;
+
+      for (int k = 0; k < i; ++k) {
+        const DType* bk = B + k*ldb;
+        DType        t  = conjugate_value(ci[k]);
+        for (int r = 0; r < NRHS; ++r) bi[r] -= t * bk[r];
+      }
+
+      DType inv = numeric_inverse(ci[i]);
+      for (int r = 0; r < NRHS; ++r) bi[r] *= inv;
+    }
+
+    // U * X = Y
+    for (int k = N-1; k >= 0; --k) {
+      const DType* ck  = A + k*lda;
+      DType*       bk  = B + k*ldb;
+      DType        inv = numeric_inverse(ck[k]);
+      for (int r = 0; r < NRHS; ++r) bk[r] *= inv;
+
+      for (int i = 0; i < k; ++i) {
+        DType* bi = B + i*ldb;
+        DType  t  = ck[i];
+        for (int r = 0; r < NRHS; ++r) bi[r] -= t * bk[r];
+      }
+    }
+  }
+
+  for (int i = 0; i < N; ++i)
+    for (int r = 0; r < NRHS; ++r) B[i*ldb + r] = conjugate_value(B[i*ldb + r]);
+
+  return 0;
+}
+
+/*
+ * potrs_rows, without the GVL.
+ */
+template <typename DType>
+int potrs_rowmajor(const enum CBLAS_UPLO uplo, const int N, const int NRHS, const void* a, const int lda, void* b,
+                   const int ldb)
+{
+  int info;
+  without_gvl<DType>([&] { info = potrs_rows<DType>(uplo, N, NRHS, a, lda, b, ldb); });
+  return info;
+}
+
+} } // end nm::math
+
+#endif // POTRS_H
@@ -0,0 +1,725 @@
+/////////////////////////////////////////////////////////////////////
+// = NMatrix
+//
+// A linear algebra library for scientific computation in Ruby.
+// NMatrix is part of SciRuby.
+//
+// NMatrix was originally inspired by and derived from NArray, by
+// Masahiro Tanaka: http://narray.rubyforge.org
+//
+// == Copyright Information
+//
+// SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+// NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+//
+// Please see LICENSE.txt for additional copyright notices.
+//
+// == Contributing
+//
+// By contributing source code to SciRuby, you agree to be bound by
+// our Contributor Agreement:
+//
+// * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+//
+// == syev.h
+//
+// Eigenvalues and eigenvectors of symmetric and Hermitian matrices in
+// native C++: Householder reduction to real symmetric tridiagonal form,
+// then divide-and-conquer for the whole spectrum, or bisection and
+// inverse iteration for a few eigenpairs. Modeled after LAPACK's
+// zhetd2.f, dsteqr.f, dstedc.f (with dlaed1-4), dstebz.f and dstein.f.
+//
+// The tridiagonal eigenproblems are always solved in double precision.
+//
+
+#ifndef SYEV_H
+#define SYEV_H
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+#include "math/conjugate.h"
+#include "math/gemm.h"
+#include "math/geqrf.h"
+
+namespace nm { namespace math {
+
+/*
+ * Tridiagonal problems up to this order are solved by steqr rather than divided further.
+ */
+const int STEDC_SMLSIZ = 25;
+
+/*
+ * Reduces a Hermitian (or real symmetric) column-major N-by-N matrix to real symmetric tridiagonal form T = Q**H * A * Q,
+ * reading and overwriting only the lower triangle (LAPACK's hetd2, lower). The diagonal of T goes to d and the
+ * off-diagonal to e. Q = H(0) * ... * H(N-2) is kept as reflectors below the subdiagonal, laid out so that ormqr_left on
+ * rows 1..N-1 of A applies it.
+ */
+template <typename DType>
+inline void hetrd_lower(const int N, DType* A, const int lda, double* d, double* e, DType* tau) {
+  std::vector<DType> x(std::max(N, 1));
+
+  for (int i = 0; i < N-1; ++i) {
+    const int m   = N-i-1;                     // order of the trailing block
+    DType*    v   = A + (i+1) + i*lda;         // this column, below the diagonal
+    DType*    A22 = A + (i+1) + (i+1)*lda;
+
+    DType alpha = v[0];
+    DType taui  = larfg<DType>(m, &alpha, v + 1, 1);
+    e[i]        = real_value(alpha);
+
+    if (!exactly_zero(taui)) {
+      v[0] = 1;
+
+      // x := taui * A22 * v
+      for (int r = 0; r < m; ++r) x[r] = 0;
+      for (int c = 0; c < m; ++c) {
+        const DType* col = A22 + c*lda;
+        const DType  vc  = v[c];
+        DType        sum = DType(real_value(col[c])) * vc;
+
+        for (int r = c+1; r < m; ++r) {
+          x[r] += col[r] * vc;
+          sum  += conjugate_value(col[r]) * v[r];
+        }
+        x[c] += sum;
+      }
+      for (int r = 0; r < m; ++r) x[r] *= taui;
+
+      // w := x - 1/2 * taui * (x**H * v) * v
+      DType dot = 0;
+      for (int r = 0; r < m; ++r) dot += conjugate_value(x[r]) * v[r];
+      const DType alpha2 = DType(-0.5) * taui * dot;
+      for (int r = 0; r < m; ++r) x[r] += alpha2 * v[r];
+
+      // A22 := A22 - v * w**H - w * v**H
+      for (int c = 0; c < m; ++c) {
+        DType*      col = A22 + c*lda;
+        const DType vc  = conjugate_value(v[c]),
+                    wc  = conjugate_value(x[c]);
+
+        for (int r = c; r < m; ++r) col[r] -= v[r] * wc + x[r] * vc;
+        col[c] = real_value(col[c]);
+      }
+    } else {
+      A22[0] = real_value(A22[0]);
+    }
+
+    v[0]   = e[i];
+    d[i]   = real_value(A[i + i*lda]);
+    tau[i] = taui;
+  }
+
+  if (N > 0) d[N-1] = real_value(A[(N-1) + (N-1)*lda]);
+}
+
+/*
+ * Sorts the eigenvalues in d into ascending order, along with the corresponding columns of the column-major matrix Z
+ * (which may be NULL).
+ */
+inline void tridiagonal_sort(const int N, double* d, double* Z, const int ldz) {
+  for (int i = 0; i < N-1; ++i) {
+    int k = i;
+    for (int j = i+1; j < N; ++j)
+      if (d[j] < d[k]) k = j;
+
+    if (k != i) {
+      std::swap(d[i], d[k]);
+      if (Z) for (int r = 0; r < N; ++r) std::swap(Z[r + i*ldz], Z[r + k*ldz]);
+    }
+  }
+}
+
+/*
+ * All eigenvalues, and optionally eigenvectors, of the real symmetric tridiagonal matrix with diagonal d and
+ * off-diagonal e, by the implicit QL method (LAPACK's steqr). d is overwritten with the eigenvalues in ascending order.
+ * If Z is given, it should hold the identity (or an orthogonal matrix to be multiplied by the eigenvectors) and is
+ * overwritten with them.
+ *
+ * Returns 0, or i if the i-th eigenvalue failed to converge.
+ */
+inline int steqr(const int N, double* d, const double* e, double* Z, const int ldz) {
+  if (N <= 1) return 0;
+
+  std::vector<double> ee(N);
+  for (int i = 0; i < N-1; ++i) ee[i] = e[i];
+  ee[N-1] = 0;
+
+  for (int l = 0; l < N; ++l) {
+    int iter = 0, m;
+
+    do {
+      for (m = l; m < N-1; ++m) {
+        double dd = std::abs(d[m]) + std::abs(d[m+1]);
+        if (std::abs(ee[m]) <= DBL_EPSILON * dd) break;
+      }
+
+      if (m != l) {
+        if (iter++ == 60) return l+1;
+
+        double g = (d[l+1] - d[l]) / (2 * ee[l]);
+        double r = std::hypot(g, 1.0);
+        g        = d[m] - d[l] + ee[l] / (g + std::copysign(r, g));
+
+        double s = 1, c = 1, p = 0;
+        int i;
+        for (i = m-1; i >= l; --i) {
+          double f = s * ee[i], b = c * ee[i];
+          ee[i+1]  = (r = std::hypot(f, g));
+          if (r == 0) {
+            d[i+1] -= p;
+            ee[m]   = 0;
+            break;
+          }
+          s       = f / r;
+          c       = g / r;
+          g       = d[i+1] - p;
+          r       = (d[i] - g) * s + 2 * c * b;
+          p       = s * r;
+          d[i+1]  = g + p;
+          g       = c * r - b;
+
+          if (Z) {
+            double* zi  = Z + i*ldz;
+            double* zi1 = zi + ldz;
+            for (int k = 0; k < N; ++k) {
+              f      = zi1[k];
+              zi1[k] = s * zi[k] + c * f;
+              zi[k]  = c * zi[k] - s * f;
+            }
+          }
+        }
+
+        if (r == 0 && i >= l) continue;
+        d[l] -= p;
+        ee[l] = g;
+        ee[m] = 0;
+      }
+    } while (m != l);
+  }
+
+  tridiagonal_sort(N, d, Z, ldz);
+  return 0;
+}
+
+/*
+ * Finds root i (0-based) of the secular equation 1 + rho * sum_j z(j)**2 / (d(j) - lambda) = 0, for strictly
+ * increasing d, unit-norm z with no zeros, and rho > 0 (LAPACK's laed4). The root lies between d(i) and d(i+1), or
+ * above d(K-1) for the last one.
+ *
+ * Returns it as d(origin) + tau, where origin is whichever of the two poles is nearer, so that the differences
+ * d(j) - lambda = (d(j) - d(origin)) - tau can be formed accurately.
+ */
+inline double laed4(const int K, const int i, const double* d, const double* z, const double rho, int& origin) {
+  if (K == 1) {
+    origin = 0;
+    return rho * z[0] * z[0];
+  }
+
+  double lo, hi;
+
+  if (i < K-1) {
+    const double gap = d[i+1] - d[i], mid = gap / 2;
+    double f = 1;
+    for (int j = 0; j < K; ++j) f += rho * z[j] * z[j] / ((d[j] - d[i]) - mid);
+
+    if (f >= 0) {
+      origin = i;
+      lo     = 0;
+      hi     = mid;
+    } else {
+      origin = i+1;
+      lo     = -mid;
+      hi     = 0;
+    }
+  } else {
+    double zz = 0;
+    for (int j = 0; j < K; ++j) zz += z[j] * z[j];
+
+    origin = K-1;
+    lo     = 0;
+    hi     = rho * zz;
+  }
+
+  const double dorig = d[origin];
+  double       tau   = (lo + hi) / 2;
+
+  for (int iter = 0; iter < 100; ++iter) {
+    double psi = 0, dpsi = 0, phi = 0, dphi = 0;
+
+    for (int j = 0; j <= i; ++j) {
+      double t = z[j] / ((d[j] - dorig) - tau);
+      psi  += z[j] * t;
+      dpsi += t * t;
+    }
+    for (int j = i+1; j < K; ++j) {
+      double t = z[j] / ((d[j] - dorig) - tau);
+      phi  += z[j] * t;
+      dphi += t * t;
+    }
+
+    const double f = 1 + rho * (psi + phi);
+    if (std::abs(f) <= 4 * DBL_EPSILON * K * (1 + rho * (std::abs(psi) + std::abs(phi)))) break;
+
+    if (f < 0) lo = tau;
+    else       hi = tau;
+    if (hi - lo <= 2 * DBL_EPSILON * std::max(std::abs(lo), std::abs(hi))) break;
+
+    // Model psi and phi by one pole each, matching value and slope at tau, and solve the model exactly.
+    const double p = (d[i] - dorig);
+    const double b = rho * dpsi * (p - tau) * (p - tau),
+                 a = rho * psi - rho * dpsi * (p - tau);
+    double next;
+
+    if (i < K-1) {
+      const double q = (d[i+1] - dorig);
+      const double e = rho * dphi * (q - tau) * (q - tau),
+                   c = rho * phi - rho * dphi * (q - tau),
+                   w = 1 + a + c;
+
+      // w*(p-t)*(q-t) + b*(q-t) + e*(p-t) = 0
+      const double qa = w, qb = -(w * (p + q) + b + e), qc = w * p * q + b * q + e * p;
+      if (qa == 0) {
+        next = -qc / qb;
+      } else {
+        const double disc = std::sqrt(std::max(qb * qb - 4 * qa * qc, 0.0));
+        const double r1   = (-qb - std::copysign(disc, qb)) / (2 * qa);
+        const double r2   = r1 != 0 ? qc / (qa * r1) : 0;
+        next = (r1 > lo && r1 < hi) ? r1 : r2;
+      }
+    } else {
+      next = p + b / (1 + a);
+    }
+
+    tau = (next > lo && next < hi) ? next : (lo + hi) / 2;
+  }
+
+  return tau;
+}
+
+/*
+ * Merges two eigendecompositions for divide-and-conquer (LAPACK's laed1-3). On entry, d(0:M-1) and d(M:N-1) hold the
+ * eigenvalues of the two halves and the block diagonal Q their eigenvectors, and the full matrix is
+ * Q * (D + rho * z * z**T) * Q**T with z = Q**T * (e(M-1) + s * e(M)). On return, d and Q hold the eigenvalues (in
+ * ascending order) and eigenvectors of the full matrix.
+ */
+inline void laed1(const int N, const int M, double* d, double* Q, const int ldq, double rho, const double s) {
+  std::vector<double> z(N);
+  std::vector<int>    perm(N);
+
+  for (int j = 0; j < M; ++j) z[j] = Q[(M-1) + j*ldq];
+  for (int j = M; j < N; ++j) z[j] = s * Q[M + j*ldq];
+
+  double znorm = 0;
+  for (int j = 0; j < N; ++j) znorm += z[j] * z[j];
+  for (int j = 0; j < N; ++j) z[j] /= std::sqrt(znorm);
+  rho *= znorm;
+
+  // Sort the poles, remembering the column of Q each came from.
+  for (int j = 0; j < N; ++j) perm[j] = j;
+  std::sort(perm.begin(), perm.end(), [d](int a, int b) { return d[a] < d[b]; });
+
+  std::vector<double> dl(N), zl(N);
+  std::vector<bool>   deflate(N);
+
+  double dmax = 0, zmax = 0;
+  for (int j = 0; j < N; ++j) {
+    dl[j]      = d[perm[j]];
+    zl[j]      = z[perm[j]];
+    deflate[j] = false;
+    dmax       = std::max(dmax, std::abs(dl[j]));
+    zmax       = std::max(zmax, std::abs(zl[j]));
+  }
+
+  // Deflate for tiny components of z, and for close pairs of poles after rotating one of their z components away.
+  const double tol = 8 * DBL_EPSILON * std::max(dmax, zmax);
+  int pj = -1;
+
+  for (int j = 0; j < N; ++j) {
+    if (rho * std::abs(zl[j]) <= tol) {
+      deflate[j] = true;
+      continue;
+    }
+    if (pj < 0) {
+      pj = j;
+      continue;
+    }
+
+    double sn  = zl[pj], cs = zl[j];
+    double tau = std::hypot(cs, sn), t = dl[j] - dl[pj];
+    cs /= tau;
+    sn  = -sn / tau;
+
+    if (std::abs(t * cs * sn) <= tol) {
+      zl[j]  = tau;
+      zl[pj] = 0;
+
+      double* x = Q + perm[pj]*ldq;
+      double* y = Q + perm[j]*ldq;
+      for (int r = 0; r < N; ++r) {
+        double xr = x[r], yr = y[r];
+        x[r] = cs * xr + sn * yr;
+        y[r] = cs * yr - sn * xr;
+      }
+
+      t      = dl[pj] * cs * cs + dl[j] * sn * sn;
+      dl[j]  = dl[pj] * sn * sn + dl[j] * cs * cs;
+      dl[pj] = t;
+      deflate[pj] = true;
+    }
+    pj = j;
+  }
+
+  // The remaining poles, which rotations may have nudged out of order.
+  std::vector<int> nd(N);
+  int  K  = 0;
+  for (int j = 0; j < N; ++j)
+    if (!deflate[j]) nd[K++] = j;
+  std::sort(nd.begin(), nd.begin() + K, [&dl](int a, int b) { return dl[a] < dl[b]; });
+
+  std::vector<double> Qout(N * N), lambda(N);
+
+  if (K > 0) {
+    std::vector<double> dk(K), zk(K), tau(K), S(K * K), Qk(N * K);
+    std::vector<int>    origin(K);
+
+    for (int j = 0; j < K; ++j) {
+      dk[j] = dl[nd[j]];
+      zk[j] = zl[nd[j]];
+    }
+
+    for (int j = 0; j < K; ++j) {
+      tau[j]    = laed4(K, j, &dk[0], &zk[0], rho, origin[j]);
+      lambda[j] = dk[origin[j]] + tau[j];
+    }
+
+    // Recompute z from the computed eigenvalues (Gu and Eisenstat), so that the eigenvectors come out orthogonal.
+    for (int i = 0; i < K; ++i) {
+      double w = 1 / rho;
+      for (int j = 0; j < K; ++j) {
+        w *= (dk[origin[j]] - dk[i]) + tau[j];
+        if (j != i) w /= dk[j] - dk[i];
+      }
+      zk[i] = std::copysign(std::sqrt(std::abs(w)), zk[i]);
+    }
+
+    for (int j = 0; j < K; ++j) {
+      double* sj   = &S[j*K];
+      double  norm = 0;
+      for (int i = 0; i < K; ++i) {
+        sj[i] = zk[i] / ((dk[i] - dk[origin[j]]) - tau[j]);
+        norm += sj[i] * sj[i];
+      }
+      norm = std::sqrt(norm);
+      for (int i = 0; i < K; ++i) sj[i] /= norm;
+    }
+
+    for (int j = 0; j < K; ++j)
+      std::copy(Q + perm[nd[j]]*ldq, Q + perm[nd[j]]*ldq + N, Qk.begin() + j*N);
+
+    const double one = 1, zero = 0;
+    gemm<double>(CblasColMajor, CblasNoTrans, CblasNoTrans, N, K, K, &one, &Qk[0], N, &S[0], K, &zero, &Qout[0], N);
+  }
+
+  for (int j = 0, c = K; j < N; ++j) {
+    if (!deflate[j]) continue;
+    lambda[c] = dl[j];
+    std::copy(Q + perm[j]*ldq, Q + perm[j]*ldq + N, Qout.begin() + c*N);
+    ++c;
+  }
+
+  for (int j = 0; j < N; ++j) {
+    d[j] = lambda[j];
+    std::copy(Qout.begin() + j*N, Qout.begin() + (j+1)*N, Q + j*ldq);
+  }
+  tridiagonal_sort(N, d, Q, ldq);
+}
+
+/*
+ * All eigenvalues and eigenvectors of the real symmetric tridiagonal matrix with diagonal d and off-diagonal e, by
+ * divide-and-conquer (LAPACK's stedc). d is overwritten with the eigenvalues in ascending order, and the column-major
+ * N-by-N matrix Q with the eigenvectors. e is used as workspace.
+ *
+ * Returns 0, or nonzero if a subproblem failed to converge.
+ */
+inline int stedc(const int N, double* d, double* e, double* Q, const int ldq) {
+  if (N <= STEDC_SMLSIZ) {
+    for (int j = 0; j < N; ++j)
+      for (int i = 0; i < N; ++i) Q[i + j*ldq] = i == j ? 1 : 0;
+    return steqr(N, d, e, Q, ldq);
+  }
+
+  // T = diag(T1, T2) + rho * u * u**T, with u = e(M-1) + s * e(M) and rho = |e(M-1)|.
+  const int    M   = N / 2;
+  const double rho = std::abs(e[M-1]), s = e[M-1] < 0 ? -1 : 1;
+
+  d[M-1] -= rho;
+  d[M]   -= rho;
+
+  for (int j = 0; j < M; ++j)
+    for (int i = M; i < N; ++i) Q[i + j*ldq] = 0;
+  for (int j = M; j < N; ++j)
+    for (int i = 0; i < M; ++i) Q[i + j*ldq] = 0;
+
+  int info = stedc(M, d, e, Q, ldq);
+  if (!info) info = stedc(N-M, d + M, e + M, Q + M + M*ldq, ldq);
+  if (info) return info;
+
+  if (rho == 0) tridiagonal_sort(N, d, Q, ldq);
+  else          laed1(N, M, d, Q, ldq, rho, s);
+
+  return 0;
+}
+
+/*
+ * Number of eigenvalues of the real symmetric tridiagonal matrix (d, e) that are less than x, by Sturm sequence.
+ */
+inline int sturm_count(const int N, const double* d, const double* e, const double x, const double pivmin) {
+  int    count = 0;
+  double q     = d[0] - x;
+
+  for (int i = 0; ; ++i) {
+    if (std::abs(q) < pivmin) q = -pivmin;
+    if (q < 0) ++count;
+    if (i == N-1) break;
+    q = (d[i+1] - x) - e[i] * e[i] / q;
+  }
+
+  return count;
+}
+
+/*
+ * Eigenvalues il through iu (0-based, in ascending order) of the real symmetric tridiagonal matrix (d, e), by
+ * bisection (LAPACK's stebz). They are written to w in ascending order.
+ */
+inline void stebz(const int N, const double* d, const double* e, const int il, const int iu, double* w) {
+  double gl = d[0], gu = d[0], emax = 0;
+
+  for (int i = 0; i < N; ++i) {
+    double r = (i > 0 ? std::abs(e[i-1]) : 0) + (i < N-1 ? std::abs(e[i]) : 0);
+    gl = std::min(gl, d[i] - r);
+    gu = std::max(gu, d[i] + r);
+    if (i < N-1) emax = std::max(emax, e[i] * e[i]);
+  }
+
+  const double tnorm  = std::max(std::abs(gl), std::abs(gu));
+  const double pivmin = DBL_MIN * std::max(1.0, emax);
+  gl -= 2 * DBL_EPSILON * tnorm * N + 2 * pivmin;
+  gu += 2 * DBL_EPSILON * tnorm * N + 2 * pivmin;
+
+  for (int k = il; k <= iu; ++k) {
+    // The previous eigenvalue is a lower bound for this one.
+    double lo = k > il ? w[k-il-1] : gl, hi = gu;
+    if (k > il && sturm_count(N, d, e, lo, pivmin) > k) lo = gl;
+
+    while (hi - lo > 2 * DBL_EPSILON * std::max(std::abs(lo), std::abs(hi)) + pivmin) {
+      double mid = lo + (hi - lo) / 2;
+      if (mid <= lo || mid >= hi) break;
+      if (sturm_count(N, d, e, mid, pivmin) > k) hi = mid;
+      else                                      lo = mid;
+    }
+
+    w[k-il] = lo + (hi - lo) / 2;
+  }
+}
+
+/*
+ * Eigenvectors of the real symmetric tridiagonal matrix (d, e) for the M eigenvalues in w (ascending), by inverse
+ * iteration (LAPACK's stein). Vectors for eigenvalues closer together than 1e-3 * ||T|| are reorthogonalized against
+ * each other. They are written to the columns of the column-major N-by-M matrix Z.
+ */
+inline void stein(const int N, const double* d, const double* e, const int M, const double* w, double* Z, const int ldz) {
+  double onenrm = 0;
+  for (int i = 0; i < N; ++i)
+    onenrm = std::max(onenrm, std::abs(d[i]) + (i > 0 ? std::abs(e[i-1]) : 0) + (i < N-1 ? std::abs(e[i]) : 0));
+
+  const double ortol  = 1e-3 * onenrm,
+               dtpcrt = std::sqrt(0.1 / N),
+               eps    = DBL_EPSILON,
+               pivtol = std::max(eps * onenrm, DBL_MIN);
+
+  std::vector<double> a(N), b(N), c(N), f(N);
+  std::vector<bool>   piv(N);
+
+  unsigned long long seed = 0x2545F4914F6CDD1DULL;
+  int    cluster = 0;
+  double xjm     = 0;
+
+  for (int j = 0; j < M; ++j) {
+    double xj = w[j];
+
+    if (j > 0 && xj - w[j-1] < ortol) {
+      // Separate coincident eigenvalues slightly, so the factorizations differ.
+      double pertol = 10 * std::abs(eps * xj);
+      if (xj - xjm < pertol) xj = xjm + pertol;
+    } else {
+      cluster = j;
+    }
+    xjm = xj;
+
+    // LU factorization of T - xj*I with partial pivoting (LAPACK's lagtf).
+    for (int i = 0; i < N; ++i) {
+      a[i] = d[i] - xj;
+      if (i < N-1) b[i] = c[i] = e[i];
+      f[i]   = 0;
+      piv[i] = false;
+    }
+    for (int k = 0; k < N-1; ++k) {
+      if (std::abs(a[k]) >= std::abs(c[k])) {
+        if (a[k] == 0) a[k] = pivtol;
+        c[k]    /= a[k];
+        a[k+1]  -= c[k] * b[k];
+      } else {
+        piv[k]      = true;
+        double mult = a[k] / c[k];
+        double temp = a[k+1];
+        a[k]        = c[k];
+        a[k+1]      = b[k] - mult * temp;
+        if (k < N-2) {
+          f[k]   = b[k+1];
+          b[k+1] = -mult * f[k];
+        }
+        b[k] = temp;
+        c[k] = mult;
+      }
+    }
+
+    double* z = Z + j*ldz;
+    for (int i = 0; i < N; ++i) {
+      seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+      z[i]  = (double)(seed >> 11) / 9007199254740992.0 * 2 - 1;
+    }
+
+    int converged = 0;
+    for (int its = 0; its < 5 && converged < 3; ++its) {
+      double asum = 0;
+      for (int i = 0; i < N; ++i) asum += std::abs(z[i]);
+      double scl = N * onenrm * std::max(eps, std::abs(a[N-1])) / asum;
+      for (int i = 0; i < N; ++i) z[i] *= scl;
+
+      // Solve with the factorization (LAPACK's lagts), perturbing tiny pivots.
+      for (int k = 1; k < N; ++k) {
+        if (!piv[k-1]) {
+          z[k] -= c[k-1] * z[k-1];
+        } else {
+          double temp = z[k-1];
+          z[k-1]      = z[k];
+          z[k]        = temp - c[k-1] * z[k];
+        }
+      }
+      for (int k = N-1; k >= 0; --k) {
+        double temp = z[k];
+        if (k < N-1) temp -= b[k] * z[k+1];
+        if (k < N-2) temp -= f[k] * z[k+2];
+        double ak = a[k];
+        if (std::abs(ak) < pivtol) ak = std::copysign(pivtol, ak);
+        z[k] = temp / ak;
+      }
+
+      for (int p = cluster; p < j; ++p) {
+        const double* zp  = Z + p*ldz;
+        double        dot = 0;
+        for (int i = 0; i < N; ++i) dot += zp[i] * z[i];
+        for (int i = 0; i < N; ++i) z[i] -= dot * zp[i];
+      }
+
+      double zmax = 0;
+      for (int i = 0; i < N; ++i) zmax = std::max(zmax, std::abs(z[i]));
+      if (zmax >= dtpcrt) ++converged;
+
+      double scale = 1 / zmax;
+      for (int i = 0; i < N; ++i) z[i] *= scale;
+    }
+
+    double norm = 0;
+    int    imax = 0;
+    for (int i = 0; i < N; ++i) {
+      norm += z[i] * z[i];
+      if (std::abs(z[i]) > std::abs(z[imax])) imax = i;
+    }
+    norm = std::copysign(1 / std::sqrt(norm), z[imax]);
+    for (int i = 0; i < N; ++i) z[i] *= norm;
+  }
+}
+
+/*
+ * Eigenvalues il through iu (0-based, in ascending order) of a symmetric or Hermitian row-major N-by-N matrix, of which
+ * only the triangle given by uplo is read, and optionally the corresponding eigenvectors. Like LAPACK's syevr/heevr,
+ * but choosing divide-and-conquer (as syevd) when most of the spectrum is wanted and bisection with inverse iteration
+ * otherwise.
+ *
+ * The eigenvalues go to w in ascending order; if Z is non-NULL, the eigenvectors go to its columns (row-major N-by-M,
+ * where M = iu - il + 1). A is not modified.
+ *
+ * Returns 0, or nonzero if the tridiagonal eigenvalue iteration failed to converge.
+ */
+template <typename DType>
+inline int syev(const enum CBLAS_UPLO uplo, const int N, const void* a, const int lda, const int il, const int iu,
+                void* w, void* z) {
+  typedef typename RealDType<DType>::type RDType;
+
+  const DType* A  = reinterpret_cast<const DType*>(a);
+  RDType*      W  = reinterpret_cast<RDType*>(w);
+  DType*       Z  = reinterpret_cast<DType*>(z);
+  const int    M  = iu - il + 1;
+
+  if (N == 0 || M <= 0) return 0;
+
+  // Column-major copy of the matrix, in its lower triangle.
+  std::vector<DType> B(N * N);
+  for (int j = 0; j < N; ++j)
+    for (int i = j; i < N; ++i)
+      B[i + j*N] = uplo == CblasLower ? A[i*lda + j] : conjugate_value(A[j*lda + i]);
+
+  std::vector<double> d(N), e(N);
+  std::vector<DType>  tau(N);
+
+  hetrd_lower<DType>(N, &B[0], N, &d[0], &e[0], &tau[0]);
+
+  int                 info = 0;
+  std::vector<double> X(Z ? N * M : 0);
+
+  if (M * 4 > N) {
+    if (Z) {
+      std::vector<double> Qt(N * N);
+      info = stedc(N, &d[0], &e[0], &Qt[0], N);
+      std::copy(Qt.begin() + il*N, Qt.begin() + (iu+1)*N, X.begin());
+    } else {
+      info = steqr(N, &d[0], &e[0], NULL, 0);
+    }
+    for (int j = 0; j < M; ++j) W[j] = d[il + j];
+  } else {
+    std::vector<double> wd(M);
+    stebz(N, &d[0], &e[0], il, iu, &wd[0]);
+    if (Z) stein(N, &d[0], &e[0], M, &wd[0], &X[0], N);
+    for (int j = 0; j < M; ++j) W[j] = wd[j];
+  }
+
+  if (Z && !info) {
+    // Eigenvectors of A are Q times those of T.
+    std::vector<DType> V(X.begin(), X.end());
+    if (N > 1) ormqr_left<DType>(false, N-1, M, N-1, &B[1], N, &tau[0], &V[1], N);
+
+    for (int i = 0; i < N; ++i)
+      for (int j = 0; j < M; ++j) Z[i*M + j] = V[i + j*N];
+  }
+
+  return info;
+}
+
+/*
+ * syev, without the GVL, for NMatrix::Internal::LAPACK.syev_rowmajor.
+ */
+template <typename DType>
+inline int syev_rowmajor(const enum CBLAS_UPLO uplo, const int N, const void* a, const int lda, const int il, const int iu,
+                         void* w, void* z) {
+  int info;
+  without_gvl<DType>([&] { info = syev<DType>(uplo, N, a, lda, il, iu, w, z); });
+  return info;
+}
+
+} } // end nm::math
+
+#endif // SYEV_H
@@ -47,6 +47,7 @@
 #include "storage/storage.h"
 #include "storage/list/list.h"
 #include "storage/yale/yale.h"
+#include "storage/bsr/bsr.h"
 
 #include "nmatrix.h"
 
@@ -257,9 +257,19 @@ NM_DEF_STORAGE_CHILD_STRUCT_PRE(YALE_STORAGE);
   size_t  ndnz; // Strictly non-diagonal non-zero count!
   size_t  capacity;
   size_t* ija;
+  size_t  ndead;    // non-diagonal entries marked deleted but not yet compacted away
+  void*   dead;     // coordinates of those entries (see storage/yale/class.h), or NULL if there are none
+  void*   batch;    // assignments staged by NMatrix#batch_update (see storage/yale/yale.cpp), or NULL
+  double  max_dead; // fraction of stored ND entries allowed to be dead before compaction; 0 means delete eagerly
 NM_DEF_STORAGE_STRUCT_POST(YALE_STORAGE);
 
 // FIXME: NODE and LIST should be put in some kind of namespace or something, at least in C++.
+#ifdef __cplusplus
+struct LIST_ARENA; // defined in util/sl_list.cpp
+#else
+struct NM_LIST_ARENA;
+#endif
+
 NM_DEF_STRUCT_PRE(NODE); // struct NODE {
   size_t key;
   void*  val;
@@ -267,7 +277,9 @@ NM_DEF_STRUCT_PRE(NODE); // struct NODE {
 NM_DEF_STRUCT_POST(NODE); // };
 
 NM_DEF_STRUCT_PRE(LIST); // struct LIST {
-  NM_DECL_STRUCT(NODE*, first); // NODE* first;
+  NM_DECL_STRUCT(NODE*, first);       // NODE* first;
+  void* index;                        // skip-list index over the nodes; built lazily by nm::list, NULL if none
+  NM_DECL_STRUCT(LIST_ARENA*, arena); // LIST_ARENA* arena; // where the nodes come from; one per list storage
 NM_DEF_STRUCT_POST(LIST); // };
 
 /* List-of-Lists Storage */
@@ -143,6 +143,8 @@ static VALUE nm_unary_log(int argc, VALUE* argv, VALUE self);
 static VALUE nm_unary_round(int argc, VALUE* argv, VALUE self);
 
 static VALUE elementwise_op(nm::ewop_t op, VALUE left_val, VALUE right_val);
+static VALUE mixed_elementwise_op(nm::ewop_t op, VALUE left_val, VALUE right_val);
+static void cast_to_common_stype(VALUE left_val, VALUE right_val, VALUE& left_cast, VALUE& right_cast);
 static VALUE unary_op(nm::unaryop_t op, VALUE self);
 static VALUE noncom_elementwise_op(nm::noncom_ewop_t op, VALUE self, VALUE other, VALUE orderflip);
 
@@ -230,6 +232,7 @@ void Init_nmatrix() {
 	rb_define_singleton_method(cNMatrix, "upcast", (METHOD)nm_upcast, 2); /* in ext/nmatrix/nmatrix.cpp */
 	rb_define_singleton_method(cNMatrix, "guess_dtype", (METHOD)nm_guess_dtype, 1);
 	rb_define_singleton_method(cNMatrix, "min_dtype", (METHOD)nm_min_dtype, 1);
+	rb_define_singleton_method(cNMatrix, "__yale_from_coo__", (METHOD)nm_yale_from_coo, 6); /* in ext/nmatrix/storage/yale/yale.cpp */
 
 	//////////////////////
 	// Instance Methods //
@@ -283,6 +286,10 @@ void Init_nmatrix() {
 	rb_define_protected_method(cNMatrix, "__list_map_stored__", (METHOD)nm_list_map_stored, 1);
 	rb_define_protected_method(cNMatrix, "__yale_map_merged_stored__", (METHOD)nm_yale_map_merged_stored, 2);
 	rb_define_protected_method(cNMatrix, "__yale_map_stored__", (METHOD)nm_yale_map_stored, 0);
+	rb_define_protected_method(cNMatrix, "__yale_ew_merge__", (METHOD)nm_yale_ew_merge, 2);
+	rb_define_protected_method(cNMatrix, "__yale_ew_scalar__", (METHOD)nm_yale_ew_scalar, 2);
+	rb_define_protected_method(cNMatrix, "__list_ew_merge__", (METHOD)nm_list_ew_merge, 2);
+	rb_define_protected_method(cNMatrix, "__list_ew_scalar__", (METHOD)nm_list_ew_scalar, 2);
 	rb_define_protected_method(cNMatrix, "__yale_stored_diagonal_each_with_indices__", (METHOD)nm_yale_stored_diagonal_each_with_indices, 0);
 	rb_define_protected_method(cNMatrix, "__yale_stored_nondiagonal_each_with_indices__", (METHOD)nm_yale_stored_nondiagonal_each_with_indices, 0);
 
@@ -337,6 +344,12 @@ void Init_nmatrix() {
 	// Helper Instance Methods //
 	/////////////////////////////
 	rb_define_protected_method(cNMatrix, "__yale_vector_set__", (METHOD)nm_vector_set, -1);
+	rb_define_protected_method(cNMatrix, "__yale_batch_begin__", (METHOD)nm_yale_batch_begin, 0);
+	rb_define_protected_method(cNMatrix, "__yale_batch_commit__", (METHOD)nm_yale_batch_commit, 0);
+	rb_define_protected_method(cNMatrix, "__yale_compact__", (METHOD)nm_yale_compact, 0);
+	rb_define_protected_method(cNMatrix, "__yale_permute__", (METHOD)nm_yale_permute, 3);
+	rb_define_protected_method(cNMatrix, "__yale_dead_space_threshold__", (METHOD)nm_yale_dead_space_threshold, 0);
+	rb_define_protected_method(cNMatrix, "__yale_set_dead_space_threshold__", (METHOD)nm_yale_set_dead_space_threshold, 1);
 
 	/////////////////////////
 	// Matrix Math Methods //
@@ -384,6 +397,12 @@ void Init_nmatrix() {
 
 	nm_math_init_blas();
 
+	/////////////////////////////
+	// Block sparse row module //
+	/////////////////////////////
+
+	nm_init_bsr();
+
 	///////////////
 	// IO module //
 	///////////////
@@ -1043,8 +1062,9 @@ static VALUE nm_complex_conjugate_bang(VALUE self) {
 
   } else if (m->stype == nm::YALE_STORE) {
 
-    size = nm_yale_storage_get_size(NM_STORAGE_YALE(self));
-    elem = NM_STORAGE_YALE(self)->a;
+    YALE_STORAGE* s = nm_yale_storage_direct(NM_STORAGE(self));
+    size = nm_yale_storage_get_size(s);
+    elem = s->a;
 
   } else {
     rb_raise(rb_eNotImpError, "please cast to yale or dense (complex) first");
@@ -1780,7 +1800,7 @@ static VALUE nm_write(int argc, VALUE* argv, VALUE self) {
   if (nmatrix->stype == nm::DENSE_STORE) {
     write_padded_dense_elements(f, reinterpret_cast<DENSE_STORAGE*>(nmatrix->storage), symm_, nmatrix->storage->dtype);
   } else if (nmatrix->stype == nm::YALE_STORE) {
-    YALE_STORAGE* s = reinterpret_cast<YALE_STORAGE*>(nmatrix->storage);
+    YALE_STORAGE* s = nm_yale_storage_direct(nmatrix->storage);
     uint32_t ndnz   = s->ndnz,
              length = nm_yale_storage_get_size(s);
     f.write(reinterpret_cast<const char*>(&ndnz),   sizeof(uint32_t));
@@ -2040,7 +2060,8 @@ static VALUE nm_mset(int argc, VALUE* argv, VALUE self) {
  *
  * For elementwise, use * instead.
  *
- * The two matrices must be of the same stype (for now). If dtype differs, an upcast will occur.
+ * The two matrices must be of the same stype (for now), except that a list or yale matrix may be multiplied by a dense
+ * one, giving a dense matrix. If dtype differs, an upcast will occur.
  */
 static VALUE nm_multiply(VALUE left_v, VALUE right_v) {
   NM_CONSERVATIVE(nm_register_value(&left_v));
@@ -2087,7 +2108,8 @@ static VALUE nm_multiply(VALUE left_v, VALUE right_v) {
       rb_raise(rb_eArgError, "incompatible dimensions");
     }
 
-    if (left->stype != right->stype) {
+    // list-by-dense and yale-by-dense are done natively (giving a dense result); other mixtures aren't.
+    if (left->stype != right->stype && !(left->stype != nm::DENSE_STORE && right->stype == nm::DENSE_STORE)) {
       NM_CONSERVATIVE(nm_unregister_value(&left_v));
       NM_CONSERVATIVE(nm_unregister_value(&right_v));
       rb_raise(rb_eNotImpError, "matrices must have same stype");
@@ -2324,6 +2346,52 @@ static void check_dims_and_shape(VALUE left_val, VALUE right_val) {
     }
 }
 
+/*
+ * For an element-wise operation between matrices of differing stypes which can't be done natively: cast the non-dense
+ * one to dense, or, for list and yale, the right one to the left's stype.
+ */
+static void cast_to_common_stype(VALUE left_val, VALUE right_val, VALUE& left_cast, VALUE& right_cast) {
+  NMATRIX *left, *right;
+  UnwrapNMatrix(left_val, left);
+  UnwrapNMatrix(right_val, right);
+
+  left_cast  = left_val;
+  right_cast = right_val;
+
+  if (left->stype == nm::DENSE_STORE)
+    right_cast = rb_funcall(right_val, rb_intern("cast"), 1, ID2SYM(rb_intern("dense")));
+  else if (right->stype == nm::DENSE_STORE)
+    left_cast  = rb_funcall(left_val, rb_intern("cast"), 1, ID2SYM(rb_intern("dense")));
+  else
+    right_cast = rb_funcall(right_val, rb_intern("cast"), 1, ID2SYM(rb_intern(STYPE_NAMES[left->stype])));
+}
+
+/*
+ * Element-wise operation between matrices of differing stypes. Sparse-dense +, -, and * are done natively, without
+ * a dense copy of the sparse matrix (see nm_sparse_dense_elementwise); anything else is done after casting one side
+ * with cast_to_common_stype.
+ */
+static VALUE mixed_elementwise_op(nm::ewop_t op, VALUE left_val, VALUE right_val) {
+  NMATRIX *left, *right;
+  UnwrapNMatrix(left_val, left);
+  UnwrapNMatrix(right_val, right);
+
+  if (left->stype == nm::DENSE_STORE || right->stype == nm::DENSE_STORE) {
+    bool     sparse_left = right->stype == nm::DENSE_STORE;
+    NMATRIX* sparse      = sparse_left ? left : right;
+    NMATRIX* dense       = sparse_left ? right : left;
+
+    nm::stype_t result_stype;
+    STORAGE* result = nm_sparse_dense_elementwise(op, sparse->storage, sparse->stype, dense->storage, sparse_left, result_stype);
+    if (result)
+      return Data_Wrap_Struct(CLASS_OF(left_val), nm_mark, nm_delete, nm_create(result_stype, result));
+  }
+
+  VALUE left_cast, right_cast;
+  cast_to_common_stype(left_val, right_val, left_cast, right_cast);
+  return elementwise_op(op, left_cast, right_cast);
+}
+
 static VALUE elementwise_op(nm::ewop_t op, VALUE left_val, VALUE right_val) {
 
   NM_CONSERVATIVE(nm_register_value(&left_val));
@@ -2392,7 +2460,7 @@ static VALUE elementwise_op(nm::ewop_t op, VALUE left_val, VALUE right_val) {
     } else {
       NM_CONSERVATIVE(nm_unregister_value(&left_val));
       NM_CONSERVATIVE(nm_unregister_value(&right_val));
-      rb_raise(rb_eArgError, "Element-wise operations are not currently supported between matrices with differing stypes.");
+      return mixed_elementwise_op(op, left_val, right_val);
     }
   }
 
@@ -2464,9 +2532,11 @@ static VALUE noncom_elementwise_op(nm::noncom_ewop_t op, VALUE self, VALUE other
       return rb_funcall(self, rb_intern(sym.c_str()), 2, other, flip);
 
     } else {
-      nm_unregister_value(&self);
-      nm_unregister_value(&other);
-      rb_raise(rb_eArgError, "Element-wise operations are not currently supported between matrices with differing stypes.");
+      NM_CONSERVATIVE(nm_unregister_value(&self));
+      NM_CONSERVATIVE(nm_unregister_value(&other));
+      VALUE self_cast, other_cast;
+      cast_to_common_stype(self, other, self_cast, other_cast);
+      return noncom_elementwise_op(op, self_cast, other_cast, flip);
     }
   }
   NM_CONSERVATIVE(nm_unregister_value(&self));
@@ -2917,8 +2987,17 @@ static VALUE matrix_multiply(NMATRIX* left, NMATRIX* right) {
     nm_yale_storage_matrix_multiply
   };
 
-  STORAGE* resulting_storage = storage_matrix_multiply[left->stype](casted, resulting_shape, vector);
-  NMATRIX* result = nm_create(left->stype, resulting_storage);
+  STORAGE*    resulting_storage;
+  nm::stype_t resulting_stype = left->stype;
+
+  if (left->stype != right->stype) { // list-by-dense or yale-by-dense
+    if (left->stype == nm::LIST_STORE) resulting_storage = nm_list_storage_matrix_multiply_dense(casted, resulting_shape);
+    else                               resulting_storage = nm_yale_storage_matrix_multiply_dense(casted, resulting_shape);
+    resulting_stype   = nm::DENSE_STORE;
+  } else {
+    resulting_storage = storage_matrix_multiply[left->stype](casted, resulting_shape, vector);
+  }
+  NMATRIX* result = nm_create(resulting_stype, resulting_storage);
   nm_register_nmatrix(result);
 
   // Free any casted-storage we created for the multiplication.
@@ -2932,10 +3011,10 @@ static VALUE matrix_multiply(NMATRIX* left, NMATRIX* right) {
   };
 
   nm_unregister_storage(left->stype, casted.left);
-  if (left->storage != casted.left)   free_storage[result->stype](casted.left);
+  if (left->storage != casted.left)   free_storage[left->stype](casted.left);
 
   nm_unregister_storage(right->stype, casted.right);
-  if (right->storage != casted.right) free_storage[result->stype](casted.right);
+  if (right->storage != casted.right) free_storage[right->stype](casted.right);
 
   VALUE to_return = result ? Data_Wrap_Struct(cNMatrix, nm_mark, nm_delete, result) : Qnil; // Only if we try to multiply list matrices should we return Qnil.
 
@@ -0,0 +1,386 @@
+/////////////////////////////////////////////////////////////////////
+// = NMatrix
+//
+// A linear algebra library for scientific computation in Ruby.
+// NMatrix is part of SciRuby.
+//
+// NMatrix was originally inspired by and derived from NArray, by
+// Masahiro Tanaka: http://narray.rubyforge.org
+//
+// == Copyright Information
+//
+// SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+// NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+//
+// Please see LICENSE.txt for additional copyright notices.
+//
+// == Contributing
+//
+// By contributing source code to SciRuby, you agree to be bound by
+// our Contributor Agreement:
+//
+// * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+//
+// == bsr.cpp
+//
+// Ruby bindings for block compressed sparse row matrices (see bsr.h),
+// in NMatrix::Internal::BSR.
+
+/*
+ * Standard Includes
+ */
+
+#include <ruby.h>
+#include <cstring>
+#include <fstream>
+
+/*
+ * Project Includes
+ */
+
+#include "../../data/data.h"
+#include "../../math/math.h"
+#include "../dense/dense.h"
+#include "../yale/yale.h"
+#include "bsr.h"
+
+#include "../../nmatrix.h"
+#include "../../ruby_constants.h"
+
+/*
+ * Forward Declarations
+ */
+
+extern "C" {
+  static VALUE nm_bsr_count_blocks(VALUE self, VALUE a, VALUE k, VALUE row_ptr);
+  static VALUE nm_bsr_from_yale(VALUE self, VALUE a, VALUE k, VALUE row_ptr, VALUE col_ind, VALUE values);
+  static VALUE nm_bsr_coo_indices(VALUE self, VALUE k, VALUE row_ptr, VALUE col_ind, VALUE rows, VALUE cols);
+  static VALUE nm_bsr_check_pattern(VALUE self, VALUE k, VALUE shape, VALUE row_ptr, VALUE col_ind);
+  static VALUE nm_bsr_multiply(VALUE self, VALUE k, VALUE m, VALUE row_ptr, VALUE col_ind, VALUE values, VALUE x, VALUE y);
+  static VALUE nm_bsr_write(VALUE self, VALUE file, VALUE k, VALUE shape, VALUE row_ptr, VALUE col_ind, VALUE values);
+  static VALUE nm_bsr_read_header(VALUE self, VALUE file);
+  static VALUE nm_bsr_read(VALUE self, VALUE file, VALUE row_ptr, VALUE col_ind, VALUE values);
+}
+
+namespace nm { namespace bsr_storage {
+
+  // First eight bytes of a BSR file: a magic string and the format version.
+  static const char    FILE_MAGIC[5] = { 'N', 'M', 'B', 'S', 'R' };
+  static const uint8_t FILE_VERSION  = 1;
+
+  template <typename DType>
+  static int64_t yale_count_blocks(const YALE_STORAGE* s, size_t k, int64_t* row_ptr) {
+    return count_blocks<DType>(s->shape[0], s->shape[1], k, s->ija, reinterpret_cast<const DType*>(s->a), row_ptr);
+  }
+
+  template <typename DType>
+  static void yale_to_bsr(const YALE_STORAGE* s, size_t k, const int64_t* row_ptr, int64_t* col_ind, void* values) {
+    from_yale<DType>(s->shape[0], s->shape[1], k, s->ija, reinterpret_cast<const DType*>(s->a), row_ptr, col_ind,
+                     reinterpret_cast<DType*>(values));
+  }
+
+  template <typename DType>
+  static void multiply(size_t nb, size_t k, const int64_t* row_ptr, const int64_t* col_ind, const void* values,
+                       const void* x, void* y, size_t nrhs) {
+    nm::math::without_gvl<DType>([&] {
+      block_multiply<DType>(nb, k, row_ptr, col_ind, reinterpret_cast<const DType*>(values),
+                            reinterpret_cast<const DType*>(x), reinterpret_cast<DType*>(y), nrhs);
+    });
+  }
+
+  /*
+   * Writes n bytes, and then zeros up to the next multiple of eight.
+   */
+  static void write_padded(std::ofstream& f, const void* data, size_t n) {
+    static const char zeros[8] = { 0 };
+    f.write(reinterpret_cast<const char*>(data), n);
+    if (n % 8) f.write(zeros, 8 - n % 8);
+  }
+
+  static void read_padded(std::ifstream& f, void* data, size_t n) {
+    char skip[8];
+    f.read(reinterpret_cast<char*>(data), n);
+    if (n % 8) f.read(skip, 8 - n % 8);
+  }
+
+}} // end of namespace nm::bsr_storage
+
+extern "C" {
+
+void nm_init_bsr() {
+  VALUE cNMatrix_Internal     = rb_define_module_under(cNMatrix, "Internal");
+  VALUE cNMatrix_Internal_BSR = rb_define_module_under(cNMatrix_Internal, "BSR");
+
+  rb_define_singleton_method(cNMatrix_Internal_BSR, "count_blocks", (METHOD)nm_bsr_count_blocks, 3);
+  rb_define_singleton_method(cNMatrix_Internal_BSR, "from_yale", (METHOD)nm_bsr_from_yale, 5);
+  rb_define_singleton_method(cNMatrix_Internal_BSR, "coo_indices", (METHOD)nm_bsr_coo_indices, 5);
+  rb_define_singleton_method(cNMatrix_Internal_BSR, "check_pattern", (METHOD)nm_bsr_check_pattern, 4);
+  rb_define_singleton_method(cNMatrix_Internal_BSR, "multiply", (METHOD)nm_bsr_multiply, 7);
+  rb_define_singleton_method(cNMatrix_Internal_BSR, "write", (METHOD)nm_bsr_write, 6);
+  rb_define_singleton_method(cNMatrix_Internal_BSR, "read_header", (METHOD)nm_bsr_read_header, 1);
+  rb_define_singleton_method(cNMatrix_Internal_BSR, "read", (METHOD)nm_bsr_read, 4);
+}
+
+/*
+ * The elements of v, which must be a dense, non-reference :int64 NMatrix with at least n entries.
+ */
+static int64_t* int64_elements(VALUE v, size_t n, const char* name) {
+  if (NM_STYPE(v) != nm::DENSE_STORE || NM_SRC(v) != NM_STORAGE(v) || NM_DTYPE(v) != nm::INT64) {
+    rb_raise(nm_eStorageTypeError, "%s must be a dense :int64 matrix, and not a slice reference", name);
+  } else if (NM_DENSE_COUNT(v) < n) {
+    rb_raise(nm_eShapeError, "%s must have at least %lu entries", name, n);
+  }
+  return reinterpret_cast<int64_t*>(NM_STORAGE_DENSE(v)->elements);
+}
+
+/*
+ * The elements of v, which must be a dense, non-reference NMatrix of a dtype other than :object, with at least n
+ * entries.
+ */
+static void* dtype_elements(VALUE v, size_t n, const char* name) {
+  if (NM_STYPE(v) != nm::DENSE_STORE || NM_SRC(v) != NM_STORAGE(v)) {
+    rb_raise(nm_eStorageTypeError, "%s must be a dense matrix, and not a slice reference", name);
+  } else if (NM_DTYPE(v) == nm::RUBYOBJ) {
+    rb_raise(nm_eDataTypeError, "block sparse matrices can't have dtype :object");
+  } else if (NM_DENSE_COUNT(v) < n) {
+    rb_raise(nm_eShapeError, "%s must have at least %lu entries", name, n);
+  }
+  return NM_STORAGE_DENSE(v)->elements;
+}
+
+/*
+ * The block size k of an n-by-m matrix, which must divide both.
+ */
+static size_t block_size(VALUE k, size_t n, size_t m) {
+  const long kk = NUM2LONG(k);
+  if (kk < 1)                     rb_raise(rb_eArgError, "block size must be positive");
+  if (n % kk != 0 || m % kk != 0) rb_raise(nm_eShapeError, "block size must divide the number of rows and columns");
+  return kk;
+}
+
+/*
+ * Checks that a is a 2D, non-reference Yale matrix of a dtype other than :object, with a block size of k.
+ */
+static size_t yale_block_size(VALUE a, VALUE k) {
+  if (NM_STYPE(a) != nm::YALE_STORE || NM_SRC(a) != NM_STORAGE(a)) {
+    rb_raise(nm_eStorageTypeError, "a must be a yale matrix, and not a slice reference");
+  } else if (NM_DTYPE(a) == nm::RUBYOBJ) {
+    rb_raise(nm_eDataTypeError, "block sparse matrices can't have dtype :object");
+  } else if (NM_DIM(a) != 2) {
+    rb_raise(nm_eShapeError, "a must be a matrix");
+  }
+  return block_size(k, NM_SHAPE0(a), NM_SHAPE1(a));
+}
+
+/*
+ * call-seq:
+ *     count_blocks(a, k, row_ptr) -> Integer
+ *
+ * Fills the :int64 row_ptr (n/k + 1 entries) with where each block row of the Yale matrix a starts in BSR form, with
+ * k-by-k blocks, and returns the number of blocks.
+ */
+static VALUE nm_bsr_count_blocks(VALUE self, VALUE a, VALUE k, VALUE row_ptr) {
+  NAMED_DTYPE_TEMPLATE_TABLE(ttable, nm::bsr_storage::yale_count_blocks, int64_t, const YALE_STORAGE*, size_t, int64_t*)
+
+  const size_t kk = yale_block_size(a, k);
+  return LL2NUM(ttable[NM_DTYPE(a)](nm_yale_storage_direct(NM_STORAGE(a)), kk,
+                                    int64_elements(row_ptr, NM_SHAPE0(a) / kk + 1, "row_ptr")));
+}
+
+/*
+ * call-seq:
+ *     from_yale(a, k, row_ptr, col_ind, values) -> values
+ *
+ * Fills the :int64 col_ind and the values (a's dtype) of the BSR form of the Yale matrix a, given the row_ptr from
+ * count_blocks.
+ */
+static VALUE nm_bsr_from_yale(VALUE self, VALUE a, VALUE k, VALUE row_ptr, VALUE col_ind, VALUE values) {
+  NAMED_DTYPE_TEMPLATE_TABLE(ttable, nm::bsr_storage::yale_to_bsr, void, const YALE_STORAGE*, size_t, const int64_t*, int64_t*, void*)
+
+  const size_t   kk = yale_block_size(a, k), nb = NM_SHAPE0(a) / kk;
+  const int64_t* rp = int64_elements(row_ptr, nb + 1, "row_ptr");
+
+  if (NM_DTYPE(values) != NM_DTYPE(a)) rb_raise(nm_eDataTypeError, "values must have a's dtype");
+
+  ttable[NM_DTYPE(a)](nm_yale_storage_direct(NM_STORAGE(a)), kk, rp, int64_elements(col_ind, rp[nb], "col_ind"),
+                      dtype_elements(values, rp[nb] * kk * kk, "values"));
+  return values;
+}
+
+/*
+ * call-seq:
+ *     coo_indices(k, row_ptr, col_ind, rows, cols) -> rows
+ *
+ * Fills the :int64 rows and cols with the row and column of each entry in the values of a BSR matrix.
+ */
+static VALUE nm_bsr_coo_indices(VALUE self, VALUE k, VALUE row_ptr, VALUE col_ind, VALUE rows, VALUE cols) {
+  const size_t   kk = NUM2LONG(k), nb = NM_DENSE_COUNT(row_ptr) - 1;
+  const int64_t* rp = int64_elements(row_ptr, nb + 1, "row_ptr");
+  const size_t   n  = rp[nb] * kk * kk;
+
+  nm::bsr_storage::coo_indices(nb, kk, rp, int64_elements(col_ind, rp[nb], "col_ind"), int64_elements(rows, n, "rows"),
+                               int64_elements(cols, n, "cols"));
+  return rows;
+}
+
+/*
+ * Raises ArgumentError unless row_ptr and col_ind make a valid pattern (see nm::bsr_storage::valid_pattern) for an
+ * n-by-m BSR matrix with k-by-k blocks.
+ */
+static void check_pattern(size_t kk, size_t n, size_t m, VALUE row_ptr, VALUE col_ind) {
+  const size_t   nb = n / kk;
+  const int64_t* rp = int64_elements(row_ptr, nb + 1, "row_ptr");
+  const int64_t* ci = int64_elements(col_ind, 0, "col_ind");
+
+  if (!nm::bsr_storage::valid_pattern(nb, m / kk, rp, ci, NM_DENSE_COUNT(col_ind))) {
+    rb_raise(rb_eArgError, "row_ptr and col_ind don't make a valid block sparsity pattern");
+  }
+}
+
+/*
+ * call-seq:
+ *     check_pattern(k, shape, row_ptr, col_ind) -> nil
+ *
+ * Raises ArgumentError unless the :int64 row_ptr and col_ind make a valid pattern for a BSR matrix of the given
+ * shape, with k-by-k blocks: row_ptr starts at zero, never decreases and stays within col_ind, and the block columns
+ * of each block row are in range and ascending.
+ */
+static VALUE nm_bsr_check_pattern(VALUE self, VALUE k, VALUE shape, VALUE row_ptr, VALUE col_ind) {
+  const size_t n = NUM2ULL(rb_ary_entry(shape, 0)), m = NUM2ULL(rb_ary_entry(shape, 1));
+  check_pattern(block_size(k, n, m), n, m, row_ptr, col_ind);
+  return Qnil;
+}
+
+/*
+ * call-seq:
+ *     multiply(k, m, row_ptr, col_ind, values, x, y) -> y
+ *
+ * Overwrites the dense y with A * x, where A is the BSR matrix with m columns given by k, row_ptr, col_ind and values,
+ * and x is dense. x and y must have values' dtype, and A's number of columns and rows, respectively. The pattern is
+ * checked first (see check_pattern), so that the product can't stray outside x. The product runs without the GVL.
+ */
+static VALUE nm_bsr_multiply(VALUE self, VALUE k, VALUE m, VALUE row_ptr, VALUE col_ind, VALUE values, VALUE x, VALUE y) {
+  NAMED_DTYPE_TEMPLATE_TABLE(ttable, nm::bsr_storage::multiply, void, size_t, size_t, const int64_t*, const int64_t*, const void*, const void*, void*, size_t)
+
+  const nm::dtype_t dtype = NM_DTYPE(values);
+  if (NM_DTYPE(x) != dtype || NM_DTYPE(y) != dtype) rb_raise(nm_eDataTypeError, "x and y must have values' dtype");
+
+  const size_t   nb   = NM_DENSE_COUNT(row_ptr) - 1, mm = NUM2ULL(m);
+  const size_t   kk   = block_size(k, NM_SHAPE0(y), mm);
+  const int64_t* rp   = int64_elements(row_ptr, nb + 1, "row_ptr");
+  const size_t   nrhs = NM_DIM(y) > 1 ? NM_SHAPE1(y) : 1;
+
+  if (NM_SHAPE0(y) != nb * kk)                   rb_raise(nm_eShapeError, "y must have as many rows as the matrix");
+  if (NM_SHAPE0(x) != mm)                        rb_raise(nm_eShapeError, "x must have as many rows as the matrix has columns");
+  if ((NM_DIM(x) > 1 ? NM_SHAPE1(x) : 1) != nrhs) rb_raise(nm_eShapeError, "x and y must have as many columns");
+  check_pattern(kk, nb * kk, mm, row_ptr, col_ind);
+
+  ttable[dtype](nb, kk, rp, int64_elements(col_ind, rp[nb], "col_ind"), dtype_elements(values, rp[nb] * kk * kk, "values"),
+                dtype_elements(x, mm * nrhs, "x"), dtype_elements(y, nb * kk * nrhs, "y"), nrhs);
+  return y;
+}
+
+/*
+ * call-seq:
+ *     write(file, k, shape, row_ptr, col_ind, values) -> nil
+ *
+ * Saves a BSR matrix to file, in the binary format described in binary_format.txt.
+ */
+static VALUE nm_bsr_write(VALUE self, VALUE file, VALUE k, VALUE shape, VALUE row_ptr, VALUE col_ind, VALUE values) {
+  Check_Type(shape, T_ARRAY);
+
+  const uint64_t rows = NUM2ULL(rb_ary_entry(shape, 0)), cols = NUM2ULL(rb_ary_entry(shape, 1));
+  const uint64_t kk   = block_size(k, rows, cols), nb = rows / kk;
+  const int64_t* rp   = int64_elements(row_ptr, nb + 1, "row_ptr");
+  const uint64_t nblocks = rp[nb];
+  const uint8_t  dtype   = NM_DTYPE(values);
+
+  const int64_t* ci = int64_elements(col_ind, nblocks, "col_ind");
+  const void*    v  = dtype_elements(values, nblocks * kk * kk, "values");
+
+  std::ofstream f(StringValueCStr(file), std::ios::out | std::ios::binary);
+  if (!f) rb_raise(rb_eIOError, "unable to open %s for writing", StringValueCStr(file));
+
+  const uint8_t header[3] = { nm::bsr_storage::FILE_VERSION, dtype, 0 };
+  f.write(nm::bsr_storage::FILE_MAGIC, sizeof(nm::bsr_storage::FILE_MAGIC));
+  f.write(reinterpret_cast<const char*>(header), sizeof(header));
+  f.write(reinterpret_cast<const char*>(&kk),      sizeof(uint64_t));
+  f.write(reinterpret_cast<const char*>(&rows),    sizeof(uint64_t));
+  f.write(reinterpret_cast<const char*>(&cols),    sizeof(uint64_t));
+  f.write(reinterpret_cast<const char*>(&nblocks), sizeof(uint64_t));
+
+  f.write(reinterpret_cast<const char*>(rp), (nb + 1) * sizeof(int64_t));
+  f.write(reinterpret_cast<const char*>(ci), nblocks * sizeof(int64_t));
+  nm::bsr_storage::write_padded(f, v, nblocks * kk * kk * DTYPE_SIZES[dtype]);
+
+  if (!f) rb_raise(rb_eIOError, "error writing %s", StringValueCStr(file));
+  return Qnil;
+}
+
+/*
+ * call-seq:
+ *     read_header(file) -> [dtype, k, rows, cols, nblocks]
+ *
+ * Reads the header of a BSR file saved by write, so that its arrays can be made for read.
+ */
+static VALUE nm_bsr_read_header(VALUE self, VALUE file) {
+  std::ifstream f(StringValueCStr(file), std::ios::in | std::ios::binary);
+  if (!f) rb_sys_fail(StringValueCStr(file));
+
+  char     magic[5];
+  uint8_t  header[3];
+  uint64_t sizes[4]; // k, rows, cols, nblocks
+  f.read(magic, sizeof(magic));
+  f.read(reinterpret_cast<char*>(header), sizeof(header));
+  f.read(reinterpret_cast<char*>(sizes), sizeof(sizes));
+
+  if (!f || std::memcmp(magic, nm::bsr_storage::FILE_MAGIC, sizeof(magic)) != 0) {
+    rb_raise(rb_eIOError, "%s is not a BSR matrix file", StringValueCStr(file));
+  } else if (header[0] != nm::bsr_storage::FILE_VERSION) {
+    rb_raise(rb_eIOError, "%s has an unknown BSR file version (%u)", StringValueCStr(file), header[0]);
+  } else if (header[1] >= nm::NUM_DTYPES || header[1] == nm::RUBYOBJ) {
+    rb_raise(rb_eIOError, "%s has an invalid dtype", StringValueCStr(file));
+  } else if (sizes[0] == 0 || sizes[1] % sizes[0] != 0 || sizes[2] % sizes[0] != 0) {
+    rb_raise(rb_eIOError, "%s has an invalid block size", StringValueCStr(file));
+  }
+
+  return rb_ary_new3(5, ID2SYM(rb_intern(DTYPE_NAMES[header[1]])), ULL2NUM(sizes[0]), ULL2NUM(sizes[1]),
+                     ULL2NUM(sizes[2]), ULL2NUM(sizes[3]));
+}
+
+/*
+ * call-seq:
+ *     read(file, row_ptr, col_ind, values) -> values
+ *
+ * Reads the arrays of a BSR file into row_ptr, col_ind and values, which must be the sizes given by read_header.
+ */
+static VALUE nm_bsr_read(VALUE self, VALUE file, VALUE row_ptr, VALUE col_ind, VALUE values) {
+  VALUE          h       = nm_bsr_read_header(self, file);
+  const size_t   kk      = NUM2ULL(rb_ary_entry(h, 1)), nb = NUM2ULL(rb_ary_entry(h, 2)) / kk;
+  const size_t   nblocks = NUM2ULL(rb_ary_entry(h, 4));
+  const uint8_t  dtype   = NM_DTYPE(values);
+
+  if (ID2SYM(rb_intern(DTYPE_NAMES[dtype])) != rb_ary_entry(h, 0)) rb_raise(nm_eDataTypeError, "values has the wrong dtype");
+
+  int64_t* rp = int64_elements(row_ptr, nb + 1, "row_ptr");
+  int64_t* ci = int64_elements(col_ind, nblocks, "col_ind");
+  void*    v  = dtype_elements(values, nblocks * kk * kk, "values");
+
+  std::ifstream f(StringValueCStr(file), std::ios::in | std::ios::binary);
+  f.seekg(8 + 4 * sizeof(uint64_t));
+  f.read(reinterpret_cast<char*>(rp), (nb + 1) * sizeof(int64_t));
+  f.read(reinterpret_cast<char*>(ci), nblocks * sizeof(int64_t));
+  nm::bsr_storage::read_padded(f, v, nblocks * kk * kk * DTYPE_SIZES[dtype]);
+
+  if (!f) rb_raise(rb_eIOError, "%s is truncated", StringValueCStr(file));
+
+  // Check the pattern, so that a damaged file can't send the products out of bounds.
+  const size_t nbcols = NUM2ULL(rb_ary_entry(h, 3)) / kk;
+  if (rp[nb] != (int64_t)nblocks || !nm::bsr_storage::valid_pattern(nb, nbcols, rp, ci, nblocks)) {
+    rb_raise(rb_eIOError, "%s has an invalid sparsity pattern", StringValueCStr(file));
+  }
+
+  return values;
+}
+
+} // end of extern "C" block
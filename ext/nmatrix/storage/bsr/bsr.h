@@ -0,0 +1,258 @@
+/////////////////////////////////////////////////////////////////////
+// = NMatrix
+//
+// A linear algebra library for scientific computation in Ruby.
+// NMatrix is part of SciRuby.
+//
+// NMatrix was originally inspired by and derived from NArray, by
+// Masahiro Tanaka: http://narray.rubyforge.org
+//
+// == Copyright Information
+//
+// SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+// NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+//
+// Please see LICENSE.txt for additional copyright notices.
+//
+// == Contributing
+//
+// By contributing source code to SciRuby, you agree to be bound by
+// our Contributor Agreement:
+//
+// * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+//
+// == bsr.h
+//
+// Block compressed sparse row (BSR) matrices, for matrices made of
+// dense k-by-k blocks, as from finite elements with several unknowns
+// per node. Only one column index is kept per block, and the products
+// work on whole blocks.
+//
+// An n-by-m BSR matrix (n and m multiples of k) has n/k block rows.
+// The blocks of block row I are row_ptr[I] to row_ptr[I+1]-1; block p
+// is in block column col_ind[p] (ascending within a block row), and
+// its entries are values[p*k*k] to values[(p+1)*k*k-1], by rows.
+//
+// The arrays are kept by NMatrix::BSR (lib/nmatrix/bsr.rb) as dense
+// NMatrix objects; what's here converts from Yale, multiplies, and
+// reads and writes the binary format in binary_format.txt.
+//
+
+#ifndef BSR_H
+#define BSR_H
+
+/*
+ * Standard Includes
+ */
+
+#include <algorithm>
+#include <stdint.h>
+#include <vector>
+
+/*
+ * Project Includes
+ */
+
+#include "../../types.h"
+#include "../../data/data.h"
+#include "../common.h"
+#include "../../nmatrix.h"
+#include "../../math/conjugate.h"
+
+extern "C" {
+
+  void nm_init_bsr(void);
+
+}
+
+namespace nm { namespace bsr_storage {
+
+/*
+ * Finds which k-by-k blocks of the n-by-m new Yale matrix (ija, a) have nonzeros, and fills row_ptr (n/k + 1 entries)
+ * with where each block row starts. Returns the number of blocks.
+ */
+template <typename DType>
+inline int64_t count_blocks(const size_t n, const size_t m, const size_t k, const size_t* ija, const DType* a,
+                            int64_t* row_ptr) {
+  const size_t         nb = n / k;
+  std::vector<int64_t> mark(m / k, -1);
+  int64_t              nblocks = 0;
+
+  for (size_t I = 0; I < nb; ++I) {
+    row_ptr[I] = nblocks;
+
+    for (size_t i = I*k; i < (I+1)*k; ++i) {
+      if (i < m && !nm::math::exactly_zero(a[i]) && mark[i/k] != (int64_t)I) {
+        mark[i/k] = I;
+        ++nblocks;
+      }
+      for (size_t p = ija[i]; p < ija[i+1]; ++p) {
+        const size_t J = ija[p] / k;
+        if (!nm::math::exactly_zero(a[p]) && mark[J] != (int64_t)I) {
+          mark[J] = I;
+          ++nblocks;
+        }
+      }
+    }
+  }
+
+  row_ptr[nb] = nblocks;
+  return nblocks;
+}
+
+/*
+ * Fills col_ind and values from the Yale matrix, given the row_ptr found by count_blocks.
+ */
+template <typename DType>
+inline void from_yale(const size_t n, const size_t m, const size_t k, const size_t* ija, const DType* a,
+                      const int64_t* row_ptr, int64_t* col_ind, DType* values) {
+  const size_t         nb = n / k, kk = k*k;
+  std::vector<int64_t> pos(m / k, -1);
+
+  for (size_t I = 0; I < nb; ++I) {
+    int64_t next = row_ptr[I];
+
+    // The block columns of the block row, in ascending order.
+    for (size_t i = I*k; i < (I+1)*k; ++i) {
+      if (i < m && !nm::math::exactly_zero(a[i]) && pos[i/k] < 0) {
+        pos[i/k]        = 0;
+        col_ind[next++] = i/k;
+      }
+      for (size_t p = ija[i]; p < ija[i+1]; ++p) {
+        const size_t J = ija[p] / k;
+        if (!nm::math::exactly_zero(a[p]) && pos[J] < 0) {
+          pos[J]          = 0;
+          col_ind[next++] = J;
+        }
+      }
+    }
+    std::sort(col_ind + row_ptr[I], col_ind + next);
+
+    for (int64_t p = row_ptr[I]; p < next; ++p) {
+      pos[col_ind[p]] = p;
+      std::fill(values + p*kk, values + (p+1)*kk, DType(0));
+    }
+
+    for (size_t i = I*k; i < (I+1)*k; ++i) {
+      DType* row = values + (i - I*k)*k;
+      if (i < m && !nm::math::exactly_zero(a[i])) row[pos[i/k]*kk + i%k] = a[i];
+      for (size_t p = ija[i]; p < ija[i+1]; ++p) {
+        const size_t j = ija[p];
+        if (!nm::math::exactly_zero(a[p])) row[pos[j/k]*kk + j%k] = a[p];
+      }
+    }
+
+    for (int64_t p = row_ptr[I]; p < next; ++p) pos[col_ind[p]] = -1;
+  }
+}
+
+/*
+ * Checks the pattern of a matrix with nb block rows and nbcols block columns, whose col_ind has room for nblocks
+ * entries: row_ptr must start at zero, never decrease and stay within col_ind, and the block columns of each block row
+ * must be in range and ascending. Everything which follows row_ptr and col_ind relies on this.
+ */
+inline bool valid_pattern(const size_t nb, const size_t nbcols, const int64_t* row_ptr, const int64_t* col_ind,
+                          const size_t nblocks) {
+  if (row_ptr[0] != 0) return false;
+
+  for (size_t I = 0; I < nb; ++I) {
+    if (row_ptr[I+1] < row_ptr[I] || row_ptr[I+1] > (int64_t)nblocks) return false;
+
+    for (int64_t p = row_ptr[I]; p < row_ptr[I+1]; ++p) {
+      if (col_ind[p] < 0 || col_ind[p] >= (int64_t)nbcols)  return false;
+      if (p > row_ptr[I] && col_ind[p] <= col_ind[p-1])      return false;
+    }
+  }
+
+  return true;
+}
+
+/*
+ * The row and column of each entry of values, for turning the matrix into coordinate form.
+ */
+inline void coo_indices(const size_t nb, const size_t k, const int64_t* row_ptr, const int64_t* col_ind,
+                        int64_t* rows, int64_t* cols) {
+  for (size_t I = 0; I < nb; ++I) {
+    for (int64_t p = row_ptr[I]; p < row_ptr[I+1]; ++p) {
+      for (size_t r = 0; r < k; ++r) {
+        for (size_t c = 0; c < k; ++c) {
+          *rows++ = I*k + r;
+          *cols++ = col_ind[p]*k + c;
+        }
+      }
+    }
+  }
+}
+
+/*
+ * y := A * x, where x and y are row-major with nrhs columns. The block size is K, fixed at compile time so that the
+ * loops over a block can be unrolled and vectorized; block_multiply below picks the instance.
+ */
+template <typename DType, size_t K>
+inline void block_multiply_fixed(const size_t nb, const int64_t* row_ptr, const int64_t* col_ind, const DType* values,
+                                 const DType* x, DType* y, const size_t nrhs) {
+  for (size_t I = 0; I < nb; ++I) {
+    DType* yi = y + I*K*nrhs;
+    std::fill(yi, yi + K*nrhs, DType(0));
+
+    for (int64_t p = row_ptr[I]; p < row_ptr[I+1]; ++p) {
+      const DType* blk = values + p*K*K;
+      const DType* xj  = x + col_ind[p]*K*nrhs;
+
+      if (nrhs == 1) {
+        for (size_t r = 0; r < K; ++r) {
+          DType sum(0);
+          for (size_t c = 0; c < K; ++c) sum += blk[r*K + c] * xj[c];
+          yi[r] += sum;
+        }
+      } else {
+        for (size_t r = 0; r < K; ++r)
+          for (size_t c = 0; c < K; ++c) {
+            const DType arc = blk[r*K + c];
+            for (size_t t = 0; t < nrhs; ++t) yi[r*nrhs + t] += arc * xj[c*nrhs + t];
+          }
+      }
+    }
+  }
+}
+
+/*
+ * As block_multiply_fixed, for any block size.
+ */
+template <typename DType>
+inline void block_multiply_any(const size_t nb, const size_t k, const int64_t* row_ptr, const int64_t* col_ind,
+                               const DType* values, const DType* x, DType* y, const size_t nrhs) {
+  for (size_t I = 0; I < nb; ++I) {
+    DType* yi = y + I*k*nrhs;
+    std::fill(yi, yi + k*nrhs, DType(0));
+
+    for (int64_t p = row_ptr[I]; p < row_ptr[I+1]; ++p) {
+      const DType* blk = values + p*k*k;
+      const DType* xj  = x + col_ind[p]*k*nrhs;
+
+      for (size_t r = 0; r < k; ++r)
+        for (size_t c = 0; c < k; ++c) {
+          const DType arc = blk[r*k + c];
+          for (size_t t = 0; t < nrhs; ++t) yi[r*nrhs + t] += arc * xj[c*nrhs + t];
+        }
+    }
+  }
+}
+
+template <typename DType>
+inline void block_multiply(const size_t nb, const size_t k, const int64_t* row_ptr, const int64_t* col_ind,
+                           const DType* values, const DType* x, DType* y, const size_t nrhs) {
+  switch (k) {
+  case 1:  block_multiply_fixed<DType,1>(nb, row_ptr, col_ind, values, x, y, nrhs); break;
+  case 2:  block_multiply_fixed<DType,2>(nb, row_ptr, col_ind, values, x, y, nrhs); break;
+  case 3:  block_multiply_fixed<DType,3>(nb, row_ptr, col_ind, values, x, y, nrhs); break;
+  case 4:  block_multiply_fixed<DType,4>(nb, row_ptr, col_ind, values, x, y, nrhs); break;
+  case 6:  block_multiply_fixed<DType,6>(nb, row_ptr, col_ind, values, x, y, nrhs); break;
+  case 8:  block_multiply_fixed<DType,8>(nb, row_ptr, col_ind, values, x, y, nrhs); break;
+  default: block_multiply_any<DType>(nb, k, row_ptr, col_ind, values, x, y, nrhs);
+  }
+}
+
+} } // end of namespace nm::bsr_storage
+
+#endif // BSR_H
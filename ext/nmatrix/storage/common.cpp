@@ -74,4 +74,17 @@ extern "C" {
     return LONG2NUM(len);
   }
 
+  /*
+   * Map an operation name (:add, :sub, or :mul) onto the ewop_t which the sparse stypes can do natively, using the
+   * ew_add, ew_sub, and ew_mul functors. Returns false for anything else.
+   */
+  bool nm_native_ewop(VALUE op, nm::ewop_t& result) {
+    ID id = SYM2ID(op);
+    if      (id == rb_intern("add")) result = nm::EW_ADD;
+    else if (id == rb_intern("sub")) result = nm::EW_SUB;
+    else if (id == rb_intern("mul")) result = nm::EW_MUL;
+    else return false;
+    return true;
+  }
+
 } // end of extern "C" block
@@ -72,11 +72,24 @@ struct SLICE {
 
   size_t nm_storage_count_max_elements(const STORAGE* storage);
   VALUE nm_enumerator_length(VALUE nmatrix);
+  bool nm_native_ewop(VALUE op, nm::ewop_t& result);
 
 } // end of extern "C" block
 
 namespace nm {
 
+  /*
+   * Functors for the element-wise operations which yale and list can do natively (see nm_native_ewop).
+   */
+  template <typename DType>
+  struct ew_add { DType operator()(const DType& l, const DType& r) const { return static_cast<DType>(l + r); } };
+
+  template <typename DType>
+  struct ew_sub { DType operator()(const DType& l, const DType& r) const { return static_cast<DType>(l - r); } };
+
+  template <typename DType>
+  struct ew_mul { DType operator()(const DType& l, const DType& r) const { return static_cast<DType>(l * r); } };
+
   /*
    * Templated helper function for element-wise operations, used by dense, yale, and list.
    */
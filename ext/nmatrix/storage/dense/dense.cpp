@@ -30,6 +30,7 @@
  */
 
 #include <ruby.h>
+#include <type_traits>
 
 /*
  * Project Includes
@@ -75,25 +76,56 @@ namespace nm { namespace dense_storage {
   bool is_symmetric(const DENSE_STORAGE* mat, int lda);
 
 
+  /*
+   * Copy +n+ contiguous elements, converting each to the destination dtype.
+   */
+  template <typename LDType, typename RDType>
+  static inline void cast_contiguous(LDType* lhs, RDType* rhs, size_t n) {
+    for (size_t i = 0; i < n; ++i)
+      lhs[i] = rhs[i];
+  }
+
+  /*
+   * Same dtype on both sides: no conversion needed, so this is just a memcpy. Ruby objects are left to the element-wise
+   * copy above, which goes through RubyObject's own assignment.
+   */
+  template <typename DType>
+  static inline typename std::enable_if<std::is_trivially_copyable<DType>::value>::type
+  cast_contiguous(DType* lhs, DType* rhs, size_t n) {
+    memcpy(lhs, rhs, n * sizeof(DType));
+  }
+
+
   /*
    * Recursive slicing for N-dimensional matrix.
+   *
+   * Once every remaining dimension of the slice spans the whole of the source's, what's left is one contiguous block
+   * in both matrices, and it's copied in a single run instead of row by row.
    */
   template <typename LDType, typename RDType>
   static void slice_copy(DENSE_STORAGE *dest, const DENSE_STORAGE *src, size_t* lengths, size_t pdest, size_t psrc, size_t n) {
-    if (src->dim - n > 1) {
+    size_t block      = lengths[n];
+    bool   contiguous = true;
+
+    for (size_t k = n + 1; k < src->dim; ++k) {
+      if (lengths[k] != src->shape[k] || lengths[k] != dest->shape[k]) {
+        contiguous = false;
+        break;
+      }
+      block *= lengths[k];
+    }
+
+    if (contiguous) {
+      cast_contiguous(reinterpret_cast<LDType*>(dest->elements) + pdest,
+                      reinterpret_cast<RDType*>(src->elements) + psrc,
+                      block);
+    } else {
       for (size_t i = 0; i < lengths[n]; ++i) {
         slice_copy<LDType,RDType>(dest, src, lengths,
                    pdest + dest->stride[n]*i,
                    psrc + src->stride[n]*i,
                    n + 1);
       }
-    } else {
-      for (size_t p = 0; p < dest->shape[n]; ++p) {
-        reinterpret_cast<LDType*>(dest->elements)[p+pdest] = reinterpret_cast<RDType*>(src->elements)[p+psrc];
-      }
-      /*memcpy((char*)dest->elements + pdest*DTYPE_SIZES[dest->dtype],
-          (char*)src->elements + psrc*DTYPE_SIZES[src->dtype],
-          dest->shape[n]*DTYPE_SIZES[dest->dtype]); */
     }
 
   }
@@ -952,11 +984,7 @@ DENSE_STORAGE* cast_copy(const DENSE_STORAGE* rhs, dtype_t new_dtype) {
                  nm_dense_storage_pos(rhs, offset), 0);
 
     } else {              // Make a regular copy.
-      RDType* rhs_els          = reinterpret_cast<RDType*>(rhs->elements);
-      LDType* lhs_els          = reinterpret_cast<LDType*>(lhs->elements);
-
-      for (size_t i = 0; i < count; ++i)
-    	  lhs_els[i] = rhs_els[i];
+      cast_contiguous(reinterpret_cast<LDType*>(lhs->elements), reinterpret_cast<RDType*>(rhs->elements), count);
     }
   }
 
@@ -63,6 +63,7 @@ extern "C" {
 static void slice_set_single(LIST_STORAGE* dest, LIST* l, void* val, size_t* coords, size_t* lengths, size_t n);
 static void __nm_list_storage_unregister_temp_value_list(std::list<VALUE*>& temp_vals);
 static void __nm_list_storage_unregister_temp_list_list(std::list<LIST*>& temp_vals, size_t recursions);
+static void completely_unregister_list(const LIST* list, size_t recursions);
 }
 
 namespace nm { namespace list_storage {
@@ -148,6 +149,18 @@ static LIST_STORAGE* cast_copy(const LIST_STORAGE* rhs, nm::dtype_t new_dtype);
 template <typename LDType, typename RDType>
 static bool eqeq_r(RecurseData& left, RecurseData& right, const LIST* l, const LIST* r, size_t rec);
 
+template <typename DType>
+static STORAGE* matrix_multiply(const STORAGE_PAIR& casted_storage, size_t* resulting_shape, bool vector);
+
+template <typename DType>
+static STORAGE* matrix_multiply_dense(const STORAGE_PAIR& casted_storage, size_t* resulting_shape);
+
+template <typename DType>
+static LIST_STORAGE* ew_merge(const LIST_STORAGE* l, const LIST_STORAGE* r, nm::ewop_t op);
+
+template <typename DType>
+static LIST_STORAGE* ew_scalar(const LIST_STORAGE* l, const void* scalar, nm::ewop_t op);
+
 template <typename SDType, typename TDType>
 static bool eqeq_empty_r(RecurseData& s, const LIST* l, size_t rec, const TDType* t_init);
 
@@ -175,7 +188,7 @@ static void map_empty_stored_r(RecurseData& result, RecurseData& s, LIST* x, con
   if (rec) {
     std::list<LIST*> temp_vals;
     while (curr) {
-      LIST* val = nm::list::create();
+      LIST* val = nm::list::create(x->arena);
       map_empty_stored_r(result, s, val, reinterpret_cast<const LIST*>(curr->val), rec-1, rev, t_init);
 
       if (!val->first) nm::list::del(val, 0);
@@ -245,7 +258,7 @@ static void map_stored_r(RecurseData& result, RecurseData& left, LIST* x, const
     std::list<LIST*> temp_vals;
     while (lcurr) {
       size_t key;
-      LIST*  val = nm::list::create();
+      LIST*  val = nm::list::create(x->arena);
       map_stored_r(result, left, val, reinterpret_cast<const LIST*>(lcurr->val), rec-1);
       key        = lcurr->key - left.offset(rec);
       lcurr      = lcurr->next;
@@ -320,7 +333,7 @@ static void map_merged_stored_r(RecurseData& result, RecurseData& left, RecurseD
     std::list<LIST*> temp_vals;
     while (lcurr || rcurr) {
       size_t key;
-      LIST*  val = nm::list::create();
+      LIST*  val = nm::list::create(x->arena);
 
       if (!rcurr || (lcurr && (lcurr->key - left.offset(rec) < rcurr->key - right.offset(rec)))) {
         map_empty_stored_r(result, left, val, reinterpret_cast<const LIST*>(lcurr->val), rec-1, false, right.init_obj());
@@ -404,10 +417,12 @@ static void map_merged_stored_r(RecurseData& result, RecurseData& left, RecurseD
 template <typename D>
 static bool slice_set(LIST_STORAGE* dest, LIST* l, size_t* coords, size_t* lengths, size_t n, D* v, size_t v_size, size_t& v_offset) {
   using nm::list::node_is_within_slice;
-  using nm::list::remove_by_node;
+  using nm::list::remove_node;
+  using nm::list::remove_list_node;
   using nm::list::find_preceding_from_list;
   using nm::list::insert_first_list;
   using nm::list::insert_first_node;
+  using nm::list::insert_list_after;
   using nm::list::insert_after;
   size_t* offsets = dest->offset;
 
@@ -430,9 +445,9 @@ static bool slice_set(LIST_STORAGE* dest, LIST* l, size_t* coords, size_t* lengt
     // Make sure we have an element to work with
     if (!node) {
       if (!prev) {
-        node = insert_first_list(l, key, nm::list::create());
+        node = insert_first_list(l, key, nm::list::create(l->arena));
       } else {
-        node = insert_after(prev, key, nm::list::create());
+        node = insert_list_after(l, prev, key, nm::list::create(l->arena));
       }
     }
 
@@ -446,7 +461,7 @@ static bool slice_set(LIST_STORAGE* dest, LIST* l, size_t* coords, size_t* lengt
         nm_list_storage_register_list(reinterpret_cast<LIST*>(node->val), dest->dim - n - 2);
       }
       if (remove_parent) {
-        NM_FREE(remove_by_node(l, prev, node));
+        nm::list::del(remove_list_node(l, prev, node), 0); // takes its skip index with it
         if (prev) node = prev->next ? prev->next : NULL;
         else      node = l->first   ? l->first   : NULL;
       } else {  // move forward
@@ -461,9 +476,9 @@ static bool slice_set(LIST_STORAGE* dest, LIST* l, size_t* coords, size_t* lengt
       // Now do we need to insert another node here? Or is there already one?
       if (!node) {
         if (!prev) {
-          node = insert_first_list(l, key, nm::list::create());
+          node = insert_first_list(l, key, nm::list::create(l->arena));
         } else {
-          node = insert_after(prev, key, nm::list::create());
+          node = insert_list_after(l, prev, key, nm::list::create(l->arena));
         }
       }
     }
@@ -482,7 +497,7 @@ static bool slice_set(LIST_STORAGE* dest, LIST* l, size_t* coords, size_t* lengt
         if (node->key == key) {
           if (v[v_offset] == *reinterpret_cast<D*>(dest->default_val)) { // remove zero value
 
-            NM_FREE(remove_by_node(l, (prev ? prev : l->first), node));
+            remove_node(l, prev, node);
 
             if (prev) node = prev->next ? prev->next : NULL;
             else      node = l->first   ? l->first   : NULL;
@@ -493,26 +508,23 @@ static bool slice_set(LIST_STORAGE* dest, LIST* l, size_t* coords, size_t* lengt
             node = node->next ? node->next : NULL;
           }
         } else if (node->key > key) {
-          D* nv = NM_ALLOC(D); *nv = v[v_offset++];
+          if (prev) node = insert_after(l, prev, key, &v[v_offset++]);
+          else      node = insert_first_node(l, key, &v[v_offset++]);
           if (dest->dtype == nm::RUBYOBJ) {
-            nm_register_value(&*reinterpret_cast<VALUE*>(nv));
-            temp_vals.push_front(reinterpret_cast<VALUE*>(nv));
+            nm_register_value(&*reinterpret_cast<VALUE*>(node->val));
+            temp_vals.push_front(reinterpret_cast<VALUE*>(node->val));
           }
 
-          if (prev) node = insert_after(prev, key, nv);
-          else      node = insert_first_node(l, key, nv, sizeof(D));
-
           prev = node;
           node = prev->next ? prev->next : NULL;
         }
       } else { // no node -- insert a new one
-        D* nv = NM_ALLOC(D); *nv = v[v_offset++];
+        if (prev) node = insert_after(l, prev, key, &v[v_offset++]);
+        else      node = insert_first_node(l, key, &v[v_offset++]);
         if (dest->dtype == nm::RUBYOBJ) {
-          nm_register_value(&*reinterpret_cast<VALUE*>(nv));
-          temp_vals.push_front(reinterpret_cast<VALUE*>(nv));
+          nm_register_value(&*reinterpret_cast<VALUE*>(node->val));
+          temp_vals.push_front(reinterpret_cast<VALUE*>(node->val));
         }
-        if (prev) node = insert_after(prev, key, nv);
-        else      node = insert_first_node(l, key, nv, sizeof(D));
 
         prev = node;
         node = prev->next ? prev->next : NULL;
@@ -635,7 +647,7 @@ LIST_STORAGE* nm_list_storage_create(nm::dtype_t dtype, size_t* shape, size_t di
   s->offset = NM_ALLOC_N(size_t, s->dim);
   memset(s->offset, 0, s->dim * sizeof(size_t));
 
-  s->rows  = nm::list::create();
+  s->rows  = nm::list::create(nm::list::create_arena(DTYPE_SIZES[dtype]));
   if (init_val)
     s->default_val = init_val;
   else {
@@ -655,7 +667,10 @@ void nm_list_storage_delete(STORAGE* s) {
   if (s) {
     LIST_STORAGE* storage = (LIST_STORAGE*)s;
     if (storage->count-- == 1) {
-      nm::list::del( storage->rows, storage->dim - 1 );
+      // Every list and node came out of the arena, so this frees them all without a walk. Only Ruby objects need one,
+      // to make sure none of them is left registered with the GC.
+      if (storage->dtype == nm::RUBYOBJ) completely_unregister_list(storage->rows, storage->dim - 1);
+      nm::list::del_arena( storage->rows->arena );
 
       NM_FREE(storage->shape);
       NM_FREE(storage->offset);
@@ -722,6 +737,16 @@ void nm_list_storage_completely_unregister_node(const NODE* curr) {
   nm_completely_unregister_value(&*reinterpret_cast<VALUE*>(curr->val));
 }
 
+/*
+ * As nm_list_storage_completely_unregister_node, for every node of a list.
+ */
+static void completely_unregister_list(const LIST* list, size_t recursions) {
+  for (const NODE* curr = list->first; curr; curr = curr->next) {
+    if (recursions == 0) nm_list_storage_completely_unregister_node(curr);
+    else                 completely_unregister_list(reinterpret_cast<const LIST*>(curr->val), recursions - 1);
+  }
+}
+
 void nm_list_storage_register_list(const LIST* list, size_t recursions) {
   NODE* next;
   if (!list) return;
@@ -1071,15 +1096,14 @@ VALUE nm_list_map_merged_stored(VALUE left, VALUE right, VALUE init) {
 
 
 /*
- * Copy a slice of a list matrix into a regular list matrix.
+ * Copy a slice of a list matrix into dst_rows, an empty list of a regular list matrix.
  */
-static LIST* slice_copy(const LIST_STORAGE* src, LIST* src_rows, size_t* coords, size_t* lengths, size_t n) {
+static void slice_copy(const LIST_STORAGE* src, LIST* src_rows, LIST* dst_rows, size_t* coords, size_t* lengths, size_t n) {
   nm_list_storage_register(src);
-  void *val = NULL;
   int key;
 
-  LIST* dst_rows = nm::list::create();
   NODE* src_node = src_rows->first;
+  NODE* dst_node = NULL;
   std::list<VALUE*> temp_vals;
   std::list<LIST*> temp_lists;
   while (src_node) {
@@ -1087,24 +1111,28 @@ static LIST* slice_copy(const LIST_STORAGE* src, LIST* src_rows, size_t* coords,
 
     if (key >= 0 && (size_t)key < lengths[n]) {
       if (src->dim - n > 1) {
-        val = slice_copy( src,
-                          reinterpret_cast<LIST*>(src_node->val),
-                          coords,
-                          lengths,
-                          n + 1    );
-        if (val) {
+        LIST* val = nm::list::create(dst_rows->arena);
+        slice_copy( src,
+                    reinterpret_cast<LIST*>(src_node->val),
+                    val,
+                    coords,
+                    lengths,
+                    n + 1    );
+        if (!val->first) nm::list::del(val, 0); // empty list -- don't insert
+        else {
           if (src->dtype == nm::RUBYOBJ) {
-            nm_list_storage_register_list(reinterpret_cast<LIST*>(val), src->dim - n - 2);
-            temp_lists.push_front(reinterpret_cast<LIST*>(val));
+            nm_list_storage_register_list(val, src->dim - n - 2);
+            temp_lists.push_front(val);
           }
-          nm::list::insert_copy(dst_rows, false, key, val, sizeof(LIST));
+          dst_node = nm::list::insert_helper(dst_rows, dst_node, key, val);
         }
       } else { // matches src->dim - n > 1
         if (src->dtype == nm::RUBYOBJ) {
           nm_register_value(&*reinterpret_cast<VALUE*>(src_node->val));
           temp_vals.push_front(reinterpret_cast<VALUE*>(src_node->val));
         }
-        nm::list::insert_copy(dst_rows, false, key, src_node->val, DTYPE_SIZES[src->dtype]);
+        if (dst_node) dst_node = nm::list::insert_after(dst_rows, dst_node, key, src_node->val);
+        else          dst_node = nm::list::insert(dst_rows, false, key, src_node->val);
       }
     }
     src_node = src_node->next;
@@ -1114,7 +1142,6 @@ static LIST* slice_copy(const LIST_STORAGE* src, LIST* src_rows, size_t* coords,
     __nm_list_storage_unregister_temp_value_list(temp_vals);
   }
   nm_list_storage_unregister(src);
-  return dst_rows;
 }
 
 /*
@@ -1141,7 +1168,7 @@ void* nm_list_storage_get(const STORAGE* storage, SLICE* slice) {
 
     ns = nm_list_storage_create(s->dtype, shape, s->dim, init_val);
 
-    ns->rows = slice_copy(s, s->rows, slice->coords, slice->lengths, 0);
+    slice_copy(s, s->rows, ns->rows, slice->coords, slice->lengths, 0);
 
     if (s->dtype == nm::RUBYOBJ) {
       nm_unregister_value(&*reinterpret_cast<VALUE*>(init_val));
@@ -1211,9 +1238,9 @@ static void slice_set_single(LIST_STORAGE* dest, LIST* l, void* val, size_t* coo
 
       if (!node) {
         // try to insert list
-        node = nm::list::insert(l, false, key, nm::list::create());
+        node = nm::list::insert_list(l, key, nm::list::create(l->arena));
       } else if (!node->next || (node->next && node->next->key > key)) {
-        node = nm::list::insert_after(node, key, nm::list::create());
+        node = nm::list::insert_list_after(l, node, key, nm::list::create(l->arena));
       } else {
         node = node->next; // correct rank already exists.
       }
@@ -1234,9 +1261,9 @@ static void slice_set_single(LIST_STORAGE* dest, LIST* l, void* val, size_t* coo
       size_t key = i + dest->offset[n] + coords[n];
 
       if (!node)  {
-        node = nm::list::insert_copy(l, true, key, val, DTYPE_SIZES[dest->dtype]);
+        node = nm::list::insert(l, true, key, val);
       } else {
-        node = nm::list::replace_insert_after(node, key, val, true, DTYPE_SIZES[dest->dtype]);
+        node = nm::list::replace_insert_after(l, node, key, val);
       }
       if (dest->dtype == nm::RUBYOBJ) {
         temp_vals.push_front(reinterpret_cast<VALUE*>(node->val));
@@ -1265,7 +1292,7 @@ void nm_list_storage_set(VALUE left, SLICE* slice, VALUE right) {
 
 
 /*
- * Insert an entry directly in a row (not using copy! don't free after).
+ * Insert an entry directly in a row. The value is copied into the node, so the caller keeps val.
  *
  * Returns a pointer to the insertion location.
  *
@@ -1285,7 +1312,7 @@ NODE* nm_list_storage_insert(STORAGE* storage, SLICE* slice, void* val) {
 
   // drill down into the structure
   for (r = 0; r < s->dim -1; ++r) {
-    n = nm::list::insert(l, false, s->offset[r] + slice->coords[s->dim - r], nm::list::create());
+    n = nm::list::insert_list(l, s->offset[r] + slice->coords[s->dim - r], nm::list::create(l->arena));
     l = reinterpret_cast<LIST*>(n->val);
   }
 
@@ -1333,12 +1360,30 @@ bool nm_list_storage_eqeq(const STORAGE* left, const STORAGE* right) {
  * List storage matrix multiplication.
  */
 STORAGE* nm_list_storage_matrix_multiply(const STORAGE_PAIR& casted_storage, size_t* resulting_shape, bool vector) {
-  free(resulting_shape);
-  rb_raise(rb_eNotImpError, "multiplication not implemented for list-of-list matrices");
-  return NULL;
-  //DTYPE_TEMPLATE_TABLE(dense_storage::matrix_multiply, NMATRIX*, STORAGE_PAIR, size_t*, bool);
+  DTYPE_TEMPLATE_TABLE(nm::list_storage::matrix_multiply, STORAGE*, const STORAGE_PAIR& casted_storage, size_t* resulting_shape, bool vector);
 
-  //return ttable[reinterpret_cast<DENSE_STORAGE*>(casted_storage.left)->dtype](casted_storage, resulting_shape, vector);
+  nm::dtype_t dtype = casted_storage.left->dtype;
+  if (dtype == nm::RUBYOBJ || casted_storage.left->dim != 2 || casted_storage.right->dim != 2) {
+    NM_FREE(resulting_shape);
+    rb_raise(rb_eNotImpError, "multiplication of list matrices is only implemented for two-dimensional, non-object matrices");
+  }
+
+  return ttable[dtype](casted_storage, resulting_shape, vector);
+}
+
+/*
+ * List-by-dense matrix multiplication. The result is dense.
+ */
+STORAGE* nm_list_storage_matrix_multiply_dense(const STORAGE_PAIR& casted_storage, size_t* resulting_shape) {
+  DTYPE_TEMPLATE_TABLE(nm::list_storage::matrix_multiply_dense, STORAGE*, const STORAGE_PAIR& casted_storage, size_t* resulting_shape);
+
+  nm::dtype_t dtype = casted_storage.left->dtype;
+  if (dtype == nm::RUBYOBJ || casted_storage.left->dim != 2 || casted_storage.right->dim != 2) {
+    NM_FREE(resulting_shape);
+    rb_raise(rb_eNotImpError, "multiplication of list matrices is only implemented for two-dimensional, non-object matrices");
+  }
+
+  return ttable[dtype](casted_storage, resulting_shape);
 }
 
 
@@ -1427,7 +1472,7 @@ LIST_STORAGE* nm_list_storage_copy(const LIST_STORAGE* rhs) {
   LIST_STORAGE* lhs = nm_list_storage_create(rhs->dtype, shape, rhs->dim, init_val);
   nm_list_storage_register(lhs);
 
-  lhs->rows = slice_copy(rhs, rhs->rows, lhs->offset, lhs->shape, 0);
+  slice_copy(rhs, rhs->rows, lhs->rows, lhs->offset, lhs->shape, 0);
 
   nm_list_storage_unregister(rhs);
   nm_list_storage_unregister(lhs);
@@ -1598,6 +1643,253 @@ static bool eqeq_r(RecurseData& left, RecurseData& right, const LIST* l, const L
 }
 
 
+/*
+ * Recursive helper for ew_merge_with. Merges the sorted lists l and r (either of which may be NULL, meaning empty) into
+ * x, applying op to each pair of values. A key present in only one of the two is paired with the other's default.
+ * Only results which differ from def are stored, and sub-lists which end up empty are dropped.
+ */
+template <typename DType, typename Op>
+static void ew_merge_r(LIST* x, const LIST* l, const LIST* r, size_t rec, const DType& ldef, const DType& rdef, const DType& def, Op op) {
+  NODE *lcurr = l ? l->first : NULL,
+       *rcurr = r ? r->first : NULL,
+       *xcurr = NULL;
+
+  while (lcurr || rcurr) {
+    size_t      key;
+    const void *lval = NULL,
+               *rval = NULL;
+
+    if (!rcurr || (lcurr && lcurr->key < rcurr->key)) {
+      key   = lcurr->key;
+      lval  = lcurr->val;
+      lcurr = lcurr->next;
+    } else if (!lcurr || rcurr->key < lcurr->key) {
+      key   = rcurr->key;
+      rval  = rcurr->val;
+      rcurr = rcurr->next;
+    } else { // == and both present
+      key   = lcurr->key;
+      lval  = lcurr->val;
+      rval  = rcurr->val;
+      lcurr = lcurr->next;
+      rcurr = rcurr->next;
+    }
+
+    if (rec) {
+      LIST* val = nm::list::create(x->arena);
+      ew_merge_r<DType>(val, reinterpret_cast<const LIST*>(lval), reinterpret_cast<const LIST*>(rval), rec-1, ldef, rdef, def, op);
+
+      if (!val->first) nm::list::del(val, 0); // empty list -- don't insert
+      else             xcurr = nm::list::insert_helper(x, xcurr, key, val);
+    } else {
+      DType val = op(lval ? *reinterpret_cast<const DType*>(lval) : ldef,
+                     rval ? *reinterpret_cast<const DType*>(rval) : rdef);
+
+      if (val != def) xcurr = nm::list::insert_helper(x, xcurr, key, val);
+    }
+  }
+}
+
+
+/*
+ * Element-wise operation on two (non-reference) list matrices of the same shape and dtype, done by merging their
+ * nested lists directly. The result's default is op applied to the two defaults.
+ */
+template <typename DType, typename Op>
+static LIST_STORAGE* ew_merge_with(const LIST_STORAGE* l, const LIST_STORAGE* r, Op op) {
+  const DType& ldef = *reinterpret_cast<const DType*>(l->default_val);
+  const DType& rdef = *reinterpret_cast<const DType*>(r->default_val);
+
+  DType* def = NM_ALLOC(DType);
+  *def       = op(ldef, rdef);
+
+  size_t* shape = NM_ALLOC_N(size_t, l->dim);
+  memcpy(shape, l->shape, sizeof(size_t) * l->dim);
+
+  LIST_STORAGE* s = nm_list_storage_create(l->dtype, shape, l->dim, def);
+  ew_merge_r<DType>(s->rows, l->rows, r->rows, l->dim - 1, ldef, rdef, *def, op);
+
+  return s;
+}
+
+template <typename DType>
+static LIST_STORAGE* ew_merge(const LIST_STORAGE* l, const LIST_STORAGE* r, nm::ewop_t op) {
+  switch(op) {
+  case nm::EW_ADD: return ew_merge_with<DType>(l, r, ew_add<DType>());
+  case nm::EW_SUB: return ew_merge_with<DType>(l, r, ew_sub<DType>());
+  case nm::EW_MUL: return ew_merge_with<DType>(l, r, ew_mul<DType>());
+  default:         rb_raise(rb_eNotImpError, "no native list implementation of this element-wise operation");
+  }
+  return NULL;
+}
+
+
+/*
+ * Recursive helper for ew_scalar_with.
+ */
+template <typename DType, typename Op>
+static void ew_scalar_r(LIST* x, const LIST* l, size_t rec, const DType& scalar, const DType& def, Op op) {
+  NODE* xcurr = NULL;
+
+  for (const NODE* lcurr = l->first; lcurr; lcurr = lcurr->next) {
+    if (rec) {
+      LIST* val = nm::list::create(x->arena);
+      ew_scalar_r<DType>(val, reinterpret_cast<const LIST*>(lcurr->val), rec-1, scalar, def, op);
+
+      if (!val->first) nm::list::del(val, 0);
+      else             xcurr = nm::list::insert_helper(x, xcurr, lcurr->key, val);
+    } else {
+      DType val = op(*reinterpret_cast<const DType*>(lcurr->val), scalar);
+      if (val != def) xcurr = nm::list::insert_helper(x, xcurr, lcurr->key, val);
+    }
+  }
+}
+
+
+/*
+ * Element-wise operation of a (non-reference) list matrix with a scalar of the same dtype.
+ */
+template <typename DType, typename Op>
+static LIST_STORAGE* ew_scalar_with(const LIST_STORAGE* l, const DType& scalar, Op op) {
+  DType* def = NM_ALLOC(DType);
+  *def       = op(*reinterpret_cast<const DType*>(l->default_val), scalar);
+
+  size_t* shape = NM_ALLOC_N(size_t, l->dim);
+  memcpy(shape, l->shape, sizeof(size_t) * l->dim);
+
+  LIST_STORAGE* s = nm_list_storage_create(l->dtype, shape, l->dim, def);
+  ew_scalar_r<DType>(s->rows, l->rows, l->dim - 1, scalar, *def, op);
+
+  return s;
+}
+
+template <typename DType>
+static LIST_STORAGE* ew_scalar(const LIST_STORAGE* l, const void* scalar_, nm::ewop_t op) {
+  const DType& scalar = *reinterpret_cast<const DType*>(scalar_);
+  switch(op) {
+  case nm::EW_ADD: return ew_scalar_with<DType>(l, scalar, ew_add<DType>());
+  case nm::EW_SUB: return ew_scalar_with<DType>(l, scalar, ew_sub<DType>());
+  case nm::EW_MUL: return ew_scalar_with<DType>(l, scalar, ew_mul<DType>());
+  default:         rb_raise(rb_eNotImpError, "no native list implementation of this element-wise operation");
+  }
+  return NULL;
+}
+
+
+/*
+ * Product of two (non-reference) 2-D list matrices of the same dtype, both with zero defaults. Works a row at a time:
+ * each row of the left matrix is multiplied into a dense accumulator row, and the columns it touched are then
+ * gathered, in order, into the result's row list.
+ */
+template <typename DType>
+static STORAGE* matrix_multiply(const STORAGE_PAIR& casted_storage, size_t* resulting_shape, bool vector) {
+  const LIST_STORAGE* left  = reinterpret_cast<const LIST_STORAGE*>(casted_storage.left);
+  const LIST_STORAGE* right = reinterpret_cast<const LIST_STORAGE*>(casted_storage.right);
+  const DType zero(0);
+
+  if (*reinterpret_cast<const DType*>(left->default_val) != zero || *reinterpret_cast<const DType*>(right->default_val) != zero) {
+    NM_FREE(resulting_shape);
+    rb_raise(rb_eNotImpError, "multiplication of list matrices requires default values of zero");
+  }
+
+  // Index the right-hand rows, so they can be found without a search.
+  std::vector<const LIST*> right_rows(right->shape[0], NULL);
+  for (const NODE* k = right->rows->first; k; k = k->next) {
+    right_rows[k->key] = reinterpret_cast<const LIST*>(k->val);
+  }
+
+  DType* default_val = NM_ALLOC(DType);
+  *default_val       = zero;
+  LIST_STORAGE* result = nm_list_storage_create(left->dtype, resulting_shape, 2, default_val);
+
+  std::vector<DType>  acc(resulting_shape[1], zero);
+  std::vector<bool>   touched(resulting_shape[1], false);
+  std::vector<size_t> cols;
+  NODE* last_row = NULL;
+
+  for (const NODE* i = left->rows->first; i; i = i->next) {
+    cols.clear();
+
+    for (const NODE* k = reinterpret_cast<const LIST*>(i->val)->first; k; k = k->next) {
+      const LIST* right_row = right_rows[k->key];
+      if (!right_row) continue;
+
+      const DType& a = *reinterpret_cast<const DType*>(k->val);
+      for (const NODE* j = right_row->first; j; j = j->next) {
+        if (!touched[j->key]) {
+          touched[j->key] = true;
+          acc[j->key]     = zero;
+          cols.push_back(j->key);
+        }
+        acc[j->key] = acc[j->key] + a * *reinterpret_cast<const DType*>(j->val);
+      }
+    }
+
+    if (cols.empty()) continue;
+    std::sort(cols.begin(), cols.end());
+
+    LIST* row  = nm::list::create(result->rows->arena);
+    NODE* last = NULL;
+    for (std::vector<size_t>::const_iterator j = cols.begin(); j != cols.end(); ++j) {
+      touched[*j] = false;
+      if (acc[*j] != zero) last = nm::list::insert_helper(row, last, *j, acc[*j]);
+    }
+
+    if (!row->first) nm::list::del(row, 0);
+    else             last_row = nm::list::insert_helper(result->rows, last_row, i->key, row);
+  }
+
+  return reinterpret_cast<STORAGE*>(result);
+}
+
+
+/*
+ * Product of a (non-reference) 2-D list matrix and a dense matrix of the same dtype, giving a dense matrix. Each stored
+ * entry a_ik adds (a_ik - default) times row k of the right-hand matrix into row i of the result; a non-zero default
+ * is accounted for up front by starting every row from default times the column sums of the right-hand matrix.
+ */
+template <typename DType>
+static STORAGE* matrix_multiply_dense(const STORAGE_PAIR& casted_storage, size_t* resulting_shape) {
+  const LIST_STORAGE*  left  = reinterpret_cast<const LIST_STORAGE*>(casted_storage.left);
+  const DENSE_STORAGE* right = reinterpret_cast<const DENSE_STORAGE*>(casted_storage.right);
+  const DType* b    = reinterpret_cast<const DType*>(right->elements);
+  const size_t m    = resulting_shape[0],
+               n    = resulting_shape[1],
+               kmax = right->shape[0];
+  const DType  zero(0);
+  const DType& def  = *reinterpret_cast<const DType*>(left->default_val);
+
+  DType* c = NM_ALLOC_N(DType, m * n);
+
+  if (def == zero) {
+    std::fill(c, c + m * n, zero);
+  } else {
+    std::vector<DType> col_sums(n, zero);
+    for (size_t k = 0; k < kmax; ++k)
+      for (size_t j = 0; j < n; ++j)
+        col_sums[j] = col_sums[j] + b[k*n + j];
+
+    for (size_t i = 0; i < m; ++i)
+      for (size_t j = 0; j < n; ++j)
+        c[i*n + j] = def * col_sums[j];
+  }
+
+  for (const NODE* i = left->rows->first; i; i = i->next) {
+    DType* c_row = c + i->key * n;
+
+    for (const NODE* k = reinterpret_cast<const LIST*>(i->val)->first; k; k = k->next) {
+      const DType  a     = *reinterpret_cast<const DType*>(k->val) - def;
+      const DType* b_row = b + k->key * n;
+      if (a == zero) continue;
+
+      for (size_t j = 0; j < n; ++j) c_row[j] = c_row[j] + a * b_row[j];
+    }
+  }
+
+  return reinterpret_cast<STORAGE*>(nm_dense_storage_create(left->dtype, resulting_shape, 2, c, m * n));
+}
+
+
 }} // end of namespace nm::list_storage
 
 extern "C" {
@@ -1625,4 +1917,72 @@ extern "C" {
     NM_CONSERVATIVE(nm_unregister_value(&self));
     return to_return;
   }
+
+  /*
+   * Return matrix's storage as a non-reference of the given dtype, making a copy only if necessary. Free it with
+   * nm_list_storage_delete if it isn't the original.
+   */
+  static LIST_STORAGE* storage_as_dtype(VALUE matrix, nm::dtype_t dtype) {
+    LIST_STORAGE* s = NM_STORAGE_LIST(matrix);
+    if (s->dtype == dtype && s->src == s) return s;
+    return reinterpret_cast<LIST_STORAGE*>(nm_list_storage_cast_copy(reinterpret_cast<STORAGE*>(s), dtype, NULL));
+  }
+
+  /*
+   * call-seq:
+   *     __list_ew_merge__(rhs, op) -> NMatrix or nil
+   *
+   * Element-wise +op+ (:add, :sub, or :mul) of two list matrices of the same shape, done natively. Returns nil if this
+   * can't be handled natively (other operations, or :object matrices); the caller should then fall back on
+   * __list_map_merged_stored__.
+   */
+  VALUE nm_list_ew_merge(VALUE left, VALUE right, VALUE op) {
+    NAMED_DTYPE_TEMPLATE_TABLE(ttable, nm::list_storage::ew_merge, LIST_STORAGE*, const LIST_STORAGE*, const LIST_STORAGE*, nm::ewop_t)
+
+    nm::ewop_t ewop;
+    if (!nm_native_ewop(op, ewop)) return Qnil;
+
+    nm::dtype_t dtype = Upcast[NM_DTYPE(left)][NM_DTYPE(right)];
+    if (dtype == nm::RUBYOBJ) return Qnil;
+
+    LIST_STORAGE* l = storage_as_dtype(left, dtype);
+    LIST_STORAGE* r = storage_as_dtype(right, dtype);
+
+    LIST_STORAGE* s = ttable[dtype](l, r, ewop);
+
+    if (l != NM_STORAGE_LIST(left))  nm_list_storage_delete(reinterpret_cast<STORAGE*>(l));
+    if (r != NM_STORAGE_LIST(right)) nm_list_storage_delete(reinterpret_cast<STORAGE*>(r));
+
+    NMATRIX* m = nm_create(nm::LIST_STORE, reinterpret_cast<STORAGE*>(s));
+    return Data_Wrap_Struct(CLASS_OF(left), nm_mark, nm_delete, m);
+  }
+
+  /*
+   * call-seq:
+   *     __list_ew_scalar__(scalar, op) -> NMatrix or nil
+   *
+   * Element-wise +op+ (:add, :sub, or :mul) of a list matrix with a scalar, done natively. Returns nil if this can't be
+   * handled natively, in which case the caller should fall back on __list_map_merged_stored__.
+   */
+  VALUE nm_list_ew_scalar(VALUE left, VALUE scalar, VALUE op) {
+    NAMED_DTYPE_TEMPLATE_TABLE(ttable, nm::list_storage::ew_scalar, LIST_STORAGE*, const LIST_STORAGE*, const void*, nm::ewop_t)
+
+    nm::ewop_t ewop;
+    if (!nm_native_ewop(op, ewop)) return Qnil;
+    if (!NM_RUBYVAL_IS_NUMERIC(scalar)) return Qnil;
+
+    nm::dtype_t dtype = Upcast[NM_DTYPE(left)][nm_dtype_min(scalar)];
+    if (dtype == nm::RUBYOBJ) return Qnil;
+
+    LIST_STORAGE* l = storage_as_dtype(left, dtype);
+    void*         x = rubyobj_to_cval(scalar, dtype);
+
+    LIST_STORAGE* s = ttable[dtype](l, x, ewop);
+
+    NM_FREE(x);
+    if (l != NM_STORAGE_LIST(left)) nm_list_storage_delete(reinterpret_cast<STORAGE*>(l));
+
+    NMATRIX* m = nm_create(nm::LIST_STORE, reinterpret_cast<STORAGE*>(s));
+    return Data_Wrap_Struct(CLASS_OF(left), nm_mark, nm_delete, m);
+  }
 } // end of extern "C" block
@@ -102,6 +102,7 @@ extern "C" {
   //////////
 
   STORAGE* nm_list_storage_matrix_multiply(const STORAGE_PAIR& casted_storage, size_t* resulting_shape, bool vector);
+  STORAGE* nm_list_storage_matrix_multiply_dense(const STORAGE_PAIR& casted_storage, size_t* resulting_shape);
 
 
   /////////////
@@ -132,6 +133,8 @@ extern "C" {
   VALUE nm_list_map_merged_stored(VALUE left, VALUE right, VALUE init);
   VALUE nm_list_map_stored(VALUE left, VALUE init);
   VALUE nm_list_default_value(VALUE self);
+  VALUE nm_list_ew_merge(VALUE left, VALUE right, VALUE op);
+  VALUE nm_list_ew_scalar(VALUE left, VALUE scalar, VALUE op);
 } // end of extern "C" block
 
 #endif // LIST_H
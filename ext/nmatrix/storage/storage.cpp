@@ -29,6 +29,8 @@
  * Standard Includes
  */
 
+#include <vector>
+
 /*
  * Project Includes
  */
@@ -75,15 +77,39 @@ namespace nm {
 namespace dense_storage {
 
 template <typename LDType, typename RDType>
-static void cast_copy_list_contents(LDType* lhs, const LIST* rhs, RDType* default_val,
-  size_t& pos, const size_t* shape, size_t dim, size_t max_elements, size_t recursions);
+static void cast_copy_list_contents(LDType* lhs, const LIST* rhs, size_t pos, const size_t* stride,
+  const size_t* offset, const size_t* shape, size_t dim, size_t recursions);
 
-template <typename LDType, typename RDType>
-static void cast_copy_list_default(LDType* lhs, RDType* default_val, size_t& pos,
-  const size_t* shape, size_t dim, size_t max_elements, size_t recursions);
+}
+
+
+/*
+ * Get the first node of a list whose key is at least +bound+. For unsliced storage the bound is always zero,
+ * so this is just list->first; otherwise the skip-list index gets us there without walking.
+ */
+static inline NODE* first_node_from(const LIST* l, size_t bound) {
+  if (!bound || !l->first || l->first->key >= bound) return l->first;
+  NODE* prev = list::find_preceding_from_list(const_cast<LIST*>(l), bound);
+  return prev ? prev->next : l->first;
+}
+
+/*
+ * Pointer to the first element of row +i+ of a (possibly sliced) 2D dense matrix. Rows of dense storage are always
+ * contiguous, so a slice only changes where each row starts.
+ */
+template <typename DType>
+static inline DType* dense_row(const DENSE_STORAGE* s, size_t i) {
+  return reinterpret_cast<DType*>(s->elements) + s->stride[0] * (i + s->offset[0]) + s->offset[1];
+}
+
+
+namespace dense_storage {
 
 /*
  * Convert (by creating a copy) from list storage to dense storage.
+ *
+ * The result is filled with the default value first, and then the stored entries which fall within the (possibly
+ * sliced) source are scattered into place. Slices are read directly rather than copied first.
  */
 template <typename LDType, typename RDType>
 DENSE_STORAGE* create_from_list_storage(const LIST_STORAGE* rhs, dtype_t l_dtype) {
@@ -93,37 +119,27 @@ DENSE_STORAGE* create_from_list_storage(const LIST_STORAGE* rhs, dtype_t l_dtype
   memcpy(shape, rhs->shape, rhs->dim * sizeof(size_t));
 
   DENSE_STORAGE* lhs = nm_dense_storage_create(l_dtype, shape, rhs->dim, NULL, 0);
+  LDType* lhs_elements = reinterpret_cast<LDType*>(lhs->elements);
 
-  // Position in lhs->elements.
-  size_t pos = 0;
-  size_t max_elements = nm_storage_count_max_elements(rhs);
-
-//static void dense_storage_cast_copy_list_contents_template(LDType* lhs, const LIST* rhs, RDType* default_val, size_t& pos, const size_t* shape, size_t dim, size_t max_elements, size_t recursions)
-  // recursively copy the contents
-  if (rhs->src == rhs)
-    cast_copy_list_contents<LDType,RDType>(reinterpret_cast<LDType*>(lhs->elements),
-                                         rhs->rows,
-                                         reinterpret_cast<RDType*>(rhs->default_val),
-                                         pos, shape, lhs->dim, max_elements, rhs->dim-1);
-  else {
-    LIST_STORAGE *tmp = nm_list_storage_copy(rhs);
-    cast_copy_list_contents<LDType,RDType>(reinterpret_cast<LDType*>(lhs->elements),
-                                         tmp->rows,
-                                         reinterpret_cast<RDType*>(tmp->default_val),
-                                         pos, shape, lhs->dim, max_elements, tmp->dim-1);
-    nm_list_storage_delete(tmp);
+  size_t count = nm_storage_count_max_elements(lhs);
+
+  LDType default_val = static_cast<LDType>(*reinterpret_cast<RDType*>(rhs->default_val));
+  for (size_t p = 0; p < count; ++p) lhs_elements[p] = default_val;
+
+  cast_copy_list_contents<LDType,RDType>(lhs_elements, rhs->rows, 0, lhs->stride, rhs->offset, shape, rhs->dim, rhs->dim-1);
 
-  }
   nm_list_storage_unregister(rhs);
 
   return lhs;
 }
 
 
-
-
 /*
  * Create/allocate dense storage, copying into it the contents of a Yale matrix.
+ *
+ * Each row is filled with the default, the diagonal is placed, and then the row's stored entries are scattered into
+ * it. Unsliced sources read each row's entries straight from IJA; only slices need a binary search for the first
+ * column and a bound check for the last.
  */
 template <typename LDType, typename RDType>
 DENSE_STORAGE* create_from_yale_storage(const YALE_STORAGE* rhs, dtype_t l_dtype) {
@@ -141,60 +157,30 @@ DENSE_STORAGE* create_from_yale_storage(const YALE_STORAGE* rhs, dtype_t l_dtype
   DENSE_STORAGE* lhs = nm_dense_storage_create(l_dtype, shape, rhs->dim, NULL, 0);
   LDType* lhs_elements = reinterpret_cast<LDType*>(lhs->elements);
 
-  // Position in dense to write to.
-  size_t pos = 0;
+  LDType LCAST_ZERO = static_cast<LDType>(rhs_a[rhs->src->shape[0]]);
 
-  LDType LCAST_ZERO = rhs_a[rhs->src->shape[0]];
+  const bool   sliced = rhs->offset[1] > 0 || rhs->shape[1] < rhs->src->shape[1];
+  const IType  j_off  = rhs->offset[1],
+               j_end  = rhs->offset[1] + shape[1];
 
-  // Walk through rows. For each entry we set in dense, increment pos.
   for (size_t i = 0; i < shape[0]; ++i) {
-    IType ri = i + rhs->offset[0];
-
-    if (rhs_ija[ri] == rhs_ija[ri+1]) { // Check boundaries of row: is row empty? (Yes.)
-
-			// Write zeros in each column.
-			for (size_t j = 0; j < shape[1]; ++j) { // Move to next dense position.
-
-        // Fill in zeros and copy the diagonal entry for this empty row.
-        if (ri == j + rhs->offset[1]) lhs_elements[pos] = static_cast<LDType>(rhs_a[ri]);
-				else                          lhs_elements[pos] = LCAST_ZERO;
-
-				++pos;
-      }
-
-    } else {  // Row contains entries: write those in each column, interspersed with zeros.
-
-      // Get the first ija position of the row (as sliced)
-      IType ija = nm::yale_storage::binary_search_left_boundary(rhs, rhs_ija[ri], rhs_ija[ri+1]-1, rhs->offset[1]);
-
-      // What column is it?
-      IType next_stored_rj = rhs_ija[ija];
+    IType   ri  = i + rhs->offset[0];
+    LDType* row = lhs_elements + i * shape[1];
 
-			for (size_t j = 0; j < shape[1]; ++j) {
-			  IType rj = j + rhs->offset[1];
+    for (size_t j = 0; j < shape[1]; ++j) row[j] = LCAST_ZERO;
 
-        if (rj == ri) { // at a diagonal in RHS
-          lhs_elements[pos] = static_cast<LDType>(rhs_a[ri]);
+    if (ri >= j_off && ri < j_end) row[ri - j_off] = static_cast<LDType>(rhs_a[ri]);
 
-        } else if (rj == next_stored_rj) { // column ID was found in RHS
-          lhs_elements[pos] = static_cast<LDType>(rhs_a[ija]); // Copy from rhs.
+    IType ija = rhs_ija[ri], ija_next = rhs_ija[ri+1];
+    if (ija == ija_next) continue;
 
-          // Get next.
-          ++ija;
-
-          // Increment to next column ID (or go off the end).
-          if (ija < rhs_ija[ri+1]) next_stored_rj = rhs_ija[ija];
-          else               	     next_stored_rj = rhs->src->shape[1];
-
-        } else { // rj < next_stored_rj
-
-          // Insert zero.
-          lhs_elements[pos] = LCAST_ZERO;
-        }
-
-        // Move to next dense position.
-        ++pos;
-      }
+    if (sliced) {
+      ija = nm::yale_storage::binary_search_left_boundary(rhs, ija, ija_next-1, j_off);
+      for (; ija < ija_next && rhs_ija[ija] < j_end; ++ija)
+        row[rhs_ija[ija] - j_off] = static_cast<LDType>(rhs_a[ija]);
+    } else {
+      for (; ija < ija_next; ++ija)
+        row[rhs_ija[ija]] = static_cast<LDType>(rhs_a[ija]);
     }
   }
   nm_yale_storage_unregister(rhs);
@@ -204,54 +190,24 @@ DENSE_STORAGE* create_from_yale_storage(const YALE_STORAGE* rhs, dtype_t l_dtype
 
 
 /*
- * Copy list contents into dense recursively.
+ * Copy list contents into dense recursively. +pos+ is the position in +lhs+ of the first element of this sub-list's
+ * block; stored keys are shifted by +offset+ and anything outside of +shape+ is skipped.
  */
 template <typename LDType, typename RDType>
-static void cast_copy_list_contents(LDType* lhs, const LIST* rhs, RDType* default_val, size_t& pos, const size_t* shape, size_t dim, size_t max_elements, size_t recursions) {
-
-  NODE *curr = rhs->first;
-  int last_key = -1;
+static void cast_copy_list_contents(LDType* lhs, const LIST* rhs, size_t pos, const size_t* stride, const size_t* offset, const size_t* shape, size_t dim, size_t recursions) {
+  size_t d   = dim - 1 - recursions,
+         end = offset[d] + shape[d];
 
   nm_list_storage_register_list(rhs, recursions);
 
-  for (size_t i = 0; i < shape[dim - 1 - recursions]; ++i, ++pos) {
-
-    if (!curr || (curr->key > (size_t)(last_key+1))) {
+  for (NODE* curr = first_node_from(rhs, offset[d]); curr && curr->key < end; curr = curr->next) {
+    size_t p = pos + (curr->key - offset[d]) * stride[d];
 
-      if (recursions == 0)  lhs[pos] = static_cast<LDType>(*default_val);
-      else               		cast_copy_list_default<LDType,RDType>(lhs, default_val, pos, shape, dim, max_elements, recursions-1);
-
-      ++last_key;
-
-    } else {
-
-      if (recursions == 0)  lhs[pos] = static_cast<LDType>(*reinterpret_cast<RDType*>(curr->val));
-      else                	cast_copy_list_contents<LDType,RDType>(lhs, (const LIST*)(curr->val),
-                                                                                         default_val, pos, shape, dim, max_elements, recursions-1);
-
-      last_key = curr->key;
-      curr     = curr->next;
-    }
+    if (recursions == 0)  lhs[p] = static_cast<LDType>(*reinterpret_cast<RDType*>(curr->val));
+    else                  cast_copy_list_contents<LDType,RDType>(lhs, reinterpret_cast<const LIST*>(curr->val), p, stride, offset, shape, dim, recursions-1);
   }
 
   nm_list_storage_unregister_list(rhs, recursions);
-
-  --pos;
-}
-
-/*
- * Copy a set of default values into dense.
- */
-template <typename LDType,typename RDType>
-static void cast_copy_list_default(LDType* lhs, RDType* default_val, size_t& pos, const size_t* shape, size_t dim, size_t max_elements, size_t recursions) {
-  for (size_t i = 0; i < shape[dim - 1 - recursions]; ++i, ++pos) {
-
-    if (recursions == 0)    lhs[pos] = static_cast<LDType>(*default_val);
-    else                  	cast_copy_list_default<LDType,RDType>(lhs, default_val, pos, shape, dim, max_elements, recursions-1);
-
-  }
-
-  --pos;
 }
 
 
@@ -261,7 +217,7 @@ namespace list_storage {
 
 
 template <typename LDType, typename RDType>
-static bool cast_copy_contents_dense(LIST* lhs, const RDType* rhs, RDType* zero, size_t& pos, size_t* coords, const size_t* shape, size_t dim, size_t recursions);
+static bool cast_copy_contents_dense(LIST* lhs, const RDType* rhs, const RDType& zero, const size_t* stride, const size_t* offset, const size_t* shape, size_t dim, size_t recursions);
 
 /*
  * Creation of list storage from dense storage.
@@ -273,12 +229,9 @@ LIST_STORAGE* create_from_dense_storage(const DENSE_STORAGE* rhs, dtype_t l_dtyp
   LDType* l_default_val = NM_ALLOC_N(LDType, 1);
   RDType* r_default_val = NM_ALLOCA_N(RDType, 1); // clean up when finished with this function
 
-  // allocate and copy shape and coords
-  size_t *shape  = NM_ALLOC_N(size_t, rhs->dim),
-         *coords = NM_ALLOC_N(size_t, rhs->dim);
-
+  // allocate and copy shape
+  size_t *shape  = NM_ALLOC_N(size_t, rhs->dim);
   memcpy(shape, rhs->shape, rhs->dim * sizeof(size_t));
-  memset(coords, 0, rhs->dim * sizeof(size_t));
 
   // set list default_val to 0
   if (init) *l_default_val = *reinterpret_cast<LDType*>(init);
@@ -296,22 +249,12 @@ LIST_STORAGE* create_from_dense_storage(const DENSE_STORAGE* rhs, dtype_t l_dtyp
 
   nm_list_storage_register(lhs);
 
-  size_t pos = 0;
+  // Slices share their source's elements, so start from the slice's origin and walk with the source's strides.
+  const RDType* rhs_elements = reinterpret_cast<const RDType*>(rhs->elements);
+  for (size_t d = 0; d < rhs->dim; ++d) rhs_elements += rhs->offset[d] * rhs->stride[d];
 
-  if (rhs->src == rhs)
-    list_storage::cast_copy_contents_dense<LDType,RDType>(lhs->rows,
-                                                          reinterpret_cast<const RDType*>(rhs->elements),
-                                                        r_default_val,
-                                                        pos, coords, rhs->shape, rhs->dim, rhs->dim - 1);
-  else {
-    DENSE_STORAGE* tmp = nm_dense_storage_copy(rhs);
-    list_storage::cast_copy_contents_dense<LDType,RDType>(lhs->rows,
-                                                          reinterpret_cast<const RDType*>(tmp->elements),
-                                                        r_default_val,
-                                                        pos, coords, rhs->shape, rhs->dim, rhs->dim - 1);
-
-    nm_dense_storage_delete(tmp);
-  }
+  list_storage::cast_copy_contents_dense<LDType,RDType>(lhs->rows, rhs_elements, *r_default_val,
+                                                        rhs->stride, rhs->offset, rhs->shape, rhs->dim, rhs->dim - 1);
 
   nm_list_storage_unregister(lhs);
   nm_dense_storage_unregister(rhs);
@@ -323,9 +266,14 @@ LIST_STORAGE* create_from_dense_storage(const DENSE_STORAGE* rhs, dtype_t l_dtyp
 
 /*
  * Creation of list storage from yale storage.
+ *
+ * Each row's stored entries are appended in column order, with the diagonal merged in at its place. Only sliced
+ * sources need a binary search for the first column and a bound check on the last.
  */
 template <typename LDType, typename RDType>
 LIST_STORAGE* create_from_yale_storage(const YALE_STORAGE* rhs, dtype_t l_dtype) {
+  if (rhs->dim != 2)    rb_raise(nm_eStorageTypeError, "Can only convert matrices of dim 2 from yale.");
+
   // allocate and copy shape
   nm_yale_storage_register(rhs);
 
@@ -340,144 +288,110 @@ LIST_STORAGE* create_from_yale_storage(const YALE_STORAGE* rhs, dtype_t l_dtype)
   *default_val        = static_cast<LDType>(R_ZERO);
 
   LIST_STORAGE* lhs = nm_list_storage_create(l_dtype, shape, rhs->dim, default_val);
-
-  if (rhs->dim != 2)    rb_raise(nm_eStorageTypeError, "Can only convert matrices of dim 2 from yale.");
+  nm_list_storage_register(lhs);
 
   IType* rhs_ija  = reinterpret_cast<YALE_STORAGE*>(rhs->src)->ija;
 
+  const bool   sliced = rhs->offset[1] > 0 || rhs->shape[1] < rhs->src->shape[1];
+  const IType  j_off  = rhs->offset[1],
+               j_end  = rhs->offset[1] + shape[1];
+
   NODE *last_row_added = NULL;
-  // Walk through rows and columns as if RHS were a dense matrix
   for (IType i = 0; i < shape[0]; ++i) {
     IType ri = i + rhs->offset[0];
 
-    NODE *last_added = NULL;
-
     // Get boundaries of beginning and end of row
     IType ija      = rhs_ija[ri],
           ija_next = rhs_ija[ri+1];
 
-    // Are we going to need to add a diagonal for this row?
-    bool add_diag = false;
-    if (rhs_a[ri] != R_ZERO) add_diag = true; // non-zero and located within the bounds of the slice
-
-    if (ija < ija_next || add_diag) {
-      ija = nm::yale_storage::binary_search_left_boundary(rhs, ija, ija_next-1, rhs->offset[1]);
-
-      LIST* curr_row = list::create();
+    if (sliced && ija < ija_next) ija = nm::yale_storage::binary_search_left_boundary(rhs, ija, ija_next-1, j_off);
 
-      LDType* insert_val;
+    // Are we going to need to add a diagonal for this row? Only if it's non-zero and within the slice.
+    bool add_diag = ri >= j_off && ri < j_end && rhs_a[ri] != R_ZERO;
 
-      while (ija < ija_next) {
-        // Find first column in slice
-        IType rj = rhs_ija[ija];
-        IType j  = rj - rhs->offset[1];
+    if (!add_diag && (ija >= ija_next || rhs_ija[ija] >= j_end)) continue; // nothing stored in this row of the slice
 
-        // Is there a nonzero diagonal item between the previously added item and the current one?
-        if (rj > ri && add_diag) {
-          // Allocate and copy insertion value
-          insert_val  = NM_ALLOC_N(LDType, 1);
-          *insert_val = static_cast<LDType>(rhs_a[ri]);
+    LIST* curr_row    = list::create(lhs->rows->arena);
+    NODE* last_added  = NULL;
 
-          // Insert the item in the list at the appropriate location.
-          // What is the appropriate key? Well, it's definitely right(i)==right(j), but the
-          // rj index has already been advanced past ri. So we should treat ri as the column and
-          // subtract offset[1].
-          if (last_added) 	last_added = list::insert_after(last_added, ri - rhs->offset[1], insert_val);
-          else            	last_added = list::insert(curr_row, false,  ri - rhs->offset[1], insert_val);
-
-					// don't add again!
-          add_diag = false;
-        }
+    for (;; ++ija) {
+      bool  stored = ija < ija_next && rhs_ija[ija] < j_end;
+      IType rj     = stored ? rhs_ija[ija] : j_end;
 
-        // now allocate and add the current item
-        insert_val  = NM_ALLOC_N(LDType, 1);
-        *insert_val = static_cast<LDType>(rhs_a[ija]);
+      // Is the diagonal due before the current item (or are we out of items)?
+      if (add_diag && ri < rj) {
+        LDType insert_val = static_cast<LDType>(rhs_a[ri]);
 
-        if (last_added)    	last_added = list::insert_after(last_added, j, insert_val);
-        else              	last_added = list::insert(curr_row, false, j, insert_val);
+        if (last_added) 	last_added = list::insert_after(curr_row, last_added, ri - j_off, &insert_val);
+        else            	last_added = list::insert(curr_row, false, ri - j_off, &insert_val);
 
-        ++ija; // move to next entry in Yale matrix
+        add_diag = false; // don't add again!
       }
 
-      if (add_diag) {
+      if (!stored) break;
 
-      	// still haven't added the diagonal.
-        insert_val         = NM_ALLOC_N(LDType, 1);
-        *insert_val        = static_cast<LDType>(rhs_a[ri]);
+      LDType insert_val = static_cast<LDType>(rhs_a[ija]);
 
-        // insert the item in the list at the appropriate location
-        if (last_added)    	last_added = list::insert_after(last_added, ri - rhs->offset[1], insert_val);
-        else              	last_added = list::insert(curr_row, false, ri - rhs->offset[1], insert_val);
-
-        // no need to set add_diag to false because it'll be reset automatically in next iteration.
-      }
-
-      // Now add the list at the appropriate location
-      if (last_row_added)   last_row_added = list::insert_after(last_row_added, i, curr_row);
-      else                  last_row_added = list::insert(lhs->rows, false, i, curr_row);
+      if (last_added)    	last_added = list::insert_after(curr_row, last_added, rj - j_off, &insert_val);
+      else              	last_added = list::insert(curr_row, false, rj - j_off, &insert_val);
     }
 
-		// end of walk through rows
+    // Now add the list at the appropriate location
+    if (last_row_added)   last_row_added = list::insert_list_after(lhs->rows, last_row_added, i, curr_row);
+    else                  last_row_added = list::insert_list(lhs->rows, i, curr_row);
   }
 
+  nm_list_storage_unregister(lhs);
   nm_yale_storage_unregister(rhs);
 
   return lhs;
 }
 
 
-/* Copy dense into lists recursively
- *
- * FIXME: This works, but could probably be cleaner (do we really need to pass coords around?)
+/*
+ * Copy dense into lists recursively. +rhs+ points at the first element of the block being copied; +stride+ is the
+ * source's, so this works the same for slices. Returns true if anything was added to +lhs+.
  */
 template <typename LDType, typename RDType>
-static bool cast_copy_contents_dense(LIST* lhs, const RDType* rhs, RDType* zero, size_t& pos, size_t* coords, const size_t* shape, size_t dim, size_t recursions) {
+static bool cast_copy_contents_dense(LIST* lhs, const RDType* rhs, const RDType& zero, const size_t* stride, const size_t* offset, const size_t* shape, size_t dim, size_t recursions) {
 
   nm_list_storage_register_list(lhs, recursions);
 
-  NODE *prev = NULL;
-  LIST *sub_list;
-  bool added = false, added_list = false;
-  //void* insert_value;
+  size_t d    = dim - 1 - recursions;
+  NODE* prev  = NULL;
+  bool  added = false;
 
-  for (coords[dim-1-recursions] = 0; coords[dim-1-recursions] < shape[dim-1-recursions]; ++coords[dim-1-recursions], ++pos) {
+  for (size_t i = 0; i < shape[d]; ++i, rhs += stride[d]) {
 
     if (recursions == 0) {
-    	// create nodes
-
-      if (rhs[pos] != *zero) {
-      	// is not zero
+      if (*rhs == zero) continue; // no need to do anything if the element is zero
 
-        // Create a copy of our value that we will insert in the list
-        LDType* insert_value = NM_ALLOC_N(LDType, 1);
-        *insert_value        = static_cast<LDType>(rhs[pos]);
+      // The list keeps a copy of the value
+      LDType insert_value = static_cast<LDType>(*rhs);
 
-        if (!lhs->first)    prev = list::insert(lhs, false, coords[dim-1-recursions], insert_value);
-        else               	prev = list::insert_after(prev, coords[dim-1-recursions], insert_value);
+      if (!prev)    prev = list::insert(lhs, false, i, &insert_value);
+      else          prev = list::insert_after(lhs, prev, i, &insert_value);
 
-        added = true;
-      }
-      // no need to do anything if the element is zero
+      added = true;
 
     } else { // create lists
       // create a list as if there's something in the row in question, and then delete it if nothing turns out to be there
-      sub_list = list::create();
+      LIST* sub_list = list::create(lhs->arena);
 
-      added_list = list_storage::cast_copy_contents_dense<LDType,RDType>(sub_list, rhs, zero, pos, coords, shape, dim, recursions-1);
+      if (!list_storage::cast_copy_contents_dense<LDType,RDType>(sub_list, rhs, zero, stride, offset, shape, dim, recursions-1)) {
+        list::del(sub_list, recursions-1);
+        continue;
+      }
 
-      if (!added_list)      	list::del(sub_list, recursions-1);
-      else if (!lhs->first)  	prev = list::insert(lhs, false, coords[dim-1-recursions], sub_list);
-      else                  	prev = list::insert_after(prev, coords[dim-1-recursions], sub_list);
+      if (!prev)    prev = list::insert_list(lhs, i, sub_list);
+      else          prev = list::insert_list_after(lhs, prev, i, sub_list);
 
-      // added = (added || added_list);
+      added = true;
     }
   }
 
   nm_list_storage_unregister_list(lhs, recursions);
 
-  coords[dim-1-recursions] = 0;
-  --pos;
-
   return added;
 }
 
@@ -487,6 +401,10 @@ static bool cast_copy_contents_dense(LIST* lhs, const RDType* rhs, RDType* zero,
 namespace yale_storage { // FIXME: Move to yale.cpp
   /*
    * Creation of yale storage from dense storage.
+   *
+   * Done in two passes: the non-diagonal non-zeros of each row are counted into the IJA row pointers, which a prefix
+   * sum then turns into row starts, so that the result is allocated at exactly its final size and each row can be
+   * filled independently of the others.
    */
   template <typename LDType, typename RDType>
   YALE_STORAGE* create_from_dense_storage(const DENSE_STORAGE* rhs, dtype_t l_dtype, void* init) {
@@ -495,9 +413,6 @@ namespace yale_storage { // FIXME: Move to yale.cpp
 
     nm_dense_storage_register(rhs);
 
-    IType pos = 0;
-    IType ndnz = 0;
-
     // We need a zero value. This should nearly always be zero, but sometimes you might want false or nil.
     LDType    L_INIT(0);
     if (init) {
@@ -506,30 +421,38 @@ namespace yale_storage { // FIXME: Move to yale.cpp
     }
     RDType R_INIT = static_cast<RDType>(L_INIT);
 
-    RDType* rhs_elements = reinterpret_cast<RDType*>(rhs->elements);
+    const size_t rows = rhs->shape[0], cols = rhs->shape[1];
 
-    // First, count the non-diagonal nonzeros
-    for (size_t i = rhs->shape[0]; i-- > 0;) {
-      for (size_t j = rhs->shape[1]; j-- > 0;) {
-        pos = rhs->stride[0]*(i + rhs->offset[0]) + rhs->stride[1]*(j + rhs->offset[1]);
-        if (i != j && rhs_elements[pos] != R_INIT)	++ndnz;
+    // First pass: count the non-diagonal nonzeros of each row.
+    IType* row_count = NM_ALLOC_N(IType, rows + 1);
+    row_count[0]     = 0;
 
-        // move forward 1 position in dense matrix elements array
-      }
+    for (size_t i = 0; i < rows; ++i) {
+      const RDType* row = dense_row<RDType>(rhs, i);
+      IType count = 0;
+      for (size_t j = 0; j < cols; ++j)
+        if (row[j] != R_INIT && i != j) ++count;
+      row_count[i+1] = count;
     }
 
+    // Prefix sum: row_count[i] becomes the number of entries stored before row i.
+    for (size_t i = 0; i < rows; ++i) row_count[i+1] += row_count[i];
+    IType ndnz = row_count[rows];
+
     // Copy shape for yale construction
     size_t* shape = NM_ALLOC_N(size_t, 2);
-    shape[0] = rhs->shape[0];
-    shape[1] = rhs->shape[1];
+    shape[0] = rows;
+    shape[1] = cols;
 
     size_t request_capacity = shape[0] + ndnz + 1;
 
     // Create with minimum possible capacity -- just enough to hold all of the entries
     YALE_STORAGE* lhs = nm_yale_storage_create(l_dtype, shape, 2, request_capacity);
 
-    if (lhs->capacity < request_capacity)
+    if (lhs->capacity < request_capacity) {
+      NM_FREE(row_count);
       rb_raise(nm_eStorageTypeError, "conversion failed; capacity of %ld requested, max allowable is %ld", (unsigned long)request_capacity, (unsigned long)(lhs->capacity));
+    }
 
     LDType* lhs_a     = reinterpret_cast<LDType*>(lhs->a);
     IType* lhs_ija    = lhs->ija;
@@ -537,30 +460,25 @@ namespace yale_storage { // FIXME: Move to yale.cpp
     // Set the zero position in the yale matrix
     lhs_a[shape[0]]   = L_INIT;
 
-    // Start just after the zero position.
-    IType ija = shape[0]+1;
-    pos       = 0;
+    for (size_t i = 0; i <= rows; ++i) lhs_ija[i] = rows + 1 + row_count[i];
+    NM_FREE(row_count);
 
-    // Copy contents
-    for (IType i = 0; i < rhs->shape[0]; ++i) {
-      // indicate the beginning of a row in the IJA array
-      lhs_ija[i] = ija;
+    // Second pass: fill each row from its start.
+    for (size_t i = 0; i < rows; ++i) {
+      const RDType* row = dense_row<RDType>(rhs, i);
+      IType ija = lhs_ija[i];
 
-      for (IType j = 0; j < rhs->shape[1];  ++j) {
-        pos = rhs->stride[0] * (i + rhs->offset[0]) + rhs->stride[1] * (j + rhs->offset[1]); // calc position with offsets
+      lhs_a[i] = i < cols ? static_cast<LDType>(row[i]) : L_INIT; // diagonal
 
-        if (i == j) { // copy to diagonal
-          lhs_a[i]     = static_cast<LDType>(rhs_elements[pos]);
-        } else if (rhs_elements[pos] != R_INIT) { // copy nonzero to LU
+      for (size_t j = 0; j < cols; ++j) {
+        if (row[j] != R_INIT && i != j) { // copy nonzero to LU
           lhs_ija[ija] = j; // write column index
-          lhs_a[ija]   = static_cast<LDType>(rhs_elements[pos]);
-
+          lhs_a[ija]   = static_cast<LDType>(row[j]);
           ++ija;
         }
       }
     }
 
-    lhs_ija[shape[0]] = ija; // indicate the end of the last row
     lhs->ndnz = ndnz;
 
     nm_dense_storage_unregister(rhs);
@@ -570,6 +488,10 @@ namespace yale_storage { // FIXME: Move to yale.cpp
 
   /*
    * Creation of yale storage from list storage.
+   *
+   * Like the dense conversion, this counts each row's entries first and prefix-sums the counts into IJA, so that the
+   * result is allocated at exactly its final size and each row is filled in one pass. Slices are read directly,
+   * skipping to the first row and column within the slice.
    */
   template <typename LDType, typename RDType>
   YALE_STORAGE* create_from_list_storage(const LIST_STORAGE* rhs, nm::dtype_t l_dtype) {
@@ -584,59 +506,66 @@ namespace yale_storage { // FIXME: Move to yale.cpp
 
     nm_list_storage_register(rhs);
 
-    size_t ndnz = nm_list_storage_count_nd_elements(rhs);
+    const size_t rows  = rhs->shape[0], cols = rhs->shape[1],
+                 i_off = rhs->offset[0], j_off = rhs->offset[1];
+
+    // First pass: count the non-diagonal entries of each row within the slice.
+    IType* row_count = NM_ALLOC_N(IType, rows + 1);
+    memset(row_count, 0, sizeof(IType) * (rows + 1));
+
+    for (NODE* i_curr = first_node_from(rhs->rows, i_off); i_curr && i_curr->key < i_off + rows; i_curr = i_curr->next) {
+      size_t i     = i_curr->key - i_off;
+      IType  count = 0;
+      for (NODE* j_curr = first_node_from(reinterpret_cast<LIST*>(i_curr->val), j_off); j_curr && j_curr->key < j_off + cols; j_curr = j_curr->next)
+        if (j_curr->key - j_off != i) ++count;
+      row_count[i+1] = count;
+    }
+
+    // Prefix sum: row_count[i] becomes the number of entries stored before row i.
+    for (size_t i = 0; i < rows; ++i) row_count[i+1] += row_count[i];
+    size_t ndnz = row_count[rows];
+
     // Copy shape for yale construction
     size_t* shape = NM_ALLOC_N(size_t, 2);
-    shape[0] = rhs->shape[0];
-    shape[1] = rhs->shape[1];
+    shape[0] = rows;
+    shape[1] = cols;
 
     size_t request_capacity = shape[0] + ndnz + 1;
     YALE_STORAGE* lhs = nm_yale_storage_create(l_dtype, shape, 2, request_capacity);
 
-    if (lhs->capacity < request_capacity)
+    if (lhs->capacity < request_capacity) {
+      NM_FREE(row_count);
       rb_raise(nm_eStorageTypeError, "conversion failed; capacity of %ld requested, max allowable is %ld", (unsigned long)request_capacity, (unsigned long)(lhs->capacity));
+    }
 
-    // Initialize the A and IJA arrays
-    init<LDType>(lhs, rhs->default_val);
+    // Initialize the A array's diagonal and zero. The list's default is an RDType, so cast it first.
+    LDType l_default_val = static_cast<LDType>(*reinterpret_cast<const RDType*>(rhs->default_val));
+    init<LDType>(lhs, &l_default_val);
 
     IType*  lhs_ija = lhs->ija;
     LDType* lhs_a   = reinterpret_cast<LDType*>(lhs->a);
 
-    IType ija = lhs->shape[0]+1;
+    for (size_t i = 0; i <= rows; ++i) lhs_ija[i] = rows + 1 + row_count[i];
+    NM_FREE(row_count);
 
-    // Copy contents 
-    for (NODE* i_curr = rhs->rows->first; i_curr; i_curr = i_curr->next) {
+    // Second pass: copy contents, each row starting at its own position.
+    for (NODE* i_curr = first_node_from(rhs->rows, i_off); i_curr && i_curr->key < i_off + rows; i_curr = i_curr->next) {
+      size_t i   = i_curr->key - i_off;
+      IType  ija = lhs_ija[i];
 
-      // Shrink reference
-      int i = i_curr->key - rhs->offset[0];
-      if (i < 0 || i >= (int)rhs->shape[0]) continue;
+      for (NODE* j_curr = first_node_from(reinterpret_cast<LIST*>(i_curr->val), j_off); j_curr && j_curr->key < j_off + cols; j_curr = j_curr->next) {
+        size_t j = j_curr->key - j_off;
+        LDType cast_jcurr_val = static_cast<LDType>(*reinterpret_cast<RDType*>(j_curr->val));
 
-      for (NODE* j_curr = ((LIST*)(i_curr->val))->first; j_curr; j_curr = j_curr->next) {
-        
-        // Shrink reference
-        int j = j_curr->key - rhs->offset[1];
-        if (j < 0 || j >= (int)rhs->shape[1]) continue;
-
-        LDType cast_jcurr_val = *reinterpret_cast<RDType*>(j_curr->val);
-        if (i_curr->key - rhs->offset[0] == j_curr->key - rhs->offset[1])
-          lhs_a[i_curr->key - rhs->offset[0]] = cast_jcurr_val; // set diagonal
+        if (i == j) lhs_a[i] = cast_jcurr_val; // set diagonal
         else {
-          lhs_ija[ija] = j_curr->key - rhs->offset[1];    // set column value
-
-          lhs_a[ija]   = cast_jcurr_val;                      // set cell value
-
+          lhs_ija[ija] = j;                       // set column value
+          lhs_a[ija]   = cast_jcurr_val;          // set cell value
           ++ija;
-          // indicate the beginning of a row in the IJA array
-          for (size_t i = i_curr->key - rhs->offset[0] + 1; i < rhs->shape[0] + rhs->offset[0]; ++i) {
-            lhs_ija[i] = ija;
-          }
-
         }
       }
-
     }
-    
-    lhs_ija[rhs->shape[0]] = ija; // indicate the end of the last row
+
     lhs->ndnz = ndnz;
 
     nm_list_storage_unregister(rhs);
@@ -645,6 +574,178 @@ namespace yale_storage { // FIXME: Move to yale.cpp
   }
 
 } // end of namespace yale_storage
+
+
+/*
+ * Element-wise operations between a sparse (list or yale) matrix and a dense one, which never make a dense copy of the
+ * sparse matrix. By the time these are called, both operands have the same dtype, and the sparse one is not a
+ * reference.
+ */
+namespace mixed {
+
+template <typename DType>
+static inline const DType& default_value(const YALE_STORAGE* s) {
+  return reinterpret_cast<const DType*>(s->a)[s->shape[0]];
+}
+
+template <typename DType>
+static inline const DType& default_value(const LIST_STORAGE* s) {
+  return *reinterpret_cast<const DType*>(s->default_val);
+}
+
+/*
+ * Yield the position (in a dense matrix of the same shape) and value of each entry stored in a yale matrix, including
+ * the diagonal.
+ */
+template <typename DType, typename Yield>
+static void each_stored(const YALE_STORAGE* s, Yield yield) {
+  const size_t* ija = s->ija;
+  const DType*  a   = reinterpret_cast<const DType*>(s->a);
+  const size_t  n   = s->shape[1];
+
+  for (size_t i = 0; i < s->shape[0]; ++i) {
+    if (i < n) yield(i*n + i, a[i]);
+    for (size_t p = ija[i]; p < ija[i+1]; ++p)
+      yield(i*n + ija[p], a[p]);
+  }
+}
+
+template <typename DType, typename Yield>
+static void each_stored_r(const LIST_STORAGE* s, const LIST* l, size_t rec, size_t base, Yield yield) {
+  for (const NODE* curr = l->first; curr; curr = curr->next) {
+    size_t k = base * s->shape[rec] + curr->key;
+    if (rec == s->dim - 1) yield(k, *reinterpret_cast<const DType*>(curr->val));
+    else                   each_stored_r<DType>(s, reinterpret_cast<const LIST*>(curr->val), rec+1, k, yield);
+  }
+}
+
+/*
+ * Yield the position (in a dense matrix of the same shape) and value of each entry stored in a list matrix.
+ */
+template <typename DType, typename Yield>
+static void each_stored(const LIST_STORAGE* s, Yield yield) {
+  each_stored_r<DType>(s, s->rows, 0, 0, yield);
+}
+
+/*
+ * Overwrite d, which holds a copy of the dense operand, with the result of the operation. The results at the stored
+ * positions of s are worked out first, and then everywhere else is done using the default value of s.
+ */
+template <typename DType, typename SparseStorage, typename Op>
+static void ew_into_dense_with(DENSE_STORAGE* d, const SparseStorage* s, bool sparse_left, Op op) {
+  DType*       out  = reinterpret_cast<DType*>(d->elements);
+  const DType& init = default_value<DType>(s);
+
+  std::vector<std::pair<size_t,DType> > stored;
+  each_stored<DType>(s, [&](size_t k, const DType& v) {
+    stored.push_back(std::make_pair(k, sparse_left ? op(v, out[k]) : op(out[k], v)));
+  });
+
+  const size_t count = nm_storage_count_max_elements(d);
+  for (size_t k = 0; k < count; ++k)
+    out[k] = sparse_left ? op(init, out[k]) : op(out[k], init);
+
+  for (size_t m = 0; m < stored.size(); ++m)
+    out[stored[m].first] = stored[m].second;
+}
+
+template <typename DType, typename SparseStorage>
+static void ew_into_dense(DENSE_STORAGE* d, const SparseStorage* s, nm::ewop_t op, bool sparse_left) {
+  switch(op) {
+  case nm::EW_ADD: ew_into_dense_with<DType>(d, s, sparse_left, ew_add<DType>()); break;
+  case nm::EW_SUB: ew_into_dense_with<DType>(d, s, sparse_left, ew_sub<DType>()); break;
+  case nm::EW_MUL: ew_into_dense_with<DType>(d, s, sparse_left, ew_mul<DType>()); break;
+  default:         rb_raise(rb_eNotImpError, "no native mixed-stype implementation of this element-wise operation");
+  }
+}
+
+template <typename DType>
+static void yale_ew_into_dense(DENSE_STORAGE* d, const STORAGE* s, nm::ewop_t op, bool sparse_left) {
+  ew_into_dense<DType>(d, reinterpret_cast<const YALE_STORAGE*>(s), op, sparse_left);
+}
+
+template <typename DType>
+static void list_ew_into_dense(DENSE_STORAGE* d, const STORAGE* s, nm::ewop_t op, bool sparse_left) {
+  ew_into_dense<DType>(d, reinterpret_cast<const LIST_STORAGE*>(s), op, sparse_left);
+}
+
+template <typename DType>
+static bool default_is_zero(const STORAGE* s, nm::stype_t stype) {
+  const DType& init = stype == nm::YALE_STORE ? default_value<DType>(reinterpret_cast<const YALE_STORAGE*>(s))
+                                              : default_value<DType>(reinterpret_cast<const LIST_STORAGE*>(s));
+  return init == DType(0);
+}
+
+/*
+ * Multiply each entry stored in s (which must have a zero default) by the matching entry of d, in place. Non-diagonal
+ * entries which become zero are removed, shifting the rest left as we go.
+ */
+template <typename DType>
+static void yale_multiply_stored(STORAGE* s_, const DENSE_STORAGE* d_) {
+  YALE_STORAGE* s   = nm_yale_storage_direct(s_);
+  const DType*  d   = reinterpret_cast<const DType*>(d_->elements);
+  size_t*       ija = s->ija;
+  DType*        a   = reinterpret_cast<DType*>(s->a);
+  const size_t  n   = s->shape[1];
+  const DType   zero(0);
+  ew_mul<DType> mul;
+
+  size_t p = ija[0], w = p;
+  for (size_t i = 0; i < s->shape[0]; ++i) {
+    if (i < n) a[i] = mul(a[i], d[i*n + i]);
+    for (size_t p_next = ija[i+1]; p < p_next; ++p) {
+      const DType v = mul(a[p], d[i*n + ija[p]]);
+      if (v == zero) continue;
+      ija[w] = ija[p];
+      a[w]   = v;
+      ++w;
+    }
+    ija[i+1] = w;
+  }
+
+  for (size_t k = w; k < p; ++k) a[k] = zero; // don't leave stale entries lying around past the end
+  s->ndnz = w - s->shape[0] - 1;
+}
+
+template <typename DType>
+static void list_multiply_stored_r(LIST_STORAGE* s, LIST* l, size_t rec, size_t base, const DType* d) {
+  const DType   zero(0);
+  ew_mul<DType> mul;
+  NODE *prev = NULL, *curr = l->first;
+
+  while (curr) {
+    NODE*  next = curr->next;
+    size_t k    = base * s->shape[rec] + curr->key;
+    bool   empty;
+
+    if (rec == s->dim - 1) {
+      DType* v = reinterpret_cast<DType*>(curr->val);
+      *v       = mul(*v, d[k]);
+      empty    = *v == zero;
+    } else {
+      LIST* sub = reinterpret_cast<LIST*>(curr->val);
+      list_multiply_stored_r<DType>(s, sub, rec+1, k, d);
+      empty     = sub->first == NULL;
+    }
+
+    if (empty) {
+      if (rec == s->dim - 1) nm::list::remove_node(l, prev, curr);
+      else                   nm::list::del(nm::list::remove_list_node(l, prev, curr), 0);
+    } else {
+      prev = curr;
+    }
+    curr = next;
+  }
+}
+
+template <typename DType>
+static void list_multiply_stored(STORAGE* s, const DENSE_STORAGE* d) {
+  LIST_STORAGE* ls = reinterpret_cast<LIST_STORAGE*>(s);
+  list_multiply_stored_r<DType>(ls, ls->rows, 0, 0, reinterpret_cast<const DType*>(d->elements));
+}
+
+} // end of namespace mixed
+
 } // end of namespace nm
 
 extern "C" {
@@ -692,7 +793,7 @@ extern "C" {
   STORAGE* nm_dense_storage_from_yale(const STORAGE* right, nm::dtype_t l_dtype, void* dummy) {
     NAMED_LR_DTYPE_TEMPLATE_TABLE(ttable, nm::dense_storage::create_from_yale_storage, DENSE_STORAGE*, const YALE_STORAGE* rhs, nm::dtype_t l_dtype);
 
-    const YALE_STORAGE* casted_right = reinterpret_cast<const YALE_STORAGE*>(right);
+    const YALE_STORAGE* casted_right = nm_yale_storage_direct(right);
 
     if (!ttable[l_dtype][right->dtype]) {
       rb_raise(nm_eDataTypeError, "casting between these dtypes is undefined");
@@ -716,7 +817,7 @@ extern "C" {
   STORAGE* nm_list_storage_from_yale(const STORAGE* right, nm::dtype_t l_dtype, void* dummy) {
     NAMED_LR_DTYPE_TEMPLATE_TABLE(ttable, nm::list_storage::create_from_yale_storage, LIST_STORAGE*, const YALE_STORAGE* rhs, nm::dtype_t l_dtype);
 
-    const YALE_STORAGE* casted_right = reinterpret_cast<const YALE_STORAGE*>(right);
+    const YALE_STORAGE* casted_right = nm_yale_storage_direct(right);
 
     if (!ttable[l_dtype][right->dtype]) {
       rb_raise(nm_eDataTypeError, "casting between these dtypes is undefined");
@@ -726,5 +827,56 @@ extern "C" {
     return (STORAGE*)ttable[l_dtype][right->dtype](casted_right, l_dtype);
   }
 
+
+  /*
+   * Element-wise +, -, or * of a sparse (list or yale) matrix and a dense one, without making a dense copy of the
+   * sparse matrix. + and - give a dense result. * gives a result with the sparse matrix's stype if its default value is
+   * zero, since only its stored positions need computing.
+   *
+   * Returns NULL if this can't be done natively (other operations, or :object matrices). Otherwise, sets result_stype.
+   */
+  STORAGE* nm_sparse_dense_elementwise(nm::ewop_t op, const STORAGE* sparse, nm::stype_t sparse_stype, const STORAGE* dense, bool sparse_left, nm::stype_t& result_stype) {
+    NAMED_DTYPE_TEMPLATE_TABLE(yale_into_dense, nm::mixed::yale_ew_into_dense, void, DENSE_STORAGE*, const STORAGE*, nm::ewop_t, bool)
+    NAMED_DTYPE_TEMPLATE_TABLE(list_into_dense, nm::mixed::list_ew_into_dense, void, DENSE_STORAGE*, const STORAGE*, nm::ewop_t, bool)
+    NAMED_DTYPE_TEMPLATE_TABLE(yale_multiply,   nm::mixed::yale_multiply_stored, void, STORAGE*, const DENSE_STORAGE*)
+    NAMED_DTYPE_TEMPLATE_TABLE(list_multiply,   nm::mixed::list_multiply_stored, void, STORAGE*, const DENSE_STORAGE*)
+    NAMED_DTYPE_TEMPLATE_TABLE(zero_default,    nm::mixed::default_is_zero, bool, const STORAGE*, nm::stype_t)
+
+    if (op != nm::EW_ADD && op != nm::EW_SUB && op != nm::EW_MUL) return NULL;
+
+    nm::dtype_t dtype = Upcast[sparse->dtype][dense->dtype];
+    if (dtype == nm::RUBYOBJ) return NULL;
+
+    bool yale = sparse_stype == nm::YALE_STORE;
+    STORAGE* (*sparse_cast_copy)(const STORAGE*, nm::dtype_t, void*) = yale ? nm_yale_storage_cast_copy : nm_list_storage_cast_copy;
+    void     (*sparse_delete)(STORAGE*)                              = yale ? nm_yale_storage_delete    : nm_list_storage_delete;
+
+    if (yale) nm_yale_storage_direct(sparse);
+
+    if (op == nm::EW_MUL && zero_default[sparse->dtype](sparse, sparse_stype)) {
+      // The result is a copy of the sparse matrix, with its stored entries multiplied by the dense ones.
+      STORAGE* s             = sparse_cast_copy(sparse, dtype, NULL);
+      bool     d_copy        = dense->src != dense || dense->dtype != dtype;
+      const DENSE_STORAGE* d = reinterpret_cast<const DENSE_STORAGE*>(d_copy ? nm_dense_storage_cast_copy(dense, dtype, NULL) : dense);
+
+      (yale ? yale_multiply : list_multiply)[dtype](s, d);
+
+      if (d_copy) nm_dense_storage_delete(const_cast<STORAGE*>(reinterpret_cast<const STORAGE*>(d)));
+      result_stype = sparse_stype;
+      return s;
+    }
+
+    // The result is a copy of the dense matrix, updated in place.
+    bool           s_copy = sparse->src != sparse || sparse->dtype != dtype;
+    const STORAGE* s      = s_copy ? sparse_cast_copy(sparse, dtype, NULL) : sparse;
+    DENSE_STORAGE* d      = reinterpret_cast<DENSE_STORAGE*>(nm_dense_storage_cast_copy(dense, dtype, NULL));
+
+    (yale ? yale_into_dense : list_into_dense)[dtype](d, s, op, sparse_left);
+
+    if (s_copy) sparse_delete(const_cast<STORAGE*>(s));
+    result_stype = nm::DENSE_STORE;
+    return reinterpret_cast<STORAGE*>(d);
+  }
+
 } // end of extern "C"
 
@@ -92,6 +92,12 @@ extern "C" {
   STORAGE*		nm_yale_storage_from_list(const STORAGE* right,  nm::dtype_t l_dtype, void*);
   STORAGE*		nm_yale_storage_from_dense(const STORAGE* right, nm::dtype_t l_dtype, void*);
 
+  //////////////////////////////////
+  // Mixed-stype Element-wise Ops //
+  //////////////////////////////////
+
+  STORAGE*    nm_sparse_dense_elementwise(nm::ewop_t op, const STORAGE* sparse, nm::stype_t sparse_stype, const STORAGE* dense, bool sparse_left, nm::stype_t& result_stype);
+
 } // end of extern "C" block
 
 
@@ -29,12 +29,32 @@
 #ifndef YALE_CLASS_H
 # define YALE_CLASS_H
 
+#include <set>
+#include <utility>
+
 #include "../dense/dense.h"
 #include "math/transpose.h"
 #include "yale.h"
 
 namespace nm {
 
+namespace yale_storage {
+  /*
+   * The (real row, real column) coordinates of the entries a matrix has deleted lazily, which YALE_STORAGE keeps in
+   * its dead field. Coordinates, unlike positions in IJA, don't change when entries are inserted or removed.
+   */
+  typedef std::set<std::pair<size_t,size_t> > dead_set;
+
+  /*
+   * Forget about all of the lazily-deleted entries of s, e.g., because they're gone.
+   */
+  inline void clear_dead(YALE_STORAGE* s) {
+    delete reinterpret_cast<dead_set*>(s->dead);
+    s->dead  = NULL;
+    s->ndead = 0;
+  }
+}
+
 
 /*
  * This class is basically an intermediary for YALE_STORAGE objects which enables us to treat it like a C++ object. It
@@ -106,6 +126,8 @@ public:
   inline size_t  offset(uint8_t d) const { return slice_offset[d]; }
   inline size_t  capacity() const { return s->capacity;            }
   inline size_t  size() const { return ija(real_shape(0));         }
+  inline size_t  ndead() const { return s->ndead;                  }
+  inline bool    lazy_delete() const { return s->max_dead > 0;     }
 
 
   /*
@@ -116,6 +138,69 @@ public:
     return (a(apos) == const_default_obj());
   }
 
+  inline yale_storage::dead_set* dead_p() const { return reinterpret_cast<yale_storage::dead_set*>(s->dead); }
+
+  /*
+   * Is the stored non-diagonal at apos, in real row i, one which was deleted lazily (and not yet compacted away)? Only
+   * entries marked by tombstone() are: an entry which just happens to equal the default value is still live.
+   */
+  bool is_dead(size_t i, size_t apos) const {
+    return s->ndead > 0 && is_pos_default_value(apos) && dead_p()->count(std::make_pair(i, ija(apos))) > 0;
+  }
+
+  /*
+   * Mark the stored non-diagonal at apos, in real row i, as deleted, without moving anything. If the dead entries now
+   * exceed the matrix's dead-space threshold, compacts. Returns true if it compacted (meaning row iterators need an
+   * update()).
+   */
+  bool tombstone(size_t i, size_t apos) {
+    if (is_dead(i, apos)) return false;
+    if (!s->dead) s->dead = new yale_storage::dead_set;
+    dead_p()->insert(std::make_pair(i, ija(apos)));
+    a(apos) = const_default_obj();
+    ++(s->ndead);
+
+    if (s->ndead > s->max_dead * (size() - real_shape(0) - 1)) {
+      compact();
+      return true;
+    }
+    return false;
+  }
+
+  /*
+   * The entry at apos, in real row i, is about to be overwritten or removed; if it was dead, it no longer is.
+   */
+  void revive(size_t i, size_t apos) {
+    if (!is_dead(i, apos)) return;
+    dead_p()->erase(std::make_pair(i, ija(apos)));
+    --(s->ndead);
+  }
+
+  /*
+   * Remove lazily-deleted non-diagonal entries in a single forward pass over the matrix. Leaves capacity alone.
+   */
+  void compact() {
+    if (s->ndead == 0) return;
+
+    size_t sz = size();
+    size_t p  = ija(0), w = p;
+    for (size_t i = 0; i < real_shape(0); ++i) {
+      for (size_t p_next = ija(i+1); p < p_next; ++p) {
+        if (is_dead(i, p)) continue;
+        ija(w) = ija(p);
+        a(w)   = a(p);
+        ++w;
+      }
+      ija(i+1) = w;
+    }
+
+    // Don't leave stale entries lying around past the end.
+    for (size_t k = w; k < sz; ++k) a(k) = const_default_obj();
+
+    s->ndnz  = w - real_shape(0) - 1;
+    yale_storage::clear_dead(s);
+  }
+
   /*
    * Given a size-2 array of size_t, representing the shape, determine
    * the maximum size of YaleStorage arrays.
@@ -393,9 +478,14 @@ public:
       v = reinterpret_cast<D*>(rubyobj_to_cval(right, dtype()));
     }
 
+    bool single = slice->single || (slice->lengths[0] == 1 && slice->lengths[1] == 1);
+
+    // The multi-entry insertion planners work on the raw structure, so get rid of any dead entries first.
+    if (!single) compact();
+
     row_iterator i = ribegin(slice->coords[0]);
 
-    if (slice->single || (slice->lengths[0] == 1 && slice->lengths[1] == 1)) { // single entry
+    if (single) { // single entry
       i.insert(slice->coords[1], *v);
     } else if (slice->lengths[0] == 1) { // single row, multiple entries
       i.insert(slice->coords[1], slice->lengths[1], v, v_size);
@@ -542,6 +632,10 @@ public:
 
     ns->ndnz          = 0;
     ns->capacity      = 0;
+    ns->ndead         = 0;
+    ns->dead          = NULL;
+    ns->batch         = NULL;
+    ns->max_dead      = 0;
 
     return ns;
   }
@@ -554,6 +648,10 @@ public:
     YALE_STORAGE* s = NM_ALLOC( YALE_STORAGE );
 
     s->ndnz         = 0;
+    s->ndead        = 0;
+    s->dead         = NULL;
+    s->batch        = NULL;
+    s->max_dead     = 0;
     s->dtype        = dtype();
     s->shape        = shape;
     s->offset       = NM_ALLOC_N(size_t, dim);
@@ -652,6 +750,10 @@ public:
      lhs->capacity         = new_capacity;
      lhs->dtype            = new_dtype;
      lhs->ndnz             = new_ndnz;
+     lhs->ndead            = 0;
+     lhs->dead             = NULL;
+     lhs->batch            = NULL;
+     lhs->max_dead         = s->max_dead;
      lhs->ija              = NM_ALLOC_N( size_t, new_capacity );
      lhs->a                = NM_ALLOC_N( E,      new_capacity );
      lhs->src              = lhs;
@@ -674,6 +776,9 @@ public:
       for (size_t m = 0; m < size(); ++m) {
         lhs->ija[m] = ija(m); // copy indices
       }
+      // dead entries come along with the structure
+      lhs->ndead = s->ndead;
+      if (s->dead) lhs->dead = new yale_storage::dead_set(*dead_p());
     }
     return lhs;
   }
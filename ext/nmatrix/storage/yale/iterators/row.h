@@ -204,11 +204,24 @@ public:
     return (p_diag() >= y.offset(1) && p_diag() - y.offset(1) < y.shape(1));
   }
 
+  // Is the stored non-diagonal at position pp one which was deleted lazily (and not yet compacted away)?
+  bool dead(size_t pp) const {
+    return y.is_dead(real_i(), pp);
+  }
+
+  // First position at or after pp (within this row) which has not been deleted lazily.
+  size_t next_live(size_t pp) const {
+    if (y.ndead() == 0) return pp;
+    while (pp <= p_last && dead(pp)) ++pp;
+    return pp;
+  }
+
   // Checks to see if the diagonal is the first entry in the slice.
   bool is_diag_first() const {
     if (!has_diag()) return false;
-    if (nd_empty())  return true;
-    return diag_j() < y.ija(p_first) - y.offset(1);
+    size_t pp = next_live(p_first);
+    if (pp > p_last) return true;
+    return diag_j() < y.ija(pp) - y.offset(1);
   }
 
   // Checks to see if the diagonal is the last entry in the slice.
@@ -236,13 +249,13 @@ public:
 
   inline VALUE rb_i() const { return LONG2NUM(i()); }
 
-  row_stored_iterator_T<D,RefType,YaleRef> begin() {  return row_stored_iterator_T<D,RefType,YaleRef>(*this, p_first);  }
-  row_stored_nd_iterator_T<D,RefType,YaleRef> ndbegin() {  return row_stored_nd_iterator_T<D,RefType,YaleRef>(*this, p_first);  }
+  row_stored_iterator_T<D,RefType,YaleRef> begin() {  return row_stored_iterator_T<D,RefType,YaleRef>(*this, next_live(p_first));  }
+  row_stored_nd_iterator_T<D,RefType,YaleRef> ndbegin() {  return row_stored_nd_iterator_T<D,RefType,YaleRef>(*this, next_live(p_first));  }
   row_stored_iterator_T<D,RefType,YaleRef> end() { return row_stored_iterator_T<D,RefType,YaleRef>(*this, p_last+1, true); }
   row_stored_nd_iterator_T<D,RefType,YaleRef> ndend() {  return row_stored_nd_iterator_T<D,RefType,YaleRef>(*this, p_last+1); }
 
-  row_stored_iterator_T<D,RefType,YaleRef> begin() const {  return row_stored_iterator_T<D,RefType,YaleRef>(*this, p_first);  }
-  row_stored_nd_iterator_T<D,RefType,YaleRef> ndbegin() const {  return row_stored_nd_iterator_T<D,RefType,YaleRef>(*this, p_first);  }
+  row_stored_iterator_T<D,RefType,YaleRef> begin() const {  return row_stored_iterator_T<D,RefType,YaleRef>(*this, next_live(p_first));  }
+  row_stored_nd_iterator_T<D,RefType,YaleRef> ndbegin() const {  return row_stored_nd_iterator_T<D,RefType,YaleRef>(*this, next_live(p_first));  }
   row_stored_iterator_T<D,RefType,YaleRef> end() const { return row_stored_iterator_T<D,RefType,YaleRef>(*this, p_last+1, true); }
   row_stored_nd_iterator_T<D,RefType,YaleRef> ndend() const {  return row_stored_nd_iterator_T<D,RefType,YaleRef>(*this, p_last+1); }
 
@@ -251,8 +264,9 @@ public:
     row_stored_nd_iterator_T<D,RefType,YaleRef>(*this, y.real_find_left_boundary_pos(p_first, p_last, y.offset(1)));
   }
 
+  // Finds the insertion position for column j. Unlike ndbegin(), this does not skip lazily-deleted entries.
   row_stored_nd_iterator_T<D,RefType,YaleRef> ndfind(size_t j) {
-    if (j == 0) return ndbegin();
+    if (j == 0) return row_stored_nd_iterator_T<D,RefType,YaleRef>(*this, p_first);
     size_t p = p_first > p_last ? p_first : y.real_find_left_boundary_pos(p_first, p_last, j + y.offset(1));
     row_stored_nd_iterator iter = row_stored_nd_iterator_T<D,RefType,YaleRef>(*this, p);
     return iter;
@@ -269,6 +283,14 @@ public:
    */
   //template <typename = typename std::enable_if<!std::is_const<RefType>::value>::type>
   row_stored_nd_iterator erase(row_stored_nd_iterator position) {
+    if (y.lazy_delete()) {
+      // Just mark the entry as dead. If that pushes us past the dead-space threshold, compact the whole matrix.
+      if (y.tombstone(real_i(), position.p())) update();
+      return row_stored_nd_iterator(*this, position.p());
+    }
+
+    y.revive(real_i(), position.p());
+
     size_t sz = y.size();
     if (sz - 1 <= y.capacity() / nm::yale_storage::GROWTH_CONSTANT) {
       y.update_resize_move(position, real_i(), -1);
@@ -299,9 +321,12 @@ public:
   //template <typename = typename std::enable_if<!std::is_const<RefType>::value>::type>
   row_stored_nd_iterator insert(row_stored_nd_iterator position, size_t jj, const D& val) {
     size_t sz = y.size();
-    while (!position.end() && position.j() < jj) ++position; // position is just a hint. (This loop ideally only has to happen once.)
+    // position is just a hint. (This loop ideally only has to happen once.) Step over lazily-deleted entries too, so we
+    // revive them rather than storing a second copy of the same column.
+    while (!position.end() && position.j() < jj) position = row_stored_nd_iterator(*this, position.p()+1);
 
     if (!position.end() && position.j() == jj) {
+      y.revive(real_i(), position.p());
       *position = val;      // replace existing
     } else {
 
@@ -93,7 +93,7 @@ public:
       d_visited = true;
       d         = false;
     } else {
-      ++p_;
+      p_ = r.next_live(p_+1); // skip over any entries deleted lazily
       // Are we at a diagonal?
       // If we hit the end or reach a point where j > diag_j, and still
       // haven't visited the diagonal, we should do so before continuing.
@@ -98,7 +98,7 @@ public:
 
   row_stored_nd_iterator_T<D,RefType,YaleRef,RowRef>& operator++() {
     if (end()) throw std::out_of_range("cannot increment row stored iterator past end of stored row");
-    ++p_;
+    p_ = r.next_live(p_+1); // skip over any entries deleted lazily
 
     return *this;
   }
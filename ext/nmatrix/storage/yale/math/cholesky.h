@@ -0,0 +1,195 @@
+/////////////////////////////////////////////////////////////////////
+// = NMatrix
+//
+// A linear algebra library for scientific computation in Ruby.
+// NMatrix is part of SciRuby.
+//
+// NMatrix was originally inspired by and derived from NArray, by
+// Masahiro Tanaka: http://narray.rubyforge.org
+//
+// == Copyright Information
+//
+// SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+// NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+//
+// Please see LICENSE.txt for additional copyright notices.
+//
+// == Contributing
+//
+// By contributing source code to SciRuby, you agree to be bound by
+// our Contributor Agreement:
+//
+// * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+//
+// == cholesky.h
+//
+// Functions for Yale math: sparse Cholesky factorization of a permuted
+// Hermitian positive definite matrix, P * A * P**T = L * L**H, split
+// into a symbolic phase, which only depends on the sparsity pattern
+// and can be reused, and a numeric one. The factorization is up-looking
+// (row by row of L), as in CSparse's cs_chol (Davis, 2006).
+//
+// L is kept by columns: the row indices of column j are li[colptr[j]]
+// to li[colptr[j+1]-1], diagonal first, and its values are in lx.
+//
+
+#ifndef YALE_MATH_CHOLESKY_H
+# define YALE_MATH_CHOLESKY_H
+
+#include <cmath>
+#include <stdint.h>
+#include <vector>
+
+#include "math/conjugate.h"
+
+namespace nm { namespace yale_storage {
+
+/*
+ * The pattern of row k of L, below the diagonal, in topological order: stack[top..n-1] on return, where top is the
+ * return value. Row k of C = P * A * P**T is row perm[k] of A, and parent is the elimination tree. mark must be
+ * n entries that are never k on entry (-1 at first, and then whatever the earlier calls left).
+ *
+ * Returns -1 if some entry's path up the tree doesn't lead to k, which means the tree is not A's.
+ */
+inline int64_t cholesky_ereach(const int64_t n, const size_t* ija, const int64_t* perm, const int64_t* pinv,
+                               const int64_t* parent, const int64_t k, int64_t* mark, int64_t* stack) {
+  const size_t row = perm[k];
+  int64_t      top = n;
+
+  mark[k] = k;
+  for (size_t p = ija[row]; p < ija[row+1]; ++p) {
+    int64_t i = pinv[ija[p]];
+    if (i > k) continue;
+
+    int64_t len = 0;
+    for (; mark[i] != k; i = parent[i]) {
+      if (i == -1) return -1;
+      stack[len++] = i;
+      mark[i]      = k;
+    }
+    while (len > 0) stack[--top] = stack[--len];
+  }
+
+  return top;
+}
+
+/*
+ * Symbolic phase: the elimination tree (parent, with -1 at the roots) and the column pointers (n+1 entries) of L for
+ * C = P * A * P**T, where A is the n-by-n new Yale matrix whose ija is given and perm[k] is P's k-th row. A must be
+ * stored in full, not just one triangle; only the pattern of the lower triangle of C is used.
+ *
+ * Returns the number of entries in L.
+ */
+inline int64_t cholesky_symbolic(const int64_t n, const size_t* ija, const int64_t* perm, int64_t* parent,
+                                 int64_t* colptr) {
+  std::vector<int64_t> pinv(n), ancestor(n, -1), mark(n, -1), stack(n), count(n, 1);
+  for (int64_t k = 0; k < n; ++k) pinv[perm[k]] = k;
+
+  // Elimination tree, with path compression through ancestor.
+  for (int64_t k = 0; k < n; ++k) {
+    parent[k]        = -1;
+    const size_t row = perm[k];
+    for (size_t p = ija[row]; p < ija[row+1]; ++p) {
+      int64_t i = pinv[ija[p]];
+      while (i != -1 && i < k) {
+        const int64_t inext = ancestor[i];
+        ancestor[i] = k;
+        if (inext == -1) parent[i] = k;
+        i = inext;
+      }
+    }
+  }
+
+  // Column counts, from the pattern of each row of L.
+  for (int64_t k = 0; k < n; ++k) {
+    const int64_t top = cholesky_ereach(n, ija, perm, &pinv[0], parent, k, &mark[0], &stack[0]);
+    for (int64_t t = top; t < n; ++t) ++count[stack[t]];
+  }
+
+  colptr[0] = 0;
+  for (int64_t j = 0; j < n; ++j) colptr[j+1] = colptr[j] + count[j];
+  return colptr[n];
+}
+
+/*
+ * Numeric phase: fills li and lx with L, given A (as ija and a) and the results of cholesky_symbolic for A's pattern.
+ *
+ * Returns 0, k+1 if the k-th pivot wasn't positive (so A isn't positive definite), or -1 if A's pattern doesn't
+ * match the symbolic phase's (the columns of L must come out exactly as long as it said).
+ */
+template <typename DType>
+inline int64_t cholesky_numeric(const int64_t n, const size_t* ija, const DType* a, const int64_t* perm,
+                                const int64_t* parent, const int64_t* colptr, int64_t* li, DType* lx) {
+  std::vector<int64_t> pinv(n), mark(n, -1), stack(n), c(colptr, colptr + n);
+  std::vector<DType>   x(n, DType(0));
+  for (int64_t k = 0; k < n; ++k) pinv[perm[k]] = k;
+
+  for (int64_t k = 0; k < n; ++k) {
+    const int64_t top = cholesky_ereach(n, ija, perm, &pinv[0], parent, k, &mark[0], &stack[0]);
+    if (top < 0) return -1;
+
+    // x := the upper part of column k of C, which is the conjugate of the lower part of row k.
+    const size_t row = perm[k];
+    x[k] = a[row];
+    for (size_t p = ija[row]; p < ija[row+1]; ++p) {
+      const int64_t i = pinv[ija[p]];
+      if (i < k) x[i] = nm::math::conjugate_value(a[p]);
+    }
+
+    double d = nm::math::real_value(x[k]);
+    x[k]     = 0;
+
+    // Solve L(0:k-1, 0:k-1) * y = x, one entry of row k of L at a time.
+    for (int64_t t = top; t < n; ++t) {
+      const int64_t j = stack[t];
+      const DType   y = x[j] / lx[colptr[j]];
+      x[j] = 0;
+
+      for (int64_t p = colptr[j] + 1; p < c[j]; ++p) x[li[p]] -= lx[p] * y;
+      d -= nm::math::abs2(y);
+
+      if (c[j] >= colptr[j+1]) return -1;
+      const int64_t p = c[j]++;
+      li[p] = k;
+      lx[p] = nm::math::conjugate_value(y);
+    }
+
+    if (!(d > 0)) return k + 1;
+    if (c[k] >= colptr[k+1]) return -1;
+
+    const int64_t p = c[k]++;
+    li[p] = k;
+    lx[p] = std::sqrt(d);
+  }
+
+  for (int64_t j = 0; j < n; ++j)
+    if (c[j] != colptr[j+1]) return -1;
+
+  return 0;
+}
+
+/*
+ * x := A**-1 * x, for x of length n, from the factorization P * A * P**T = L * L**H. work must have n entries.
+ */
+template <typename DType>
+inline void cholesky_solve(const int64_t n, const int64_t* perm, const int64_t* colptr, const int64_t* li,
+                           const DType* lx, DType* x, DType* work) {
+  for (int64_t k = 0; k < n; ++k) work[k] = x[perm[k]];
+
+  for (int64_t j = 0; j < n; ++j) {
+    work[j] /= lx[colptr[j]];
+    for (int64_t p = colptr[j] + 1; p < colptr[j+1]; ++p) work[li[p]] -= lx[p] * work[j];
+  }
+
+  for (int64_t j = n; j-- > 0; ) {
+    DType sum = work[j];
+    for (int64_t p = colptr[j] + 1; p < colptr[j+1]; ++p) sum -= nm::math::conjugate_value(lx[p]) * work[li[p]];
+    work[j] = sum / nm::math::conjugate_value(lx[colptr[j]]);
+  }
+
+  for (int64_t k = 0; k < n; ++k) x[perm[k]] = work[k];
+}
+
+} } // end of namespace nm::yale_storage
+
+#endif
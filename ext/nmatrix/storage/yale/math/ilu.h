@@ -0,0 +1,157 @@
+/////////////////////////////////////////////////////////////////////
+// = NMatrix
+//
+// A linear algebra library for scientific computation in Ruby.
+// NMatrix is part of SciRuby.
+//
+// NMatrix was originally inspired by and derived from NArray, by
+// Masahiro Tanaka: http://narray.rubyforge.org
+//
+// == Copyright Information
+//
+// SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+// NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+//
+// Please see LICENSE.txt for additional copyright notices.
+//
+// == Contributing
+//
+// By contributing source code to SciRuby, you agree to be bound by
+// our Contributor Agreement:
+//
+// * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+//
+// == ilu.h
+//
+// Functions for Yale math: incomplete LU and Cholesky factorization
+// with no fill-in (ILU(0) and IC(0)), and the triangular solves that
+// apply them as preconditioners.
+//
+
+#ifndef YALE_MATH_ILU_H
+# define YALE_MATH_ILU_H
+
+#include <cmath>
+#include <vector>
+
+#include "math/conjugate.h"
+
+namespace nm { namespace yale_storage {
+
+/*
+ * Overwrites the square n-by-n new Yale matrix given by ija and a with its ILU(0) factorization: the entries below the
+ * diagonal become those of the unit lower triangular L, and the diagonal and the entries above it those of U, where
+ * L * U matches A on A's sparsity pattern. The column indices of each row must be in ascending order, as Yale keeps
+ * them.
+ *
+ * Returns 0, or i+1 if the pivot of row i came out zero.
+ */
+template <typename DType>
+inline int ilu0(const size_t n, const size_t* ija, DType* a) {
+  // pos[j] is the position of column j in the row being factored, or 0 if there's no entry there.
+  std::vector<size_t> pos(n, 0);
+
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t p = ija[i]; p < ija[i+1]; ++p) pos[ija[p]] = p;
+
+    for (size_t p = ija[i]; p < ija[i+1] && ija[p] < i; ++p) {
+      const size_t k = ija[p];
+      a[p] /= a[k];
+
+      // Row i -= a(i,k) * row k, restricted to the entries to the right of k that row i already has.
+      for (size_t q = ija[k]; q < ija[k+1]; ++q) {
+        const size_t j = ija[q];
+        if (j <= k)      continue;
+        else if (j == i) a[i] -= a[p] * a[q];
+        else if (pos[j]) a[pos[j]] -= a[p] * a[q];
+      }
+    }
+
+    for (size_t p = ija[i]; p < ija[i+1]; ++p) pos[ija[p]] = 0;
+
+    if (nm::math::exactly_zero(a[i])) return i + 1;
+  }
+
+  return 0;
+}
+
+/*
+ * Overwrites the lower triangle (and diagonal) of the Hermitian positive definite n-by-n new Yale matrix given by ija
+ * and a with its IC(0) factor L, where L * L**H matches A on the lower triangle of A's sparsity pattern. The entries
+ * above the diagonal are neither read nor written. The column indices of each row must be in ascending order.
+ *
+ * Returns 0, or i+1 if the pivot of row i came out not positive.
+ */
+template <typename DType>
+inline int ic0(const size_t n, const size_t* ija, DType* a) {
+  std::vector<size_t> pos(n, 0);
+
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t p = ija[i]; p < ija[i+1] && ija[p] < i; ++p) pos[ija[p]] = p;
+
+    double d = nm::math::real_value(a[i]);
+
+    for (size_t p = ija[i]; p < ija[i+1] && ija[p] < i; ++p) {
+      const size_t k = ija[p];
+
+      // L(i,k) = (A(i,k) - sum over m < k of L(i,m) * conj(L(k,m))) / L(k,k)
+      DType sum = a[p];
+      for (size_t q = ija[k]; q < ija[k+1] && ija[q] < k; ++q)
+        if (pos[ija[q]]) sum -= a[pos[ija[q]]] * nm::math::conjugate_value(a[q]);
+
+      a[p] = sum / a[k];
+      d   -= nm::math::abs2(a[p]);
+    }
+
+    for (size_t p = ija[i]; p < ija[i+1] && ija[p] < i; ++p) pos[ija[p]] = 0;
+
+    if (!(d > 0)) return i + 1;
+    a[i] = std::sqrt(d);
+  }
+
+  return 0;
+}
+
+/*
+ * x := U**-1 * L**-1 * x, with L and U from ilu0.
+ */
+template <typename DType>
+inline void ilu0_solve(const size_t n, const size_t* ija, const DType* a, DType* x) {
+  for (size_t i = 0; i < n; ++i) {
+    DType sum = x[i];
+    for (size_t p = ija[i]; p < ija[i+1]; ++p)
+      if (ija[p] < i) sum -= a[p] * x[ija[p]];
+    x[i] = sum;
+  }
+
+  for (size_t i = n; i-- > 0; ) {
+    DType sum = x[i];
+    for (size_t p = ija[i]; p < ija[i+1]; ++p)
+      if (ija[p] > i) sum -= a[p] * x[ija[p]];
+    x[i] = sum / a[i];
+  }
+}
+
+/*
+ * x := L**-H * L**-1 * x, with L from ic0. The second solve goes through L by rows, so it only needs the lower
+ * triangle.
+ */
+template <typename DType>
+inline void ic0_solve(const size_t n, const size_t* ija, const DType* a, DType* x) {
+  for (size_t i = 0; i < n; ++i) {
+    DType sum = x[i];
+    for (size_t p = ija[i]; p < ija[i+1]; ++p)
+      if (ija[p] < i) sum -= a[p] * x[ija[p]];
+    x[i] = sum / a[i];
+  }
+
+  for (size_t i = n; i-- > 0; ) {
+    x[i] /= nm::math::conjugate_value(a[i]);
+    for (size_t p = ija[i]; p < ija[i+1]; ++p)
+      if (ija[p] < i) x[ija[p]] -= nm::math::conjugate_value(a[p]) * x[i];
+  }
+}
+
+} } // end of namespace nm::yale_storage
+
+#endif
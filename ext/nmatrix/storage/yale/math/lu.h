@@ -0,0 +1,209 @@
+/////////////////////////////////////////////////////////////////////
+// = NMatrix
+//
+// A linear algebra library for scientific computation in Ruby.
+// NMatrix is part of SciRuby.
+//
+// NMatrix was originally inspired by and derived from NArray, by
+// Masahiro Tanaka: http://narray.rubyforge.org
+//
+// == Copyright Information
+//
+// SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+// NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+//
+// Please see LICENSE.txt for additional copyright notices.
+//
+// == Contributing
+//
+// By contributing source code to SciRuby, you agree to be bound by
+// our Contributor Agreement:
+//
+// * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+//
+// == lu.h
+//
+// Functions for Yale math: sparse LU factorization with partial
+// pivoting, by the left-looking algorithm of Gilbert and Peierls
+// (1988), as in CSparse's cs_lu (Davis, 2006).
+//
+// That algorithm works by columns, and Yale stores rows, so what gets
+// factored is B = A**T, whose columns are A's rows: P * B * Q = L * U,
+// where Q is the fill-reducing order (q[k] is B's k-th column) and P the
+// pivoting (pinv[i] is the row of P * B that B's row i went to). Then
+// A = Q * U**T * L**T * P, which lu_solve applies the inverse of.
+//
+// L (unit lower triangular, diagonal first in each column) and U (upper
+// triangular, diagonal last) are kept by columns, as in cholesky.h.
+//
+
+#ifndef YALE_MATH_LU_H
+# define YALE_MATH_LU_H
+
+#include <cmath>
+#include <stdint.h>
+#include <vector>
+
+#include "math/conjugate.h"
+
+namespace nm { namespace yale_storage {
+
+/*
+ * Depth-first search from node j of the graph of L (whose column J = pinv[j] holds the edges out of j, if j is
+ * pivotal already), pushing the nodes it finishes onto out[..top-1]. Returns the new top.
+ */
+inline int64_t lu_dfs(int64_t j, const int64_t* lp, const int64_t* li, const int64_t* pinv, int64_t top,
+                      int64_t* out, char* mark, int64_t* stack, int64_t* pstack) {
+  int64_t head = 0;
+  stack[0] = j;
+
+  while (head >= 0) {
+    j = stack[head];
+    const int64_t jnew = pinv[j];
+
+    if (!mark[j]) {
+      mark[j]      = 1;
+      pstack[head] = jnew < 0 ? 0 : lp[jnew];
+    }
+
+    bool          done = true;
+    const int64_t end  = jnew < 0 ? 0 : lp[jnew+1];
+    for (int64_t p = pstack[head]; p < end; ++p) {
+      const int64_t i = li[p];
+      if (mark[i]) continue;
+
+      pstack[head]    = p;
+      stack[++head]   = i;
+      done            = false;
+      break;
+    }
+
+    if (done) {
+      --head;
+      out[--top] = j;
+    }
+  }
+
+  return top;
+}
+
+/*
+ * Numeric factorization of the n-by-n new Yale matrix given by ija and a, in the order q, with a pivot tolerance tol
+ * in (0, 1]: the diagonal entry is kept as the pivot if its magnitude is at least tol times the largest in its column,
+ * which with a symmetric fill-reducing order usually keeps the fill low. tol = 1 is plain partial pivoting.
+ *
+ * L and U go into lp, li, lx and up, ui, ux, whose index and value arrays have room for lcap and ucap entries; P goes
+ * into pinv.
+ *
+ * Returns 0, k+1 if column k has no usable pivot (so A is singular), or -1 if L or U didn't fit, in which case the
+ * factorization must be redone with more room.
+ */
+template <typename DType>
+inline int64_t lu_numeric(const int64_t n, const size_t* ija, const DType* a, const int64_t* q, const double tol,
+                          int64_t* lp, int64_t* li, DType* lx, const int64_t lcap,
+                          int64_t* up, int64_t* ui, DType* ux, const int64_t ucap, int64_t* pinv) {
+  std::vector<DType>   x(n, DType(0));
+  std::vector<int64_t> out(n), stack(n), pstack(n);
+  std::vector<char>    mark(n, 0);
+  int64_t              lnz = 0, unz = 0;
+
+  for (int64_t i = 0; i < n; ++i) pinv[i] = -1;
+
+  for (int64_t k = 0; k < n; ++k) {
+    lp[k] = lnz;
+    up[k] = unz;
+    if (lnz + n > lcap || unz + n > ucap) return -1;
+
+    // Column col of B is row col of A. Find where L \ B(:,col) can be nonzero, then scatter and solve.
+    const size_t col = q[k];
+    int64_t      top = n;
+
+    if (!mark[col]) top = lu_dfs(col, lp, li, pinv, top, &out[0], &mark[0], &stack[0], &pstack[0]);
+    for (size_t p = ija[col]; p < ija[col+1]; ++p)
+      if (!mark[ija[p]]) top = lu_dfs(ija[p], lp, li, pinv, top, &out[0], &mark[0], &stack[0], &pstack[0]);
+    for (int64_t t = top; t < n; ++t) mark[out[t]] = 0;
+
+    for (int64_t t = top; t < n; ++t) x[out[t]] = 0;
+    x[col] = a[col];
+    for (size_t p = ija[col]; p < ija[col+1]; ++p) x[ija[p]] = a[p];
+
+    for (int64_t t = top; t < n; ++t) {
+      const int64_t j = out[t], J = pinv[j];
+      if (J < 0) continue;
+
+      const DType xj = x[j]; // L's diagonal is one
+      for (int64_t p = lp[J] + 1; p < lp[J+1]; ++p) x[li[p]] -= lx[p] * xj;
+    }
+
+    // Entries in pivotal rows go to U; pick the pivot among the others.
+    int64_t ipiv = -1;
+    double  best = -1;
+    for (int64_t t = top; t < n; ++t) {
+      const int64_t i = out[t];
+      if (pinv[i] < 0) {
+        const double m = std::sqrt(nm::math::abs2(x[i]));
+        if (m > best) {
+          best = m;
+          ipiv = i;
+        }
+      } else {
+        ui[unz]   = pinv[i];
+        ux[unz++] = x[i];
+      }
+    }
+
+    if (ipiv == -1 || !(best > 0)) return k + 1;
+    if (pinv[col] < 0 && std::sqrt(nm::math::abs2(x[col])) >= best * tol) ipiv = col;
+
+    const DType pivot = x[ipiv];
+    ui[unz]    = k;
+    ux[unz++]  = pivot;
+    pinv[ipiv] = k;
+    li[lnz]    = ipiv;
+    lx[lnz++]  = 1;
+
+    for (int64_t t = top; t < n; ++t) {
+      const int64_t i = out[t];
+      if (pinv[i] < 0) {
+        li[lnz]   = i;
+        lx[lnz++] = x[i] / pivot;
+      }
+      x[i] = 0;
+    }
+  }
+
+  lp[n] = lnz;
+  up[n] = unz;
+  for (int64_t p = 0; p < lnz; ++p) li[p] = pinv[li[p]];
+
+  return 0;
+}
+
+/*
+ * x := A**-1 * x, for x of length n, from the factorization computed by lu_numeric. work must have n entries.
+ */
+template <typename DType>
+inline void lu_solve(const int64_t n, const int64_t* q, const int64_t* pinv, const int64_t* lp, const int64_t* li,
+                     const DType* lx, const int64_t* up, const int64_t* ui, const DType* ux, DType* x, DType* work) {
+  for (int64_t k = 0; k < n; ++k) work[k] = x[q[k]];
+
+  // U**T is lower triangular, with U's column k as its row k.
+  for (int64_t k = 0; k < n; ++k) {
+    DType sum = work[k];
+    for (int64_t p = up[k]; p < up[k+1] - 1; ++p) sum -= ux[p] * work[ui[p]];
+    work[k] = sum / ux[up[k+1] - 1];
+  }
+
+  // L**T is unit upper triangular.
+  for (int64_t k = n; k-- > 0; ) {
+    DType sum = work[k];
+    for (int64_t p = lp[k] + 1; p < lp[k+1]; ++p) sum -= lx[p] * work[li[p]];
+    work[k] = sum;
+  }
+
+  for (int64_t i = 0; i < n; ++i) x[i] = work[pinv[i]];
+}
+
+} } // end of namespace nm::yale_storage
+
+#endif
@@ -0,0 +1,261 @@
+/////////////////////////////////////////////////////////////////////
+// = NMatrix
+//
+// A linear algebra library for scientific computation in Ruby.
+// NMatrix is part of SciRuby.
+//
+// NMatrix was originally inspired by and derived from NArray, by
+// Masahiro Tanaka: http://narray.rubyforge.org
+//
+// == Copyright Information
+//
+// SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+// NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+//
+// Please see LICENSE.txt for additional copyright notices.
+//
+// == Contributing
+//
+// By contributing source code to SciRuby, you agree to be bound by
+// our Contributor Agreement:
+//
+// * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+//
+// == ordering.h
+//
+// Functions for Yale math: fill-reducing and bandwidth-reducing
+// orderings of the rows and columns of a square sparse matrix.
+//
+
+#ifndef YALE_MATH_ORDERING_H
+# define YALE_MATH_ORDERING_H
+
+#include <algorithm>
+#include <vector>
+
+namespace nm { namespace yale_storage {
+
+/*
+ * The adjacency lists of the graph of A + A**T, without self-loops or repeated edges, for the n-by-n new Yale matrix
+ * whose ija array is given.
+ */
+inline void symmetric_adjacency(const size_t n, const size_t* ija, std::vector<std::vector<size_t> >& adj) {
+  adj.assign(n, std::vector<size_t>());
+
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t p = ija[i]; p < ija[i+1]; ++p) {
+      const size_t j = ija[p];
+      if (j == i || j >= n) continue;
+      adj[i].push_back(j);
+      adj[j].push_back(i);
+    }
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    std::sort(adj[i].begin(), adj[i].end());
+    adj[i].erase(std::unique(adj[i].begin(), adj[i].end()), adj[i].end());
+  }
+}
+
+/*
+ * A minimum degree ordering of the n-by-n new Yale matrix whose ija array is given, for factorizing it with little
+ * fill-in: perm[k] is the row and column to eliminate k-th. Only the pattern of A + A**T matters.
+ *
+ * This follows AMD (Amestoy, Davis and Duff, 1996): the graph being eliminated is kept as a quotient graph, in which
+ * each eliminated node becomes an element standing for the clique it created, and elements are absorbed into the
+ * new ones they are part of, so the storage never grows much beyond that of A. Degrees are AMD's approximate external
+ * degrees, which are upper bounds that are cheap to update. It leaves out AMD's supervariable detection, so it is
+ * slower on matrices with many identical rows, but the orderings are of much the same quality.
+ */
+inline void minimum_degree(const size_t n, const size_t* ija, size_t* perm) {
+  const size_t NONE = static_cast<size_t>(-1);
+
+  std::vector<std::vector<size_t> > var, elem(n), le(n);
+  symmetric_adjacency(n, ija, var);
+
+  std::vector<size_t> degree(n), head(n, NONE), next(n, NONE), prev(n, NONE), mark(n, 0), wmark(n, 0), w(n, 0), lp;
+  std::vector<char>   eliminated(n, 0), absorbed(n, 0);
+  size_t              stamp = 0, mindeg = 0;
+
+  // Degree lists, to find a node of minimum degree quickly.
+  auto insert = [&](size_t i) {
+    next[i] = head[degree[i]];
+    prev[i] = NONE;
+    if (next[i] != NONE) prev[next[i]] = i;
+    head[degree[i]] = i;
+    mindeg = std::min(mindeg, degree[i]);
+  };
+  auto remove = [&](size_t i) {
+    if (prev[i] != NONE) next[prev[i]] = next[i];
+    else                 head[degree[i]] = next[i];
+    if (next[i] != NONE) prev[next[i]] = prev[i];
+  };
+
+  for (size_t i = 0; i < n; ++i) {
+    degree[i] = var[i].size();
+    insert(i);
+  }
+
+  for (size_t k = 0; k < n; ++k) {
+    while (head[mindeg] == NONE) ++mindeg;
+    const size_t p = head[mindeg];
+    remove(p);
+    perm[k]       = p;
+    eliminated[p] = 1;
+
+    // The new element p's variables: p's neighbors, and the variables of the elements p belonged to, which p absorbs.
+    ++stamp;
+    lp.clear();
+    for (size_t t = 0; t < var[p].size(); ++t) {
+      const size_t j = var[p][t];
+      if (!eliminated[j] && mark[j] != stamp) {
+        mark[j] = stamp;
+        lp.push_back(j);
+      }
+    }
+    for (size_t t = 0; t < elem[p].size(); ++t) {
+      const size_t e = elem[p][t];
+      if (absorbed[e]) continue;
+      for (size_t u = 0; u < le[e].size(); ++u) {
+        const size_t j = le[e][u];
+        if (!eliminated[j] && mark[j] != stamp) {
+          mark[j] = stamp;
+          lp.push_back(j);
+        }
+      }
+      absorbed[e] = 1;
+      std::vector<size_t>().swap(le[e]);
+    }
+    le[p] = lp;
+    std::vector<size_t>().swap(var[p]);
+    std::vector<size_t>().swap(elem[p]);
+
+    // w[e] := |Le \ Lp| for each other element e next to a variable in Lp.
+    for (size_t t = 0; t < lp.size(); ++t) {
+      const std::vector<size_t>& ei = elem[lp[t]];
+      for (size_t u = 0; u < ei.size(); ++u) {
+        const size_t e = ei[u];
+        if (absorbed[e]) continue;
+        if (wmark[e] != stamp) {
+          wmark[e] = stamp;
+          w[e]     = le[e].size();
+        }
+        --w[e];
+      }
+    }
+
+    // Update the variables in Lp: the edges among them are now implied by p, as are the elements inside Lp.
+    for (size_t t = 0; t < lp.size(); ++t) {
+      const size_t i = lp[t];
+      remove(i);
+
+      std::vector<size_t>& vi = var[i];
+      size_t keep = 0;
+      for (size_t u = 0; u < vi.size(); ++u)
+        if (!eliminated[vi[u]] && mark[vi[u]] != stamp) vi[keep++] = vi[u];
+      vi.resize(keep);
+
+      std::vector<size_t>& ei  = elem[i];
+      size_t               deg = vi.size() + lp.size() - 1;
+      keep = 0;
+      for (size_t u = 0; u < ei.size(); ++u) {
+        const size_t e = ei[u];
+        if (absorbed[e]) continue;
+        if (w[e] == 0) { // e's variables are all in Lp
+          absorbed[e] = 1;
+          std::vector<size_t>().swap(le[e]);
+          continue;
+        }
+        deg += w[e];
+        ei[keep++] = e;
+      }
+      ei.resize(keep);
+      ei.push_back(p);
+
+      degree[i] = std::min(deg, n - k - 1);
+      insert(i);
+    }
+  }
+}
+
+/*
+ * The levels of a breadth-first search from root through the nodes whose mark isn't stamp (which it sets to stamp):
+ * order gets the nodes in the order visited, and the return value is the number of levels. The neighbors of each node
+ * are visited in order of increasing degree, as Cuthill-McKee wants.
+ */
+inline size_t level_structure(const std::vector<std::vector<size_t> >& adj, size_t root, std::vector<size_t>& mark,
+                              size_t stamp, std::vector<size_t>& order, std::vector<size_t>& level) {
+  order.clear();
+  order.push_back(root);
+  mark[root]  = stamp;
+  level[root] = 0;
+
+  size_t depth = 1;
+  for (size_t head = 0; head < order.size(); ++head) {
+    const size_t i     = order[head];
+    const size_t start = order.size();
+
+    for (size_t t = 0; t < adj[i].size(); ++t) {
+      const size_t j = adj[i][t];
+      if (mark[j] == stamp) continue;
+      mark[j]  = stamp;
+      level[j] = level[i] + 1;
+      depth    = std::max(depth, level[j] + 1);
+      order.push_back(j);
+    }
+
+    std::sort(order.begin() + start, order.end(), [&](size_t a, size_t b) {
+      return adj[a].size() < adj[b].size() || (adj[a].size() == adj[b].size() && a < b);
+    });
+  }
+
+  return depth;
+}
+
+/*
+ * A reverse Cuthill-McKee ordering of the n-by-n new Yale matrix whose ija array is given, which reduces the bandwidth
+ * (and profile) of A + A**T: perm[k] is the row and column to put k-th. Each connected component is numbered by a
+ * breadth-first search from a pseudo-peripheral node, found as by George and Liu (1979), and the whole numbering is
+ * then reversed.
+ */
+inline void reverse_cuthill_mckee(const size_t n, const size_t* ija, size_t* perm) {
+  std::vector<std::vector<size_t> > adj;
+  symmetric_adjacency(n, ija, adj);
+
+  std::vector<size_t> by_degree(n), mark(n, 0), level(n), order, trial;
+  for (size_t i = 0; i < n; ++i) by_degree[i] = i;
+  std::stable_sort(by_degree.begin(), by_degree.end(), [&](size_t a, size_t b) { return adj[a].size() < adj[b].size(); });
+
+  // mark[i] is 1 once i is numbered; larger stamps are for the trial searches.
+  size_t k = 0, stamp = 1;
+  for (size_t t = 0; t < n; ++t) {
+    size_t root = by_degree[t];
+    if (mark[root] == 1) continue;
+
+    // Move the root to a node of minimum degree in the last level until the number of levels stops growing.
+    size_t depth = level_structure(adj, root, mark, ++stamp, trial, level);
+    for (;;) {
+      size_t next = root;
+      for (size_t u = 0; u < trial.size(); ++u) {
+        const size_t i = trial[u];
+        if (level[i] + 1 == depth && (next == root || adj[i].size() < adj[next].size())) next = i;
+      }
+      if (next == root) break;
+
+      const size_t d = level_structure(adj, next, mark, ++stamp, order, level);
+      if (d <= depth) break;
+      root  = next;
+      depth = d;
+      trial.swap(order);
+    }
+
+    level_structure(adj, root, mark, 1, order, level);
+    for (size_t u = 0; u < order.size(); ++u) perm[k++] = order[u];
+  }
+
+  std::reverse(perm, perm + n);
+}
+
+} } // end of namespace nm::yale_storage
+
+#endif
@@ -0,0 +1,152 @@
+/////////////////////////////////////////////////////////////////////
+// = NMatrix
+//
+// A linear algebra library for scientific computation in Ruby.
+// NMatrix is part of SciRuby.
+//
+// NMatrix was originally inspired by and derived from NArray, by
+// Masahiro Tanaka: http://narray.rubyforge.org
+//
+// == Copyright Information
+//
+// SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+// NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+//
+// Please see LICENSE.txt for additional copyright notices.
+//
+// == Contributing
+//
+// By contributing source code to SciRuby, you agree to be bound by
+// our Contributor Agreement:
+//
+// * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+//
+// == spgemm.h
+//
+// Functions for Yale math: sparse matrix-matrix products split into a
+// symbolic phase, which finds the pattern of C = A * B once, and a
+// numeric one, which fills that pattern in for any A and B whose
+// patterns are (no bigger than) the ones it was found for.
+//
+// Unlike symbmm and numbmm in math/math.h, which find the pattern of
+// each product anew and drop the entries that come out zero, the
+// pattern here is fixed: C keeps every entry the patterns of A and B
+// can produce. Its columns are sorted within each row.
+//
+// Diagonal entries are always stored in Yale, so the ones that are
+// zero when the pattern is found are left out of it (diag flags);
+// the numeric phase likewise skips zeros on the diagonal.
+//
+
+#ifndef YALE_MATH_SPGEMM_H
+# define YALE_MATH_SPGEMM_H
+
+#include <algorithm>
+#include <stdint.h>
+#include <vector>
+
+#include "math/conjugate.h"
+
+namespace nm { namespace yale_storage {
+
+/*
+ * Symbolic phase: the pattern of C = A * B, where A is the n-by-m new Yale matrix whose ija is ia and B the m-by-l one
+ * whose ija is ib. adiag[i] (bdiag[i]) says whether A's (B's) diagonal entry in row i is part of its pattern.
+ *
+ * If ic isn't NULL, C's ija goes into it. Returns its length: n+1 plus the number of off-diagonal entries in C.
+ */
+inline size_t spgemm_symbolic(const size_t n, const size_t m, const size_t l, const size_t* ia, const char* adiag,
+                              const size_t* ib, const char* bdiag, int64_t* ic) {
+  std::vector<size_t> mark(l, n), cols;
+  size_t              pos = n + 1;
+
+  for (size_t i = 0; i < n; ++i) {
+    if (ic) ic[i] = pos;
+    cols.clear();
+
+    for (size_t p = ia[i]; p <= ia[i+1]; ++p) {
+      // The last pass through is A's diagonal entry.
+      const size_t j = p < ia[i+1] ? ia[p] : i;
+      if (p == ia[i+1] && !(i < m && adiag[i])) continue;
+
+      for (size_t q = ib[j]; q <= ib[j+1]; ++q) {
+        const size_t k = q < ib[j+1] ? ib[q] : j;
+        if (q == ib[j+1] && !(j < l && bdiag[j])) continue;
+
+        if (k != i && mark[k] != i) {
+          mark[k] = i;
+          cols.push_back(k);
+        }
+      }
+    }
+
+    if (ic) {
+      std::sort(cols.begin(), cols.end());
+      std::copy(cols.begin(), cols.end(), ic + pos);
+    }
+    pos += cols.size();
+  }
+
+  if (ic) ic[n] = pos;
+  return pos;
+}
+
+/*
+ * Adds v times row j of B (given by ib and b, with m rows and l columns) to C's row, whose entries are at pos[k] for
+ * each column k (-1 for the ones not in the pattern). Returns false if that would touch an entry not in the pattern.
+ */
+template <typename DType>
+inline bool spgemm_axpy_row(const size_t j, const DType v, const size_t m, const size_t l, const size_t* ib,
+                            const DType* b, const int64_t* pos, DType* c) {
+  if (j < l && !nm::math::exactly_zero(b[j])) {
+    if (pos[j] < 0) return false;
+    c[pos[j]] += v * b[j];
+  }
+
+  for (size_t q = ib[j]; q < ib[j+1]; ++q) {
+    const int64_t p = pos[ib[q]];
+    if (p < 0) return false;
+    c[p] += v * b[q];
+  }
+
+  return true;
+}
+
+/*
+ * Numeric phase: fills c, the values of C = A * B for the pattern ic found by spgemm_symbolic, from those of A (ia, a)
+ * and B (ib, b). pos is work space for l entries.
+ *
+ * Returns false if A and B have entries outside the patterns the symbolic phase was done for, in which case c is left
+ * partly filled in.
+ */
+template <typename DType>
+inline bool spgemm_numeric(const size_t n, const size_t m, const size_t l, const size_t* ia, const DType* a,
+                           const size_t* ib, const DType* b, const int64_t* ic, DType* c, int64_t* pos) {
+  std::fill(pos, pos + l, -1);
+
+  for (size_t i = 0; i < n; ++i) {
+    c[i] = 0;
+    if (i < l) pos[i] = i;
+    for (int64_t p = ic[i]; p < ic[i+1]; ++p) {
+      pos[ic[p]] = p;
+      c[p]       = 0;
+    }
+
+    if (i < m && !nm::math::exactly_zero(a[i])) {
+      if (!spgemm_axpy_row<DType>(i, a[i], m, l, ib, b, pos, c)) return false;
+    }
+    for (size_t p = ia[i]; p < ia[i+1]; ++p) {
+      if (!spgemm_axpy_row<DType>(ia[p], a[p], m, l, ib, b, pos, c)) return false;
+    }
+
+    if (i < l) pos[i] = -1;
+    for (int64_t p = ic[i]; p < ic[i+1]; ++p) pos[ic[p]] = -1;
+  }
+
+  c[n] = 0; // the default value
+  return true;
+}
+
+} } // end of namespace nm::yale_storage
+
+#endif
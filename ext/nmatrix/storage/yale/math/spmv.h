@@ -0,0 +1,55 @@
+/////////////////////////////////////////////////////////////////////
+// = NMatrix
+//
+// A linear algebra library for scientific computation in Ruby.
+// NMatrix is part of SciRuby.
+//
+// NMatrix was originally inspired by and derived from NArray, by
+// Masahiro Tanaka: http://narray.rubyforge.org
+//
+// == Copyright Information
+//
+// SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+// NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+//
+// Please see LICENSE.txt for additional copyright notices.
+//
+// == Contributing
+//
+// By contributing source code to SciRuby, you agree to be bound by
+// our Contributor Agreement:
+//
+// * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+//
+// == spmv.h
+//
+// Functions for Yale math: sparse matrix-vector multiplication
+//
+
+#ifndef YALE_MATH_SPMV_H
+# define YALE_MATH_SPMV_H
+
+namespace nm { namespace yale_storage {
+
+/*
+ * y := A * x, where A is an n-by-m new Yale matrix (diagonal first) whose default value is zero, given by its ija and
+ * a arrays.
+ *
+ * Like transpose_yale, this does not act on a YALE_STORAGE object, so that the iterative solvers can call it on the
+ * raw arrays.
+ */
+template <typename DType>
+inline void spmv(const size_t n, const size_t m, const size_t* ija, const DType* a, const DType* x, DType* y) {
+  for (size_t i = 0; i < n; ++i) {
+    DType sum = i < m ? a[i] * x[i] : DType(0);
+
+    for (size_t p = ija[i]; p < ija[i+1]; ++p)
+      sum += a[p] * x[ija[p]];
+
+    y[i] = sum;
+  }
+}
+
+} } // end of namespace nm::yale_storage
+
+#endif
@@ -0,0 +1,150 @@
+/////////////////////////////////////////////////////////////////////
+// = NMatrix
+//
+// A linear algebra library for scientific computation in Ruby.
+// NMatrix is part of SciRuby.
+//
+// NMatrix was originally inspired by and derived from NArray, by
+// Masahiro Tanaka: http://narray.rubyforge.org
+//
+// == Copyright Information
+//
+// SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+// NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+//
+// Please see LICENSE.txt for additional copyright notices.
+//
+// == Contributing
+//
+// By contributing source code to SciRuby, you agree to be bound by
+// our Contributor Agreement:
+//
+// * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+//
+// == triangular.h
+//
+// Functions for Yale math: solves with the lower or upper triangle of a
+// square sparse matrix, by rows, in level-scheduled order.
+//
+// Only the entries of the chosen triangle are read, so the L and U of a
+// factorization kept in one matrix (as ilu0 leaves them) can each be
+// used in place. The diagonal comes from Yale's separate diagonal array,
+// or is taken to be one.
+//
+
+#ifndef YALE_MATH_TRIANGULAR_H
+# define YALE_MATH_TRIANGULAR_H
+
+#include <algorithm>
+#include <stdint.h>
+#include <vector>
+
+#include "math/conjugate.h"
+
+namespace nm { namespace yale_storage {
+
+/*
+ * Dependency levels of a triangular solve with the lower (or upper) triangle of the n-by-n new Yale matrix whose ija
+ * array is given: row i's level is one more than the highest level of the rows its off-diagonal entries in the
+ * triangle refer to, so the rows of a level depend only on those of earlier levels and can be solved in any order, or
+ * at the same time.
+ *
+ * On return, the rows of level l are order[level_ptr[l]] to order[level_ptr[l+1]-1], in ascending order; level_ptr
+ * must have room for n+1 entries. Returns the number of levels.
+ */
+inline int64_t triangular_levels(const size_t n, const size_t* ija, const bool lower, int64_t* level_ptr,
+                                 int64_t* order) {
+  std::vector<size_t> level(n, 0);
+  size_t              nlevels = 0;
+
+  for (size_t t = 0; t < n; ++t) {
+    const size_t i = lower ? t : n - 1 - t;
+    size_t       l = 0;
+
+    for (size_t p = ija[i]; p < ija[i+1]; ++p) {
+      const size_t j = ija[p];
+      if (lower ? j < i : j > i) l = std::max(l, level[j] + 1);
+    }
+
+    level[i] = l;
+    nlevels  = std::max(nlevels, l + 1);
+  }
+
+  // Counting sort of the rows by level.
+  std::fill(level_ptr, level_ptr + nlevels + 1, 0);
+  for (size_t i = 0; i < n; ++i) ++level_ptr[level[i] + 1];
+  for (size_t l = 0; l < nlevels; ++l) level_ptr[l+1] += level_ptr[l];
+
+  std::vector<int64_t> next(level_ptr, level_ptr + nlevels);
+  for (size_t i = 0; i < n; ++i) order[next[level[i]]++] = i;
+
+  return nlevels;
+}
+
+/*
+ * Checks a schedule from triangular_levels against the n-by-n new Yale matrix whose ija array is given. Returns 0 if
+ * level_ptr is non-decreasing from 0 to n, order is a permutation of 0...n, and every off-diagonal entry of the
+ * triangle refers to a row of an earlier level; 1 if level_ptr or order is malformed; and 2 if the schedule doesn't
+ * fit the matrix's sparsity pattern.
+ */
+inline int triangular_schedule_check(const size_t n, const size_t* ija, const bool lower, const int64_t nlevels,
+                                     const int64_t* level_ptr, const int64_t* order) {
+  if (nlevels < 0 || (size_t)nlevels > n || level_ptr[0] != 0 || level_ptr[nlevels] != (int64_t)n) return 1;
+
+  std::vector<int64_t> level(n, -1);
+  for (int64_t l = 0; l < nlevels; ++l) {
+    if (level_ptr[l+1] < level_ptr[l]) return 1;
+
+    for (int64_t t = level_ptr[l]; t < level_ptr[l+1]; ++t) {
+      if (order[t] < 0 || order[t] >= (int64_t)n || level[order[t]] >= 0) return 1;
+      level[order[t]] = l;
+    }
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t p = ija[i]; p < ija[i+1]; ++p) {
+      const size_t j = ija[p];
+      if ((lower ? j < i : j > i) && level[j] >= level[i]) return 2;
+    }
+  }
+
+  return 0;
+}
+
+/*
+ * Solves T * X = B in place, where T is the lower (or upper) triangle of the n-by-n new Yale matrix given by ija and a,
+ * with a unit diagonal if unit is set, and X is the row-major n-by-nrhs x. Rows are taken in the order given by
+ * triangular_levels, and each row's update is done for all of the right-hand sides at once, which keeps the accesses
+ * to x contiguous.
+ *
+ * Returns 0, or i+1 if row i has a zero on the diagonal.
+ */
+template <typename DType>
+inline size_t triangular_solve(const size_t n, const size_t* ija, const DType* a, const bool lower, const bool unit,
+                               const int64_t nlevels, const int64_t* level_ptr, const int64_t* order, DType* x,
+                               const size_t nrhs) {
+  for (int64_t t = 0; t < level_ptr[nlevels]; ++t) {
+    const size_t i  = order[t];
+    DType*       xi = x + i*nrhs;
+
+    for (size_t p = ija[i]; p < ija[i+1]; ++p) {
+      const size_t j = ija[p];
+      if (lower ? j >= i : j <= i) continue;
+
+      const DType  aij = a[p];
+      const DType* xj  = x + j*nrhs;
+      for (size_t c = 0; c < nrhs; ++c) xi[c] -= aij * xj[c];
+    }
+
+    if (!unit) {
+      if (nm::math::exactly_zero(a[i])) return i + 1;
+      for (size_t c = 0; c < nrhs; ++c) xi[c] /= a[i];
+    }
+  }
+
+  return 0;
+}
+
+} } // end of namespace nm::yale_storage
+
+#endif
@@ -47,6 +47,8 @@
 #include <typeinfo>
 #include <tuple>
 #include <queue>
+#include <unordered_map>
+#include <vector>
 
 /*
  * Project Includes
@@ -55,8 +57,10 @@
 // #include "types.h"
 #include "../../data/data.h"
 #include "../../math/math.h"
+#include "../../math/conjugate.h"
 
 #include "../common.h"
+#include "../dense/dense.h"
 
 #include "../../nmatrix.h"
 #include "../../data/meta.h"
@@ -70,6 +74,7 @@
 #include "class.h"
 #include "yale.h"
 #include "../../ruby_constants.h"
+#include "../../util/io.h"
 
 /*
  * Macros
@@ -257,6 +262,118 @@ YALE_STORAGE* create_from_old_yale(dtype_t dtype, size_t* shape, char* r_ia, cha
 }
 
 
+/*
+ * One pass of a stable counting sort: writes into out the entries of in (or 0...n if in is NULL), ordered by key.
+ * count must have room for key_max+1 entries.
+ */
+static void coo_counting_sort(const size_t* key, const size_t* in, size_t n, size_t key_max, size_t* count, size_t* out) {
+  std::fill(count, count + key_max + 1, 0);
+
+  for (size_t k = 0; k < n; ++k)
+    ++count[ key[in ? in[k] : k] + 1 ];
+
+  for (size_t i = 1; i < key_max; ++i) // count[i] becomes the first output position for key i
+    count[i] += count[i-1];
+
+  for (size_t k = 0; k < n; ++k) {
+    size_t idx = in ? in[k] : k;
+    out[ count[key[idx]]++ ] = idx;
+  }
+}
+
+
+/*
+ * Walk the sorted triplets, merging duplicate coordinates, and yield (i, j, value) once per coordinate. Duplicates
+ * are summed, or if sum_duplicates is false, the last one given wins (the counting sort is stable).
+ */
+template <typename DType, typename Yield>
+static void coo_each_merged(size_t n, const size_t* order, const size_t* ir, const size_t* jr, const DType* v, bool sum_duplicates, Yield yield) {
+  size_t k = 0;
+  while (k < n) {
+    size_t p = order[k], i = ir[p], j = jr[p];
+    DType val = v[p];
+
+    for (++k; k < n && ir[order[k]] == i && jr[order[k]] == j; ++k) {
+      if (sum_duplicates) val += v[order[k]];
+      else                val  = v[order[k]];
+    }
+
+    yield(i, j, val);
+  }
+}
+
+
+/*
+ * Build a Yale matrix from coordinate (COO) triplets in one go: sort the triplets by row and then column with two
+ * counting sorts, count the non-diagonal entries per row, and then write IJA, A, and the diagonal exactly once into
+ * storage allocated at its precise final size. This is O(n + rows + cols), instead of the O(n^2) worst case of
+ * inserting the triplets one at a time.
+ *
+ * Entries which end up equal to zero (the default value) are not stored.
+ */
+template <typename DType>
+static YALE_STORAGE* create_from_coo(size_t* shape, size_t n, const size_t* ir, const size_t* jr, const void* v_, bool sum_duplicates) {
+  const DType  ZERO(0);
+  const DType* v = reinterpret_cast<const DType*>(v_);
+
+  size_t* by_col = NM_ALLOC_N(size_t, n);
+  size_t* order  = NM_ALLOC_N(size_t, n);
+  size_t* count  = NM_ALLOC_N(size_t, NM_MAX(shape[0], shape[1]) + 1);
+
+  // Radix sort on (row, column): first by column, then stably by row.
+  coo_counting_sort(jr, NULL,   n, shape[1], count, by_col);
+  coo_counting_sort(ir, by_col, n, shape[0], count, order);
+  NM_FREE(by_col);
+
+  // Count the non-diagonal non-zeros in each row.
+  std::fill(count, count + shape[0], 0);
+  coo_each_merged<DType>(n, order, ir, jr, v, sum_duplicates, [&](size_t i, size_t j, const DType& val) {
+    if (i != j && val != ZERO) ++count[i];
+  });
+
+  size_t ndnz = 0;
+  for (size_t i = 0; i < shape[0]; ++i)
+    ndnz += count[i];
+
+  YALE_STORAGE* s = YaleStorage<DType>::alloc(shape, 2);
+  s->ndnz         = ndnz;
+  s->capacity     = shape[0] + ndnz + 1;
+  s->ija          = NM_ALLOC_N(IType, s->capacity);
+  s->a            = NM_ALLOC_N(DType, s->capacity);
+  IType* ija      = s->ija;
+  DType* a        = reinterpret_cast<DType*>(s->a);
+
+  ija[0] = shape[0] + 1;
+  for (size_t i = 0; i < shape[0]; ++i) {
+    ija[i+1]  = ija[i] + count[i];
+    count[i]  = ija[i]; // becomes the insertion position for row i
+  }
+
+  if (s->dtype == nm::RUBYOBJ) { // values must be visible to the GC before we call back into Ruby to add them.
+    std::fill(a, a + s->capacity, ZERO);
+    nm_yale_storage_register(reinterpret_cast<STORAGE*>(s));
+  } else {
+    std::fill(a, a + shape[0] + 1, ZERO); // diagonal and default value
+  }
+
+  coo_each_merged<DType>(n, order, ir, jr, v, sum_duplicates, [&](size_t i, size_t j, const DType& val) {
+    if (i == j) {
+      a[i] = val;
+    } else if (val != ZERO) {
+      ija[count[i]] = j;
+      a[count[i]++] = val;
+    }
+  });
+
+  if (s->dtype == nm::RUBYOBJ) nm_yale_storage_unregister(reinterpret_cast<STORAGE*>(s));
+
+  NM_FREE(order);
+  NM_FREE(count);
+
+  return s;
+}
+
+
 /*
  * Empty the matrix by initializing the IJA vector and setting the diagonal to 0.
  *
@@ -373,6 +490,160 @@ void set(VALUE left, SLICE* slice, VALUE right) {
   y.insert(slice, right);
 }
 
+
+/*
+ * Staging area for NMatrix#batch_update, kept by the matrix's source storage in its batch field. Single-cell
+ * assignments are appended here instead of being inserted into the matrix one at a time (each of which may shift the
+ * whole IJA/A tail), and are merged all at once by batch_commit. A cell assigned again has its staged value replaced,
+ * and reads of single cells look here first, so the block sees its own assignments.
+ */
+struct batch_t {
+  const size_t        columns, elem_size;
+  std::vector<size_t> i, j;   // real coordinates
+  std::vector<char>   v;      // packed values of the matrix's dtype
+  std::unordered_map<size_t, size_t> staged; // i*columns + j -> where that cell is in i, j and v
+
+  batch_t(const YALE_STORAGE* s) : columns(s->shape[1]), elem_size(DTYPE_SIZES[s->dtype]) { }
+
+  size_t size() const { return i.size(); }
+
+  // The staged value for the cell at real coordinates (ii, jj), or NULL if it hasn't been assigned.
+  void* find(size_t ii, size_t jj) {
+    std::unordered_map<size_t, size_t>::const_iterator it = staged.find(ii * columns + jj);
+    return it == staged.end() ? NULL : reinterpret_cast<void*>(&(v[it->second * elem_size]));
+  }
+
+  // Room for the value of the cell at real coordinates (ii, jj), whether it was staged already or not.
+  void* stage(size_t ii, size_t jj) {
+    std::pair<std::unordered_map<size_t, size_t>::iterator, bool> ins = staged.insert(std::make_pair(ii * columns + jj, size()));
+    if (ins.second) {
+      i.push_back(ii);
+      j.push_back(jj);
+      v.resize(v.size() + elem_size);
+    }
+    return reinterpret_cast<void*>(&(v[ins.first->second * elem_size]));
+  }
+
+  void clear() {
+    i.clear();
+    j.clear();
+    v.clear();
+    staged.clear();
+  }
+};
+
+
+template <typename DType>
+static void compact(YALE_STORAGE* s) {
+  YaleStorage<DType>(s).compact();
+}
+
+
+/*
+ * Merge the staged assignments of a batch into the matrix in one rebuild: O(k log k) to sort the k staged entries and
+ * O(nnz) to copy the rest of the matrix across. When a position was assigned more than once, the last assignment wins;
+ * assigning the default value erases a stored entry.
+ */
+template <typename DType>
+static void batch_commit(YALE_STORAGE* s, batch_t& b) {
+  const size_t k = b.size();
+  if (k == 0) return;
+
+  YaleStorage<DType>(s).compact(); // the merge below works on the raw structure
+
+  const size_t *bi = &(b.i[0]),
+               *bj = &(b.j[0]);
+  const DType*  bv = reinterpret_cast<const DType*>(&(b.v[0]));
+
+  std::vector<size_t> order(k);
+  for (size_t p = 0; p < k; ++p) order[p] = p;
+  std::stable_sort(order.begin(), order.end(), [&](size_t x, size_t y) {
+    return bi[x] < bi[y] || (bi[x] == bi[y] && bj[x] < bj[y]);
+  });
+
+  const size_t r = s->shape[0];
+  IType*  ija    = s->ija;
+  DType*  a      = reinterpret_cast<DType*>(s->a);
+  const DType& default_val = a[r];
+
+  // Drop superseded assignments and apply diagonal ones, which don't change the structure. Comparisons against the
+  // default may call into Ruby, so they all happen here, before anything new is allocated.
+  std::vector<size_t> nd;    // surviving non-diagonal assignments, in row-column order
+  std::vector<bool>   erase; // whether each of those sets the default value
+  nd.reserve(k);
+  erase.reserve(k);
+
+  for (size_t p = 0; p < k; ++p) {
+    size_t x = order[p];
+    if (p+1 < k && bi[order[p+1]] == bi[x] && bj[order[p+1]] == bj[x]) continue;
+
+    if (bi[x] == bj[x]) a[bi[x]] = bv[x];
+    else {
+      nd.push_back(x);
+      erase.push_back(bv[x] == default_val);
+    }
+  }
+
+  // Count the change in size, row by row.
+  long delta = 0;
+  for (size_t p = 0; p < nd.size(); ) {
+    size_t i = bi[nd[p]], q = ija[i], q_end = ija[i+1];
+    for (; p < nd.size() && bi[nd[p]] == i; ++p) {
+      while (q < q_end && ija[q] < bj[nd[p]]) ++q;
+
+      if (q < q_end && ija[q] == bj[nd[p]]) {
+        if (erase[p]) --delta;
+        ++q;
+      } else if (!erase[p]) ++delta;
+    }
+  }
+
+  const size_t new_size = ija[r] + delta,
+               new_cap  = NM_MAX(new_size, s->capacity);
+  IType* new_ija = NM_ALLOC_N(IType, new_cap);
+  DType* new_a   = NM_ALLOC_N(DType, new_cap);
+
+  std::copy(a, a + r + 1, new_a); // diagonal and default value
+  if (s->dtype == nm::RUBYOBJ) std::fill(new_a + new_size, new_a + new_cap, default_val);
+
+  size_t pp = r + 1;
+  for (size_t i = 0, p = 0; i < r; ++i) {
+    size_t q = ija[i], q_end = ija[i+1];
+    new_ija[i] = pp;
+
+    for (; p < nd.size() && bi[nd[p]] == i; ++p) {
+      size_t x = nd[p];
+      for (; q < q_end && ija[q] < bj[x]; ++q, ++pp) {
+        new_ija[pp] = ija[q];
+        new_a[pp]   = a[q];
+      }
+
+      if (q < q_end && ija[q] == bj[x]) ++q; // replaced or erased
+
+      if (!erase[p]) {
+        new_ija[pp] = bj[x];
+        new_a[pp]   = bv[x];
+        ++pp;
+      }
+    }
+
+    // Copy the rest of the row (or all of it, if it wasn't touched).
+    std::copy(ija + q, ija + q_end, new_ija + pp);
+    std::copy(a + q,   a + q_end,   new_a + pp);
+    pp += q_end - q;
+  }
+  new_ija[r] = pp;
+
+  NM_FREE(s->ija);
+  NM_FREE(s->a);
+  s->ija       = new_ija;
+  s->a         = reinterpret_cast<void*>(new_a);
+  s->capacity  = new_cap;
+  s->ndnz     += delta;
+
+  b.clear();
+}
+
 ///////////
 // Tests //
 ///////////
@@ -727,6 +998,283 @@ static STORAGE* matrix_multiply(const STORAGE_PAIR& casted_storage, size_t* resu
 }
 
 
+/*
+ * Product of a (non-reference) Yale matrix, whose default value is zero, and a dense matrix of the same dtype, giving
+ * a dense matrix. Row i of the result is the diagonal entry a_ii times row i of the right-hand matrix plus a_ij times
+ * row j for each stored non-diagonal a_ij, so the work is proportional to the number of stored entries times the
+ * number of columns of the right-hand matrix.
+ */
+template <typename DType>
+static STORAGE* matrix_multiply_dense(const STORAGE_PAIR& casted_storage, size_t* resulting_shape) {
+  const YALE_STORAGE*  left  = reinterpret_cast<const YALE_STORAGE*>(casted_storage.left);
+  const DENSE_STORAGE* right = reinterpret_cast<const DENSE_STORAGE*>(casted_storage.right);
+  const IType* ija  = left->ija;
+  const DType* a    = reinterpret_cast<const DType*>(left->a);
+  const DType* b    = reinterpret_cast<const DType*>(right->elements);
+  const size_t m    = resulting_shape[0],
+               n    = resulting_shape[1],
+               kmax = right->shape[0];
+
+  DType* c = NM_ALLOC_N(DType, m * n);
+  std::fill(c, c + m * n, DType(0));
+
+  for (size_t i = 0; i < m; ++i) {
+    DType* c_row = c + i * n;
+
+    if (i < kmax && !nm::math::exactly_zero(a[i])) {
+      const DType* b_row = b + i * n;
+      for (size_t j = 0; j < n; ++j) c_row[j] += a[i] * b_row[j];
+    }
+
+    for (IType p = ija[i]; p < ija[i+1]; ++p) {
+      const DType* b_row = b + ija[p] * n;
+      const DType  aij   = a[p];
+      for (size_t j = 0; j < n; ++j) c_row[j] += aij * b_row[j];
+    }
+  }
+
+  return reinterpret_cast<STORAGE*>(nm_dense_storage_create(left->dtype, resulting_shape, 2, c, m * n));
+}
+
+
+/*
+ * Allocate a matrix with room for exactly ndnz non-diagonal entries. Takes ownership of shape.
+ */
+template <typename DType>
+static YALE_STORAGE* alloc_exact(size_t* shape, size_t ndnz) {
+  YALE_STORAGE* s = YaleStorage<DType>::alloc(shape, 2);
+  s->ndnz         = ndnz;
+  s->capacity     = shape[0] + ndnz + 1;
+  s->ija          = NM_ALLOC_N(IType, s->capacity);
+  s->a            = NM_ALLOC_N(DType, s->capacity);
+  return s;
+}
+
+
+/*
+ * Walk the non-diagonal entries of row i of two matrices in column order, yielding the column and op applied to the
+ * pair of values. A column stored in only one of the matrices is paired with the other's default value.
+ */
+template <typename DType, typename Op, typename Yield>
+static inline void ew_merge_row(size_t i, const IType* lij, const DType* la, const DType& ldef,
+                                          const IType* rij, const DType* ra, const DType& rdef, Op op, Yield yield) {
+  IType p = lij[i], p_end = lij[i+1],
+        q = rij[i], q_end = rij[i+1];
+
+  while (p < p_end || q < q_end) {
+    if (q == q_end || (p < p_end && lij[p] < rij[q])) {
+      yield(lij[p], op(la[p], rdef));
+      ++p;
+    } else if (p == p_end || rij[q] < lij[p]) {
+      yield(rij[q], op(ldef, ra[q]));
+      ++q;
+    } else {
+      yield(lij[p], op(la[p], ra[q]));
+      ++p; ++q;
+    }
+  }
+}
+
+
+/*
+ * Element-wise operation on two (non-reference) matrices of the same shape and dtype, done by merging their sorted
+ * rows directly. The result's default is op applied to the two defaults, and only results which differ from it are
+ * stored -- so with zero defaults, + and - give the union of the stored entries and * gives their intersection.
+ *
+ * The first pass counts the result entries in each row, so that the result can be allocated at its exact size; the
+ * second pass fills it in.
+ */
+template <typename DType, typename Op>
+static YALE_STORAGE* ew_merge_with(const YALE_STORAGE* l, const YALE_STORAGE* r, Op op) {
+  const size_t n    = l->shape[0];
+  const IType* lij  = l->ija;
+  const IType* rij  = r->ija;
+  const DType* la   = reinterpret_cast<const DType*>(l->a);
+  const DType* ra   = reinterpret_cast<const DType*>(r->a);
+  const DType  ldef = la[n], rdef = ra[n];
+  const DType  def  = op(ldef, rdef);
+
+  size_t ndnz = 0;
+  for (size_t i = 0; i < n; ++i) {
+    ew_merge_row<DType>(i, lij, la, ldef, rij, ra, rdef, op, [&](IType j, const DType& v) {
+      if (v != def) ++ndnz;
+    });
+  }
+
+  size_t* shape   = NM_ALLOC_N(size_t, 2);
+  shape[0]        = l->shape[0];
+  shape[1]        = l->shape[1];
+  YALE_STORAGE* s = alloc_exact<DType>(shape, ndnz);
+  IType* ija      = s->ija;
+  DType* a        = reinterpret_cast<DType*>(s->a);
+
+  IType pp = n + 1;
+  for (size_t i = 0; i < n; ++i) {
+    ija[i] = pp;
+    a[i]   = op(la[i], ra[i]);
+    ew_merge_row<DType>(i, lij, la, ldef, rij, ra, rdef, op, [&](IType j, const DType& v) {
+      if (v != def) {
+        ija[pp] = j;
+        a[pp++] = v;
+      }
+    });
+  }
+  ija[n] = pp;
+  a[n]   = def;
+
+  return s;
+}
+
+template <typename DType>
+static YALE_STORAGE* ew_merge(const YALE_STORAGE* l, const YALE_STORAGE* r, nm::ewop_t op) {
+  switch(op) {
+  case nm::EW_ADD: return ew_merge_with<DType>(l, r, ew_add<DType>());
+  case nm::EW_SUB: return ew_merge_with<DType>(l, r, ew_sub<DType>());
+  case nm::EW_MUL: return ew_merge_with<DType>(l, r, ew_mul<DType>());
+  default:         rb_raise(rb_eNotImpError, "no native yale implementation of this element-wise operation");
+  }
+  return NULL;
+}
+
+
+/*
+ * Element-wise operation of a (non-reference) matrix with a scalar of the same dtype. Like ew_merge_with, the result is
+ * exactly sized, and only stores entries which differ from its new default.
+ */
+template <typename DType, typename Op>
+static YALE_STORAGE* ew_scalar_with(const YALE_STORAGE* l, const DType& x, Op op) {
+  const size_t n   = l->shape[0];
+  const IType* lij = l->ija;
+  const DType* la  = reinterpret_cast<const DType*>(l->a);
+  const DType  def = op(la[n], x);
+
+  size_t ndnz = 0;
+  for (IType p = lij[0]; p < lij[n]; ++p) {
+    if (op(la[p], x) != def) ++ndnz;
+  }
+
+  size_t* shape   = NM_ALLOC_N(size_t, 2);
+  shape[0]        = l->shape[0];
+  shape[1]        = l->shape[1];
+  YALE_STORAGE* s = alloc_exact<DType>(shape, ndnz);
+  IType* ija      = s->ija;
+  DType* a        = reinterpret_cast<DType*>(s->a);
+
+  IType pp = n + 1;
+  for (size_t i = 0; i < n; ++i) {
+    ija[i] = pp;
+    a[i]   = op(la[i], x);
+    for (IType p = lij[i]; p < lij[i+1]; ++p) {
+      DType v = op(la[p], x);
+      if (v != def) {
+        ija[pp] = lij[p];
+        a[pp++] = v;
+      }
+    }
+  }
+  ija[n] = pp;
+  a[n]   = def;
+
+  return s;
+}
+
+template <typename DType>
+static YALE_STORAGE* ew_scalar(const YALE_STORAGE* l, const void* x_, nm::ewop_t op) {
+  const DType& x = *reinterpret_cast<const DType*>(x_);
+  switch(op) {
+  case nm::EW_ADD: return ew_scalar_with<DType>(l, x, ew_add<DType>());
+  case nm::EW_SUB: return ew_scalar_with<DType>(l, x, ew_sub<DType>());
+  case nm::EW_MUL: return ew_scalar_with<DType>(l, x, ew_mul<DType>());
+  default:         rb_raise(rb_eNotImpError, "no native yale implementation of this element-wise operation");
+  }
+  return NULL;
+}
+
+
+/*
+ * A copy of l with its rows and columns permuted: row i of the copy is row rows[i] of l, and column j is column cols[j],
+ * where cinv is the inverse of cols. Entries of l's diagonal which move off it are dropped if they equal the default
+ * value. The copy's entries are put in order with two counting sorts (into columns, visiting the new rows in order, and
+ * then back into rows, visiting the columns in order), so this takes O(n + nnz) time, and sorts no rows.
+ *
+ * The sorts only move positions in l, so for :object matrices no Ruby values are held outside of l until the copy is
+ * written out.
+ */
+template <typename DType>
+static YALE_STORAGE* copy_permuted(const YALE_STORAGE* l, const size_t* rows, const size_t* cinv) {
+  const size_t n   = l->shape[0], m = l->shape[1];
+  const IType* lij = l->ija;
+  const DType* la  = reinterpret_cast<const DType*>(l->a);
+  const DType& def = la[n];
+
+  // The new column of each of l's diagonal entries that leaves the diagonal, or m for those that stay or are dropped.
+  std::vector<size_t> diag_col(n, m), colptr(m + 1, 0);
+  for (size_t i = 0; i < n; ++i) {
+    const size_t r = rows[i];
+    if (r < m && cinv[r] != i && la[r] != def) {
+      diag_col[i] = cinv[r];
+      ++colptr[cinv[r] + 1];
+    }
+    for (IType p = lij[r]; p < lij[r+1]; ++p)
+      if (cinv[lij[p]] != i) ++colptr[cinv[lij[p]] + 1];
+  }
+  for (size_t j = 0; j < m; ++j) colptr[j+1] += colptr[j];
+
+  const size_t        ndnz = colptr[m];
+  std::vector<size_t> next(colptr.begin(), colptr.end() - 1), row(ndnz), src(ndnz), rowptr(n + 1, 0);
+  for (size_t i = 0; i < n; ++i) {
+    const size_t r = rows[i];
+    if (diag_col[i] < m) {
+      const size_t k = next[diag_col[i]]++;
+      row[k] = i;
+      src[k] = r;
+    }
+    for (IType p = lij[r]; p < lij[r+1]; ++p) {
+      const size_t j = cinv[lij[p]];
+      if (j == i) continue;
+      const size_t k = next[j]++;
+      row[k] = i;
+      src[k] = p;
+    }
+  }
+
+  for (size_t k = 0; k < ndnz; ++k) ++rowptr[row[k] + 1];
+
+  size_t* shape   = NM_ALLOC_N(size_t, 2);
+  shape[0]        = n;
+  shape[1]        = m;
+  YALE_STORAGE* s = alloc_exact<DType>(shape, ndnz);
+  IType* ija      = s->ija;
+  DType* a        = reinterpret_cast<DType*>(s->a);
+
+  ija[0] = n + 1;
+  for (size_t i = 0; i < n; ++i) {
+    ija[i+1]  = ija[i] + rowptr[i+1];
+    rowptr[i] = ija[i]; // becomes the insertion position for row i
+  }
+
+  // The new diagonal: entry (rows[i], cols[i]) of l, wherever l keeps it.
+  for (size_t i = 0; i < n; ++i) {
+    const size_t r = rows[i];
+    a[i] = def;
+    if (r < m && cinv[r] == i) a[i] = la[r];
+    for (IType p = lij[r]; p < lij[r+1]; ++p)
+      if (cinv[lij[p]] == i) a[i] = la[p];
+  }
+  a[n] = def;
+
+  for (size_t j = 0; j < m; ++j) {
+    for (size_t k = colptr[j]; k < colptr[j+1]; ++k) {
+      const size_t pos = rowptr[row[k]]++;
+      ija[pos] = j;
+      a[pos]   = la[src[k]];
+    }
+  }
+
+  return s;
+}
+
+
 /*
  * Get the sum of offsets from the original matrix (for sliced iteration).
  */
@@ -943,6 +1491,7 @@ static VALUE map_stored(VALUE self) {
   NM_CONSERVATIVE(nm_register_value(&self));
   YALE_STORAGE* s = NM_STORAGE_YALE(self);
   YaleStorage<D> y(s);
+  y.compact(); // don't yield for lazily-deleted entries
 
   RETURN_SIZED_ENUMERATOR_PRE
   NM_CONSERVATIVE(nm_unregister_value(&self));
@@ -1163,10 +1712,31 @@ void nm_init_yale_functions() {
 // C ACCESSORS //
 /////////////////
 
+/*
+ * The staging area of the matrix storage belongs to (or refers to), if it's inside NMatrix#batch_update; else NULL.
+ */
+static nm::yale_storage::batch_t* yale_batch(const STORAGE* storage) {
+  return reinterpret_cast<nm::yale_storage::batch_t*>(reinterpret_cast<YALE_STORAGE*>(storage->src)->batch);
+}
+
+/*
+ * Merge whatever NMatrix#batch_update has staged for the matrix storage belongs to (or refers to), for code which is
+ * about to read or change it other than one cell at a time.
+ */
+static void yale_batch_flush(const STORAGE* storage) {
+  nm::yale_storage::batch_t* batch = yale_batch(storage);
+  if (!batch || batch->size() == 0) return;
+
+  NAMED_DTYPE_TEMPLATE_TABLE(commit, nm::yale_storage::batch_commit, void, YALE_STORAGE*, nm::yale_storage::batch_t&)
+  commit[storage->dtype](reinterpret_cast<YALE_STORAGE*>(storage->src), *batch);
+}
+
+
 /* C interface for NMatrix#each_with_indices (Yale) */
 VALUE nm_yale_each_with_indices(VALUE nmatrix) {
   NAMED_DTYPE_TEMPLATE_TABLE(ttable, nm::yale_storage::each_with_indices, VALUE, VALUE)
 
+  yale_batch_flush(NM_STORAGE(nmatrix));
   return ttable[ NM_DTYPE(nmatrix) ](nmatrix);
 }
 
@@ -1175,6 +1745,7 @@ VALUE nm_yale_each_with_indices(VALUE nmatrix) {
 VALUE nm_yale_each_stored_with_indices(VALUE nmatrix) {
   NAMED_DTYPE_TEMPLATE_TABLE(ttable, nm::yale_storage::each_stored_with_indices, VALUE, VALUE)
 
+  yale_batch_flush(NM_STORAGE(nmatrix));
   return ttable[ NM_DTYPE(nmatrix) ](nmatrix);
 }
 
@@ -1183,6 +1754,7 @@ VALUE nm_yale_each_stored_with_indices(VALUE nmatrix) {
 VALUE nm_yale_stored_diagonal_each_with_indices(VALUE nmatrix) {
   NAMED_DTYPE_TEMPLATE_TABLE(ttable, nm::yale_storage::stored_diagonal_each_with_indices, VALUE, VALUE)
 
+  yale_batch_flush(NM_STORAGE(nmatrix));
   return ttable[ NM_DTYPE(nmatrix) ](nmatrix);
 }
 
@@ -1190,6 +1762,7 @@ VALUE nm_yale_stored_diagonal_each_with_indices(VALUE nmatrix) {
 VALUE nm_yale_stored_nondiagonal_each_with_indices(VALUE nmatrix) {
   NAMED_DTYPE_TEMPLATE_TABLE(ttable, nm::yale_storage::stored_nondiagonal_each_with_indices, VALUE, VALUE)
 
+  yale_batch_flush(NM_STORAGE(nmatrix));
   return ttable[ NM_DTYPE(nmatrix) ](nmatrix);
 }
 
@@ -1198,6 +1771,7 @@ VALUE nm_yale_stored_nondiagonal_each_with_indices(VALUE nmatrix) {
 VALUE nm_yale_each_ordered_stored_with_indices(VALUE nmatrix) {
   NAMED_DTYPE_TEMPLATE_TABLE(ttable, nm::yale_storage::each_ordered_stored_with_indices, VALUE, VALUE)
 
+  yale_batch_flush(NM_STORAGE(nmatrix));
   return ttable[ NM_DTYPE(nmatrix) ](nmatrix);
 }
 
@@ -1209,6 +1783,23 @@ VALUE nm_yale_each_ordered_stored_with_indices(VALUE nmatrix) {
 void nm_yale_storage_set(VALUE left, SLICE* slice, VALUE right) {
   NAMED_DTYPE_TEMPLATE_TABLE(ttable, nm::yale_storage::set, void, VALUE left, SLICE* slice, VALUE right);
 
+  const STORAGE*             s     = NM_STORAGE(left);
+  nm::yale_storage::batch_t* batch = yale_batch(s);
+
+  if (batch) {
+    // Inside NMatrix#batch_update, stage single-cell assignments of scalars, whether made on the matrix or through a
+    // reference slice of it. Anything else is applied directly, after first applying whatever is already staged so
+    // that the order of assignments is respected.
+    if (slice->single && TYPE(right) != T_ARRAY && TYPE(right) != T_DATA) {
+      char val[sizeof(nm::Complex128)]; // convert first, so a bad value doesn't leave anything staged
+      rubyval_to_cval(right, s->dtype, val);
+      memcpy(batch->stage(slice->coords[0] + s->offset[0], slice->coords[1] + s->offset[1]), val, DTYPE_SIZES[s->dtype]);
+      return;
+    }
+
+    yale_batch_flush(s);
+  }
+
   ttable[NM_DTYPE(left)](left, slice, right);
 }
 
@@ -1231,6 +1822,16 @@ static size_t yale_count_slice_copy_ndnz(const YALE_STORAGE* s, size_t* offset,
 void* nm_yale_storage_get(const STORAGE* storage, SLICE* slice) {
   YALE_STORAGE* casted_storage = (YALE_STORAGE*)storage;
 
+  if (yale_batch(storage)) {
+    // Inside NMatrix#batch_update, a single cell may have been assigned since the last merge.
+    if (slice->single) {
+      void* staged = yale_batch(storage)->find(slice->coords[0] + storage->offset[0], slice->coords[1] + storage->offset[1]);
+      if (staged) return staged;
+    } else {
+      yale_batch_flush(storage);
+    }
+  }
+
   if (slice->single) {
     NAMED_DTYPE_TEMPLATE_TABLE(elem_copy_table,  nm::yale_storage::get_single, void*, YALE_STORAGE*, SLICE*)
 
@@ -1278,6 +1879,12 @@ static void nm_yale_storage_increment_ia_after(YALE_STORAGE* s, size_t ija_size,
 void* nm_yale_storage_ref(const STORAGE* storage, SLICE* slice) {
   YALE_STORAGE* casted_storage = (YALE_STORAGE*)storage;
 
+  if (slice->single && yale_batch(storage)) {
+    // Inside NMatrix#batch_update, a single cell may have been assigned since the last merge.
+    void* staged = yale_batch(storage)->find(slice->coords[0] + storage->offset[0], slice->coords[1] + storage->offset[1]);
+    if (staged) return staged;
+  }
+
   if (slice->single) {
     //return reinterpret_cast<void*>(nm::YaleStorage<nm::dtype_enum_T<storage->dtype>::type>(casted_storage).get_single_p(slice));
     NAMED_DTYPE_TEMPLATE_TABLE(elem_copy_table,  nm::yale_storage::get_single, void*, YALE_STORAGE*, SLICE*)
@@ -1299,6 +1906,9 @@ bool nm_yale_storage_eqeq(const STORAGE* left, const STORAGE* right) {
 
   const YALE_STORAGE* casted_left = reinterpret_cast<const YALE_STORAGE*>(left);
 
+  nm_yale_storage_direct(left);
+  nm_yale_storage_direct(right);
+
   return ttable[casted_left->dtype][right->dtype](casted_left, (const YALE_STORAGE*)right);
 }
 
@@ -1310,6 +1920,7 @@ STORAGE* nm_yale_storage_cast_copy(const STORAGE* rhs, nm::dtype_t new_dtype, vo
   NAMED_LR_DTYPE_TEMPLATE_TABLE(ttable, nm::yale_storage::cast_copy, YALE_STORAGE*, const YALE_STORAGE* rhs);
 
   const YALE_STORAGE* casted_rhs = reinterpret_cast<const YALE_STORAGE*>(rhs);
+  nm_yale_storage_direct(rhs);
   //return reinterpret_cast<STORAGE*>(nm::YaleStorage<nm::dtype_enum_T< rhs->dtype >::type>(rhs).alloc_copy<nm::dtype_enum_T< new_dtype >::type>());
   return (STORAGE*)ttable[new_dtype][casted_rhs->dtype](casted_rhs);
 }
@@ -1323,6 +1934,24 @@ size_t nm_yale_storage_get_size(const YALE_STORAGE* storage) {
 }
 
 
+/*
+ * Get at the IJA and A arrays of a matrix or slice. Anything which reads them directly (rather than through the
+ * iterators) must go through this, since it first merges any assignments staged by NMatrix#batch_update and removes
+ * any lazily-deleted entries from the source storage, which would otherwise show up as stored entries. (C accessor)
+ */
+YALE_STORAGE* nm_yale_storage_direct(const STORAGE* storage) {
+  YALE_STORAGE* s = reinterpret_cast<YALE_STORAGE*>(storage->src);
+  yale_batch_flush(storage);
+
+  if (s->ndead > 0) {
+    NAMED_DTYPE_TEMPLATE_TABLE(ttable, nm::yale_storage::compact, void, YALE_STORAGE*)
+    ttable[s->dtype](s);
+  }
+
+  return reinterpret_cast<YALE_STORAGE*>(const_cast<STORAGE*>(storage));
+}
+
+
 
 /*
  * Return a pointer to the matrix's default value entry.
@@ -1364,6 +1993,7 @@ static bool default_value_is_numeric_zero(const YALE_STORAGE* s) {
 STORAGE* nm_yale_storage_copy_transposed(const STORAGE* rhs_base) {
   YALE_STORAGE* rhs = (YALE_STORAGE*)rhs_base;
   NAMED_DTYPE_TEMPLATE_TABLE(transp, nm::yale_storage::copy_transposed, YALE_STORAGE*, YALE_STORAGE*)
+  nm_yale_storage_direct(rhs_base);
   return (STORAGE*)(transp[rhs->dtype](rhs));
 }
 
@@ -1384,10 +2014,33 @@ STORAGE* nm_yale_storage_matrix_multiply(const STORAGE_PAIR& casted_storage, siz
     return NULL;
   }
 
+  nm_yale_storage_direct(casted_storage.left);
+  nm_yale_storage_direct(casted_storage.right);
+
   return ttable[left->dtype](casted_storage, resulting_shape, vector);
 }
 
 
+/*
+ * Yale-by-dense matrix multiplication. The result is dense.
+ */
+STORAGE* nm_yale_storage_matrix_multiply_dense(const STORAGE_PAIR& casted_storage, size_t* resulting_shape) {
+  DTYPE_TEMPLATE_TABLE(nm::yale_storage::matrix_multiply_dense, STORAGE*, const STORAGE_PAIR& casted_storage, size_t* resulting_shape);
+
+  YALE_STORAGE* left = reinterpret_cast<YALE_STORAGE*>(casted_storage.left);
+
+  if (left->dtype == nm::RUBYOBJ || casted_storage.right->dim != 2) {
+    NM_FREE(resulting_shape);
+    rb_raise(rb_eNotImpError, "multiplication of yale and dense matrices is only implemented for two-dimensional, non-object matrices");
+  } else if (!default_value_is_numeric_zero(left)) {
+    NM_FREE(resulting_shape);
+    rb_raise(rb_eNotImpError, "matrix default value must be some form of zero (not false or nil) for multiplication");
+  }
+
+  return ttable[left->dtype](casted_storage, resulting_shape);
+}
+
+
 ///////////////
 // Lifecycle //
 ///////////////
@@ -1419,6 +2072,8 @@ void nm_yale_storage_delete(STORAGE* s) {
       NM_FREE(storage->offset);
       NM_FREE(storage->ija);
       NM_FREE(storage->a);
+      nm::yale_storage::clear_dead(storage);
+      delete reinterpret_cast<nm::yale_storage::batch_t*>(storage->batch);
       NM_FREE(storage);
     }
   }
@@ -1459,6 +2114,13 @@ void nm_yale_storage_mark(STORAGE* storage_base) {
 
     VALUE* a = (VALUE*)(storage->a);
     rb_gc_mark_locations(a, &(a[storage->capacity-1]));
+
+    // and anything staged by NMatrix#batch_update
+    nm::yale_storage::batch_t* batch = reinterpret_cast<nm::yale_storage::batch_t*>(storage->batch);
+    if (batch && batch->size() > 0) {
+      VALUE* v = reinterpret_cast<VALUE*>(&(batch->v[0]));
+      rb_gc_mark_locations(v, v + batch->size());
+    }
   }
 }
 
@@ -1495,6 +2157,10 @@ static YALE_STORAGE* alloc(nm::dtype_t dtype, size_t* shape, size_t dim) {
   s = NM_ALLOC( YALE_STORAGE );
 
   s->ndnz        = 0;
+  s->ndead       = 0;
+  s->dead        = NULL;
+  s->batch       = NULL;
+  s->max_dead    = 0;
   s->dtype       = dtype;
   s->shape       = shape;
   s->offset      = NM_ALLOC_N(size_t, dim);
@@ -1522,11 +2188,13 @@ YALE_STORAGE* nm_yale_storage_create_from_old_yale(nm::dtype_t dtype, size_t* sh
  * call-seq:
  *     yale_size -> Integer
  *
- * Get the size of a Yale matrix (the number of elements actually stored).
+ * Get the size of a Yale matrix (the number of elements actually stored). Like the other raw IJA and A accessors, this
+ * first removes any lazily-deleted entries.
  *
  * For capacity (the maximum number of elements that can be stored without a resize), use capacity instead.
  */
 static VALUE nm_size(VALUE self) {
+  nm_yale_storage_direct(NM_STORAGE(self));
   YALE_STORAGE* s = (YALE_STORAGE*)(NM_SRC(self));
   VALUE to_return = INT2FIX(nm::yale_storage::IJA(s)[s->shape[0]]);
   return to_return;
@@ -1567,8 +2235,8 @@ static VALUE nm_row_keys_intersection(VALUE m1, VALUE ii1, VALUE m2, VALUE ii2)
   size_t i1 = FIX2INT(ii1),
          i2 = FIX2INT(ii2);
 
-  YALE_STORAGE *s   = NM_STORAGE_YALE(m1),
-               *t   = NM_STORAGE_YALE(m2);
+  YALE_STORAGE *s   = nm_yale_storage_direct(NM_STORAGE(m1)),
+               *t   = nm_yale_storage_direct(NM_STORAGE(m2));
 
   size_t pos1 = s->ija[i1],
          pos2 = t->ija[i2];
@@ -1649,6 +2317,7 @@ static VALUE nm_a(int argc, VALUE* argv, VALUE self) {
   rb_scan_args(argc, argv, "01", &idx);
   NM_CONSERVATIVE(nm_register_value(&idx));
 
+  nm_yale_storage_direct(NM_STORAGE(self));
   YALE_STORAGE* s = reinterpret_cast<YALE_STORAGE*>(NM_SRC(self));
   size_t size = nm_yale_storage_get_size(s);
 
@@ -1699,6 +2368,7 @@ static VALUE nm_d(int argc, VALUE* argv, VALUE self) {
   rb_scan_args(argc, argv, "01", &idx);
   NM_CONSERVATIVE(nm_register_value(&idx));
 
+  nm_yale_storage_direct(NM_STORAGE(self));
   YALE_STORAGE* s = reinterpret_cast<YALE_STORAGE*>(NM_SRC(self));
 
   if (idx == Qnil) {
@@ -1738,6 +2408,7 @@ static VALUE nm_d(int argc, VALUE* argv, VALUE self) {
 static VALUE nm_lu(VALUE self) {
   NM_CONSERVATIVE(nm_register_value(&self));
 
+  nm_yale_storage_direct(NM_STORAGE(self));
   YALE_STORAGE* s = reinterpret_cast<YALE_STORAGE*>(NM_SRC(self));
 
   size_t size = nm_yale_storage_get_size(s);
@@ -1777,6 +2448,7 @@ static VALUE nm_lu(VALUE self) {
 static VALUE nm_ia(VALUE self) {
   NM_CONSERVATIVE(nm_register_value(&self));
 
+  nm_yale_storage_direct(NM_STORAGE(self));
   YALE_STORAGE* s = reinterpret_cast<YALE_STORAGE*>(NM_SRC(self));
 
   VALUE* vals = NM_ALLOCA_N(VALUE, s->shape[0] + 1);
@@ -1801,6 +2473,7 @@ static VALUE nm_ja(VALUE self) {
 
   NM_CONSERVATIVE(nm_register_value(&self));
 
+  nm_yale_storage_direct(NM_STORAGE(self));
   YALE_STORAGE* s = reinterpret_cast<YALE_STORAGE*>(NM_SRC(self));
 
   size_t size = nm_yale_storage_get_size(s);
@@ -1838,6 +2511,7 @@ static VALUE nm_ija(int argc, VALUE* argv, VALUE self) {
   rb_scan_args(argc, argv, "01", &idx);
   NM_CONSERVATIVE(nm_register_value(&idx));
 
+  nm_yale_storage_direct(NM_STORAGE(self));
   YALE_STORAGE* s = reinterpret_cast<YALE_STORAGE*>(NM_SRC(self));
   size_t size = nm_yale_storage_get_size(s);
 
@@ -1901,7 +2575,7 @@ static VALUE nm_nd_row(int argc, VALUE* argv, VALUE self) {
 
   size_t i = FIX2INT(i_);
 
-  YALE_STORAGE* s   = NM_STORAGE_YALE(self);
+  YALE_STORAGE* s   = nm_yale_storage_direct(NM_STORAGE(self));
   //nm::dtype_t dtype = NM_DTYPE(self);
 
   if (i >= s->shape[0]) {
@@ -1994,7 +2668,7 @@ VALUE nm_vector_set(int argc, VALUE* argv, VALUE self) { //, VALUE i_, VALUE jv,
     rb_raise(rb_eArgError, "lengths must match between j array (%lu) and value array (%lu)", len, vvlen);
   }
 
-  YALE_STORAGE* s   = NM_STORAGE_YALE(self);
+  YALE_STORAGE* s   = nm_yale_storage_direct(NM_STORAGE(self));
   nm::dtype_t dtype = NM_DTYPE(self);
 
   size_t i   = FIX2INT(i_);    // get the row
@@ -2035,6 +2709,375 @@ VALUE nm_vector_set(int argc, VALUE* argv, VALUE self) { //, VALUE i_, VALUE jv,
 
 
 
+/*
+ * Raise unless a COO argument is one of the forms nm_yale_from_coo reads: a Ruby Array, a String of packed values, or
+ * a dense NMatrix (not a reference) of the given dtype. Strings can't hold Ruby objects.
+ */
+static void coo_check(VALUE v, nm::dtype_t dtype, const char* name) {
+  if (TYPE(v) == T_ARRAY) return;
+  if (TYPE(v) == T_STRING && dtype != nm::RUBYOBJ) return;
+  if (NM_IsNMatrix(v) && NM_STYPE(v) == nm::DENSE_STORE && NM_DTYPE(v) == dtype && NM_SRC(v) == NM_STORAGE(v)) return;
+
+  rb_raise(rb_eTypeError, "%s must be an Array, a packed String, or a dense %s NMatrix", name, DTYPE_NAMES[dtype]);
+}
+
+
+/*
+ * Number of entries in a COO argument: a Ruby Array, a dense NMatrix, or a String of packed native values, each of
+ * which is elem_size bytes.
+ */
+static size_t coo_length(VALUE v, size_t elem_size) {
+  if (TYPE(v) == T_ARRAY)       return RARRAY_LEN(v);
+  else if (TYPE(v) == T_STRING) return RSTRING_LEN(v) / elem_size;
+  else                          return nm_storage_count_max_elements(NM_STORAGE(v));
+}
+
+
+/*
+ * Pointer to the packed contents of a COO argument which is a String or a dense NMatrix, or NULL for an Array.
+ */
+static void* coo_packed_ptr(VALUE v) {
+  if (TYPE(v) == T_ARRAY)       return NULL;
+  else if (TYPE(v) == T_STRING) return reinterpret_cast<void*>(RSTRING_PTR(v));
+  else                          return NM_STORAGE_DENSE(v)->elements;
+}
+
+
+/*
+ * Read a COO index argument into a size_t array. Packed indices (String or NMatrix) are 64-bit integers.
+ */
+static void coo_read_indices(VALUE v, size_t n, size_t* out) {
+  int64_t* packed = reinterpret_cast<int64_t*>(coo_packed_ptr(v));
+
+  if (packed) {
+    for (size_t k = 0; k < n; ++k) out[k] = static_cast<size_t>(packed[k]);
+  } else {
+    for (size_t k = 0; k < n; ++k) out[k] = static_cast<size_t>(NUM2LONG(rb_ary_entry(v, k)));
+  }
+}
+
+
+/*
+ * The COO arguments and the native copies nm_yale_from_coo makes of them. Reading Array entries can raise, so it's done
+ * under rb_protect (see read) and everything allocated here is freed before the exception goes on.
+ */
+struct coo_args {
+  VALUE       rows, cols, vals;
+  nm::dtype_t dtype;
+  size_t      n;
+  size_t*     ir;
+  size_t*     jr;
+  void*       v;      // vals, or a native copy if it's an Array
+  bool        v_alloc;
+
+  static VALUE read(VALUE self) {
+    coo_args* a = reinterpret_cast<coo_args*>(self);
+    coo_read_indices(a->rows, a->n, a->ir);
+    coo_read_indices(a->cols, a->n, a->jr);
+    if (a->v_alloc) {
+      for (size_t k = 0; k < a->n; ++k)
+        rubyval_to_cval(rb_ary_entry(a->vals, k), a->dtype, reinterpret_cast<char*>(a->v) + k * DTYPE_SIZES[a->dtype]);
+    }
+    return Qnil;
+  }
+
+  void free() {
+    if (v_alloc) {
+      if (dtype == nm::RUBYOBJ) nm_unregister_values(reinterpret_cast<VALUE*>(v), n);
+      NM_FREE(v);
+    }
+    NM_FREE(ir);
+    NM_FREE(jr);
+  }
+};
+
+
+/*
+ * call-seq:
+ *     __yale_from_coo__(rows, cols, values, shape, dtype, sum_duplicates) -> NMatrix
+ *
+ * Build a Yale matrix directly from coordinate triplets. Arguments are expected to have been checked and converted by
+ * NMatrix.from_coo: rows and cols are Arrays of Integers, dense :int64 NMatrix objects, or Strings packed with 'q*';
+ * values are an Array, a dense NMatrix of the requested dtype, or a String of packed values of that dtype. Anything
+ * else raises a TypeError.
+ */
+VALUE nm_yale_from_coo(VALUE klass, VALUE rows, VALUE cols, VALUE vals, VALUE shape, VALUE dtype_sym, VALUE sum_duplicates) {
+  NAMED_DTYPE_TEMPLATE_TABLE(ttable, nm::yale_storage::create_from_coo, YALE_STORAGE*, size_t*, size_t, const size_t*, const size_t*, const void*, bool)
+
+  nm::dtype_t dtype = nm_dtype_from_rbsymbol(dtype_sym);
+  coo_check(rows, nm::INT64, "rows");
+  coo_check(cols, nm::INT64, "cols");
+  coo_check(vals, dtype, "values");
+
+  Check_Type(shape, T_ARRAY);
+  if (RARRAY_LEN(shape) != 2) rb_raise(rb_eArgError, "shape must have two dimensions");
+  const size_t r = NUM2SIZET(rb_ary_entry(shape, 0)), c = NUM2SIZET(rb_ary_entry(shape, 1));
+
+  coo_args a;
+  a.rows  = rows;
+  a.cols  = cols;
+  a.vals  = vals;
+  a.dtype = dtype;
+  a.n     = coo_length(rows, sizeof(int64_t));
+
+  if (coo_length(cols, sizeof(int64_t)) != a.n || coo_length(vals, DTYPE_SIZES[dtype]) != a.n)
+    rb_raise(rb_eArgError, "rows, cols, and values must all have the same length");
+
+  a.ir      = NM_ALLOC_N(size_t, a.n);
+  a.jr      = NM_ALLOC_N(size_t, a.n);
+  a.v       = coo_packed_ptr(vals);
+  a.v_alloc = a.v == NULL;
+  if (a.v_alloc) {
+    a.v = NM_ALLOC_N(char, DTYPE_SIZES[dtype] * a.n);
+    if (dtype == nm::RUBYOBJ) {
+      for (size_t k = 0; k < a.n; ++k) reinterpret_cast<VALUE*>(a.v)[k] = Qnil;
+      nm_register_values(reinterpret_cast<VALUE*>(a.v), a.n);
+    }
+  }
+
+  int state = 0;
+  rb_protect(coo_args::read, reinterpret_cast<VALUE>(&a), &state);
+  if (state) {
+    a.free();
+    rb_jump_tag(state);
+  }
+
+  for (size_t k = 0; k < a.n; ++k) {
+    if (a.ir[k] >= r || a.jr[k] >= c) {
+      long i = (long)a.ir[k], j = (long)a.jr[k];
+      a.free();
+      rb_raise(rb_eRangeError, "coordinates (%ld, %ld) are out of bounds for a %lu x %lu matrix", i, j, r, c);
+    }
+  }
+
+  size_t* shape_ = NM_ALLOC_N(size_t, 2);
+  shape_[0]      = r;
+  shape_[1]      = c;
+
+  YALE_STORAGE* s = ttable[dtype](shape_, a.n, a.ir, a.jr, a.v, RTEST(sum_duplicates));
+  a.free();
+
+  NMATRIX* m = nm_create(nm::YALE_STORE, reinterpret_cast<STORAGE*>(s));
+  return Data_Wrap_Struct(klass, nm_mark, nm_delete, m);
+}
+
+
+/*
+ * Return matrix's storage as dtype, making a cast copy only if necessary. Free it with nm_yale_storage_delete if it
+ * isn't the original.
+ */
+static YALE_STORAGE* storage_as_dtype(VALUE matrix, nm::dtype_t dtype) {
+  YALE_STORAGE* s = NM_STORAGE_YALE(matrix);
+  if (s->dtype == dtype) return s;
+  return reinterpret_cast<YALE_STORAGE*>(nm_yale_storage_cast_copy(reinterpret_cast<STORAGE*>(s), dtype, NULL));
+}
+
+
+/*
+ * call-seq:
+ *     __yale_ew_merge__(rhs, op) -> NMatrix or nil
+ *
+ * Element-wise +op+ (:add, :sub, or :mul) of two Yale matrices of the same shape, done natively. Returns nil if this
+ * can't be handled natively (other operations, references, or :object matrices); the caller should then fall back on
+ * __yale_map_merged_stored__.
+ */
+VALUE nm_yale_ew_merge(VALUE left, VALUE right, VALUE op) {
+  NAMED_DTYPE_TEMPLATE_TABLE(ttable, nm::yale_storage::ew_merge, YALE_STORAGE*, const YALE_STORAGE*, const YALE_STORAGE*, nm::ewop_t)
+
+  nm::ewop_t ewop;
+  if (!nm_native_ewop(op, ewop)) return Qnil;
+  if (NM_SRC(left) != NM_STORAGE(left) || NM_SRC(right) != NM_STORAGE(right)) return Qnil;
+
+  nm::dtype_t dtype = Upcast[NM_DTYPE(left)][NM_DTYPE(right)];
+  if (dtype == nm::RUBYOBJ) return Qnil;
+
+  nm_yale_storage_direct(NM_STORAGE(left));
+  nm_yale_storage_direct(NM_STORAGE(right));
+
+  YALE_STORAGE* l = storage_as_dtype(left, dtype);
+  YALE_STORAGE* r = storage_as_dtype(right, dtype);
+
+  YALE_STORAGE* s = ttable[dtype](l, r, ewop);
+
+  if (l != NM_STORAGE_YALE(left))  nm_yale_storage_delete(reinterpret_cast<STORAGE*>(l));
+  if (r != NM_STORAGE_YALE(right)) nm_yale_storage_delete(reinterpret_cast<STORAGE*>(r));
+
+  NMATRIX* m = nm_create(nm::YALE_STORE, reinterpret_cast<STORAGE*>(s));
+  return Data_Wrap_Struct(CLASS_OF(left), nm_mark, nm_delete, m);
+}
+
+
+/*
+ * call-seq:
+ *     __yale_ew_scalar__(scalar, op) -> NMatrix or nil
+ *
+ * Element-wise +op+ (:add, :sub, or :mul) of a Yale matrix with a scalar, done natively. Returns nil if this can't be
+ * handled natively, in which case the caller should fall back on __yale_map_stored__.
+ */
+VALUE nm_yale_ew_scalar(VALUE left, VALUE scalar, VALUE op) {
+  NAMED_DTYPE_TEMPLATE_TABLE(ttable, nm::yale_storage::ew_scalar, YALE_STORAGE*, const YALE_STORAGE*, const void*, nm::ewop_t)
+
+  nm::ewop_t ewop;
+  if (!nm_native_ewop(op, ewop)) return Qnil;
+  if (NM_SRC(left) != NM_STORAGE(left)) return Qnil;
+  if (!NM_RUBYVAL_IS_NUMERIC(scalar)) return Qnil;
+
+  nm::dtype_t dtype = Upcast[NM_DTYPE(left)][nm_dtype_min(scalar)];
+  if (dtype == nm::RUBYOBJ) return Qnil;
+
+  nm_yale_storage_direct(NM_STORAGE(left));
+
+  YALE_STORAGE* l = storage_as_dtype(left, dtype);
+  void*         x = rubyobj_to_cval(scalar, dtype);
+
+  YALE_STORAGE* s = ttable[dtype](l, x, ewop);
+
+  NM_FREE(x);
+  if (l != NM_STORAGE_YALE(left)) nm_yale_storage_delete(reinterpret_cast<STORAGE*>(l));
+
+  NMATRIX* m = nm_create(nm::YALE_STORE, reinterpret_cast<STORAGE*>(s));
+  return Data_Wrap_Struct(CLASS_OF(left), nm_mark, nm_delete, m);
+}
+
+
+/*
+ * Read a permutation of 0...n, given as nil (the identity), an Array, or a dense :int64 NMatrix, into perm; and its
+ * inverse into inv.
+ */
+static void read_permutation(VALUE v, size_t n, size_t* perm, size_t* inv, const char* name) {
+  if (NIL_P(v)) {
+    for (size_t k = 0; k < n; ++k) perm[k] = k;
+  } else {
+    if (coo_length(v, sizeof(int64_t)) != n) rb_raise(rb_eArgError, "%s must have %lu entries", name, n);
+    coo_read_indices(v, n, perm);
+  }
+
+  std::fill(inv, inv + n, n);
+  for (size_t k = 0; k < n; ++k) {
+    if (perm[k] >= n || inv[perm[k]] != n) rb_raise(rb_eArgError, "%s is not a permutation of 0...%lu", name, n);
+    inv[perm[k]] = k;
+  }
+}
+
+
+/*
+ * call-seq:
+ *     __yale_permute__(rows, cols, in_place) -> NMatrix
+ *
+ * Permute the rows and columns of a Yale matrix natively: entry (i,j) of the result is entry (rows[i], cols[j]) of the
+ * matrix. +rows+ and +cols+ are nil (for no permutation), Arrays, or dense :int64 NMatrix objects. If +in_place+ is
+ * true, the matrix's own storage is replaced and self is returned; otherwise a new matrix is.
+ */
+VALUE nm_yale_permute(VALUE self, VALUE rows, VALUE cols, VALUE in_place) {
+  NAMED_DTYPE_TEMPLATE_TABLE(ttable, nm::yale_storage::copy_permuted, YALE_STORAGE*, const YALE_STORAGE*, const size_t*, const size_t*)
+
+  if (NM_SRC(self) != NM_STORAGE(self))
+    rb_raise(rb_eNotImpError, "please make a copy before permuting a slice reference");
+
+  YALE_STORAGE* l = NM_STORAGE_YALE(self);
+  nm_yale_storage_direct(reinterpret_cast<STORAGE*>(l));
+
+  const size_t n = l->shape[0], m = l->shape[1];
+  std::vector<size_t> r(n), rinv(n), c(m), cinv(m);
+  read_permutation(rows, n, &r[0], &rinv[0], "rows");
+  read_permutation(cols, m, &c[0], &cinv[0], "cols");
+
+  YALE_STORAGE* s = ttable[l->dtype](l, &r[0], &cinv[0]);
+
+  if (RTEST(in_place)) { // take over the new arrays, and let s free the old ones
+    std::swap(l->ija,      s->ija);
+    std::swap(l->a,        s->a);
+    std::swap(l->capacity, s->capacity);
+    std::swap(l->ndnz,     s->ndnz);
+    nm_yale_storage_delete(reinterpret_cast<STORAGE*>(s));
+    return self;
+  }
+
+  NMATRIX* mat = nm_create(nm::YALE_STORE, reinterpret_cast<STORAGE*>(s));
+  return Data_Wrap_Struct(CLASS_OF(self), nm_mark, nm_delete, mat);
+}
+
+
+/*
+ * call-seq:
+ *     __yale_batch_begin__ -> true or false
+ *
+ * Start staging single-cell assignments for NMatrix#batch_update. Returns false if the matrix is already staging.
+ */
+VALUE nm_yale_batch_begin(VALUE self) {
+  YALE_STORAGE* s = reinterpret_cast<YALE_STORAGE*>(NM_SRC(self));
+  if (s->batch) return Qfalse;
+
+  s->batch = new nm::yale_storage::batch_t(s);
+  return Qtrue;
+}
+
+
+/*
+ * call-seq:
+ *     __yale_batch_commit__ -> self
+ *
+ * Merge the staged assignments into the matrix and stop staging.
+ */
+VALUE nm_yale_batch_commit(VALUE self) {
+  YALE_STORAGE* s = reinterpret_cast<YALE_STORAGE*>(NM_SRC(self));
+
+  if (s->batch) {
+    yale_batch_flush(NM_STORAGE(self));
+    delete reinterpret_cast<nm::yale_storage::batch_t*>(s->batch);
+    s->batch = NULL;
+  }
+  return self;
+}
+
+
+/*
+ * call-seq:
+ *     __yale_compact__ -> self
+ *
+ * Remove lazily-deleted entries from the matrix (or from the matrix a slice refers to).
+ */
+VALUE nm_yale_compact(VALUE self) {
+  nm_yale_storage_direct(NM_STORAGE(self));
+  return self;
+}
+
+
+/*
+ * call-seq:
+ *     __yale_dead_space_threshold__ -> Float or nil
+ *
+ * Get the fraction of stored non-diagonal entries which may be lazily-deleted before the matrix compacts itself, or
+ * nil if entries are deleted immediately.
+ */
+VALUE nm_yale_dead_space_threshold(VALUE self) {
+  YALE_STORAGE* s = reinterpret_cast<YALE_STORAGE*>(NM_SRC(self));
+  return s->max_dead > 0 ? rb_float_new(s->max_dead) : Qnil;
+}
+
+
+/*
+ * call-seq:
+ *     __yale_set_dead_space_threshold__(threshold) -> threshold
+ *
+ * Turn lazy deletion on (with a positive Float threshold) or off (with nil). Turning it off compacts the matrix.
+ */
+VALUE nm_yale_set_dead_space_threshold(VALUE self, VALUE threshold) {
+  YALE_STORAGE* s = reinterpret_cast<YALE_STORAGE*>(NM_SRC(self));
+
+  if (NIL_P(threshold)) {
+    s->max_dead = 0;
+    nm_yale_storage_direct(NM_STORAGE(self));
+  } else {
+    double t = NUM2DBL(threshold);
+    if (!(t > 0)) rb_raise(rb_eArgError, "dead space threshold must be positive");
+    s->max_dead = t;
+  }
+
+  return threshold;
+}
+
+
 /*
  * call-seq:
  *     __yale_default_value__ -> ...
@@ -2055,6 +3098,8 @@ VALUE nm_yale_default_value(VALUE self) {
  */
 VALUE nm_yale_map_merged_stored(VALUE left, VALUE right, VALUE init) {
   NAMED_LR_DTYPE_TEMPLATE_TABLE(ttable, nm::yale_storage::map_merged_stored, VALUE, VALUE, VALUE, VALUE)
+  yale_batch_flush(NM_STORAGE(left));
+  yale_batch_flush(NM_STORAGE(right));
   return ttable[NM_DTYPE(left)][NM_DTYPE(right)](left, right, init);
   //return nm::yale_storage::map_merged_stored(left, right, init);
 }
@@ -2068,6 +3113,7 @@ VALUE nm_yale_map_merged_stored(VALUE left, VALUE right, VALUE init) {
  */
 VALUE nm_yale_map_stored(VALUE self) {
   NAMED_DTYPE_TEMPLATE_TABLE(ttable, nm::yale_storage::map_stored, VALUE, VALUE)
+  yale_batch_flush(NM_STORAGE(self));
   return ttable[NM_DTYPE(self)](self);
 }
 
@@ -126,6 +126,7 @@ extern "C" {
   //////////
 
   STORAGE* nm_yale_storage_matrix_multiply(const STORAGE_PAIR& casted_storage, size_t* resulting_shape, bool vector);
+  STORAGE* nm_yale_storage_matrix_multiply_dense(const STORAGE_PAIR& casted_storage, size_t* resulting_shape);
 
   /////////////
   // Utility //
@@ -140,11 +141,22 @@ extern "C" {
   STORAGE*      nm_yale_storage_cast_copy(const STORAGE* rhs, nm::dtype_t new_dtype, void*);
   STORAGE*      nm_yale_storage_copy_transposed(const STORAGE* rhs_base);
 
+  YALE_STORAGE* nm_yale_storage_direct(const STORAGE* storage);
+
 
 
   void nm_init_yale_functions(void);
 
   VALUE nm_vector_set(int argc, VALUE* argv, VALUE self);
+  VALUE nm_yale_batch_begin(VALUE self);
+  VALUE nm_yale_batch_commit(VALUE self);
+  VALUE nm_yale_compact(VALUE self);
+  VALUE nm_yale_ew_merge(VALUE left, VALUE right, VALUE op);
+  VALUE nm_yale_ew_scalar(VALUE left, VALUE scalar, VALUE op);
+  VALUE nm_yale_dead_space_threshold(VALUE self);
+  VALUE nm_yale_set_dead_space_threshold(VALUE self, VALUE threshold);
+  VALUE nm_yale_from_coo(VALUE klass, VALUE rows, VALUE cols, VALUE vals, VALUE shape, VALUE dtype, VALUE sum_duplicates);
+  VALUE nm_yale_permute(VALUE self, VALUE rows, VALUE cols, VALUE in_place);
 
 
 } // end of extern "C" block
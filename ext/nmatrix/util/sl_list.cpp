@@ -30,6 +30,7 @@
  */
 
 #include <ruby.h>
+#include <algorithm>
 
 /*
  * Project Includes
@@ -43,6 +44,33 @@
 
 #include "storage/list/list.h"
 
+/*
+ * Arenas. Each list storage has one, shared by all of its lists (LIST::arena), and every NODE, LIST header and
+ * skip-list entry of those lists is carved out of it. A leaf node carries its value inline, right after the NODE; the
+ * nodes of the upper levels point to the LIST header of their sub-list.
+ *
+ * Cells come from chunks, which double in size (up to MAX_CHUNK) as the storage grows, and freed cells go onto a free
+ * list for their size, to be reused by the same storage. Deleting the storage hands the chunks back in one pass over
+ * the chunk list, without visiting the nodes.
+ */
+struct LIST_ARENA {
+  struct CHUNK {
+    CHUNK* next;
+  };
+
+  static const size_t GRAIN       = 8;
+  static const size_t MAX_CELL    = 256;
+  static const size_t FIRST_CHUNK = 1024;
+  static const size_t MAX_CHUNK   = 65536;
+
+  CHUNK* chunks;     // most recently allocated chunk first
+  char*  bump;       // next never-used byte in chunks
+  char*  bump_end;
+  size_t next_chunk; // size of the next chunk
+  size_t val_size;   // size of the values stored in leaf nodes
+  void*  free_cells[MAX_CELL / GRAIN + 1]; // by size in GRAINs
+};
+
 namespace nm { namespace list {
 
 /*
@@ -56,6 +84,197 @@ namespace nm { namespace list {
 /*
  * Global Variables
  */
+
+namespace arena {
+
+  static inline size_t round(size_t bytes) {
+    return (bytes + LIST_ARENA::GRAIN - 1) & ~(LIST_ARENA::GRAIN - 1);
+  }
+
+  static void* alloc(LIST_ARENA* a, size_t bytes) {
+    bytes = round(bytes);
+
+    void*& free_cell = a->free_cells[bytes / LIST_ARENA::GRAIN];
+    if (free_cell) {
+      void* c   = free_cell;
+      free_cell = *reinterpret_cast<void**>(c);
+      return c;
+    }
+
+    if (a->bump + bytes > a->bump_end) {
+      size_t size = std::max(a->next_chunk, bytes);
+
+      LIST_ARENA::CHUNK* chunk = reinterpret_cast<LIST_ARENA::CHUNK*>(NM_ALLOC_N(char, round(sizeof(LIST_ARENA::CHUNK)) + size));
+      chunk->next  = a->chunks;
+      a->chunks    = chunk;
+      a->bump      = reinterpret_cast<char*>(chunk) + round(sizeof(LIST_ARENA::CHUNK));
+      a->bump_end  = a->bump + size;
+
+      if (a->next_chunk < LIST_ARENA::MAX_CHUNK) a->next_chunk *= 2;
+    }
+
+    void* c  = a->bump;
+    a->bump += bytes;
+    return c;
+  }
+
+  static void release(LIST_ARENA* a, void* c, size_t bytes) {
+    void*& free_cell = a->free_cells[round(bytes) / LIST_ARENA::GRAIN];
+    *reinterpret_cast<void**>(c) = free_cell;
+    free_cell = c;
+  }
+
+  static_assert(sizeof(NODE) + sizeof(nm::Complex128) <= LIST_ARENA::MAX_CELL, "leaf nodes must fit in an arena cell");
+
+  /*
+   * Size of a leaf node together with its value.
+   */
+  static inline size_t leaf_size(const LIST_ARENA* a) {
+    return sizeof(NODE) + round(a->val_size);
+  }
+
+} // end of namespace arena
+
+/*
+ * Skip-list index. The nodes of a LIST stay an ordinary sorted singly-linked
+ * list, which is what every caller walks; the index is a set of express lanes
+ * over a sample of those nodes, hung off LIST::index. A search descends the
+ * lanes to the last indexed node before the key and walks the base list from
+ * there.
+ *
+ * Nodes are never indexed on insertion (insert_after doesn't search the list
+ * it's working on). Instead, whenever a search has to walk more than SPAN
+ * unindexed nodes, the node it's standing on is added to the index, so each
+ * gap the searches actually cross stays short. Removals that go through the
+ * list (remove_node, remove_list_node, remove_recursive) drop the node's entry.
+ */
+namespace skip {
+
+  static const size_t MAX_HEIGHT = 16;
+  static const size_t SPAN       = 16;
+
+  struct ENTRY {
+    NODE*  node;
+    size_t height;
+    ENTRY* next[1]; // really next[height]
+  };
+
+  struct INDEX {
+    ENTRY* head[MAX_HEIGHT];
+  };
+
+  static_assert(sizeof(INDEX) <= LIST_ARENA::MAX_CELL && sizeof(ENTRY) + (MAX_HEIGHT - 1) * sizeof(ENTRY*) <= LIST_ARENA::MAX_CELL,
+                "skip-list entries must fit in an arena cell");
+
+  static uint64_t rng_state = 0x2545F4914F6CDD1DULL;
+
+  // Entry heights are geometric with ratio 1/4, which with the SPAN sampling
+  // keeps the upper lanes short.
+  static size_t random_height() {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+
+    size_t   h    = 1;
+    uint64_t bits = rng_state;
+    while (h < MAX_HEIGHT && (bits & 3) == 0) {
+      ++h;
+      bits >>= 2;
+    }
+    return h;
+  }
+
+  static inline size_t entry_size(size_t height) {
+    return sizeof(ENTRY) + (height - 1) * sizeof(ENTRY*);
+  }
+
+  static inline ENTRY*& link(INDEX* ix, ENTRY* e, size_t level) {
+    return e ? e->next[level] : ix->head[level];
+  }
+
+  /*
+   * Descends the index of l towards key. update[level] receives the last entry
+   * at that level whose node's key is less than key (NULL for the head). Returns
+   * the node of update[0], or NULL if there is no such entry.
+   */
+  static NODE* descend(const LIST* l, size_t key, ENTRY** update) {
+    INDEX* ix = reinterpret_cast<INDEX*>(l->index);
+    if (!ix) {
+      for (size_t level = 0; level < MAX_HEIGHT; ++level) update[level] = NULL;
+      return NULL;
+    }
+
+    ENTRY* e = NULL;
+    for (size_t level = MAX_HEIGHT; level-- > 0; ) {
+      ENTRY* n;
+      while ((n = link(ix, e, level)) && n->node->key < key) e = n;
+      update[level] = e;
+    }
+
+    return e ? e->node : NULL;
+  }
+
+  /*
+   * Adds node to the index of l. update must come from descend() for a key no
+   * smaller than the key of the last indexed node before node, and is advanced
+   * past the new entry.
+   */
+  static void add(LIST* l, NODE* node, ENTRY** update) {
+    if (!l->index) {
+      INDEX* ix = reinterpret_cast<INDEX*>(arena::alloc(l->arena, sizeof(INDEX)));
+      for (size_t level = 0; level < MAX_HEIGHT; ++level) ix->head[level] = NULL;
+      l->index = ix;
+    }
+    INDEX* ix = reinterpret_cast<INDEX*>(l->index);
+
+    size_t h  = random_height();
+    ENTRY* e  = reinterpret_cast<ENTRY*>(arena::alloc(l->arena, entry_size(h)));
+    e->node   = node;
+    e->height = h;
+
+    for (size_t level = 0; level < h; ++level) {
+      ENTRY*& prev   = link(ix, update[level], level);
+      e->next[level] = prev;
+      prev           = e;
+      update[level]  = e;
+    }
+  }
+
+  /*
+   * Drops node's entry, if it has one, from the index of l.
+   */
+  static void remove(LIST* l, const NODE* node) {
+    INDEX* ix = reinterpret_cast<INDEX*>(l->index);
+    if (!ix) return;
+
+    ENTRY* update[MAX_HEIGHT];
+    descend(l, node->key, update);
+
+    ENTRY* e = link(ix, update[0], 0);
+    if (!e || e->node != node) return;
+
+    for (size_t level = 0; level < e->height; ++level) {
+      link(ix, update[level], level) = e->next[level];
+    }
+    arena::release(l->arena, e, entry_size(e->height));
+  }
+
+  static void del(LIST* l) {
+    INDEX* ix = reinterpret_cast<INDEX*>(l->index);
+    if (!ix) return;
+
+    ENTRY* e = ix->head[0];
+    while (e) {
+      ENTRY* next = e->next[0];
+      arena::release(l->arena, e, entry_size(e->height));
+      e = next;
+    }
+    arena::release(l->arena, ix, sizeof(INDEX));
+    l->index = NULL;
+  }
+
+} // end of namespace skip
+
  
 
 /*
@@ -71,20 +290,51 @@ namespace nm { namespace list {
 ///////////////
 
 /*
- * Creates an empty linked list.
+ * Creates an empty arena for the lists of a list storage whose values are val_size bytes each.
+ */
+LIST_ARENA* create_arena(size_t val_size) {
+  LIST_ARENA* a = NM_ALLOC(LIST_ARENA);
+  a->chunks     = NULL;
+  a->bump       = NULL;
+  a->bump_end   = NULL;
+  a->next_chunk = LIST_ARENA::FIRST_CHUNK;
+  a->val_size   = val_size;
+  std::fill(a->free_cells, a->free_cells + sizeof(a->free_cells) / sizeof(void*), (void*)(NULL));
+  return a;
+}
+
+/*
+ * Frees an arena and everything in it, in one pass over its chunks. The lists which came out of it are gone too, so
+ * nothing must be left registered with the GC inside them.
+ */
+void del_arena(LIST_ARENA* a) {
+  LIST_ARENA::CHUNK* chunk = a->chunks;
+  while (chunk) {
+    LIST_ARENA::CHUNK* next = chunk->next;
+    NM_FREE(chunk);
+    chunk = next;
+  }
+  NM_FREE(a);
+}
+
+/*
+ * Creates an empty linked list in the given arena.
  */
-LIST* create(void) {
-  LIST* list = NM_ALLOC( LIST );
+LIST* create(LIST_ARENA* a) {
+  LIST* list  = reinterpret_cast<LIST*>(arena::alloc(a, sizeof(LIST)));
   list->first = NULL;
+  list->index = NULL;
+  list->arena = a;
   return list;
 }
 
 /*
- * Deletes the linked list and all of its contents. If you want to delete a
+ * Deletes the linked list and all of its contents, handing the memory back to its arena. If you want to delete a
  * list inside of a list, set recursions to 1. For lists inside of lists inside
  *  of the list, set it to 2; and so on. Setting it to 0 is for no recursions.
  */
 void del(LIST* list, size_t recursions) {
+  LIST_ARENA* a = list->arena;
   NODE* next;
   NODE* curr = list->first;
 
@@ -94,18 +344,19 @@ void del(LIST* list, size_t recursions) {
     if (recursions == 0) {
       //fprintf(stderr, "    free_val: %p\n", curr->val);
       nm_list_storage_completely_unregister_node(curr);
-      NM_FREE(curr->val);
+      arena::release(a, curr, arena::leaf_size(a));
       
     } else {
       //fprintf(stderr, "    free_list: %p\n", list);
       del((LIST*)curr->val, recursions - 1);
+      arena::release(a, curr, sizeof(NODE));
     }
 
-    NM_FREE(curr);
     curr = next;
   }
-  //fprintf(stderr, "    free_list: %p\n", list);
-  NM_FREE(list);
+
+  skip::del(list);
+  arena::release(a, list, sizeof(LIST));
 }
 
 /*
@@ -133,209 +384,158 @@ void mark(LIST* list, size_t recursions) {
 // Accessors //
 ///////////////
 
-
 /*
- * Given a list, insert key/val as the first entry in the list. Does not do any
- * checks, just inserts.
+ * Allocates a leaf node with a copy of val, which is list->arena->val_size bytes long. The node isn't linked in.
  */
-NODE* insert_first_node(LIST* list, size_t key, void* val, size_t val_size) {
-  NODE* ins   = NM_ALLOC(NODE);
-  ins->next   = list->first;
+static NODE* new_leaf(LIST* list, size_t key, const void* val) {
+  LIST_ARENA* a = list->arena;
+  NODE* n = reinterpret_cast<NODE*>(arena::alloc(a, arena::leaf_size(a)));
+  n->key  = key;
+  n->val  = reinterpret_cast<char*>(n) + sizeof(NODE);
+  memcpy(n->val, val, a->val_size);
+  return n;
+}
 
-  void* val_copy = NM_ALLOC_N(char, val_size);
-  memcpy(val_copy, val, val_size);
+/*
+ * Allocates a node for the sub-list l. The node isn't linked in.
+ */
+static NODE* new_inner(LIST* list, size_t key, LIST* l) {
+  NODE* n = reinterpret_cast<NODE*>(arena::alloc(list->arena, sizeof(NODE)));
+  n->key  = key;
+  n->val  = reinterpret_cast<void*>(l);
+  return n;
+}
 
-  ins->val    = reinterpret_cast<void*>(val_copy);
-  ins->key    = key;
+static inline NODE* link_first(LIST* list, NODE* ins) {
+  ins->next   = list->first;
   list->first = ins;
-
   return ins;
 }
 
-NODE* insert_first_list(LIST* list, size_t key, LIST* l) {
-  NODE* ins   = NM_ALLOC(NODE);
-  ins->next   = list->first;
+static inline NODE* link_after(NODE* node, NODE* ins) {
+  // insert 'ins' between 'node' and 'node->next'
+  ins->next  = node->next;
+  node->next = ins;
+  return ins;
+}
 
-  ins->val    = reinterpret_cast<void*>(l);
-  ins->key    = key;
-  list->first = ins;
+/*
+ * Given a list, insert key/val as the first entry in the list. Does not do any
+ * checks, just inserts. The value is copied.
+ */
+NODE* insert_first_node(LIST* list, size_t key, const void* val) {
+  return link_first(list, new_leaf(list, key, val));
+}
 
-  return ins;
+NODE* insert_first_list(LIST* list, size_t key, LIST* l) {
+  return link_first(list, new_inner(list, key, l));
 }
 
 
 /* 
- * Given a list and a key/value-ptr pair, create a node (and return that node).
- * If NULL is returned, it means insertion failed.
- * If the key already exists in the list, replace tells it to delete the old
- * value and put in your new one. !replace means delete the new value.
+ * Given a list and a key/value-ptr pair, create a node holding a copy of the
+ * value (and return that node).
+ * If the key already exists in the list, replace tells it to copy the new
+ * value over the old one. !replace means leave the old one alone.
  */
-NODE* insert(LIST* list, bool replace, size_t key, void* val) {
-  NODE *ins;
-
-  if (list->first == NULL) {
-  	// List is empty
-  	
-    //if (!(ins = malloc(sizeof(NODE)))) return NULL;
-    ins = NM_ALLOC(NODE);
-    ins->next             = NULL;
-    ins->val              = val;
-    ins->key              = key;
-    list->first           = ins;
-    
-    return ins;
-
-  } else if (key < list->first->key) {
+NODE* insert(LIST* list, bool replace, size_t key, const void* val) {
+  if (list->first == NULL || key < list->first->key) {
   	// Goes at the beginning of the list
-  	
-    //if (!(ins = malloc(sizeof(NODE)))) return NULL;
-    ins = NM_ALLOC(NODE);
-    ins->next             = list->first;
-    ins->val              = val;
-    ins->key              = key;
-    list->first           = ins;
-    
-    return ins;
+    return insert_first_node(list, key, val);
   }
 
   // Goes somewhere else in the list.
-  ins = find_nearest_from(list->first, key);
+  NODE* ins = find_nearest(list, key);
 
   if (ins->key == key) {
     // key already exists
     if (replace) {
       nm_list_storage_completely_unregister_node(ins);
-      NM_FREE(ins->val);
-      ins->val = val;
-    } else {
-      NM_FREE(val);
+      memcpy(ins->val, val, list->arena->val_size);
     }
     
     return ins;
 
   } else {
-  	return insert_after(ins, key, val);
+  	return insert_after(list, ins, key, val);
   }
 }
 
 
-
 /*
- * Documentation goes here.
+ * As insert, for a sub-list: links l into list at key. If the key is already
+ * there, l (which should be empty) is deleted and the existing node returned.
  */
-NODE* insert_after(NODE* node, size_t key, void* val) {
-  //if (!(ins = malloc(sizeof(NODE)))) return NULL;
-  NODE* ins = NM_ALLOC(NODE);
+NODE* insert_list(LIST* list, size_t key, LIST* l) {
+  if (list->first == NULL || key < list->first->key) {
+    return insert_first_list(list, key, l);
+  }
 
-  // insert 'ins' between 'node' and 'node->next'
-  ins->next  = node->next;
-  node->next = ins;
+  NODE* ins = find_nearest(list, key);
 
-  // initialize our new node
-  ins->key   = key;
-  ins->val   = val;
+  if (ins->key == key) {
+    del(l, 0);
+    return ins;
 
-  return ins;
+  } else {
+    return insert_list_after(list, ins, key, l);
+  }
 }
 
 
 /*
- * Insert a new node immediately after +node+, or replace the existing one if its key is a match.
+ * Inserts a copy of val immediately after node, which must belong to list. No checks.
  */
-NODE* replace_insert_after(NODE* node, size_t key, void* val, bool copy, size_t copy_size) {
-  if (node->next && node->next->key == key) {
-
-    // Should we copy into the current one or free and insert?
-    if (copy) memcpy(node->next->val, val, copy_size);
-    else {
-      NM_FREE(node->next->val);
-      node->next->val = val;
-    }
-
-    return node->next;
-
-  } else { // no next node, or if there is one, it's greater than the current key
-
-    if (copy) {
-      void* val_copy = NM_ALLOC_N(char, copy_size);
-      memcpy(val_copy, val, copy_size);
-      return insert_after(node, key, val_copy);
-    } else {
-      return insert_after(node, key, val);
-    }
-
-  }
+NODE* insert_after(LIST* list, NODE* node, size_t key, const void* val) {
+  return link_after(node, new_leaf(list, key, val));
 }
 
+NODE* insert_list_after(LIST* list, NODE* node, size_t key, LIST* l) {
+  return link_after(node, new_inner(list, key, l));
+}
 
 
 /*
- * Functions analogously to list::insert but this inserts a copy of the value instead of the original.
+ * Insert a new node immediately after +node+, or copy val into the existing one if its key is a match.
  */
-NODE* insert_copy(LIST *list, bool replace, size_t key, void *val, size_t size) {
-  void *copy_val = NM_ALLOC_N(char, size);
-  memcpy(copy_val, val, size);
+NODE* replace_insert_after(LIST* list, NODE* node, size_t key, const void* val) {
+  if (node->next && node->next->key == key) {
+    memcpy(node->next->val, val, list->arena->val_size);
+    return node->next;
 
-  return insert(list, replace, key, copy_val);
+  } else { // no next node, or if there is one, it's greater than the current key
+    return insert_after(list, node, key, val);
+  }
 }
 
 
 /*
- * Returns the value pointer for some key. Doesn't free the memory for that value. Doesn't require a find operation,
- * assumes finding has already been done. If rm is the first item in the list, prev should be NULL.
+ * Unlinks rm from the list and frees it, value and all. Doesn't require a find operation, assumes finding has already
+ * been done. If rm is the first item in the list, prev should be NULL.
  */
-void* remove_by_node(LIST* list, NODE* prev, NODE* rm) {
+void remove_node(LIST* list, NODE* prev, NODE* rm) {
+  skip::remove(list, rm);
+
   if (!prev)  list->first = rm->next;
   else        prev->next  = rm->next;
 
-  void* val   = rm->val;
-  NM_FREE(rm);
-
-  return val;
+  arena::release(list->arena, rm, arena::leaf_size(list->arena));
 }
 
 
 /*
- * Returns the value pointer (not the node) for some key. Note that it doesn't
- * free the memory for the value stored in the node -- that pointer gets
- * returned! Only the node is destroyed.
+ * As remove_node, for a node holding a sub-list, which is returned rather than freed (del it when done with it).
  */
-void* remove_by_key(LIST* list, size_t key) {
-  NODE *f, *rm;
-  void* val;
+LIST* remove_list_node(LIST* list, NODE* prev, NODE* rm) {
+  skip::remove(list, rm);
 
-  if (!list->first || list->first->key > key) { // empty list or def. not present
-  	return NULL;
-  }
-
-  if (list->first->key == key) {
-    val = list->first->val;
-    rm  = list->first;
-    
-    list->first = rm->next;
-    NM_FREE(rm);
-    
-    return val;
-  }
-
-  f = find_preceding_from_node(list->first, key);
-  if (!f || !f->next) { // not found, end of list
-  	return NULL;
-  }
-
-  if (f->next->key == key) {
-    // remove the node
-    rm      = f->next;
-    f->next = rm->next;
-
-    // get the value and free the memory for the node
-    val = rm->val;
-    NM_FREE(rm);
+  if (!prev)  list->first = rm->next;
+  else        prev->next  = rm->next;
 
-    return val;
-  }
+  LIST* l = reinterpret_cast<LIST*>(rm->val);
+  arena::release(list->arena, rm, sizeof(NODE));
 
-  return NULL; // not found, middle of list
+  return l;
 }
 
 
@@ -365,7 +565,7 @@ bool remove_recursive(LIST* list, const size_t* coords, const size_t* offsets, c
 
       if (remove_parent) { // now empty -- so remove the sub-list
 //        std::cerr << r << ": removing parent list at " << n->key << std::endl;
-        NM_FREE(remove_by_node(list, prev, n));
+        del(remove_list_node(list, prev, n), 0); // takes its skip index with it
 
         if (prev) n  = prev->next && node_is_within_slice(prev->next, coords[r] + offsets[r], lengths[r]) ? prev->next : NULL;
         else      n  = node_is_within_slice(list->first, coords[r] + offsets[r], lengths[r]) ? list->first : NULL;
@@ -384,7 +584,7 @@ bool remove_recursive(LIST* list, const size_t* coords, const size_t* offsets, c
 
     while (n) {
 //      std::cerr << r << ": removing node at " << n->key << std::endl;
-      NM_FREE(remove_by_node(list, prev, n));
+      remove_node(list, prev, n);
 
       if (prev) n  = prev->next && node_is_within_slice(prev->next, coords[r] + offsets[r], lengths[r]) ? prev->next : NULL;
       else      n  = node_is_within_slice(list->first, coords[r] + offsets[r], lengths[r]) ? list->first : NULL;
@@ -409,24 +609,17 @@ bool remove_recursive(LIST* list, const size_t* coords, const size_t* offsets, c
  * Find some element in the list and return the node ptr for that key.
  */
 NODE* find(LIST* list, size_t key) {
-  NODE* f;
-  if (!list->first) {
-  	// empty list -- does not exist
-  	return NULL;
-  }
+  NODE* prev = find_preceding_from_list(list, key);
+  NODE* f    = prev ? prev->next : list->first;
 
-  // see if we can find it.
-  f = find_nearest_from(list->first, key);
-  
-  if (!f || f->key == key) {
+  if (f && f->key == key) {
   	return f;
   }
-  
+
   return NULL;
 }
 
 
-
 /*
  * Find some element in the list and return the node ptr for that key.
  */
@@ -455,33 +648,51 @@ NODE* find_with_preceding(LIST* list, size_t key, NODE*& prev) {
  * that key is present.
  */
 NODE* find_preceding_from_node(NODE* prev, size_t key) {
-  NODE* curr = prev->next;
-
-  if (!curr || key <= curr->key) {
-  	return prev;
-  	
-  } else {
-  	return find_preceding_from_node(curr, key);
+  while (prev->next && prev->next->key < key) {
+    prev = prev->next;
   }
+
+  return prev;
 }
 
 
 /*
  * Returns NULL if the key being sought is first in the list or *should* be first in the list but is absent. Otherwise
  * returns the previous node to where that key is or should be.
+ *
+ * Uses (and maintains) the list's skip-list index, so this is O(log n) rather than a walk from the front.
  */
 NODE* find_preceding_from_list(LIST* l, size_t key) {
   NODE* n = l->first;
   if (!n || n->key >= key)  return NULL;
-  else                      return find_preceding_from_node(n, key);
+
+  skip::ENTRY* update[skip::MAX_HEIGHT];
+  NODE* indexed = skip::descend(l, key, update);
+  if (indexed) n = indexed;
+
+  // Walk the rest of the way, indexing a node whenever the gap gets too long.
+  size_t steps = 0;
+  while (n->next && n->next->key < key) {
+    n = n->next;
+    if (++steps == skip::SPAN) {
+      skip::add(l, n, update);
+      steps = 0;
+    }
+  }
+
+  return n;
 }
 
 /*
- * Finds the node or, if not present, the node that it should follow. NULL
- * indicates no preceding node.
+ * Finds the node or, if not present, the node that it should follow. If the key
+ * would go before every node, returns the first node.
  */
 NODE* find_nearest(LIST* list, size_t key) {
-  return find_nearest_from(list->first, key);
+  NODE* prev = find_preceding_from_list(list, key);
+  if (!prev) return list->first;
+
+  if (prev->next && prev->next->key == key) return prev->next;
+  return prev;
 }
 
 /*
@@ -517,48 +728,20 @@ NODE* find_nearest_from(NODE* prev, size_t key) {
  */
 template <typename LDType, typename RDType>
 void cast_copy_contents(LIST* lhs, const LIST* rhs, size_t recursions) {
-  NODE *lcurr, *rcurr;
-
-  if (rhs->first) {
-    // copy head node
-    rcurr = rhs->first;
-    lcurr = lhs->first = NM_ALLOC( NODE );
-
-    while (rcurr) {
-      lcurr->key = rcurr->key;
-
-      if (recursions == 0) {
-      	// contents is some kind of value
-
-        lcurr->val = NM_ALLOC( LDType );
-
-        *reinterpret_cast<LDType*>(lcurr->val) = *reinterpret_cast<RDType*>( rcurr->val );
-
-      } else {
-      	// contents is a list
-
-        lcurr->val = NM_ALLOC( LIST );
-
-        cast_copy_contents<LDType, RDType>(
-          reinterpret_cast<LIST*>(lcurr->val),
-          reinterpret_cast<LIST*>(rcurr->val),
-          recursions-1
-        );
-      }
-
-      if (rcurr->next) {
-      	lcurr->next = NM_ALLOC( NODE );
+  NODE* lcurr = NULL;
 
-      } else {
-      	lcurr->next = NULL;
-      }
+  for (const NODE* rcurr = rhs->first; rcurr; rcurr = rcurr->next) {
+    if (recursions == 0) {
+      // contents is some kind of value
+      LDType val = *reinterpret_cast<RDType*>(rcurr->val);
+      lcurr = insert_helper(lhs, lcurr, rcurr->key, val);
 
-      lcurr = lcurr->next;
-      rcurr = rcurr->next;
+    } else {
+      // contents is a list
+      LIST* l = create(lhs->arena);
+      cast_copy_contents<LDType, RDType>(l, reinterpret_cast<const LIST*>(rcurr->val), recursions-1);
+      lcurr = insert_helper(lhs, lcurr, rcurr->key, l);
     }
-
-  } else {
-    lhs->first = NULL;
   }
 }
 
@@ -69,7 +69,10 @@ namespace nm { namespace list {
 // Lifecycle //
 ///////////////
 
-LIST*	create(void);
+LIST_ARENA* create_arena(size_t val_size);
+void        del_arena(LIST_ARENA* arena);
+
+LIST*	create(LIST_ARENA* arena);
 void	del(LIST* list, size_t recursions);
 void	mark(LIST* list, size_t recursions);
 
@@ -77,37 +80,40 @@ void	mark(LIST* list, size_t recursions);
 // Accessors //
 ///////////////
 
-NODE* insert(LIST* list, bool replace, size_t key, void* val);
-NODE* insert_copy(LIST *list, bool replace, size_t key, void *val, size_t size);
-NODE* insert_first_node(LIST* list, size_t key, void* val, size_t val_size);
+NODE* insert(LIST* list, bool replace, size_t key, const void* val);
+NODE* insert_after(LIST* list, NODE* node, size_t key, const void* val);
+NODE* replace_insert_after(LIST* list, NODE* node, size_t key, const void* val);
+NODE* insert_first_node(LIST* list, size_t key, const void* val);
+NODE* insert_list(LIST* list, size_t key, LIST* l);
+NODE* insert_list_after(LIST* list, NODE* node, size_t key, LIST* l);
 NODE* insert_first_list(LIST* list, size_t key, LIST* l);
-NODE* insert_after(NODE* node, size_t key, void* val);
-NODE* replace_insert_after(NODE* node, size_t key, void* val, bool copy, size_t copy_size);
-void* remove(LIST* list, size_t key);
-void* remove_by_node(LIST* list, NODE* prev, NODE* rm);
+void  remove_node(LIST* list, NODE* prev, NODE* rm);
+LIST* remove_list_node(LIST* list, NODE* prev, NODE* rm);
 bool remove_recursive(LIST* list, const size_t* coords, const size_t* offset, const size_t* lengths, size_t r, const size_t& dim);
 bool node_is_within_slice(NODE* n, size_t coord, size_t len);
 
+/*
+ * Appends a value after node (or inserts it into list, if node is NULL). The value is copied into the new node.
+ */
 template <typename Type>
 inline NODE* insert_helper(LIST* list, NODE* node, size_t key, Type val) {
-	Type* val_mem = NM_ALLOC(Type);
-	*val_mem = val;
-	
 	if (node == NULL) {
-		return insert(list, false, key, val_mem);
+		return insert(list, false, key, &val);
 		
 	} else {
-		return insert_after(node, key, val_mem);
+		return insert_after(list, node, key, &val);
 	}
 }
 
-template <typename Type>
-inline NODE* insert_helper(LIST* list, NODE* node, size_t key, Type* ptr) {
+/*
+ * As above, for a sub-list, which is linked in rather than copied.
+ */
+inline NODE* insert_helper(LIST* list, NODE* node, size_t key, LIST* l) {
 	if (node == NULL) {
-		return insert(list, false, key, ptr);
+		return insert_list(list, key, l);
 		
 	} else {
-		return insert_after(node, key, ptr);
+		return insert_list_after(list, node, key, l);
 	}
 }
 
@@ -0,0 +1,215 @@
+#--
+# = NMatrix
+#
+# A linear algebra library for scientific computation in Ruby.
+# NMatrix is part of SciRuby.
+#
+# NMatrix was originally inspired by and derived from NArray, by
+# Masahiro Tanaka: http://narray.rubyforge.org
+#
+# == Copyright Information
+#
+# SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+# NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+#
+# Please see LICENSE.txt for additional copyright notices.
+#
+# == Contributing
+#
+# By contributing source code to SciRuby, you agree to be bound by
+# our Contributor Agreement:
+#
+# * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+#
+# == bsr.rb
+#
+# Block compressed sparse row matrices, for matrices made of small
+# dense blocks. The native code is in ext/nmatrix/storage/bsr.
+#++
+
+class NMatrix
+
+  #
+  # call-seq:
+  #     to_bsr(block_size) -> NMatrix::BSR
+  #
+  # This matrix in block compressed sparse row form, with square blocks
+  # of +block_size+ rows and columns, which must divide both dimensions.
+  # Only the blocks with nonzeros in them are stored. Matrices other than
+  # Yale ones are cast to Yale first.
+  #
+  def to_bsr(block_size)
+    BSR.from_yale(self.stype == :yale && !self.is_ref? ? self : self.cast(:yale, self.dtype), block_size)
+  end
+
+  #
+  # A matrix made of dense k-by-k blocks, as from finite elements with
+  # several unknowns per node, kept by block rows (see
+  # ext/nmatrix/storage/bsr/bsr.h). Compared with Yale, only one column
+  # index is kept per block, and products work on whole blocks at a time.
+  #
+  # A BSR matrix is made from a Yale one with NMatrix#to_bsr, and turned
+  # back into one with #to_yale. It can be multiplied by dense vectors and
+  # matrices (#dot), split into block rows (#block_rows), and saved and
+  # loaded (#write, BSR.read).
+  #
+  class BSR
+    # The matrix's shape, and the number of rows and columns in a block.
+    attr_reader :shape, :block_size
+
+    # Where each block row starts in col_ind and values (an :int64 NMatrix
+    # with shape[0]/block_size + 1 entries).
+    attr_reader :row_ptr
+
+    # The block column of each block (an :int64 NMatrix).
+    attr_reader :col_ind
+
+    # The entries of each block in turn, by rows (a one-dimensional dense
+    # NMatrix).
+    attr_reader :values
+
+    class << self
+      #
+      # call-seq:
+      #     from_yale(matrix, block_size) -> NMatrix::BSR
+      #
+      # The BSR form of a Yale matrix; see NMatrix#to_bsr.
+      #
+      def from_yale(matrix, block_size)
+        raise(StorageTypeError, "only works with yale matrices") unless matrix.stype == :yale
+        raise(ShapeError, "only works with matrices") unless matrix.dim == 2
+        raise(NotImplementedError, "matrix default value must be zero") unless matrix.default_value == 0
+
+        matrix  = matrix.clone if matrix.is_ref?
+        row_ptr = NMatrix.new([matrix.shape[0] / block_size + 1], 0, dtype: :int64)
+        nblocks = NMatrix::Internal::BSR.count_blocks(matrix, block_size, row_ptr)
+        col_ind = NMatrix.new([[nblocks, 1].max], 0, dtype: :int64)
+        values  = NMatrix.new([[nblocks * block_size**2, 1].max], 0, dtype: matrix.dtype)
+
+        NMatrix::Internal::BSR.from_yale(matrix, block_size, row_ptr, col_ind, values)
+        new(matrix.shape, block_size, row_ptr, col_ind, values)
+      end
+
+      #
+      # call-seq:
+      #     read(file) -> NMatrix::BSR
+      #
+      # Load a BSR matrix saved by #write.
+      #
+      def read(file)
+        dtype, block_size, rows, cols, nblocks = NMatrix::Internal::BSR.read_header(file)
+
+        row_ptr = NMatrix.new([rows / block_size + 1], 0, dtype: :int64)
+        col_ind = NMatrix.new([[nblocks, 1].max], 0, dtype: :int64)
+        values  = NMatrix.new([[nblocks * block_size**2, 1].max], 0, dtype: dtype)
+
+        NMatrix::Internal::BSR.read(file, row_ptr, col_ind, values)
+        new([rows, cols], block_size, row_ptr, col_ind, values)
+      end
+    end
+
+    #
+    # call-seq:
+    #     new(shape, block_size, row_ptr, col_ind, values) -> NMatrix::BSR
+    #
+    # A BSR matrix from its arrays, which are kept, not copied. See the
+    # attributes for what they hold; col_ind and values may have room to
+    # spare. Raises ArgumentError unless the block columns of each block
+    # row are in range and ascending.
+    #
+    def initialize(shape, block_size, row_ptr, col_ind, values)
+      raise(ArgumentError, "block size must be positive") unless block_size > 0
+      raise(ShapeError, "block size must divide the number of rows and columns") unless
+        shape.size == 2 && shape.all? { |d| d % block_size == 0 }
+      raise(ShapeError, "row_ptr must have one entry per block row, and one more") unless
+        row_ptr.size == shape[0] / block_size + 1
+      raise(DataTypeError, "row_ptr and col_ind must be :int64") unless row_ptr.dtype == :int64 && col_ind.dtype == :int64
+      raise(DataTypeError, "block sparse matrices can't have dtype :object") if values.dtype == :object
+      NMatrix::Internal::BSR.check_pattern(block_size, shape, row_ptr, col_ind)
+
+      @shape      = shape
+      @block_size = block_size
+      @row_ptr    = row_ptr
+      @col_ind    = col_ind
+      @values     = values
+    end
+
+    def dtype
+      @values.dtype
+    end
+
+    # The number of stored blocks.
+    def blocks
+      @row_ptr[@row_ptr.size - 1]
+    end
+
+    #
+    # call-seq:
+    #     dot(x) -> NMatrix
+    #
+    # The product of this matrix and the vector or matrix +x+, which is cast
+    # to dense with this matrix's dtype. The result is dense.
+    #
+    def dot(x)
+      raise(ShapeError, "number of rows of x must equal number of columns of self") unless x.shape[0] == @shape[1]
+
+      x = x.cast(:dense, dtype)
+      x = x.clone if x.is_ref?
+      y = NMatrix.new(x.dim > 1 ? [@shape[0], x.shape[1]] : [@shape[0]], 0, dtype: dtype)
+
+      NMatrix::Internal::BSR.multiply(@block_size, @shape[1], @row_ptr, @col_ind, @values, x, y)
+    end
+
+    #
+    # call-seq:
+    #     block_rows(range) -> NMatrix::BSR
+    #     block_rows(first, count) -> NMatrix::BSR
+    #
+    # A copy of the given block rows: rows +first+ * +block_size+ up to
+    # (+first+ + +count+) * +block_size+ of the matrix, with all its columns.
+    #
+    def block_rows(first, count = nil)
+      first, count = first.first, first.size if first.is_a?(Range)
+      nb = @row_ptr.size - 1
+      raise(RangeError, "block rows #{first}...#{first+count} out of range (0...#{nb})") unless
+        first >= 0 && count > 0 && first + count <= nb
+
+      p0, p1  = @row_ptr[first], @row_ptr[first + count]
+      kk      = @block_size**2
+      row_ptr = (@row_ptr[first..(first + count)] - p0).cast(:dense, :int64)
+      col_ind = p1 > p0 ? @col_ind[p0...p1].clone : NMatrix.new([1], 0, dtype: :int64)
+      values  = p1 > p0 ? @values[(p0 * kk)...(p1 * kk)].clone : NMatrix.new([1], 0, dtype: dtype)
+
+      BSR.new([count * @block_size, @shape[1]], @block_size, row_ptr, col_ind, values)
+    end
+
+    #
+    # call-seq:
+    #     to_yale -> NMatrix
+    #
+    # This matrix as a Yale matrix, without the zeros in its blocks.
+    #
+    def to_yale
+      n = blocks * @block_size**2
+      return NMatrix.new(@shape, stype: :yale, dtype: dtype) if n == 0
+
+      rows = NMatrix.new([n], 0, dtype: :int64)
+      cols = NMatrix.new([n], 0, dtype: :int64)
+      NMatrix::Internal::BSR.coo_indices(@block_size, @row_ptr, @col_ind, rows, cols)
+
+      vals = @values.size == n ? @values : @values[0...n].clone
+      NMatrix.from_coo(rows, cols, vals, @shape, dtype: dtype)
+    end
+
+    #
+    # call-seq:
+    #     write(file) -> nil
+    #
+    # Save this matrix in the binary format described in
+    # ext/nmatrix/binary_format.txt; see BSR.read.
+    #
+    def write(file)
+      NMatrix::Internal::BSR.write(file, @block_size, @shape, @row_ptr, @col_ind, @values)
+    end
+  end
+end
@@ -0,0 +1,430 @@
+#--
+# = NMatrix
+#
+# A linear algebra library for scientific computation in Ruby.
+# NMatrix is part of SciRuby.
+#
+# NMatrix was originally inspired by and derived from NArray, by
+# Masahiro Tanaka: http://narray.rubyforge.org
+#
+# == Copyright Information
+#
+# SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+# NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+#
+# Please see LICENSE.txt for additional copyright notices.
+#
+# == Contributing
+#
+# By contributing source code to SciRuby, you agree to be bound by
+# our Contributor Agreement:
+#
+# * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+#
+# == factorization.rb
+#
+# Factorization objects returned by NMatrix#factorize, which keep a
+# factored matrix around so that it can be used for any number of
+# solves.
+#++
+
+class NMatrix
+
+  #
+  # call-seq:
+  #     factorize(:lu) -> NMatrix::Factorization::LU
+  #     factorize(:cholesky) -> NMatrix::Factorization::Cholesky
+  #     factorize(:cholesky, uplo: :upper) -> NMatrix::Factorization::Cholesky
+  #     factorize(:qr) -> NMatrix::Factorization::QR
+  #
+  # Factor a dense matrix once, for repeated solves with the same matrix:
+  #
+  #     lu = a.factorize(:lu)
+  #     x  = lu.solve(b)     # b may be a vector or an n-by-k block
+  #     lu.solve!(y)         # overwrites y with the solution
+  #
+  # :cholesky requires a symmetric (Hermitian) positive-definite matrix, and
+  # reads only the triangle given by +:uplo+ (+:lower+ by default).
+  #
+  # :qr also takes a tall (m-by-n, m >= n) matrix, whose solve gives the
+  # least-squares solution; see NMatrix#lstsq.
+  #
+  # :lu factors through NMatrix::LAPACK.clapack_getrf, so it uses the
+  # nmatrix-atlas or nmatrix-lapacke version when one of those plugins is
+  # loaded. :cholesky and :qr always use the internal implementations.
+  #
+  # A square Yale matrix gets a sparse direct factorization instead, which
+  # only stores the nonzeros of its factors:
+  #
+  #     lu = a.factorize(:lu)                            # a.stype == :yale
+  #     c  = a.factorize(:cholesky, ordering: :natural)
+  #     c2 = b.factorize(:cholesky, symbolic: c.symbolic)
+  #
+  # Options for Yale matrices:
+  # * +:ordering+ - +:amd+ (the default) orders the rows and columns by
+  #   approximate minimum degree to keep the fill-in low; +:rcm+ by reverse
+  #   Cuthill-McKee, which suits banded matrices; +:natural+ keeps them as
+  #   they are. See NMatrix#ordering.
+  # * +:symbolic+ - the #symbolic of an earlier factorization of a matrix
+  #   with the same sparsity pattern, whose ordering (and, for Cholesky,
+  #   elimination tree) is reused rather than recomputed.
+  # * +:pivot_tolerance+ - for :lu, how much smaller than the largest entry
+  #   in its column a diagonal pivot may be and still be chosen (0.1 by
+  #   default; 1.0 is plain partial pivoting).
+  #
+  # Sparse Cholesky reads the whole matrix, not one triangle, so both
+  # triangles must be stored. :qr is not available for Yale matrices.
+  #
+  # Other Ruby threads keep running while the numeric factorization does
+  # (a Yale matrix is copied first, so it may even change meanwhile), but
+  # the factorization can't be interrupted: Thread#raise, Thread#kill and
+  # ^C only take effect once it is done. Don't write to a dense matrix
+  # from another thread while it is being factored.
+  #
+  def factorize(type = :lu, opts = {})
+    if stype == :yale
+      case type
+      when :lu
+        return Factorization::SparseLU.new(self, opts)
+      when :cholesky
+        return Factorization::SparseCholesky.new(self, opts)
+      else
+        raise(ArgumentError, "unknown sparse factorization #{type.inspect}; expected :lu or :cholesky")
+      end
+    end
+
+    case type
+    when :lu
+      Factorization::LU.new(self)
+    when :cholesky
+      Factorization::Cholesky.new(self, opts[:uplo] || :lower)
+    when :qr
+      Factorization::QR.new(self)
+    else
+      raise(ArgumentError, "unknown factorization #{type.inspect}; expected :lu, :cholesky or :qr")
+    end
+  end
+
+  # Base class for the objects returned by NMatrix#factorize.
+  class Factorization
+    # The factored matrix, in the layout the corresponding LAPACK function leaves it.
+    attr_reader :factor
+
+    def initialize(matrix) #:nodoc:
+      raise(StorageTypeError, "only works with dense matrices") unless matrix.stype == :dense
+      raise(ShapeError, "Must be called on square matrix") unless matrix.dim == 2 && (matrix.shape[0] == matrix.shape[1] || tall_allowed?)
+      raise(DataTypeError, "only works for non-integer, non-object dtypes") if
+        matrix.integer_dtype? || matrix.object_dtype?
+
+      @factor = matrix.clone
+    end
+
+    def shape
+      @factor.shape
+    end
+
+    def dtype
+      @factor.dtype
+    end
+
+    #
+    # call-seq:
+    #     solve(b) -> NMatrix
+    #
+    # Solve A*X = B, where A is the factored matrix and B is a vector or a
+    # matrix whose columns are the right-hand sides. +b+ is not modified,
+    # and may be of any stype or dtype; X has the factorization's dtype.
+    #
+    def solve(b)
+      solve!(b.cast(:dense, self.dtype))
+    end
+
+    #
+    # call-seq:
+    #     solve!(b) -> b
+    #
+    # Solve A*X = B, overwriting +b+ with X. +b+ must be a dense matrix of the
+    # factorization's dtype, and not a slice reference.
+    #
+    def solve!(b)
+      raise(ShapeError, "number of rows of b must equal number of rows of the factored matrix") unless b.shape[0] == shape[0]
+      raise(DataTypeError, "b must have the factorization's dtype (#{self.dtype})") unless b.dtype == self.dtype
+
+      __solve__(b)
+    end
+
+    # LU factorization with partial pivoting, from clapack_getrf. The
+    # factoring goes through NMatrix::LAPACK, so it uses a plugin's
+    # clapack_getrf when one is loaded.
+    class LU < Factorization
+      # The (0-based) pivots from clapack_getrf, as an :int32 NMatrix.
+      attr_reader :pivot
+
+      def initialize(matrix) #:nodoc:
+        super(matrix)
+
+        n      = shape[0]
+        @pivot = NMatrix.new([n], NMatrix::LAPACK.clapack_getrf(:row, n, n, @factor, n), dtype: :int32)
+      end
+
+      protected
+
+      def __solve__(b)
+        NMatrix::Internal::LAPACK.getrs_rowmajor(@factor, @pivot, b)
+      end
+    end
+
+    # Cholesky factorization of a symmetric (Hermitian) positive-definite matrix, from clapack_potrf.
+    class Cholesky < Factorization
+      # The triangle (+:upper+ or +:lower+) holding the factor.
+      attr_reader :uplo
+
+      def initialize(matrix, uplo = :lower) #:nodoc:
+        super(matrix)
+
+        raise(ArgumentError, "uplo must be :upper or :lower") unless [:upper, :lower].include?(uplo)
+        @uplo = uplo
+        NMatrix::Internal::LAPACK.clapack_potrf(:row, uplo, shape[0], @factor, shape[0])
+      end
+
+      protected
+
+      def __solve__(b)
+        NMatrix::Internal::LAPACK.potrs_rowmajor(@uplo, @factor, b)
+      end
+    end
+
+    # Householder QR factorization, from clapack_geqrf. The matrix may have
+    # more rows than columns, in which case #solve gives the least-squares
+    # solution.
+    class QR < Factorization
+      # The scalar factors of the Householder reflectors, as an NMatrix.
+      attr_reader :tau
+
+      def initialize(matrix) #:nodoc:
+        super(matrix)
+
+        raise(ShapeError, "QR factorization needs at least as many rows as columns") if shape[0] < shape[1]
+        @tau = NMatrix.new([shape[1]], 0, dtype: dtype)
+        NMatrix::Internal::LAPACK.clapack_geqrf(:row, shape[0], shape[1], @factor, shape[1], @tau)
+      end
+
+      #
+      # call-seq:
+      #     solve(b) -> NMatrix
+      #
+      # Least-squares solution X of A*X = B, which has one row per column of
+      # A. +b+ is not modified.
+      #
+      def solve(b)
+        x = b.cast(:dense, self.dtype)
+        raise(ShapeError, "number of rows of b must equal number of rows of the factored matrix") unless x.shape[0] == shape[0]
+        __solve__(x)
+
+        n = shape[1]
+        x.dim == 1 ? x.slice(0...n) : x.slice(0...n, 0...x.shape[1])
+      end
+
+      # In-place solves need the solution to fit in +b+, so only work for a square A.
+      def solve!(b)
+        raise(ShapeError, "solve! needs a square matrix; use solve for least squares") unless shape[0] == shape[1]
+        super(b)
+      end
+
+      protected
+
+      def tall_allowed?
+        true
+      end
+
+      def __solve__(b)
+        NMatrix::Internal::LAPACK.geqrs_rowmajor(@factor, @tau, b)
+      end
+    end
+
+    #
+    # Base class for the sparse direct factorizations of Yale matrices,
+    # whose factors are kept in compressed-column form in dense NMatrix
+    # buffers rather than in a single factored matrix.
+    #
+    class Sparse < Factorization
+      # The ordering and other results of the symbolic phase, which only
+      # depend on the sparsity pattern; see Symbolic.
+      attr_reader :symbolic
+
+      attr_reader :shape, :dtype
+
+      def initialize(matrix, opts = {}) #:nodoc:
+        raise(StorageTypeError, "only works with yale matrices") unless matrix.stype == :yale
+        raise(ShapeError, "Must be called on square matrix") unless matrix.dim == 2 && matrix.shape[0] == matrix.shape[1]
+        raise(DataTypeError, "only works for non-integer, non-object dtypes") if
+          matrix.integer_dtype? || matrix.object_dtype?
+        raise(NotImplementedError, "matrix default value must be zero") unless matrix.default_value == 0
+
+        @shape    = matrix.shape
+        @dtype    = matrix.dtype
+        @symbolic = opts[:symbolic] || analyze(matrix, opts[:ordering] || :amd)
+
+        raise(ArgumentError, "symbolic analysis is for a #{@symbolic.shape[0]}-by-#{@symbolic.shape[0]} matrix") unless
+          @symbolic.shape == shape
+      end
+
+      #
+      # call-seq:
+      #     refactor(matrix) -> self
+      #
+      # Redo the numeric factorization for +matrix+, which must have the
+      # same shape, dtype and sparsity pattern as the matrix this was first
+      # computed for, reusing the symbolic phase.
+      #
+      def refactor(matrix)
+        raise(ShapeError, "matrix must be #{shape[0]}-by-#{shape[1]}") unless matrix.shape == shape
+        raise(DataTypeError, "matrix must have the factorization's dtype (#{dtype})") unless matrix.dtype == dtype
+        raise(StorageTypeError, "only works with yale matrices") unless matrix.stype == :yale
+
+        numeric(matrix.is_ref? ? matrix.clone : matrix)
+        self
+      end
+
+      #
+      # The symbolic phase of a sparse factorization: the fill-reducing
+      # order, as an :int64 NMatrix +perm+ (the k-th row and column
+      # eliminated is perm[k]), and whatever else the factorization
+      # precomputes from the sparsity pattern.
+      #
+      class Symbolic
+        attr_reader :shape, :perm
+
+        def initialize(shape, perm) #:nodoc:
+          @shape = shape
+          @perm  = perm
+        end
+      end
+
+      protected
+
+      # The fill-reducing order of matrix, as an :int64 NMatrix.
+      def ordering(matrix, type) #:nodoc:
+        NMatrix.new([shape[0]], matrix.ordering(type), dtype: :int64)
+      end
+
+      def int64_buffer(size) #:nodoc:
+        NMatrix.new([[size,1].max], 0, dtype: :int64)
+      end
+
+      def value_buffer(size) #:nodoc:
+        NMatrix.new([[size,1].max], 0, dtype: dtype)
+      end
+    end
+
+    #
+    # Sparse Cholesky factorization P*A*P**T = L*L**H of a Hermitian positive
+    # definite Yale matrix, up-looking, with L stored by columns.
+    #
+    class SparseCholesky < Sparse
+      # The symbolic phase of a sparse Cholesky factorization, which adds the
+      # elimination tree (+parent+) and the column pointers of L (+colptr+).
+      class Symbolic < Sparse::Symbolic
+        attr_reader :parent, :colptr
+
+        def initialize(shape, perm, parent, colptr) #:nodoc:
+          super(shape, perm)
+          @parent = parent
+          @colptr = colptr
+        end
+
+        # The number of entries in L.
+        def nnz
+          @colptr[@shape[0]]
+        end
+      end
+
+      def initialize(matrix, opts = {}) #:nodoc:
+        matrix = matrix.clone if matrix.is_ref?
+        super(matrix, opts)
+        raise(ArgumentError, "symbolic analysis is not for a Cholesky factorization") unless
+          @symbolic.is_a?(SparseCholesky::Symbolic)
+
+        numeric(matrix)
+      end
+
+      protected
+
+      def analyze(matrix, type) #:nodoc:
+        perm   = ordering(matrix, type)
+        parent = NMatrix.new([shape[0]], 0, dtype: :int64)
+        colptr = NMatrix.new([shape[0]+1], 0, dtype: :int64)
+        NMatrix::Internal::Sparse.cholesky_symbolic(matrix, perm, parent, colptr)
+
+        Symbolic.new(shape, perm, parent, colptr)
+      end
+
+      def numeric(matrix) #:nodoc:
+        s   = @symbolic
+        @li = int64_buffer(s.nnz)
+        @lx = value_buffer(s.nnz)
+        NMatrix::Internal::Sparse.cholesky_numeric(matrix, s.perm, s.parent, s.colptr, @li, @lx)
+      end
+
+      def __solve__(b)
+        NMatrix::Internal::Sparse.cholesky_solve(@symbolic.perm, @symbolic.colptr, @li, @lx, b)
+      end
+    end
+
+    #
+    # Sparse LU factorization with threshold partial pivoting (Gilbert and
+    # Peierls' left-looking algorithm) of a square Yale matrix.
+    #
+    class SparseLU < Sparse
+      # The pivot tolerance; see NMatrix#factorize.
+      attr_reader :pivot_tolerance
+
+      def initialize(matrix, opts = {}) #:nodoc:
+        matrix = matrix.clone if matrix.is_ref?
+        super(matrix, opts)
+
+        @pivot_tolerance = opts[:pivot_tolerance] || 0.1
+        raise(ArgumentError, "pivot_tolerance must be in (0, 1]") unless @pivot_tolerance > 0 && @pivot_tolerance <= 1
+
+        numeric(matrix)
+      end
+
+      protected
+
+      def analyze(matrix, type) #:nodoc:
+        Symbolic.new(shape, ordering(matrix, type))
+      end
+
+      # The sizes of L and U aren't known until the pivots are, so start with
+      # room for some fill-in and grow the buffers until they fit.
+      def numeric(matrix) #:nodoc:
+        n        = shape[0]
+        capacity = @capacity || 4*matrix.capacity + n
+        @lp      = NMatrix.new([n+1], 0, dtype: :int64)
+        @up      = NMatrix.new([n+1], 0, dtype: :int64)
+        @pinv    = NMatrix.new([n], 0, dtype: :int64)
+
+        loop do
+          @li, @lx, @ui, @ux = int64_buffer(capacity), value_buffer(capacity), int64_buffer(capacity), value_buffer(capacity)
+          break if NMatrix::Internal::Sparse.lu_numeric(matrix, @symbolic.perm, @pivot_tolerance.to_f,
+                                                        @lp, @li, @lx, @up, @ui, @ux, @pinv)
+          capacity *= 2
+        end
+
+        @capacity = capacity
+      end
+
+      def __solve__(b)
+        NMatrix::Internal::Sparse.lu_solve(@symbolic.perm, @pinv, @lp, @li, @lx, @up, @ui, @ux, b)
+      end
+    end
+
+    protected
+
+    # Whether the factorization also accepts matrices with more rows than columns.
+    def tall_allowed?
+      false
+    end
+
+  end
+end
@@ -51,7 +51,6 @@ class NMatrix
       # This uses the Cholesky decomposition so it should be faster than
       # the generic NMatrix#solve method.
       # Doesn't modify inputs.
-      # Requires either the nmatrix-atlas or nmatrix-lapacke gem.
       # * *Arguments* :
       #   - +uplo+ -> Either +:upper+ or +:lower+. Specifies which half of +a+ to read.
       #   - +a+ -> The matrix A.
@@ -59,7 +58,21 @@ class NMatrix
       # * *Returns* :
       #   - The solution X
       def posv(uplo, a, b)
-        raise(NotImplementedError, "Either the nmatrix-atlas or nmatrix-lapacke gem must be installed to use posv")
+        raise(ShapeError, "a must be square") unless a.dim == 2 && a.shape[0] == a.shape[1]
+        raise(ShapeError, "number of rows of b must equal number of cols of a") unless a.shape[1] == b.shape[0]
+        raise(StorageTypeError, "only works with dense matrices") unless a.stype == :dense && b.stype == :dense
+        raise(DataTypeError, "only works for non-integer, non-object dtypes") if
+          a.integer_dtype? || a.object_dtype? || b.integer_dtype? || b.object_dtype?
+
+        x     = b.cast(dtype: a.dtype)
+        clone = a.clone
+        n     = a.shape[0]
+        nrhs  = b.shape[1]
+        clapack_potrf(:row, uplo, n, clone, n)
+        # Each right-hand side is a row of b for clapack_potrs, so transpose before and after.
+        x = x.transpose
+        clapack_potrs(:row, uplo, n, nrhs, clone, n, x, n)
+        x.transpose
       end
 
       #     laswp(matrix, ipiv) -> NMatrix
@@ -160,22 +173,6 @@ class NMatrix
       def lapack_geev(jobvl, jobvr, n, a, lda, w, wi, vl, ldvl, vr, ldvr, lwork)
         raise(NotImplementedError,"lapack_geev requires the nmatrix-atlas gem")
       end
-
-      def clapack_potrf(order, uplo, n, a, lda)
-        raise(NotImplementedError,"clapack_potrf requires the nmatrix-atlas gem")
-      end
-
-      def clapack_potri(order, uplo, n, a, lda)
-        raise(NotImplementedError,"clapack_potri requires the nmatrix-atlas gem")
-      end
-
-      def clapack_potrs(order, uplo, n, nrhs, a, lda, b, ldb)
-        raise(NotImplementedError,"clapack_potrs requires the nmatrix-atlas gem")
-      end
-
-      def clapack_getri(order, n, a, lda, ipiv)
-        raise(NotImplementedError,"clapack_getri requires the nmatrix-atlas gem")
-      end
     end
   end
 end
@@ -195,11 +195,15 @@ class NMatrix
     NMatrix::LAPACK::lapacke_potrf(:row, which, self.shape[0], self, self.shape[1])
   end
 
-  def solve b
+  alias_method :internal_solve, :solve
+
+  def solve b, opts = {}
+    # Yale matrices, and any solve options, are handled by the core #solve.
+    return self.internal_solve(b, opts) unless self.stype == :dense && opts.empty?
+
     raise(ShapeError, "Must be called on square matrix") unless self.dim == 2 && self.shape[0] == self.shape[1]
     raise(ShapeError, "number of rows of b must equal number of cols of self") if 
       self.shape[1] != b.shape[0]
-    raise ArgumentError, "only works with dense matrices" if self.stype != :dense
     raise ArgumentError, "only works for non-integer, non-object dtypes" if 
       integer_dtype? or object_dtype? or b.integer_dtype? or b.object_dtype?
 
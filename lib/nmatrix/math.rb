@@ -164,21 +164,23 @@ class NMatrix
   # Also the function only reads in the upper or lower part of the matrix,
   # so it doesn't actually have to be symmetric/Hermitian.
   # However, if the matrix (i.e. the symmetric matrix implied by the lower/upper
-  # half) is not positive-definite, the function will return nonsense.
+  # half) is not positive-definite, an ArgumentError is raised.
   #
-  # This functions requires either the nmatrix-atlas or nmatrix-lapacke gem
-  # installed.
+  # The nmatrix-atlas and nmatrix-lapacke gems replace this with their own
+  # version.
   #
   # * *Returns* :
   #   the triangular portion specified by the parameter
   # * *Raises* :
-  #   - +StorageTypeError+ -> ATLAS functions only work on dense matrices.
+  #   - +StorageTypeError+ -> LAPACK functions only work on dense matrices.
   #   - +ShapeError+ -> Must be square.
-  #   - +NotImplementedError+ -> If called without nmatrix-atlas or nmatrix-lapacke gem
+  #   - +ArgumentError+ -> If the matrix is not positive-definite.
   #
   def potrf!(which)
-    # The real implementation is in the plugin files.
-    raise(NotImplementedError, "potrf! requires either the nmatrix-atlas or nmatrix-lapacke gem")
+    raise(StorageTypeError, "LAPACK functions only work on dense matrices") unless self.dense?
+    raise(ShapeError, "Cholesky decomposition only valid for square matrices") unless self.dim == 2 && self.shape[0] == self.shape[1]
+
+    NMatrix::LAPACK::clapack_potrf(:row, which, self.shape[0], self, self.shape[1])
   end
 
   def potrf_upper!
@@ -232,6 +234,391 @@ class NMatrix
     [t, FactorizeLUMethods.permutation_matrix_from(pivot)]
   end
 
+  #
+  # call-seq:
+  #     geqrf! -> NMatrix
+  #
+  # Householder QR factorization of an m-by-n matrix, in place, as LAPACK's
+  # geqrf leaves it: R on and above the diagonal, and below it the
+  # Householder vectors that make up Q. Returns +tau+, the min(m,n) scalar
+  # factors of those reflectors. See #factorize_qr for Q and R themselves.
+  #
+  # Only works for dense matrices with non-integer, non-object dtypes.
+  #
+  def geqrf!
+    raise(StorageTypeError, "LAPACK functions only work on dense matrices") unless self.dense?
+    raise(ShapeError, "QR factorization only works on 2-dimensional matrices") unless self.dim == 2
+    raise(DataTypeError, "only works for non-integer, non-object dtypes") if integer_dtype? || object_dtype?
+
+    tau = NMatrix.new([[self.shape[0], self.shape[1]].min], 0, dtype: self.dtype)
+    NMatrix::LAPACK::clapack_geqrf(:row, self.shape[0], self.shape[1], self, self.shape[1], tau)
+    tau
+  end
+
+  #
+  # call-seq:
+  #     factorize_qr -> [q, r]
+  #
+  # QR factorization of an m-by-n matrix, A = QR. This is the reduced form:
+  # with k = min(m,n), Q is m-by-k with orthonormal columns, and R is k-by-n
+  # and upper triangular.
+  #
+  def factorize_qr
+    a   = self.clone
+    tau = a.geqrf!
+    m, n = self.shape
+    k   = tau.shape[0]
+
+    r = a.slice(0...k, 0...n)
+    (1...k).each { |i| (0...i).each { |j| r[i,j] = 0 } }
+
+    q = NMatrix.new([m,k], 0, dtype: self.dtype)
+    k.times { |i| q[i,i] = 1 }
+    NMatrix::LAPACK::clapack_ormqr(:row, :left, false, m, k, k, a, n, tau, q, k)
+
+    [q, r]
+  end
+
+  #
+  # call-seq:
+  #     lstsq(b) -> NMatrix
+  #
+  # Least-squares solution X of A*X = B, where A is +self+, an m-by-n matrix
+  # with m >= n and full rank, and B is m-by-k (or a vector of length m):
+  # each column of X minimizes the norm of the residual of the corresponding
+  # column of B. Uses a Householder QR factorization of A rather than the
+  # normal equations, so it keeps the accuracy of A's condition number
+  # rather than its square.
+  #
+  # == Usage
+  #
+  #   a = NMatrix.new [3,2], [1,1, 1,2, 1,3], dtype: :float64
+  #   b = NMatrix.new [3,1], [1,2,2], dtype: :float64
+  #   a.lstsq(b) # => the best-fit intercept and slope
+  #
+  def lstsq b
+    raise(ShapeError, "number of rows of b must equal number of rows of self") if
+      self.dim != 2 || self.shape[0] != b.shape[0]
+    raise ArgumentError, "only works with dense matrices" if self.stype != :dense
+    raise ArgumentError, "only works for non-integer, non-object dtypes" if
+      integer_dtype? or object_dtype? or b.integer_dtype? or b.object_dtype?
+
+    factorize(:qr).solve(b)
+  end
+
+  #
+  # call-seq:
+  #     eigh -> [eigenvalues, eigenvectors]
+  #     eigh(k: 3, which: :largest) -> [eigenvalues, eigenvectors]
+  #     eigh(vectors: false) -> eigenvalues
+  #
+  # Eigenvalues and eigenvectors of a symmetric (or, if complex, Hermitian)
+  # matrix. Only the triangle given by +:uplo+ (+:lower+ by default) is read.
+  #
+  # +eigenvalues+ is an m-by-1 NMatrix of the real dtype that goes with the
+  # matrix's dtype, in ascending order, and the columns of the n-by-m
+  # +eigenvectors+ are the corresponding orthonormal eigenvectors. By
+  # default m = n; +:k+ asks for only the k +:smallest+ (the default) or
+  # +:largest+ eigenvalues, which is much cheaper than the whole spectrum
+  # when k is small.
+  #
+  # Does not need the nmatrix-atlas or nmatrix-lapacke plugins.
+  #
+  # == Usage
+  #
+  #   cov = data.cov
+  #   variances, components = cov.eigh(k: 2, which: :largest)
+  #
+  def eigh(opts = {})
+    raise(StorageTypeError, "eigh only works on dense matrices") unless self.dense?
+    raise(ShapeError, "eigh only works on square matrices") unless self.dim == 2 && self.shape[0] == self.shape[1]
+    raise(DataTypeError, "only works for non-integer, non-object dtypes") if integer_dtype? || object_dtype?
+
+    n     = self.shape[0]
+    k     = opts[:k] || n
+    which = opts[:which] || :smallest
+    raise(ArgumentError, "k must be between 0 and #{n}") unless k.is_a?(Integer) && k >= 0 && k <= n
+    raise(ArgumentError, "which must be :smallest or :largest") unless [:smallest, :largest].include?(which)
+
+    a       = self.is_ref? ? self.clone : self
+    values  = NMatrix.new([k,1], 0, dtype: self.abs_dtype)
+    vectors = opts.fetch(:vectors, true) ? NMatrix.new([n,k], 0, dtype: self.dtype) : nil
+
+    NMatrix::Internal::LAPACK.syev_rowmajor(opts[:uplo] || :lower, a, which == :largest ? n-k : 0, values, vectors)
+
+    vectors ? [values, vectors] : values
+  end
+
+  #
+  # call-seq:
+  #     svd_truncated(k) -> [u, sigma, v_conjugate_transpose]
+  #     svd_truncated(k, oversample: 10, power_iters: 2, seed: nil) -> [u, sigma, v_conjugate_transpose]
+  #
+  # The k largest singular values of an m-by-n dense or Yale matrix, and the
+  # corresponding singular vectors, by randomized range finding (Halko,
+  # Martinsson and Tropp). +u+ is m-by-k, +sigma+ is a k-by-1 NMatrix of the
+  # real dtype that goes with the matrix's dtype, in descending order, and
+  # +v_conjugate_transpose+ is k-by-n.
+  #
+  # The matrix is only touched through products with m-by-(k+oversample)
+  # and n-by-(k+oversample) dense blocks (Yale-by-dense products are done
+  # natively), and only a matrix of that size is decomposed, so the time and
+  # memory needed grow with (m+n)k rather than mn. Each of the +power_iters+
+  # extra passes over the matrix sharpens the result when the singular
+  # values decay slowly. +seed+ makes the random test matrix reproducible.
+  #
+  # Does not need the nmatrix-atlas or nmatrix-lapacke plugins.
+  #
+  # == Usage
+  #
+  #   u, sigma, vt = term_matrix.svd_truncated(20)
+  #
+  def svd_truncated(k, opts = {})
+    raise(StorageTypeError, "svd_truncated only works on dense and yale matrices") unless self.dense? || self.yale?
+    raise(ShapeError, "svd_truncated only works on 2-dimensional matrices") unless self.dim == 2
+    raise(DataTypeError, "only works for non-integer, non-object dtypes") if integer_dtype? || object_dtype?
+
+    m, n        = self.shape
+    oversample  = opts[:oversample] || 10
+    power_iters = opts[:power_iters] || 2
+    raise(ArgumentError, "k must be between 1 and #{[m,n].min}") unless k.is_a?(Integer) && k >= 1 && k <= [m,n].min
+    raise(ArgumentError, "oversample and power_iters must be non-negative") if oversample < 0 || power_iters < 0
+
+    l   = [k + oversample, m, n].min
+    a   = self.is_ref? ? self.clone : self
+    ah  = a.conjugate_transpose
+    rng = opts[:seed] ? Random.new(opts[:seed]) : Random.new
+
+    values = Array.new(n*l) do
+      complex_dtype? ? Complex(rng.rand(-1.0..1.0), rng.rand(-1.0..1.0)) : rng.rand(-1.0..1.0)
+    end
+
+    # Orthonormal basis Q for the range of A * omega, refined by power iterations.
+    q = a.dot(NMatrix.new([n,l], values, dtype: self.dtype)).factorize_qr[0]
+    power_iters.times do
+      q = ah.dot(q).factorize_qr[0]
+      q = a.dot(q).factorize_qr[0]
+    end
+
+    # With B = Q**H * A, B**H = Vb * diag(sigma) * W**H, so A ~= Q * B = (Q * W) * diag(sigma) * Vb**H.
+    vb    = ah.dot(q)
+    sigma = NMatrix.new([l,1], 0, dtype: self.abs_dtype)
+    w     = NMatrix.new([l,l], 0, dtype: self.dtype)
+    NMatrix::Internal::LAPACK.gesvj_rowmajor(vb, sigma, w)
+
+    [q.dot(w.slice(0...l, 0...k)), sigma.slice(0...k, 0..0), vb.slice(0...n, 0...k).conjugate_transpose]
+  end
+
+  #
+  # call-seq:
+  #     eigsh(k) -> [eigenvalues, eigenvectors]
+  #     eigsh(k, which: :smallest, ncv: 40, maxiter: 1000, tol: 1e-8, v0: x) -> [eigenvalues, eigenvectors]
+  #     eigsh(k, vectors: false) -> eigenvalues
+  #
+  # The k largest (or, with <tt>which: :smallest</tt>, smallest) eigenvalues
+  # of a large symmetric (or, if complex, Hermitian) Yale matrix, and the
+  # corresponding eigenvectors, by thick-restart Lanczos. The results are
+  # laid out as in #eigh: the eigenvalues are a k-by-1 NMatrix of the real
+  # dtype that goes with the matrix's dtype, in ascending order.
+  #
+  # The matrix is only used through native sparse matrix-vector products,
+  # so this works for matrices far too large to densify. The Krylov basis
+  # holds +:ncv+ vectors of length n (by default, 2k+1 or 20, whichever is
+  # larger); more vectors cost memory but need fewer restarts. +:tol+ is
+  # the residual norm wanted, relative to the largest eigenvalue magnitude
+  # (the square root of machine precision by default; the eigenvalues are
+  # then accurate to about machine precision), +:maxiter+ the number of
+  # restarts allowed before a RuntimeError is raised (10n by default), and
+  # +:v0+ the start vector.
+  #
+  # A single Krylov sequence only sees one vector of each eigenspace, so
+  # the converged eigenvectors are locked and the search is repeated on
+  # their orthogonal complement from a random vector, until it finds
+  # nothing nearer the wanted end. Repeated eigenvalues, as in the
+  # Laplacian of a grid, are therefore found with all their copies; each
+  # such check costs about as much as a restart cycle.
+  #
+  # Dense matrices work too, but #eigh is usually the better choice for
+  # them. See NMatrix.eigsh for operators that aren't stored as a matrix.
+  #
+  # For a Yale matrix the whole iteration runs natively on a copy of it,
+  # letting other threads run but ignoring interrupts until it returns.
+  #
+  # == Usage
+  #
+  #   values, vectors = laplacian.eigsh(4, which: :smallest)
+  #
+  def eigsh(k, opts = {})
+    raise(StorageTypeError, "eigsh only works on yale and dense matrices") unless self.yale? || self.dense?
+    raise(ShapeError, "eigsh only works on square matrices") unless self.dim == 2 && self.shape[0] == self.shape[1]
+    raise(DataTypeError, "only works for non-integer, non-object dtypes") if integer_dtype? || object_dtype?
+
+    a = self.is_ref? ? self.clone : self
+    if a.yale?
+      raise(NotImplementedError, "matrix default value must be zero") unless a.default_value == 0
+      op = a
+    else
+      op = lambda { |x| a.dot(x) }
+    end
+
+    NMatrix.__lanczos__(op, self.shape[0], self.dtype, k, opts)
+  end
+
+  #
+  # call-seq:
+  #     cg(b) -> [x, info]
+  #     cg(b, tol: 1e-10, maxiter: 500, x0: guess, preconditioner: m) -> [x, info]
+  #
+  # Solves A * x = b, where A is +self+, a Hermitian positive definite Yale
+  # matrix, by conjugate gradients. b is a vector with n entries; x is
+  # returned as a dense n-by-1 NMatrix.
+  #
+  # The iteration starts from +:x0+ (zero by default) and stops once the
+  # residual norm |b - A * x| is at most +:tol+ * |b| (+:tol+ defaults to
+  # the square root of machine precision), or after +:maxiter+ iterations
+  # (10n by default). +info+ is a Hash: <tt>:converged</tt> says whether
+  # the tolerance was met, <tt>:iterations</tt> is the number of
+  # iterations done and <tt>:residuals</tt> the relative residual norm
+  # after each, starting with the initial guess's. A RuntimeError is raised
+  # if A turns out not to be positive definite.
+  #
+  # +:preconditioner+ is an NMatrix::Preconditioner from #preconditioner
+  # (or just its type, such as +:ic+), which can cut the number of
+  # iterations a great deal. For cg it must be Hermitian positive definite,
+  # as :jacobi and :ic are for such an A.
+  #
+  # A is only used through native sparse matrix-vector products, so
+  # nothing of size n-by-n is ever formed. See also #bicgstab and #gmres
+  # for matrices that aren't Hermitian positive definite.
+  #
+  # The iteration works on a copy of A and the preconditioner, and lets
+  # other Ruby threads run, but can't be interrupted: Thread#raise and ^C
+  # only take effect once it returns, so bound long solves by +:maxiter+.
+  # The same goes for #bicgstab and #gmres.
+  #
+  # == Usage
+  #
+  #   x, info = laplacian.cg(b, tol: 1e-10, preconditioner: :ic)
+  #   raise "no convergence" unless info[:converged]
+  #
+  def cg(b, opts = {})
+    __krylov__(:cg, b, opts)
+  end
+
+  #
+  # call-seq:
+  #     bicgstab(b) -> [x, info]
+  #     bicgstab(b, tol: 1e-10, maxiter: 500, x0: guess, preconditioner: m) -> [x, info]
+  #
+  # Solves A * x = b, where A is +self+, a square Yale matrix, by BiCGSTAB.
+  # Takes the same options and returns the same results as #cg, but works
+  # for general matrices; each iteration applies A twice. A RuntimeError
+  # is raised if the method breaks down, in which case #gmres may do better.
+  #
+  def bicgstab(b, opts = {})
+    __krylov__(:bicgstab, b, opts)
+  end
+
+  #
+  # call-seq:
+  #     gmres(b) -> [x, info]
+  #     gmres(b, restart: 50, tol: 1e-10, maxiter: 500, x0: guess, preconditioner: m) -> [x, info]
+  #
+  # Solves A * x = b, where A is +self+, a square Yale matrix, by GMRES,
+  # restarted every +:restart+ iterations (30 by default, and at most n).
+  # The residual norm never increases, which makes it the most robust
+  # choice for general matrices, but the Krylov basis keeps +:restart+
+  # vectors of length n. Takes the same other options and returns the same
+  # results as #cg.
+  #
+  def gmres(b, opts = {})
+    __krylov__(:gmres, b, opts)
+  end
+
+  # Shared by cg, bicgstab and gmres.
+  def __krylov__(method, b, opts) #:nodoc:
+    raise(StorageTypeError, "#{method} only works on yale matrices") unless self.yale?
+    raise(ShapeError, "#{method} only works on square matrices") unless self.dim == 2 && self.shape[0] == self.shape[1]
+    raise(DataTypeError, "only works for non-integer, non-object dtypes") if integer_dtype? || object_dtype?
+    raise(NotImplementedError, "matrix default value must be zero") unless self.default_value == 0
+
+    n = self.shape[0]
+    raise(ShapeError, "b must have #{n} entries") unless b.size == n
+
+    a = self.is_ref? ? self.clone : self
+    b = NMatrix.new([n,1], b.to_a.flatten, dtype: self.dtype) unless b.is_a?(NMatrix) && b.dense? && !b.is_ref? &&
+                                                                    b.dtype == self.dtype && b.shape == [n,1]
+    x = NMatrix.new([n,1], opts[:x0] ? opts[:x0].to_a.flatten : 0, dtype: self.dtype)
+
+    m = opts[:preconditioner]
+    m = a.preconditioner(m) if m.is_a?(Symbol)
+    raise(ArgumentError, "preconditioner must be an NMatrix::Preconditioner") unless m.nil? || m.is_a?(Preconditioner)
+    raise(ShapeError, "preconditioner doesn't match the matrix") unless m.nil? || (m.shape == self.shape && m.dtype == self.dtype)
+
+    restart = [opts[:restart] || 30, n].min
+    info, residuals = NMatrix::Internal::Sparse.krylov(method, a, b, x, opts[:tol] || 0.0, opts[:maxiter] || 10*n, restart,
+                                                       m && m.kind, m && m.factor)
+    raise(RuntimeError, "#{method} broke down") if info == 2
+
+    [x, {converged: info == 0, iterations: residuals.size - 1, residuals: residuals}]
+  end
+
+  class << self
+    #
+    # call-seq:
+    #     eigsh(n, k) { |x| ... } -> [eigenvalues, eigenvectors]
+    #     eigsh(n, k, dtype: :complex128, which: :smallest, ...) { |x| ... } -> [eigenvalues, eigenvectors]
+    #
+    # Matrix-free version of NMatrix#eigsh, for an n-by-n symmetric (or
+    # Hermitian) operator given by a block, which is passed a dense n-by-1
+    # NMatrix x of +:dtype+ (+:float64+ by default) and must return the
+    # operator applied to x as an NMatrix with n entries. The block must not
+    # keep x, which is reused. Takes the same options as NMatrix#eigsh.
+    #
+    # Passing the inverse of A - sigma*I (through a factorization) gives the
+    # eigenvalues of A nearest sigma, which Lanczos finds slowly otherwise:
+    #
+    #   lu     = (a - NMatrix.eye(n) * sigma).factorize(:lu)
+    #   mu, v  = NMatrix.eigsh(n, 3) { |x| lu.solve(x) }
+    #   nearest = mu.map { |m| sigma + 1 / m }
+    #
+    def eigsh(n, k, opts = {}, &block)
+      raise(ArgumentError, "expected a block applying the operator") unless block
+
+      dtype = opts[:dtype] || :float64
+      op    = lambda do |x|
+        y = block.call(x)
+        raise(ShapeError, "operator must return an NMatrix with #{n} entries") unless y.is_a?(NMatrix) && y.size == n
+        y = y.cast(:dense, dtype) unless y.dense? && y.dtype == dtype
+        y.is_ref? ? y.clone : y
+      end
+
+      __lanczos__(op, n, dtype, k, opts)
+    end
+
+    # Shared by both forms of eigsh; +op+ is a Yale matrix or responds to call.
+    def __lanczos__(op, n, dtype, k, opts) #:nodoc:
+      raise(DataTypeError, "only works for non-integer, non-object dtypes") unless
+        [:float32, :float64, :complex64, :complex128].include?(dtype)
+      raise(ArgumentError, "k must be between 1 and #{n-1}") unless k.is_a?(Integer) && k >= 1 && k < n
+
+      which = opts[:which] || :largest
+      raise(ArgumentError, "which must be :smallest or :largest") unless [:smallest, :largest].include?(which)
+      ncv   = opts[:ncv] || [[2*k + 1, 20].max, n].min
+
+      # A zero start vector makes the native code use its own reproducible random one.
+      x = NMatrix.new([n,1], opts[:v0] ? opts[:v0].to_a.flatten : 0, dtype: dtype)
+
+      abs_dtype = [:complex64, :float32].include?(dtype) ? :float32 : :float64
+      values    = NMatrix.new([k,1], 0, dtype: abs_dtype)
+      vectors   = opts.fetch(:vectors, true) ? NMatrix.new([n,k], 0, dtype: dtype) : nil
+
+      NMatrix::Internal::Sparse.lanczos(op, x, which, ncv, opts[:maxiter] || 10*n, opts[:tol] || 0.0, values, vectors)
+
+      vectors ? [values, vectors] : values
+    end
+  end
+
   # Reduce self to upper hessenberg form using householder transforms.
   # 
   # == References
@@ -258,36 +645,45 @@ class NMatrix
 
   # Solve the matrix equation AX = B, where A is +self+, B is the first
   # argument, and X is returned. A must be a nxn square matrix, while B must be
-  # nxm. Only works with dense
-  # matrices and non-integer, non-object data types.
+  # nxm. Only works with dense or yale matrices and non-integer, non-object
+  # data types.
+  #
+  # Dense matrices are solved by LU factorization. Yale matrices are solved
+  # column by column with #gmres, or with the iterative method given as
+  # +:method+ (+:cg+, +:bicgstab+ or +:gmres+), which takes the other
+  # options; a RuntimeError is raised if it doesn't converge. +:method+ may
+  # also be +:lu+ or +:cholesky+, for a sparse direct solve (see #factorize).
+  #
+  # The native solvers let other threads run but can't be interrupted, and
+  # B mustn't be written from another thread while they work (see #cg and
+  # #factorize for the details).
   # 
   # == Usage
   # 
   #   a = NMatrix.new [2,2], [3,1,1,2], dtype: dtype
   #   b = NMatrix.new [2,1], [9,8], dtype: dtype
   #   a.solve(b)
-  def solve b
+  def solve b, opts = {}
     raise(ShapeError, "Must be called on square matrix") unless self.dim == 2 && self.shape[0] == self.shape[1]
     raise(ShapeError, "number of rows of b must equal number of cols of self") if 
       self.shape[1] != b.shape[0]
-    raise ArgumentError, "only works with dense matrices" if self.stype != :dense
+    raise ArgumentError, "only works with dense or yale matrices" unless self.stype == :dense || self.stype == :yale
     raise ArgumentError, "only works for non-integer, non-object dtypes" if 
       integer_dtype? or object_dtype? or b.integer_dtype? or b.object_dtype?
 
-    x     = b.clone
-    clone = self.clone
-    n = self.shape[0]
-    nrhs = b.shape[1]
+    return factorize(:lu).solve(b) if self.stype == :dense
+
+    method = opts[:method] || :gmres
+    return factorize(method, opts).solve(b) if method == :lu || method == :cholesky
 
-    ipiv = NMatrix::LAPACK.clapack_getrf(:row, n, n, clone, n)
-    # When we call clapack_getrs with :row, actually only the first matrix
-    # (i.e. clone) is interpreted as row-major, while the other matrix (x)
-    # is interpreted as column-major. See here: http://math-atlas.sourceforge.net/faq.html#RowSolve
-    # So we must transpose x before and after
-    # calling it.
-    x = x.transpose
-    NMatrix::LAPACK.clapack_getrs(:row, :no_transpose, n, nrhs, clone, n, ipiv, x, n)
-    x.transpose
+    n, m   = b.shape[0], (b.dim > 1 ? b.shape[1] : 1)
+    x      = NMatrix.new([n,m], 0, dtype: self.dtype)
+    m.times do |j|
+      xj, info = __krylov__(method, b.dim > 1 ? b.column(j) : b, opts)
+      raise(RuntimeError, "#{method} did not converge") unless info[:converged]
+      x[0...n, j] = xj
+    end
+    x
   end
 
   #
@@ -365,7 +761,8 @@ class NMatrix
   # That is, the i'th entry of +ary+ is the index of the column that will be in position i after the 
   # reordering (Matlab-like behaviour). This is the default.
   #
-  # Not yet implemented for yale or list. 
+  # Yale matrices are permuted natively, in O(nnz) time (see #permute); not
+  # yet implemented for list.
   #
   # == Arguments
   #
@@ -376,8 +773,17 @@ class NMatrix
   # * +:covention+ - Possible values are +:lapack+ and +:intuitive+. Default is +:intuitive+. See above for details.
   #
   def laswp!(ary, opts={})
-    raise(StorageTypeError, "ATLAS functions only work on dense matrices") unless self.dense?
+    raise(StorageTypeError, "ATLAS functions only work on dense matrices") unless self.dense? || self.yale?
     opts = { convention: :intuitive }.merge(opts)
+
+    if self.yale?
+      order = ary
+      if opts[:convention] != :intuitive
+        order = (0...self.shape[1]).to_a
+        ary.each_with_index { |p,i| order[i], order[p] = order[p], order[i] }
+      end
+      return __yale_permute__(nil, order, true)
+    end
     
     if opts[:convention] == :intuitive
       if ary.length != ary.uniq.length
@@ -412,7 +818,7 @@ class NMatrix
   # That is, the i'th entry of +ary+ is the index of the column that will be in position i after the 
   # reordering (Matlab-like behaviour). 
   #
-  # Not yet implemented for yale or list. 
+  # Not yet implemented for list.
   #
   # == Arguments
   #
@@ -426,6 +832,60 @@ class NMatrix
     self.clone.laswp!(ary, opts)
   end
 
+  #
+  # call-seq:
+  #     permute(perm) -> NMatrix
+  #     permute(rows, cols) -> NMatrix
+  #
+  # Reorder the rows and columns of a matrix: entry (i,j) of the result is
+  # entry (rows[i], cols[j]) of +self+. With one permutation, both rows and
+  # columns are reordered by it (P*A*P**T), which keeps the diagonal on the
+  # diagonal; pass nil for +rows+ or +cols+ to leave them as they are.
+  # Permutations may be Arrays or dense :int64 NMatrix objects.
+  #
+  # Yale matrices are permuted natively in O(nnz) time, without going
+  # through #[]=. Together with #ordering, this can make a sparse matrix's
+  # bandwidth much smaller, which improves the memory locality of #dot:
+  #
+  #     b = a.permute(a.ordering(:rcm))
+  #
+  # Other stypes are permuted by way of a Yale copy.
+  #
+  def permute(rows, cols = rows)
+    raise(ShapeError, "Must be called on a 2D matrix") unless self.dim == 2
+    return self.cast(:yale, self.dtype).permute(rows, cols).cast(self.stype, self.dtype) unless self.yale?
+
+    (self.is_ref? ? self.clone : self).__yale_permute__(rows, cols, false)
+  end
+
+  #
+  # call-seq:
+  #     ordering(:rcm) -> Array
+  #     ordering(:amd) -> Array
+  #     ordering(:natural) -> Array
+  #
+  # A symmetric reordering of the rows and columns of a square Yale matrix,
+  # as an Array +perm+ whose k-th entry is the row (and column) to put k-th;
+  # see #permute. Only the sparsity pattern of A + A**T is used.
+  #
+  # * +:rcm+ - reverse Cuthill-McKee, which reduces the bandwidth.
+  # * +:amd+ - approximate minimum degree, which reduces the fill-in of a
+  #   sparse factorization (see #factorize).
+  # * +:natural+ - the identity.
+  #
+  def ordering(type = :rcm)
+    raise(StorageTypeError, "only works with yale matrices") unless self.yale?
+    raise(ShapeError, "Must be called on square matrix") unless self.dim == 2 && self.shape[0] == self.shape[1]
+
+    n = self.shape[0]
+    return (0...n).to_a if type == :natural
+
+    method = {rcm: :reverse_cuthill_mckee, amd: :minimum_degree}[type]
+    raise(ArgumentError, "unknown ordering #{type.inspect}; expected :rcm, :amd or :natural") unless method
+
+    NMatrix::Internal::Sparse.send(method, self.is_ref? ? self.clone : self, NMatrix.new([n], 0, dtype: :int64)).to_a
+  end
+
   #
   # call-seq:
   #     det -> determinant
@@ -835,21 +1295,29 @@ protected
   # Define the element-wise operations for lists. Note that the __list_map_merged_stored__ iterator returns a Ruby Object
   # matrix, which we then cast back to the appropriate type. If you don't want that, you can redefine these functions in
   # your own code.
+  #
+  # For yale and list, +, -, and * are done natively by __yale_ew_merge__/__list_ew_merge__ and
+  # __yale_ew_scalar__/__list_ew_scalar__ where possible, which return nil when they can't handle their arguments (e.g.,
+  # :object matrices).
   {add: :+, sub: :-, mul: :*, div: :/, pow: :**, mod: :%}.each_pair do |ewop, op|
     define_method("__list_elementwise_#{ewop}__") do |rhs|
-      self.__list_map_merged_stored__(rhs, nil) { |l,r| l.send(op,r) }.cast(stype, NMatrix.upcast(dtype, rhs.dtype))
+      self.__list_ew_merge__(rhs, ewop) ||
+        self.__list_map_merged_stored__(rhs, nil) { |l,r| l.send(op,r) }.cast(stype, NMatrix.upcast(dtype, rhs.dtype))
     end
     define_method("__dense_elementwise_#{ewop}__") do |rhs|
       self.__dense_map_pair__(rhs) { |l,r| l.send(op,r) }.cast(stype, NMatrix.upcast(dtype, rhs.dtype))
     end
     define_method("__yale_elementwise_#{ewop}__") do |rhs|
-      self.__yale_map_merged_stored__(rhs, nil) { |l,r| l.send(op,r) }.cast(stype, NMatrix.upcast(dtype, rhs.dtype))
+      self.__yale_ew_merge__(rhs, ewop) ||
+        self.__yale_map_merged_stored__(rhs, nil) { |l,r| l.send(op,r) }.cast(stype, NMatrix.upcast(dtype, rhs.dtype))
     end
     define_method("__list_scalar_#{ewop}__") do |rhs|
-      self.__list_map_merged_stored__(rhs, nil) { |l,r| l.send(op,r) }.cast(stype, NMatrix.upcast(dtype, NMatrix.min_dtype(rhs)))
+      self.__list_ew_scalar__(rhs, ewop) ||
+        self.__list_map_merged_stored__(rhs, nil) { |l,r| l.send(op,r) }.cast(stype, NMatrix.upcast(dtype, NMatrix.min_dtype(rhs)))
     end
     define_method("__yale_scalar_#{ewop}__") do |rhs|
-      self.__yale_map_stored__ { |l| l.send(op,rhs) }.cast(stype, NMatrix.upcast(dtype, NMatrix.min_dtype(rhs)))
+      self.__yale_ew_scalar__(rhs, ewop) ||
+        self.__yale_map_stored__ { |l| l.send(op,rhs) }.cast(stype, NMatrix.upcast(dtype, NMatrix.min_dtype(rhs)))
     end
     define_method("__dense_scalar_#{ewop}__") do |rhs|
       self.__dense_map__ { |l| l.send(op,rhs) }.cast(stype, NMatrix.upcast(dtype, NMatrix.min_dtype(rhs)))
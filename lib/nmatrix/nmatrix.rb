@@ -992,6 +992,87 @@ class NMatrix
     NMatrix.new(self.shape, opts)
   end
 
+  #
+  # call-seq:
+  #     batch_update { |m| ... } -> NMatrix
+  #
+  # Defers single-element assignments made inside the block and then merges them into the
+  # matrix all at once when the block exits. For +:yale+ matrices this avoids shifting the
+  # stored entries of every later row on each insertion, which makes building a matrix
+  # from many scattered updates much faster. For other stypes, the block is simply called.
+  #
+  # Reading an element inside the block sees the pending assignments, so updates such as
+  # <tt>m[i,j] += v</tt> accumulate; this holds for single elements read or assigned through
+  # reference slices of the matrix as well. Anything else (assigning to a range, assigning
+  # an Array or NMatrix, iterating, doing arithmetic) merges everything pending first.
+  #
+  # * *Returns* :
+  #   - The matrix itself.
+  # * *Examples* :
+  #     m = NMatrix.new(1000, stype: :yale, dtype: :int64)
+  #     m.batch_update do
+  #       edges.each { |i,j| m[i,j] = 1 }
+  #     end
+  #
+  def batch_update
+    raise(ArgumentError, "This operation cannot be performed on reference slices") if self.is_ref?
+
+    started = self.yale? && __yale_batch_begin__
+    begin
+      yield self
+    ensure
+      __yale_batch_commit__ if started
+    end
+    self
+  end
+
+  #
+  # call-seq:
+  #     dead_space_threshold -> Float or nil
+  #
+  # For +:yale+ matrices with lazy deletion turned on, the fraction of stored non-diagonal
+  # entries which may be deleted-but-not-yet-removed before the matrix compacts itself.
+  # Returns nil if lazy deletion is off (the default) or the matrix is not +:yale+.
+  #
+  def dead_space_threshold
+    self.yale? ? __yale_dead_space_threshold__ : nil
+  end
+
+  #
+  # call-seq:
+  #     dead_space_threshold = threshold
+  #
+  # Turns lazy deletion on or off for a +:yale+ matrix. Normally, setting a stored entry
+  # back to the default value removes it at once, shifting every stored entry after it. With
+  # a positive +threshold+, the entry is instead only marked as deleted (it reads as the
+  # default, and the iterators skip it); once the marked entries make up more than
+  # +threshold+ of the stored non-diagonal entries, they are all removed in a single pass.
+  # Setting an entry which was marked reuses its slot. This helps a lot when entries are
+  # repeatedly added and removed.
+  #
+  # Setting +threshold+ to nil turns lazy deletion off again and compacts the matrix.
+  #
+  # * *Examples* :
+  #     m = NMatrix.new(10000, stype: :yale, dtype: :float64)
+  #     m.dead_space_threshold = 0.25
+  #
+  def dead_space_threshold=(threshold)
+    raise(NotImplementedError, "lazy deletion is only available for yale matrices") unless self.yale?
+    __yale_set_dead_space_threshold__(threshold)
+  end
+
+  #
+  # call-seq:
+  #     compact! -> NMatrix
+  #
+  # Removes any entries of a +:yale+ matrix which were deleted lazily (see
+  # #dead_space_threshold=). Does nothing for other stypes.
+  #
+  def compact!
+    __yale_compact__ if self.yale?
+    self
+  end
+
   #
   # call-seq:
   #     repeat(count, axis) -> NMatrix
@@ -1121,6 +1202,11 @@ end
 
 require_relative './shortcuts.rb'
 require_relative './math.rb'
+require_relative './factorization.rb'
+require_relative './preconditioner.rb'
+require_relative './triangular.rb'
+require_relative './spgemm.rb'
+require_relative './bsr.rb'
 require_relative './enumerate.rb'
 
 require_relative './version.rb'
@@ -0,0 +1,153 @@
+#--
+# = NMatrix
+#
+# A linear algebra library for scientific computation in Ruby.
+# NMatrix is part of SciRuby.
+#
+# NMatrix was originally inspired by and derived from NArray, by
+# Masahiro Tanaka: http://narray.rubyforge.org
+#
+# == Copyright Information
+#
+# SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+# NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+#
+# Please see LICENSE.txt for additional copyright notices.
+#
+# == Contributing
+#
+# By contributing source code to SciRuby, you agree to be bound by
+# our Contributor Agreement:
+#
+# * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+#
+# == preconditioner.rb
+#
+# Preconditioner objects returned by NMatrix#preconditioner, for the
+# iterative solvers NMatrix#cg, #bicgstab and #gmres.
+#++
+
+class NMatrix
+
+  #
+  # call-seq:
+  #     preconditioner(:jacobi) -> NMatrix::Preconditioner::Jacobi
+  #     preconditioner(:ilu) -> NMatrix::Preconditioner::ILU
+  #     preconditioner(:ic) -> NMatrix::Preconditioner::IC
+  #
+  # Set up a preconditioner M for a square Yale matrix A, that is, an
+  # approximation of A that is much cheaper to solve with:
+  #
+  #     m      = a.preconditioner(:ilu)
+  #     x, inf = a.gmres(b, preconditioner: m)
+  #     z      = m.apply(r)     # M**-1 * r
+  #
+  # :jacobi is the diagonal of A. :ilu is the incomplete LU factorization
+  # with no fill-in, ILU(0), whose factors have A's sparsity pattern.
+  # :ic is the incomplete Cholesky factorization IC(0) of a Hermitian
+  # positive definite A, which only reads A's lower triangle; use it with
+  # #cg, which needs a Hermitian positive definite M.
+  #
+  # A zero pivot raises ZeroDivisionError, and a non-positive one in IC(0)
+  # raises ArgumentError. The solvers also accept the type in place of the
+  # object, but setting it up once pays off over several solves.
+  #
+  def preconditioner(type = :ilu)
+    case type
+    when :jacobi
+      Preconditioner::Jacobi.new(self)
+    when :ilu
+      Preconditioner::ILU.new(self)
+    when :ic
+      Preconditioner::IC.new(self)
+    else
+      raise(ArgumentError, "unknown preconditioner #{type.inspect}; expected :jacobi, :ilu or :ic")
+    end
+  end
+
+  # Base class for the objects returned by NMatrix#preconditioner.
+  class Preconditioner
+    # The diagonal (Jacobi) as a dense n-by-1 NMatrix, or the incomplete
+    # factors (ILU, IC) in a Yale matrix with the original's pattern.
+    attr_reader :factor
+
+    attr_reader :shape, :dtype
+
+    def initialize(matrix) #:nodoc:
+      raise(StorageTypeError, "only works with yale matrices") unless matrix.stype == :yale
+      raise(ShapeError, "Must be called on square matrix") unless matrix.dim == 2 && matrix.shape[0] == matrix.shape[1]
+      raise(DataTypeError, "only works for non-integer, non-object dtypes") if
+        matrix.integer_dtype? || matrix.object_dtype?
+      raise(NotImplementedError, "matrix default value must be zero") unless matrix.default_value == 0
+
+      @shape = matrix.shape
+      @dtype = matrix.dtype
+    end
+
+    #
+    # call-seq:
+    #     apply(x) -> NMatrix
+    #
+    # M**-1 * x, as a dense n-by-1 NMatrix of the preconditioner's dtype.
+    # +x+ may be any vector with n entries, and is not modified.
+    #
+    def apply(x)
+      raise(ShapeError, "x must have #{shape[0]} entries") unless x.size == shape[0]
+      apply!(NMatrix.new([shape[0],1], x.to_a.flatten, dtype: dtype))
+    end
+
+    #
+    # call-seq:
+    #     apply!(x) -> x
+    #
+    # Overwrite +x+, a dense NMatrix of the preconditioner's dtype with n
+    # entries (and not a slice reference), with M**-1 * x.
+    #
+    def apply!(x)
+      raise(DataTypeError, "x must have the preconditioner's dtype (#{dtype})") unless x.dtype == dtype
+      NMatrix::Internal::Sparse.precondition(kind, @factor, x)
+    end
+
+    # The symbol the native code knows this preconditioner by.
+    def kind #:nodoc:
+      self.class::KIND
+    end
+
+    # Diagonal (Jacobi) preconditioning.
+    class Jacobi < Preconditioner
+      KIND = :jacobi #:nodoc:
+
+      def initialize(matrix) #:nodoc:
+        super(matrix)
+
+        @factor = NMatrix.new([shape[0],1], 0, dtype: dtype)
+        NMatrix::Internal::Sparse.factor_preconditioner(kind, matrix.is_ref? ? matrix.clone : matrix, @factor)
+      end
+    end
+
+    # Incomplete LU factorization with no fill-in.
+    class ILU < Preconditioner
+      KIND = :ilu #:nodoc:
+
+      def initialize(matrix) #:nodoc:
+        super(matrix)
+
+        @factor = matrix.clone
+        NMatrix::Internal::Sparse.factor_preconditioner(kind, @factor, @factor)
+      end
+    end
+
+    # Incomplete Cholesky factorization with no fill-in, for Hermitian
+    # positive definite matrices.
+    class IC < Preconditioner
+      KIND = :ic #:nodoc:
+
+      def initialize(matrix) #:nodoc:
+        super(matrix)
+
+        @factor = matrix.clone
+        NMatrix::Internal::Sparse.factor_preconditioner(kind, @factor, @factor)
+      end
+    end
+  end
+end
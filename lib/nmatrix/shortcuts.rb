@@ -345,6 +345,49 @@ class NMatrix
     end
     alias :block_diag :block_diagonal
 
+    #
+    # call-seq:
+    #     from_coo(rows, cols, values, shape) -> NMatrix
+    #     from_coo(rows, cols, values, shape, dtype: dtype, sum_duplicates: false) -> NMatrix
+    #
+    # Creates a +:yale+ matrix from coordinate (COO) triplets: entry +k+ has value +values[k]+ at
+    # +[rows[k], cols[k]]+. The triplets may be given in any order. They are sorted and written out
+    # in a single pass, which is much faster than assembling the matrix with repeated calls to #[]=.
+    #
+    # * *Arguments* :
+    #   - +rows+, +cols+ -> Arrays of Integers, dense NMatrix objects, or Strings of 64-bit indices packed with 'q*'.
+    #   - +values+ -> Array, dense NMatrix, or String of packed native values (requires +:dtype+).
+    #   - +shape+ -> Array (or integer for square matrix) specifying the dimensions.
+    #   - +dtype+ -> (optional) Guessed from +values+ if not given.
+    #   - +sum_duplicates+ -> (optional) Add up values given for the same coordinates (the default);
+    #     if false, the last one given is kept.
+    # * *Returns* :
+    #   - A +:yale+ NMatrix. Entries which end up as zero are not stored.
+    #
+    # Examples:
+    #
+    #   NMatrix.from_coo([0, 1, 1], [1, 0, 0], [2, 3, 4], 2, dtype: :int32) # => 0  2
+    #                                                                            7  0
+    #
+    def from_coo(rows, cols, values, shape, opts={})
+      shape = [shape, shape] unless shape.is_a?(Array)
+      raise(ArgumentError, "from_coo only creates 2D matrices") unless shape.size == 2
+
+      dtype = opts[:dtype]
+      dtype ||= values.dtype if values.is_a?(NMatrix)
+      dtype ||= values.empty? ? :float64 : guess_dtype(values[0]) if values.is_a?(Array)
+      raise(ArgumentError, "packed values require a dtype") if dtype.nil?
+      raise(ArgumentError, "packed values cannot have dtype :object") if dtype == :object && values.is_a?(String)
+
+      native = lambda do |v, d|
+        next v unless v.is_a?(NMatrix)
+        v.dense? && v.dtype == d && !v.is_ref? ? v : v.cast(:dense, d)
+      end
+
+      NMatrix.__yale_from_coo__(native.call(rows, :int64), native.call(cols, :int64), native.call(values, dtype),
+                                shape, dtype, opts.fetch(:sum_duplicates, true))
+    end
+
     #
     # call-seq:
     #     random(shape) -> NMatrix
@@ -0,0 +1,135 @@
+#--
+# = NMatrix
+#
+# A linear algebra library for scientific computation in Ruby.
+# NMatrix is part of SciRuby.
+#
+# NMatrix was originally inspired by and derived from NArray, by
+# Masahiro Tanaka: http://narray.rubyforge.org
+#
+# == Copyright Information
+#
+# SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+# NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+#
+# Please see LICENSE.txt for additional copyright notices.
+#
+# == Contributing
+#
+# By contributing source code to SciRuby, you agree to be bound by
+# our Contributor Agreement:
+#
+# * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+#
+# == spgemm.rb
+#
+# Products of Yale matrices whose sparsity patterns stay the same from
+# one product to the next, so that the pattern of the result only has
+# to be worked out once.
+#++
+
+class NMatrix
+
+  class << self
+    #
+    # call-seq:
+    #     spgemm_plan(a, b) -> NMatrix::SpGEMMPlan
+    #
+    # Plan the products of Yale matrices with the sparsity patterns of +a+
+    # and +b+. See SpGEMMPlan.
+    #
+    def spgemm_plan(a, b)
+      SpGEMMPlan.new(a, b)
+    end
+  end
+
+  #
+  # The sparsity pattern of the product of two Yale matrices, for when
+  # the same product is formed again and again with new values, as in
+  # time stepping: #multiply and #multiply! then only do the arithmetic.
+  #
+  #   plan = NMatrix.spgemm_plan(a, b)
+  #   c    = plan.multiply(a, b)
+  #   # ... change the values of a and b, but not their patterns ...
+  #   plan.multiply!(a, b, into: c)
+  #
+  # The result keeps every entry the patterns of +a+ and +b+ can produce,
+  # including those whose value comes out zero, so it may have more stored
+  # entries than <tt>a.dot(b)</tt>. The zeros on the diagonals of +a+ and
+  # +b+ when the plan is made are not part of their patterns.
+  #
+  # Later +a+ and +b+ may have fewer entries than the plan was made for,
+  # but an entry outside the planned patterns raises ArgumentError.
+  #
+  class SpGEMMPlan
+    # The shape of the product.
+    attr_reader :shape
+
+    # The ija array of the product (an :int64 NMatrix).
+    attr_reader :ija
+
+    def initialize(a, b) #:nodoc:
+      raise(StorageTypeError, "only works with yale matrices") unless a.stype == :yale && b.stype == :yale
+      zero_defaults(a, b)
+      a = a.clone if a.is_ref?
+      b = b.clone if b.is_ref?
+
+      @shape = [a.shape[0], b.shape[1]]
+      @ija   = NMatrix.new([NMatrix::Internal::Sparse.spgemm_symbolic(a, b, nil)], 0, dtype: :int64)
+      NMatrix::Internal::Sparse.spgemm_symbolic(a, b, @ija)
+    end
+
+    #
+    # call-seq:
+    #     size -> Integer
+    #
+    # The number of stored entries in a product: the diagonal, plus the
+    # planned off-diagonal entries.
+    #
+    def size
+      @shape[0] + @ija.size - @ija[0]
+    end
+
+    #
+    # call-seq:
+    #     multiply(a, b) -> NMatrix
+    #
+    # A new Yale matrix with the planned pattern, holding the product
+    # <tt>a.dot(b)</tt>. +a+ and +b+ must have the same dtype.
+    #
+    def multiply(a, b)
+      zero_defaults(a, b)
+      c = NMatrix.new(@shape, stype: :yale, dtype: a.dtype)
+      NMatrix::Internal::Sparse.spgemm_numeric(unref(a), unref(b), @ija, c, true)
+    end
+
+    #
+    # call-seq:
+    #     multiply!(a, b, into: c) -> c
+    #
+    # Overwrite the values of +c+, which must have come from #multiply (on
+    # this plan), with those of <tt>a.dot(b)</tt>. Its pattern, and so its
+    # storage, is reused as it is.
+    #
+    def multiply!(a, b, opts = {})
+      c = opts[:into]
+      raise(ArgumentError, "the result must be given as :into") if c.nil?
+      zero_defaults(a, b, c)
+
+      NMatrix::Internal::Sparse.spgemm_numeric(unref(a), unref(b), @ija, c, false)
+    end
+
+  protected
+
+    # Only the stored entries take part in the product, so the unstored ones must be zero.
+    def zero_defaults(*ms)
+      ms.each do |m|
+        raise(NotImplementedError, "matrix default value must be zero") unless m.stype != :yale || m.default_value == 0
+      end
+    end
+
+    def unref(m)
+      m.is_ref? ? m.clone : m
+    end
+  end
+end
@@ -0,0 +1,146 @@
+#--
+# = NMatrix
+#
+# A linear algebra library for scientific computation in Ruby.
+# NMatrix is part of SciRuby.
+#
+# NMatrix was originally inspired by and derived from NArray, by
+# Masahiro Tanaka: http://narray.rubyforge.org
+#
+# == Copyright Information
+#
+# SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+# NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+#
+# Please see LICENSE.txt for additional copyright notices.
+#
+# == Contributing
+#
+# By contributing source code to SciRuby, you agree to be bound by
+# our Contributor Agreement:
+#
+# * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+#
+# == triangular.rb
+#
+# Solves with the lower or upper triangle of a matrix (forward and back
+# substitution), natively for Yale matrices.
+#++
+
+class NMatrix
+
+  #
+  # call-seq:
+  #     solve_triangular(b) -> NMatrix
+  #     solve_triangular(b, uplo: :upper, diag: :unit) -> NMatrix
+  #
+  # Solve T*X = B, where T is the lower (+uplo: :lower+, the default) or
+  # upper (+:upper+) triangle of the square matrix +self+, and B is a vector
+  # or a matrix whose columns are the right-hand sides. The entries of the
+  # other triangle are ignored, so the two factors of an LU factorization
+  # kept in one matrix can each be used directly. With +diag: :unit+, T's
+  # diagonal is taken to be all ones and not read.
+  #
+  # +b+ is not modified, and may be of any stype or dtype; X is dense, with
+  # +self+'s dtype. A zero on the diagonal raises ZeroDivisionError.
+  #
+  # Yale matrices are solved natively, a row at a time for all of the
+  # right-hand sides, in the order given by a TriangularSchedule. Pass one
+  # from #triangular_schedule as +:schedule+ to skip recomputing it when
+  # solving repeatedly with the same matrix; ArgumentError is raised if it
+  # doesn't fit +self+'s sparsity pattern. Dense matrices use BLAS trsm.
+  #
+  def solve_triangular(b, opts = {})
+    uplo = opts[:uplo] || :lower
+    diag = opts[:diag] || :nonunit
+
+    raise(ShapeError, "Must be called on square matrix") unless self.dim == 2 && self.shape[0] == self.shape[1]
+    raise(ShapeError, "number of rows of b must equal number of rows of self") unless b.shape[0] == self.shape[0]
+    raise(ArgumentError, "uplo must be :upper or :lower") unless [:upper, :lower].include?(uplo)
+    raise(ArgumentError, "diag must be :unit or :nonunit") unless [:unit, :nonunit].include?(diag)
+    raise(DataTypeError, "only works for non-integer, non-object dtypes") if integer_dtype? || object_dtype?
+
+    x = b.cast(:dense, self.dtype)
+    x = x.clone if x.equal?(b) || x.is_ref?
+    n = self.shape[0]
+    m = x.dim > 1 ? x.shape[1] : 1
+
+    case self.stype
+    when :yale
+      raise(NotImplementedError, "matrix default value must be zero") unless self.default_value == 0
+      s = opts[:schedule] || triangular_schedule(uplo)
+      raise(ArgumentError, "schedule is for the #{s.uplo} triangle") unless s.uplo == uplo
+      raise(ShapeError, "schedule is for a #{s.shape[0]}-by-#{s.shape[1]} matrix") unless s.shape == self.shape
+
+      NMatrix::Internal::Sparse.triangular_solve(self.is_ref? ? self.clone : self, uplo, diag, s.levels, s.level_ptr,
+                                                 s.order, x)
+    when :dense
+      if diag == :nonunit
+        n.times { |i| raise(ZeroDivisionError, "zero on the diagonal in row #{i}") if self[i,i] == 0 }
+      end
+      NMatrix::BLAS.cblas_trsm(:row, :left, uplo, false, diag, n, m, 1, self.is_ref? ? self.clone : self, n, x, m)
+    else
+      raise(StorageTypeError, "only works with dense or yale matrices")
+    end
+
+    x
+  end
+
+  #
+  # call-seq:
+  #     triangular_schedule(uplo = :lower) -> NMatrix::TriangularSchedule
+  #
+  # The order in which #solve_triangular takes the rows of a square Yale
+  # matrix's lower or upper triangle. It only depends on the sparsity
+  # pattern, so it can be reused for as long as that stays the same.
+  #
+  def triangular_schedule(uplo = :lower)
+    TriangularSchedule.new(self, uplo)
+  end
+
+  #
+  # Dependency levels of a sparse triangular solve. Row i of the triangle
+  # is in level 0 if none of its off-diagonal entries refer to other rows,
+  # and otherwise in one level past the highest of the rows they refer to.
+  # The rows of one level are independent of each other.
+  #
+  class TriangularSchedule
+    # The triangle (+:lower+ or +:upper+) the schedule is for.
+    attr_reader :uplo
+
+    # The number of levels.
+    attr_reader :levels
+
+    # The rows by level (an :int64 NMatrix), and where each level starts
+    # in it (+levels+ + 1 entries used).
+    attr_reader :order, :level_ptr
+
+    attr_reader :shape
+
+    def initialize(matrix, uplo = :lower) #:nodoc:
+      raise(StorageTypeError, "only works with yale matrices") unless matrix.stype == :yale
+      raise(ShapeError, "Must be called on square matrix") unless matrix.dim == 2 && matrix.shape[0] == matrix.shape[1]
+      raise(ArgumentError, "uplo must be :upper or :lower") unless [:upper, :lower].include?(uplo)
+      raise(NotImplementedError, "matrix default value must be zero") unless matrix.default_value == 0
+
+      n          = matrix.shape[0]
+      @uplo      = uplo
+      @shape     = matrix.shape
+      @level_ptr = NMatrix.new([n+1], 0, dtype: :int64)
+      @order     = NMatrix.new([n], 0, dtype: :int64)
+      @levels    = NMatrix::Internal::Sparse.triangular_levels(matrix.is_ref? ? matrix.clone : matrix, uplo,
+                                                               @level_ptr, @order)
+    end
+
+    #
+    # call-seq:
+    #     level(l) -> Array
+    #
+    # The rows in level +l+, in ascending order.
+    #
+    def level(l)
+      raise(RangeError, "level #{l} out of range (0...#{levels})") unless l >= 0 && l < levels
+      (@level_ptr[l]...@level_ptr[l+1]).map { |k| @order[k] }
+    end
+  end
+end
@@ -61,6 +61,50 @@ describe NMatrix do
     expect(m).to eq(n)
   end
 
+  it "allows dtype casting of dense slices" do
+    m = NMatrix.new([3,4,2], (0...24).to_a, dtype: :int32)
+    expect(m[1..2,0..3,0..1].cast(dtype: :float64).to_a).to eq(m.to_a[1..2].map { |a| a.map { |r| r.map(&:to_f) } })
+    expect(m[0..2,1..2,1].cast(dtype: :int32).to_a).to eq(m.to_a.map { |a| a[1..2].map { |r| [r[1]] } })
+  end
+
+  it "casts contiguous and strided dense slices between dtypes" do
+    m = NMatrix.new([3,4,2], (0...24).to_a, dtype: :int32)
+    [:int16, :float32, :float64, :complex128, :object].each do |dtype|
+      whole   = m[0..2,0..3,0..1].cast(dtype: dtype) # one contiguous block
+      rows    = m[1..2,0..3,0..1].cast(dtype: dtype) # contiguous, starting part-way in
+      strided = m[0..2,1..2,1].cast(dtype: dtype)
+
+      expect(whole.dtype).to eq(dtype)
+      expect(whole.to_a).to eq(m.to_a)
+      expect(rows.to_a).to eq(m.to_a[1..2])
+      expect(strided.to_a).to eq(m.to_a.map { |a| a[1..2].map { |r| [r[1]] } })
+    end
+
+    c = NMatrix.new([2,3], [1+2i, 3, -1i, 4.5, 0, 2-1i], dtype: :complex128)
+    expect(c[0..1,1..2].cast(dtype: :complex64).to_a).to eq([[3, -1i], [0, 2-1i]])
+    expect(c.cast(dtype: :complex64).to_a).to eq(c.to_a)
+  end
+
+  it "copies dense matrices and slices of the same dtype, including complex and Ruby object dtypes" do
+    [[:int64, (1..12).to_a], [:float64, (1..12).map { |x| x / 4.0 }],
+     [:complex128, (1..12).map { |x| Complex(x, -x) }], [:object, (1..12).map(&:to_s)]].each do |dtype, values|
+      m = NMatrix.new([3,4], values, dtype: dtype)
+
+      copy = m.cast(dtype: dtype)
+      expect(copy).to eq(m)
+      expect(m[1..2,0..3].cast(dtype: dtype).to_a).to eq(m.to_a[1..2])
+      expect(m[0..2,1..2].cast(dtype: dtype).to_a).to eq(m.to_a.map { |r| r[1..2] })
+
+      copy[0,0] = values[1]
+      expect(m[0,0]).to eq(values[0])
+    end
+
+    strings = NMatrix.new([2,2], ["a", "b", "c", "d"], dtype: :object)
+    copies  = Array.new(3) { strings[0..1,0..1].cast(dtype: :object) }
+    GC.start
+    copies.each { |c| expect(c.to_a).to eq([["a", "b"], ["c", "d"]]) }
+  end
+
   it "allows stype casting of a dim 2 matrix between dense, sparse, and list (different dtypes)" do
     m = NMatrix.new(:dense, [3,3], [0,0,1,0,2,0,3,4,5], :int64).
       cast(:yale, :int32).
@@ -76,6 +120,32 @@ describe NMatrix do
     # work at all in IRB, but work fine when run in a regular Ruby session.
   end
 
+  it "allows stype casting of slices" do
+    d = NMatrix.new([5,6], [0,1,0,2,0,3, 4,0,5,0,6,0, 0,7,8,0,0,9, 1,0,0,2,3,0, 0,0,4,0,5,6], dtype: :int64)
+    expected = d[1..3,1..4].to_a
+
+    [:dense, :list, :yale].each do |from|
+      s = d.cast(from)[1..3,1..4]
+      [:dense, :list, :yale].each do |to|
+        expect(s.cast(to).to_a).to eq(expected)
+      end
+    end
+  end
+
+  it "casts the default value when converting list to yale with a different dtype" do
+    l = NMatrix.new(:list, [3,3], 0, :int32)
+    l[0,1] = 5
+    y = l.cast(:yale, :float64)
+    expect(y.default_value).to eq(0.0)
+    expect(y.to_a).to eq([[0.0, 5.0, 0.0], [0.0, 0.0, 0.0], [0.0, 0.0, 0.0]])
+  end
+
+  it "allows stype casting of a dim 3 matrix between dense and list" do
+    d = NMatrix.new([2,3,2], [1,0,0,2,3,0, 0,0,4,5,0,6], dtype: :int64)
+    expect(d.cast(:list).cast(:dense)).to eq(d)
+    expect(d[0..1,1..2,1].cast(:list).to_a).to eq(d[0..1,1..2,1].to_a)
+  end
+
   it "fills dense Ruby object matrix with nil" do
     n = NMatrix.new([4,3], dtype: :object)
     expect(n[0,0]).to eq(nil)
@@ -307,6 +377,26 @@ describe NMatrix do
     expect(n[2,2]).to eq(777)
   end
 
+  it "supports random assembly and removal in wide list matrices" do
+    m = NMatrix.new([2,2000], stype: :list, dtype: :int64, default: 0)
+    expected = {}
+    keys = (0...2000).to_a.shuffle(random: Random.new(11))
+
+    keys.each_with_index do |j, k|
+      m[k % 2, j] = j + 1
+      expected[[k % 2, j]] = j + 1
+    end
+    keys.first(500).each_with_index do |j, k|
+      m[k % 2, j] = 0
+      expected.delete([k % 2, j])
+    end
+
+    expected.each { |(i,j),v| expect(m[i,j]).to eq(v) }
+    stored = 0
+    m.each_stored_with_indices { |v,i,j| stored += 1 }
+    expect(stored).to eq(expected.size)
+  end
+
   it "should return an enumerator when each is called without a block" do
     a = NMatrix.new(2, 1)
     b = NMatrix.new(2, [-1,0,1,0])
@@ -174,7 +174,6 @@ describe NMatrix::BLAS do
 
       it "exposes nrm2" do
         pending("broken for :object") if dtype == :object
-        pending("Temporarily disable because the internal implementation of nrm2 is broken -WL 2015-05-17") if dtype == :complex64 || dtype == :complex128
 
         x = NMatrix.new([4,1], [2,-4,3,5], dtype: dtype)
         err = case dtype
@@ -63,6 +63,13 @@ describe NMatrix do
       expect { r.dot(y) }.to raise_error
     end
 
+    it "should multiply a yale matrix by a dense one, giving a dense matrix" do
+      d = NMatrix.new([3,2], [1, 2, 3, 4, 5, 6], dtype: :int64)
+      r = @n.dot(d)
+      expect(r.stype).to eq(:dense)
+      expect(r).to eq(NMatrix.new([3,2], [167, 254, 120, 160, 6, 12], dtype: :int64))
+    end
+
     it "should perform element-wise addition" do
       expect(@n+@m).to eq(NMatrix.new(:dense, 3, [52,30,0,0,-8,0,6,0,0], :int64).cast(:yale, :int64))
     end
@@ -77,6 +84,31 @@ describe NMatrix do
       expect(@n*@m).to eq(r)
     end
 
+    it "should upcast when adding matrices of different dtypes" do
+      f = NMatrix.new(3, stype: :yale, dtype: :float64)
+      f[0,1] = 0.5
+      x = @n + f
+      expect(x.dtype).to eq(:float64)
+      expect(x.to_a).to eq([[52.0, 30.5, 5.0], [0.0, 40.0, 0.0], [6.0, 0.0, 0.0]])
+    end
+
+    it "should only store the entries which differ from the default" do
+      x = @n * @m
+      x.extend NMatrix::YaleFunctions
+      expect(x.yale_ja_at(0)).to eq([2])
+      expect(x.yale_ja_at(2)).to eq([])
+      expect(x.capacity).to eq(x.yale_size)
+    end
+
+    it "should respect non-zero default values" do
+      a = NMatrix.new(3, stype: :yale, dtype: :int64, default: 2)
+      b = NMatrix.new(3, stype: :yale, dtype: :int64, default: 3)
+      a[0,1] = 5
+      b[2,0] = 4
+      expect((a*b).to_a).to eq([[6, 15, 6], [6, 6, 6], [8, 6, 6]])
+      expect((a-b).to_a).to eq([[-1, 2, -1], [-1, -1, -1], [-2, -1, -1]])
+    end
+
     it "should perform element-wise division" do
       r = NMatrix.new(:dense, 3, [52, 30, -2, 0, -1, 0, 6, 0, 0], :int64).cast(:yale, :int64)
       expect(@n/(@m+1)).to eq(r)
@@ -154,6 +186,32 @@ describe NMatrix do
       expect(@n*m).to eq(r)
     end
 
+    it "should upcast in native element-wise operations" do
+      m = NMatrix.new([2,2], stype: :list, dtype: :float64, default: 0)
+      m[0,1] = 0.5
+      q = @n + m
+      expect(q.dtype).to eq(:float64)
+      expect(q.stype).to eq(:list)
+      expect(q.to_a).to eq([[52.0, 0.5], [0.0, 40.0]])
+      expect((@n * 0.5).to_a).to eq([[26.0, 0.0], [0.0, 20.0]])
+    end
+
+    it "should multiply list matrices" do
+      m = NMatrix.new([2,3], stype: :list, dtype: :int64, default: 0)
+      m[0,2] = 2
+      m[1,0] = 3
+      r = @n.dot(m)
+      expect(r.stype).to eq(:list)
+      expect(r.to_a).to eq([[0, 0, 104], [120, 0, 0]])
+    end
+
+    it "should multiply a list matrix by a dense one, giving a dense matrix" do
+      d = NMatrix.new([2,2], [1, 2, 3, 4], dtype: :int64)
+      r = @n.dot(d)
+      expect(r.stype).to eq(:dense)
+      expect(r).to eq(NMatrix.new([2,2], [52, 104, 120, 160], dtype: :int64))
+    end
+
     it "should perform element-wise division" do
       m = NMatrix.new(:list, 2, 1, :int64)
       m[1,1] = 2
@@ -300,4 +358,35 @@ describe NMatrix do
       end
     end
   end
+
+  context "mixed stypes" do
+    before :each do
+      @d = NMatrix.new([2,3], [1, 2, 3, 4, 5, 6], dtype: :float64)
+      @y = NMatrix.new([2,3], stype: :yale, dtype: :int64)
+      @y[0,2] = 10
+      @y[1,1] = -1
+      @l = @y.cast(:list, :int64)
+    end
+
+    it "adds sparse and dense matrices, giving a dense matrix" do
+      [@y, @l].each do |s|
+        expect(s + @d).to eq(NMatrix.new([2,3], [1.0, 2.0, 13.0, 4.0, 4.0, 6.0], dtype: :float64))
+        expect((@d - s).stype).to eq(:dense)
+        expect(@d - s).to eq(NMatrix.new([2,3], [1.0, 2.0, -7.0, 4.0, 6.0, 6.0], dtype: :float64))
+      end
+    end
+
+    it "multiplies sparse and dense matrices, keeping the sparse stype" do
+      [@y, @l].each do |s|
+        r = s * @d
+        expect(r.stype).to eq(s.stype)
+        expect(r.dtype).to eq(:float64)
+        expect(r.to_a).to eq([[0.0, 0.0, 30.0], [0.0, -5.0, 0.0]])
+      end
+    end
+
+    it "handles other operations by casting to dense" do
+      expect(@d / (@y + 1)).to eq(NMatrix.new([2,3], [1.0, 2.0, 3.0/11, 4.0, 5.0/0, 6.0], dtype: :float64))
+    end
+  end
 end
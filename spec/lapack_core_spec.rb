@@ -166,6 +166,40 @@ describe "NMatrix::LAPACK functions with internal implementations" do
         expect(ipiv).to eq(ipiv_true)
       end
 
+      it "calculates LU decomposition using #getrf! (larger than one block)" do
+        n = 150
+        a = NMatrix.new([n,n], (0...n*n).map { |x| ((x * 7919) % 1009) / 1009.0 - 0.5 }, dtype: dtype)
+        lu = a.clone
+        ipiv = lu.getrf!
+
+        l = NMatrix.eye(n, dtype: dtype)
+        u = NMatrix.zeros(n, dtype: dtype)
+        n.times { |i| n.times { |j| j < i ? l[i,j] = lu[i,j] : u[i,j] = lu[i,j] } }
+
+        perm = NMatrix::FactorizeLUMethods.permutation_array_for(ipiv)
+        pa   = NMatrix.new([n,n], perm.map { |i| a.row(i).to_a }.flatten, dtype: dtype)
+
+        err = [:float32, :complex64].include?(dtype) ? 1e-3 : 1e-10
+        expect(l.dot(u)).to be_within(err).of(pa)
+      end
+
+      it "exposes clapack_getri" do
+        a    = NMatrix.new(3, [1,2,3, 0,1,4, 5,6,0], dtype: dtype)
+        ipiv = NMatrix::LAPACK::clapack_getrf(:row, 3, 3, a, 3)
+        NMatrix::LAPACK::clapack_getri(:row, 3, a, 3, ipiv)
+
+        b   = NMatrix.new(3, [-24,18,5, 20,-15,-4, -5,4,1], dtype: dtype)
+        err = [:float32, :complex64].include?(dtype) ? 1e-4 : 1e-12
+        expect(a).to be_within(err).of(b)
+      end
+
+      it "inverts a matrix larger than one block" do
+        n   = 150
+        a   = NMatrix.new([n,n], (0...n*n).map { |x| ((x * 7919) % 1009) / 1009.0 - 0.5 }, dtype: dtype) + NMatrix.eye(n, dtype: dtype) * 10
+        err = [:float32, :complex64].include?(dtype) ? 1e-4 : 1e-10
+        expect(a.dot(a.invert)).to be_within(err).of(NMatrix.eye(n, dtype: dtype))
+      end
+
       # Together, these calls are basically xGESV from LAPACK: http://www.netlib.org/lapack/double/dgesv.f
       it "exposes clapack_getrs" do
         a     = NMatrix.new(3, [-2,4,-3, 3,-2,1, 0,-4,3], dtype: dtype)
@@ -248,6 +282,54 @@ describe "NMatrix::LAPACK functions with internal implementations" do
         expect(x).to be_within(err).of(x_true)
       end
 
+      it "inverts a (symmetric positive-definite) matrix using clapack_potrf and clapack_potri" do
+        a = NMatrix.new(3, [4,0,-1, 0,2,1, -1,1,1], dtype: dtype)
+        NMatrix::LAPACK::clapack_potrf(:row, :lower, 3, a, 3)
+        NMatrix::LAPACK::clapack_potri(:row, :lower, 3, a, 3)
+
+        b = NMatrix.new(3, [0.5,0,0, -0.5,1.5,0, 1,-2,4], dtype: dtype)
+        err = [:float32, :complex64].include?(dtype) ? 1e-5 : 1e-14
+        expect(a.tril).to be_within(err).of(b)
+      end
+
+      it "solves a (symmetric positive-definite) matrix equation larger than one block using posv" do
+        n = 150
+        m = NMatrix.new([n,n], (0...n*n).map { |x| ((x * 7919) % 1009) / 1009.0 - 0.5 }, dtype: dtype)
+        a = m.dot(m.transpose) + NMatrix.eye(n, dtype: dtype) * n
+        b = NMatrix.new([n,2], (0...2*n).map { |x| x % 7 }, dtype: dtype)
+
+        [:upper, :lower].each do |uplo|
+          x   = NMatrix::LAPACK::posv(uplo, a, b)
+          err = [:float32, :complex64].include?(dtype) ? 1e-2 : 1e-10
+          expect(a.dot(x)).to be_within(err).of(b)
+        end
+      end
+
+      it "computes a QR factorization larger than one block using clapack_geqrf and clapack_ormqr" do
+        m, n = 100, 70
+        a   = NMatrix.new([m,n], (0...m*n).map { |x| ((x * 7919) % 1009) / 1009.0 - 0.5 }, dtype: dtype)
+        qr  = a.clone
+        tau = NMatrix.new([n], 0, dtype: dtype)
+        NMatrix::LAPACK::clapack_geqrf(:row, m, n, qr, n, tau)
+
+        # Q**H * A must give back R, which is the upper triangle of the factorization.
+        r = qr.clone
+        (1...m).each { |i| (0...[i,n].min).each { |j| r[i,j] = 0 } }
+        NMatrix::LAPACK::clapack_ormqr(:row, :left, :complex_conjugate, m, n, n, qr, n, tau, a, n)
+
+        err = [:float32, :complex64].include?(dtype) ? 1e-3 : 1e-10
+        expect(a).to be_within(err).of(r)
+      end
+
+      it "solves a least-squares problem using clapack_gels" do
+        a = NMatrix.new([4,2], [1,0, 1,1, 1,2, 1,3], dtype: dtype)
+        b = NMatrix.new([4,1], [1,2,2,4], dtype: dtype)
+        NMatrix::LAPACK::clapack_gels(:row, false, 4, 2, 1, a, 2, b, 1)
+
+        err = [:float32, :complex64].include?(dtype) ? 1e-5 : 1e-14
+        expect(b[0...2,0]).to be_within(err).of(NMatrix.new([2,1], [0.9, 0.9], dtype: dtype))
+      end
+
       it "calculates the singular value decomposition with NMatrix#gesvd" do
         #example from Wikipedia
         m = 4
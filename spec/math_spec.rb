@@ -580,6 +580,471 @@ describe "math" do
 
         expect(a.solve(b)).to eq(NMatrix.new [3,2], [1,0, 0,0, 2,2], dtype: dtype)
       end
+
+      it "solves linear equation for dtype #{dtype} (yale matrix)" do
+        a = NMatrix.new([3,3], [4,1,0, 1,4,1, 0,1,4], dtype: dtype).cast(:yale, dtype)
+        b = NMatrix.new [3,2], [6,5, 12,7, 14,9], dtype: dtype
+
+        err = [:float32, :complex64].include?(dtype) ? 1e-3 : 1e-7
+        expect(a.solve(b)).to be_within(err).of(NMatrix.new([3,2], [1,1, 2,1, 3,2], dtype: dtype))
+        expect(a.solve(b, method: :cholesky)).to be_within(err).of(NMatrix.new([3,2], [1,1, 2,1, 3,2], dtype: dtype))
+      end
+    end
+  end
+
+  context "Krylov solvers" do
+    NON_INTEGER_DTYPES.each do |dtype|
+      next if dtype == :object
+      context dtype do
+        err = [:float32, :complex64].include?(dtype) ? 1e-3 : 1e-10
+        tol = [:float32, :complex64].include?(dtype) ? 1e-5 : 1e-12
+
+        before do
+          # Symmetric positive definite, and a non-symmetric matrix with the same sparsity.
+          @n   = 30
+          @spd = NMatrix.new([@n,@n], 0, dtype: dtype)
+          @gen = NMatrix.new([@n,@n], 0, dtype: dtype)
+          @n.times do |i|
+            @spd[i,i] = 3
+            @gen[i,i] = 3
+            next if i+1 == @n
+            @spd[i,i+1] = @spd[i+1,i] = -1
+            @gen[i,i+1] = -1.5
+            @gen[i+1,i] = -0.5
+          end
+          @spd = @spd.cast(:yale, dtype)
+          @gen = @gen.cast(:yale, dtype)
+          @b   = NMatrix.new([@n,1], (1..@n).to_a, dtype: dtype)
+        end
+
+        it "solves a positive definite system by conjugate gradients" do
+          x, info = @spd.cg(@b, tol: tol)
+          expect(info[:converged]).to eq(true)
+          expect(info[:residuals].size).to eq(info[:iterations] + 1)
+          expect(@spd.dot(x)).to be_within(err * @n).of(@b)
+        end
+
+        [:bicgstab, :gmres].each do |method|
+          it "solves a non-symmetric system by #{method}" do
+            x, info = @gen.send(method, @b, tol: tol, restart: 10)
+            expect(info[:converged]).to eq(true)
+            expect(info[:residuals].last).to be_within(tol).of(0)
+            expect(@gen.dot(x)).to be_within(err * @n).of(@b)
+          end
+        end
+
+        it "stops after maxiter iterations" do
+          x, info = @gen.gmres(@b, maxiter: 3)
+          expect(info[:converged]).to eq(false)
+          expect(info[:iterations]).to eq(3)
+        end
+
+        it "starts from the initial guess" do
+          x, info = @spd.cg(@b, tol: tol)
+          expect(@spd.cg(@b, tol: tol, x0: x)[1][:iterations]).to eq(0)
+        end
+
+        [[:cg, :ic], [:bicgstab, :ilu], [:gmres, :ilu], [:cg, :jacobi]].each do |method, type|
+          it "solves by #{method} with a #{type} preconditioner" do
+            a = method == :cg ? @spd : @gen
+            x, info = a.send(method, @b, tol: tol, preconditioner: a.preconditioner(type))
+            expect(info[:converged]).to eq(true)
+            expect(a.dot(x)).to be_within(err * @n).of(@b)
+          end
+        end
+      end
+    end
+  end
+
+  context "#preconditioner" do
+    NON_INTEGER_DTYPES.each do |dtype|
+      next if dtype == :object
+      context dtype do
+        err = [:float32, :complex64].include?(dtype) ? 1e-4 : 1e-12
+
+        before do
+          # Tridiagonal, so that ILU(0) and IC(0) have no fill-in to drop and are exact.
+          @a = NMatrix.new([4,4], [4,1,0,0, 2,5,1,0, 0,1,6,2, 0,0,3,7], dtype: dtype).cast(:yale, dtype)
+          @s = NMatrix.new([3,3], [4,2,0, 2,5,1, 0,1,3], dtype: dtype).cast(:yale, dtype)
+        end
+
+        it "applies ILU(0)" do
+          expect(@a.dot(@a.preconditioner(:ilu).apply([1,2,3,4]))).to be_within(err).of(NMatrix.new([4,1], [1,2,3,4], dtype: dtype))
+        end
+
+        it "applies IC(0)" do
+          expect(@s.dot(@s.preconditioner(:ic).apply([1,2,3]))).to be_within(err).of(NMatrix.new([3,1], [1,2,3], dtype: dtype))
+        end
+
+        it "applies Jacobi" do
+          expect(@s.preconditioner(:jacobi).apply([4,10,3])).to be_within(err).of(NMatrix.new([3,1], [1,2,1], dtype: dtype))
+        end
+
+        it "raises on a zero pivot" do
+          a = NMatrix.new([2,2], [0,1, 1,0], dtype: dtype).cast(:yale, dtype)
+          expect { a.preconditioner(:ilu) }.to raise_error(ZeroDivisionError)
+          expect { a.preconditioner(:jacobi) }.to raise_error(ZeroDivisionError)
+        end
+
+        it "raises on a matrix that is not positive definite for IC(0)" do
+          a = NMatrix.new([2,2], [1,2, 2,1], dtype: dtype).cast(:yale, dtype)
+          expect { a.preconditioner(:ic) }.to raise_error(ArgumentError)
+        end
+      end
+    end
+  end
+
+  context "#factorize" do
+    NON_INTEGER_DTYPES.each do |dtype|
+      next if dtype == :object
+      context dtype do
+        err = [:float32, :complex64].include?(dtype) ? 1e-5 : 1e-14
+
+        it "reuses an LU factorization for several right-hand sides" do
+          a  = NMatrix.new [3,3], [1,1,1, -1,0,1, 3,4,6], dtype: dtype
+          lu = a.factorize(:lu)
+
+          expect(lu.solve(NMatrix.new([3,1], [6,2,29], dtype: dtype))).to be_within(err).of(NMatrix.new([3,1], [1,2,3], dtype: dtype))
+          expect(lu.solve(NMatrix.new([3,2], [3,6, 0,2, 13,29], dtype: dtype))).to be_within(err).of(NMatrix.new([3,2], [1,1, 1,2, 1,3], dtype: dtype))
+        end
+
+        it "solves in place with a Cholesky factorization" do
+          a = NMatrix.new [3,3], [4,0,-1, 0,2,1, -1,1,1], dtype: dtype
+          b = NMatrix.new [3,2], [4,-1, 2,-1, 0,0], dtype: dtype
+
+          [:lower, :upper].each do |uplo|
+            x = b.clone
+            a.factorize(:cholesky, uplo: uplo).solve!(x)
+            expect(x).to be_within(err).of(NMatrix.new([3,2], [1,0, 1,-1, 0,1], dtype: dtype))
+          end
+        end
+
+        it "solves a least-squares problem with a QR factorization" do
+          a = NMatrix.new [4,2], [1,0, 1,1, 1,2, 1,3], dtype: dtype
+          b = NMatrix.new [4,2], [1,0, 2,1, 2,2, 4,3], dtype: dtype
+
+          expect(a.factorize(:qr).solve(b)).to be_within(err).of(NMatrix.new([2,2], [0.9,0, 0.9,1], dtype: dtype))
+          expect(a.lstsq(b)).to be_within(err).of(NMatrix.new([2,2], [0.9,0, 0.9,1], dtype: dtype))
+        end
+
+        it "computes a reduced QR factorization with #factorize_qr" do
+          a    = NMatrix.new [3,2], [3,1, 4,2, 0,2], dtype: dtype
+          q, r = a.factorize_qr
+
+          expect(q.shape).to eq([3,2])
+          expect(r[1,0]).to eq(0)
+          expect(q.dot(r)).to be_within(err*10).of(a)
+          expect(q.conjugate_transpose.dot(q)).to be_within(err*10).of(NMatrix.eye(2, dtype: dtype))
+        end
+
+        it "raises on a singular LU factorization" do
+          lu = NMatrix.new([2,2], [1,2, 2,4], dtype: dtype).factorize(:lu)
+          expect { lu.solve(NMatrix.new([2,1], [1,1], dtype: dtype)) }.to raise_error(ZeroDivisionError)
+        end
+      end
+    end
+  end
+
+  context "#solve_triangular" do
+    NON_INTEGER_DTYPES.each do |dtype|
+      next if dtype == :object
+      context dtype do
+        err = [:float32, :complex64].include?(dtype) ? 1e-4 : 1e-12
+
+        before do
+          @d = NMatrix.new([5,5], [4,1,0,2,0, 1,5,0,0,1, 0,2,6,1,0, 3,0,1,7,2, 0,1,0,2,8], dtype: dtype)
+          @b = NMatrix.new([5,2], (1..10).to_a, dtype: dtype)
+        end
+
+        [:dense, :yale].each do |stype|
+          [:lower, :upper].each do |uplo|
+            [:nonunit, :unit].each do |diag|
+              it "solves with the #{uplo} triangle of a #{stype} matrix and a #{diag} diagonal" do
+                t = uplo == :lower ? @d.tril : @d.triu
+                5.times { |i| t[i,i] = 1 } if diag == :unit
+
+                x = @d.cast(stype, dtype).solve_triangular(@b, uplo: uplo, diag: diag)
+                expect(t.dot(x)).to be_within(err).of(@b)
+              end
+            end
+          end
+        end
+
+        it "reuses a schedule" do
+          y = @d.cast(:yale, dtype)
+          s = y.triangular_schedule(:upper)
+
+          expect(s.levels).to eq(3)
+          expect(y.solve_triangular(@b, uplo: :upper, schedule: s)).to be_within(err).of(y.solve_triangular(@b, uplo: :upper))
+          expect { y.solve_triangular(@b, schedule: s) }.to raise_error(ArgumentError)
+        end
+
+        it "raises on a schedule for another sparsity pattern or a malformed one" do
+          y = NMatrix.new([3,3], [2,1,0, 0,2,1, 0,0,2], dtype: dtype).cast(:yale, dtype)
+          b = NMatrix.new([3,1], [1,1,1], dtype: dtype)
+          s = NMatrix.new([3,3], [1,0,0, 0,1,0, 0,0,1], dtype: dtype).cast(:yale, dtype).triangular_schedule(:upper)
+          expect { y.solve_triangular(b, uplo: :upper, schedule: s) }.to raise_error(ArgumentError)
+
+          s = y.triangular_schedule(:upper)
+          s.order[0] = 10**9
+          expect { y.solve_triangular(b, uplo: :upper, schedule: s) }.to raise_error(ArgumentError)
+
+          s = y.triangular_schedule(:upper)
+          s.level_ptr[1] = 2
+          expect { y.solve_triangular(b, uplo: :upper, schedule: s) }.to raise_error(ArgumentError)
+        end
+
+        it "puts independent rows in the same level" do
+          y = NMatrix.new([4,4], [1,0,0,0, 1,1,0,0, 0,0,1,0, 0,0,1,1], dtype: dtype).cast(:yale, dtype)
+          s = y.triangular_schedule
+
+          expect(s.levels).to eq(2)
+          expect(s.level(0)).to eq([0, 2])
+          expect(s.level(1)).to eq([1, 3])
+        end
+
+        it "raises on a zero on the diagonal" do
+          y = NMatrix.new([2,2], [0,0, 1,1], dtype: dtype).cast(:yale, dtype)
+          expect { y.solve_triangular(NMatrix.new([2,1], [1,1], dtype: dtype)) }.to raise_error(ZeroDivisionError)
+          expect(y.solve_triangular(NMatrix.new([2,1], [1,2], dtype: dtype), diag: :unit)).to eq(NMatrix.new([2,1], [1,1], dtype: dtype))
+        end
+
+        it "raises on a yale matrix with a nonzero default value" do
+          y = NMatrix.new([2,2], 1, stype: :yale, dtype: dtype)
+          expect { y.solve_triangular(NMatrix.new([2,1], [1,1], dtype: dtype)) }.to raise_error(NotImplementedError)
+          expect { y.triangular_schedule }.to raise_error(NotImplementedError)
+        end
+      end
+    end
+  end
+
+  context "sparse #factorize" do
+    NON_INTEGER_DTYPES.each do |dtype|
+      next if dtype == :object
+      context dtype do
+        err = [:float32, :complex64].include?(dtype) ? 1e-4 : 1e-12
+
+        before do
+          # The 5-point Laplacian on an m-by-m grid, whose factors fill in, and a non-symmetric matrix
+          # that needs pivoting (its first diagonal entry is zero).
+          m  = 6
+          @n = m*m
+          @spd = NMatrix.new([@n,@n], 0, dtype: dtype)
+          (0...m).each do |i|
+            (0...m).each do |j|
+              k = i*m + j
+              @spd[k,k]   = 4
+              @spd[k,k+1] = @spd[k+1,k] = -1 if j+1 < m
+              @spd[k,k+m] = @spd[k+m,k] = -1 if i+1 < m
+            end
+          end
+          @spd = @spd.cast(:yale, dtype)
+
+          @gen = NMatrix.new([4,4], [0,2,0,1, 1,0,3,0, 0,1,1e-3,1, 5,0,0,1], dtype: dtype).cast(:yale, dtype)
+          @b   = NMatrix.new([@n,2], (0...2*@n).map { |i| i % 7 - 3 }, dtype: dtype)
+        end
+
+        [:amd, :rcm, :natural].each do |ordering|
+          it "solves with a Cholesky factorization in #{ordering} order" do
+            x = @spd.factorize(:cholesky, ordering: ordering).solve(@b)
+            expect(@spd.dot(x)).to be_within(err).of(@b)
+          end
+
+          it "solves with an LU factorization in #{ordering} order" do
+            x = @spd.factorize(:lu, ordering: ordering).solve(@b)
+            expect(@spd.dot(x)).to be_within(err).of(@b)
+          end
+        end
+
+        it "has less fill-in with the minimum degree ordering" do
+          amd     = @spd.factorize(:cholesky).symbolic.nnz
+          natural = @spd.factorize(:cholesky, ordering: :natural).symbolic.nnz
+          expect(amd < natural).to eq(true)
+        end
+
+        it "pivots in an LU factorization" do
+          b = NMatrix.new([4,1], [1,2,3,4], dtype: dtype)
+          [0.1, 1.0].each do |tol|
+            expect(@gen.dot(@gen.factorize(:lu, pivot_tolerance: tol).solve(b))).to be_within(err).of(b)
+          end
+        end
+
+        it "reuses the symbolic phase" do
+          a2 = @spd * 2
+          c  = @spd.factorize(:cholesky)
+          lu = @spd.factorize(:lu)
+
+          expect(a2.factorize(:cholesky, symbolic: c.symbolic).solve(@b)).to be_within(err).of(c.solve(@b) / 2)
+          expect(c.refactor(a2).solve(@b)).to be_within(err).of(lu.solve(@b) / 2)
+          expect(lu.refactor(a2).solve(@b)).to be_within(err).of(c.solve(@b))
+        end
+
+        it "raises on a different sparsity pattern for the symbolic phase" do
+          c = NMatrix.new([3,3], [2,0,0, 0,2,0, 0,0,2], dtype: dtype).cast(:yale, dtype).factorize(:cholesky)
+          a = NMatrix.new([3,3], [2,1,0, 1,2,1, 0,1,2], dtype: dtype).cast(:yale, dtype)
+          expect { c.refactor(a) }.to raise_error(ArgumentError)
+        end
+
+        it "raises on a matrix that is not positive definite" do
+          a = NMatrix.new([2,2], [1,2, 2,1], dtype: dtype).cast(:yale, dtype)
+          expect { a.factorize(:cholesky) }.to raise_error(ArgumentError)
+        end
+
+        it "raises on a singular matrix" do
+          a = NMatrix.new([3,3], [1,0,0, 0,1,1, 0,1,1], dtype: dtype).cast(:yale, dtype)
+          expect { a.factorize(:lu) }.to raise_error(ZeroDivisionError)
+        end
+
+        it "leaves out entries deleted lazily" do
+          a = NMatrix.new([3,3], [4,1,0, 1,4,1, 0,1,4], dtype: dtype).cast(:yale, dtype)
+          e = NMatrix.new([3,3], [4,0,0, 0,4,1, 0,1,4], dtype: dtype).cast(:yale, dtype)
+          a.dead_space_threshold = 0.9
+          a[0,1] = a[1,0] = 0
+
+          expect(a.factorize(:cholesky).symbolic.nnz).to eq(e.factorize(:cholesky).symbolic.nnz)
+          b = NMatrix.new([3,1], [1,2,3], dtype: dtype)
+          expect(a.factorize(:lu).solve(b)).to be_within(err).of(e.factorize(:lu).solve(b))
+        end
+      end
+    end
+  end
+
+  context "#eigh" do
+    NON_INTEGER_DTYPES.each do |dtype|
+      next if dtype == :object
+      context dtype do
+        err = [:float32, :complex64].include?(dtype) ? 1e-4 : 1e-12
+
+        it "computes all eigenvalues and eigenvectors of a symmetric matrix" do
+          a    = NMatrix.new [3,3], [2,-1,0, -1,2,-1, 0,-1,2], dtype: dtype
+          w, v = a.eigh
+
+          expect(w).to be_within(err).of(NMatrix.new([3,1], [2-Math.sqrt(2), 2, 2+Math.sqrt(2)], dtype: a.abs_dtype))
+          expect(a.dot(v)).to be_within(err).of(v.dot(NMatrix.diagonal(w.to_a.flatten, dtype: dtype)))
+          expect(v.conjugate_transpose.dot(v)).to be_within(err).of(NMatrix.eye(3, dtype: dtype))
+        end
+
+        it "computes the k largest eigenpairs of a matrix larger than the divide-and-conquer leaves" do
+          n = 60
+          a = NMatrix.new([n,n], (0...n*n).map { |x| ((x * 7919) % 1009) / 1009.0 - 0.5 }, dtype: dtype)
+          a = a + a.transpose
+
+          all  = a.eigh(vectors: false)
+          w, v = a.eigh(k: 3, which: :largest)
+
+          expect(w).to be_within(err*100).of(all[(n-3)...n, 0])
+          expect(a.dot(v)).to be_within(err*100).of(v.dot(NMatrix.diagonal(w.to_a.flatten, dtype: dtype)))
+        end
+
+        if [:complex64, :complex128].include?(dtype)
+          it "computes the eigenvalues of a Hermitian matrix from either triangle" do
+            a = NMatrix.new [2,2], [2,Complex(0,1), Complex(0,-1),2], dtype: dtype
+
+            [:lower, :upper].each do |uplo|
+              expect(a.eigh(uplo: uplo, vectors: false)).to be_within(err).of(NMatrix.new([2,1], [1,3], dtype: a.abs_dtype))
+            end
+          end
+        end
+      end
+    end
+  end
+
+  context "#svd_truncated" do
+    NON_INTEGER_DTYPES.each do |dtype|
+      next if dtype == :object
+      context dtype do
+        err = [:float32, :complex64].include?(dtype) ? 1e-4 : 1e-12
+
+        [:dense, :yale].each do |stype|
+          it "computes the largest singular triplets of a #{stype} matrix" do
+            # Singular values 5, 4, 3, 2 and 1, with the rows and columns shuffled.
+            a = NMatrix.new([7,5], 0, dtype: dtype)
+            [[3,1,5], [0,4,4], [6,0,3], [1,2,2], [4,3,1]].each { |i,j,v| a[i,j] = v }
+            a = a.cast(stype, dtype)
+
+            u, sigma, vt = a.svd_truncated(2, seed: 1)
+
+            expect(sigma).to be_within(err).of(NMatrix.new([2,1], [5,4], dtype: a.abs_dtype))
+            expect(u.conjugate_transpose.dot(u)).to be_within(err).of(NMatrix.eye(2, dtype: dtype))
+            expect(a.dot(vt.conjugate_transpose)).to be_within(err).of(u.dot(NMatrix.diagonal(sigma.to_a.flatten, dtype: dtype)))
+          end
+        end
+      end
+    end
+  end
+
+  context "#eigsh" do
+    # The n-by-n second difference matrix, whose eigenvalues are 2 - 2cos(k*pi/(n+1)) for k = 1..n.
+    def laplacian n, dtype, stype
+      a = NMatrix.new([n,n], 0, dtype: dtype)
+      n.times do |i|
+        a[i,i]   = 2
+        a[i,i+1] = -1 if i+1 < n
+        a[i+1,i] = -1 if i+1 < n
+      end
+      a.cast(stype, dtype)
+    end
+
+    def laplacian_eigenvalues n, ks, dtype
+      NMatrix.new([ks.size,1], ks.map { |k| 2 - 2*Math.cos(k*Math::PI/(n+1)) }, dtype: dtype)
+    end
+
+    NON_INTEGER_DTYPES.each do |dtype|
+      next if dtype == :object
+      context dtype do
+        err = [:float32, :complex64].include?(dtype) ? 1e-3 : 1e-10
+        tol = [:float32, :complex64].include?(dtype) ? 1e-4 : 1e-12
+
+        [:dense, :yale].each do |stype|
+          it "finds the largest eigenpairs of a #{stype} matrix" do
+            a = laplacian(40, dtype, stype)
+            w, v = a.eigsh(3, tol: tol)
+
+            expect(w).to be_within(err).of(laplacian_eigenvalues(40, [38,39,40], a.abs_dtype))
+            expect(v.conjugate_transpose.dot(v)).to be_within(err).of(NMatrix.eye(3, dtype: dtype))
+            expect(a.dot(v)).to be_within(err).of(v.dot(NMatrix.diagonal(w.to_a.flatten, dtype: dtype)))
+          end
+        end
+
+        it "finds the smallest eigenvalues" do
+          w = laplacian(40, dtype, :yale).eigsh(2, which: :smallest, vectors: false)
+          expect(w).to be_within(err).of(laplacian_eigenvalues(40, [1,2], w.dtype))
+        end
+      end
+    end
+
+    # The 2-D Laplacian on an m-by-m grid, whose eigenvalues 4 - 2cos(i*pi/(m+1)) - 2cos(j*pi/(m+1)) are mostly double.
+    it "finds every copy of a repeated eigenvalue" do
+      m = 12
+      a = NMatrix.new([m*m,m*m], 0, dtype: :float64)
+      m.times do |i|
+        m.times do |j|
+          r = i*m + j
+          a[r,r]   = 4
+          a[r,r+1] = a[r+1,r] = -1 if j+1 < m
+          a[r,r+m] = a[r+m,r] = -1 if i+1 < m
+        end
+      end
+      a = a.cast(:yale, :float64)
+
+      all = (1..m).to_a.product((1..m).to_a).map { |i,j| 4 - 2*Math.cos(i*Math::PI/(m+1)) - 2*Math.cos(j*Math::PI/(m+1)) }.sort
+
+      w, v = a.eigsh(3, which: :smallest)
+      expect(w).to be_within(1e-10).of(NMatrix.new([3,1], all[0...3], dtype: :float64))
+      expect(v.transpose.dot(v)).to be_within(1e-10).of(NMatrix.eye(3, dtype: :float64))
+
+      w = a.eigsh(3, which: :largest, vectors: false)
+      expect(w).to be_within(1e-10).of(NMatrix.new([3,1], all[-3..-1], dtype: :float64))
+    end
+
+    it "applies an operator given as a block" do
+      w, v = NMatrix.eigsh(40, 2, which: :smallest) { |x| laplacian(40, :float64, :yale).dot(x) }
+      expect(w).to be_within(1e-10).of(laplacian_eigenvalues(40, [1,2], :float64))
+      expect(v.shape).to eq([40,2])
+    end
+
+    it "passes on exceptions raised by the block" do
+      expect { NMatrix.eigsh(10, 2) { |x| raise ArgumentError, "stop" } }.to raise_error(ArgumentError, "stop")
     end
   end
 
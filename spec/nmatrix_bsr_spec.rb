@@ -0,0 +1,108 @@
+# = NMatrix
+#
+# A linear algebra library for scientific computation in Ruby.
+# NMatrix is part of SciRuby.
+#
+# NMatrix was originally inspired by and derived from NArray, by
+# Masahiro Tanaka: http://narray.rubyforge.org
+#
+# == Copyright Information
+#
+# SciRuby is Copyright (c) 2010 - 2014, Ruby Science Foundation
+# NMatrix is Copyright (c) 2012 - 2014, John Woods and the Ruby Science Foundation
+#
+# Please see LICENSE.txt for additional copyright notices.
+#
+# == Contributing
+#
+# By contributing source code to SciRuby, you agree to be bound by
+# our Contributor Agreement:
+#
+# * https://github.com/SciRuby/sciruby/wiki/Contributor-Agreement
+#
+# == nmatrix_bsr_spec.rb
+#
+# Tests for block compressed sparse row matrices (NMatrix::BSR).
+#
+require 'spec_helper'
+require "./lib/nmatrix"
+
+describe NMatrix::BSR do
+  let(:dense) do
+    NMatrix.new([6,6], [1,2, 0,0, 0,0,
+                        3,4, 0,0, 0,0,
+                        0,0, 5,0, 7,0,
+                        0,0, 0,6, 0,8,
+                        9,0, 0,0, 0,0,
+                        0,0, 0,0, 0,0], dtype: :float64)
+  end
+  let(:yale) { dense.cast(:yale, :float64) }
+  let(:bsr)  { yale.to_bsr(2) }
+
+  it "keeps only the blocks with nonzeros" do
+    expect(bsr.blocks).to eq(4)
+    expect(bsr.row_ptr.to_a).to eq([0, 1, 3, 4])
+    expect(bsr.col_ind.to_a).to eq([0, 1, 2, 0])
+    expect(bsr.values.to_a.first(4)).to eq([1, 2, 3, 4])
+  end
+
+  it "converts back to yale" do
+    expect(bsr.to_yale).to eq(yale)
+    expect(dense.to_bsr(3).to_yale).to eq(yale)
+  end
+
+  it "requires the block size to divide the shape" do
+    expect { yale.to_bsr(4) }.to raise_error(ShapeError)
+  end
+
+  it "requires a zero default value" do
+    expect { NMatrix.new([4,4], 1, stype: :yale, dtype: :float64).to_bsr(2) }.to raise_error(NotImplementedError)
+  end
+
+  it "rejects an invalid sparsity pattern" do
+    values = NMatrix.new([8], 1, dtype: :float64)
+    [[[0,1,2], [0,2]],   # block column out of range
+     [[0,1,2], [1,-1]],
+     [[0,2,2], [1,0]],   # not ascending within a block row
+     [[0,2,2], [1,1]],
+     [[0,2,1], [0,1]],   # row_ptr decreasing
+     [[0,1,3], [0,1]],   # past the end of col_ind
+     [[1,1,2], [0,1]]].each do |rp, ci|
+      row_ptr = NMatrix.new([3], rp, dtype: :int64)
+      col_ind = NMatrix.new([2], ci, dtype: :int64)
+      expect { NMatrix::BSR.new([4,4], 2, row_ptr, col_ind, values) }.to raise_error(ArgumentError)
+    end
+  end
+
+  [:float64, :complex128, :int64].each do |dtype|
+    it "multiplies by dense vectors and matrices (#{dtype})" do
+      a = dense.cast(:yale, dtype).to_bsr(2)
+      x = NMatrix.new([6,2], (1..12).to_a, dtype: dtype)
+      expect(a.dot(x)).to eq(dense.cast(:dense, dtype).dot(x))
+
+      v = NMatrix.new([6], (1..6).to_a, dtype: dtype)
+      expect(a.dot(v).to_a).to eq(dense.cast(:dense, dtype).dot(NMatrix.new([6,1], (1..6).to_a, dtype: dtype)).to_a.flatten)
+    end
+  end
+
+  it "slices by block rows" do
+    s = bsr.block_rows(1..2)
+    expect(s.shape).to eq([4,6])
+    expect(s.to_yale).to eq(dense[2...6, 0...6].cast(:yale, :float64))
+    expect(bsr.block_rows(0, 1).to_yale).to eq(dense[0...2, 0...6].cast(:yale, :float64))
+    expect { bsr.block_rows(2, 2) }.to raise_error(RangeError)
+  end
+
+  it "saves and loads" do
+    file = "spec/nmatrix_bsr_spec.bsr"
+    begin
+      bsr.write(file)
+      b = NMatrix::BSR.read(file)
+      expect(b.shape).to eq([6,6])
+      expect(b.block_size).to eq(2)
+      expect(b.to_yale).to eq(yale)
+    ensure
+      File.delete(file) if File.exist?(file)
+    end
+  end
+end
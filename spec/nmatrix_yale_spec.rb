@@ -268,6 +268,288 @@ describe NMatrix do
       expect(mn[0,0]).to eq(541)
     end
 
+    context "#from_coo" do
+      it "builds a matrix from unsorted triplets, summing duplicates" do
+        n = NMatrix.from_coo([2, 0, 1, 1, 2, 0], [0, 1, 0, 0, 2, 1], [6, 2, 3, 4, 5, -2], 3, dtype: :int32)
+        n.extend(NMatrix::YaleFunctions)
+        expect(n.stype).to eq(:yale)
+        expect(n.to_a).to eq([[0, 0, 0], [7, 0, 0], [6, 0, 5]])
+        expect(n.yale_ija).to eq([4, 4, 5, 6, 0, 0])
+        expect(n.capacity).to eq(6)
+      end
+
+      it "keeps the last value for duplicates if sum_duplicates is false" do
+        n = NMatrix.from_coo([0, 1, 1], [1, 0, 0], [2, 3, 4], 2, dtype: :float64, sum_duplicates: false)
+        expect(n.to_a).to eq([[0.0, 2.0], [4.0, 0.0]])
+      end
+
+      it "accepts NMatrix and packed String arguments" do
+        rows = NMatrix.new([3], [0, 2, 1], dtype: :int32)
+        cols = [2, 0, 1].pack('q*')
+        vals = [1.5, 2.5, 3.5].pack('d*')
+        n = NMatrix.from_coo(rows, cols, vals, [3, 4], dtype: :float64)
+        expect(n.to_a).to eq([[0.0, 0.0, 1.5, 0.0], [0.0, 3.5, 0.0, 0.0], [2.5, 0.0, 0.0, 0.0]])
+      end
+
+      it "matches a matrix assembled with []=" do
+        rows = Array.new(200) { rand(30) }
+        cols = Array.new(200) { rand(40) }
+        vals = Array.new(200) { rand(10) + 1 }
+        m = NMatrix.new([30, 40], stype: :yale, dtype: :int64)
+        rows.each_index { |k| m[rows[k], cols[k]] += vals[k] }
+        expect(NMatrix.from_coo(rows, cols, vals, [30, 40], dtype: :int64)).to eq(m)
+      end
+
+      it "raises on out-of-bounds coordinates" do
+        expect { NMatrix.from_coo([0, 2], [0, 0], [1, 1], 2) }.to raise_error(RangeError)
+      end
+
+      it "raises on arguments it can't read" do
+        expect { NMatrix.from_coo({0 => 1}, [0], [1], 2, dtype: :int64) }.to raise_error(TypeError)
+        expect { NMatrix.from_coo([0], [0], 1, 2, dtype: :int64) }.to raise_error(TypeError)
+        expect { NMatrix.from_coo([0, 1], [0, "1"], [1, 2], 2, dtype: :int64) }.to raise_error(TypeError)
+      end
+    end
+
+    context "#batch_update" do
+      it "gives the same result as assigning directly" do
+        ops = Array.new(500) { [rand(20), rand(30), rand(3)] }
+        m = NMatrix.new([20, 30], stype: :yale, dtype: :int64)
+        n = NMatrix.new([20, 30], stype: :yale, dtype: :int64)
+        m[3,4] = 9
+        n[3,4] = 9
+
+        m.batch_update { ops.each { |i,j,v| m[i,j] = v } }
+        ops.each { |i,j,v| n[i,j] = v }
+
+        expect(m).to eq(n)
+      end
+
+      it "sees pending assignments when reading inside the block" do
+        m = NMatrix.new(3, stype: :yale, dtype: :float64)
+        m.batch_update do
+          m[0,2] = 1.0
+          m[1,1] = 2.0
+          expect(m[0,2]).to eq(1.0)
+          expect(m[2,2]).to eq(0.0)
+        end
+        expect(m.to_a).to eq([[0.0, 0.0, 1.0], [0.0, 2.0, 0.0], [0.0, 0.0, 0.0]])
+      end
+
+      it "accumulates repeated updates of the same element" do
+        m = NMatrix.new([4, 5], stype: :yale, dtype: :int64)
+        m[2,3] = 10
+        m.batch_update do
+          5.times { m[2,3] += 1 }
+          3.times { m[0,4] += 2 }
+        end
+        expect(m[2,3]).to eq(15)
+        expect(m[0,4]).to eq(6)
+      end
+
+      it "stages assignments made through reference slices" do
+        m = NMatrix.new(4, stype: :yale, dtype: :int32)
+        m.batch_update do
+          r = m[1..2, 1..3]
+          r[0,1] = 4
+          r[1,2] += 3
+          expect(m[1,2]).to eq(4)
+          expect(r[1,2]).to eq(3)
+        end
+        expect(m.to_a).to eq([[0, 0, 0, 0], [0, 0, 4, 0], [0, 0, 0, 3], [0, 0, 0, 0]])
+      end
+
+      it "applies pending assignments before a slice assignment" do
+        m = NMatrix.new(3, stype: :yale, dtype: :int32)
+        m.batch_update do
+          m[1,0] = 5
+          m[1,0..1] = [6, 7]
+          m[1,1] = 0
+        end
+        expect(m.to_a).to eq([[0, 0, 0], [6, 0, 0], [0, 0, 0]])
+      end
+    end
+
+    context "#dead_space_threshold=" do
+      it "marks deleted entries instead of removing them" do
+        m = NMatrix.new(4, stype: :yale, dtype: :int64)
+        m.extend NMatrix::YaleFunctions
+        m.dead_space_threshold = 0.9
+        m[0,1] = 1
+        m[0,2] = 2
+        m[0,3] = 3
+        size = m.yale_size
+
+        m[0,2] = 0
+        expect(m[0,2]).to eq(0)
+        expect(m.yale_nd_row(0, :keys)).to eq([1, 3])
+
+        m[0,2] = 5
+        expect(m[0,2]).to eq(5)
+
+        m[0,2] = 0
+        m.compact!
+        expect(m.yale_size).to eq(size - 1)
+      end
+
+      it "hides deleted entries from the raw IJA and A accessors" do
+        m = NMatrix.new(5, stype: :yale, dtype: :float64)
+        m.extend NMatrix::YaleFunctions
+        m.dead_space_threshold = 0.9
+        [[0,1], [0,3], [1,2], [2,4], [3,0], [4,1]].each_with_index { |(i,j),k| m[i,j] = k+1 }
+        size = m.yale_size
+
+        m[0,1] = 0
+        m[2,4] = 0
+        expect(m.yale_size).to eq(size - 2)
+        expect(m.yale_ija[m.yale_ija(0)...m.yale_ija(1)]).to eq([3])
+        expect(m.yale_ja.compact).to eq([3, 2, 0, 1])
+        expect(m.yale_lu.compact).to eq([2.0, 3.0, 5.0, 6.0])
+        expect(m.yale_a[6...size-2]).to eq([2.0, 3.0, 5.0, 6.0])
+      end
+
+      it "gives the same result as eager deletion" do
+        ops = Array.new(1000) { [rand(15), rand(15), rand(2) * (1+rand(5))] }
+        m = NMatrix.new(15, stype: :yale, dtype: :float64)
+        n = NMatrix.new(15, stype: :yale, dtype: :float64)
+        m.dead_space_threshold = 0.25
+
+        ops.each do |i,j,v|
+          m[i,j] = v
+          n[i,j] = v
+        end
+
+        expect(m).to eq(n)
+        expect(m.to_a).to eq(n.to_a)
+        m.each_stored_with_indices { |v,i,j| expect(v).not_to eq(0) unless i == j }
+      end
+
+      it "doesn't mistake stored entries equal to the default for deleted ones" do
+        m = NMatrix.new(4, stype: :yale, dtype: :int64)
+        m.extend NMatrix::YaleFunctions
+        m.dead_space_threshold = 0.9
+        m.send(:__yale_vector_set__, 0, [1,2,3], [0,2,3])
+
+        m[0,2] = 0
+        m[0,1] = 4
+        stored = []
+        m.each_stored_with_indices { |v,i,j| stored << [i,j] unless i == j }
+        expect(stored).to eq([[0,1], [0,3]])
+
+        m.compact!
+        expect(m.yale_nd_row(0, :keys)).to eq([1, 3])
+      end
+    end
+
+    context "#permute" do
+      before do
+        @d = NMatrix.new([4,5], (1..20).to_a, dtype: :int64)
+        @d[0,0] = 0
+        @d[2,2] = 0
+        @y = @d.cast(:yale, :int64)
+      end
+
+      it "reorders rows and columns, moving entries on and off the diagonal" do
+        rows, cols = [2,0,3,1], [4,1,0,3,2]
+        p = @y.permute(rows, cols)
+
+        expect(p.stype).to eq(:yale)
+        4.times { |i| 5.times { |j| expect(p[i,j]).to eq(@d[rows[i], cols[j]]) } }
+        p.each_stored_with_indices { |v,i,j| expect(v).not_to eq(0) unless i == j }
+      end
+
+      it "applies one permutation symmetrically" do
+        a = NMatrix.new([3,3], [1,2,0, 0,3,4, 5,0,6], dtype: :float64).cast(:yale, :float64)
+        expect(a.permute([2,0,1]).to_a).to eq([[6,5,0], [0,1,2], [4,0,3]])
+        expect(a.permute(nil, [1,0,2]).to_a).to eq([[2,1,0], [3,0,4], [0,5,6]])
+      end
+
+      it "permutes columns in place with #laswp!" do
+        y = @y.clone
+        y.laswp!([4,1,0,3,2])
+        expect(y).to eq(@y.permute(nil, [4,1,0,3,2]))
+        expect(@y.laswp([1,0,2,3,4], convention: :lapack)).to eq(@y)
+      end
+
+      it "raises on an argument that is not a permutation" do
+        expect { @y.permute([0,0,1,2], nil) }.to raise_error(ArgumentError)
+        expect { @y.permute([0,1], nil) }.to raise_error(ArgumentError)
+      end
+    end
+
+    context "#ordering" do
+      it "reduces the bandwidth by reverse Cuthill-McKee" do
+        n = 60
+        b = NMatrix.new([n,n], 0, dtype: :float64)
+        n.times do |i|
+          b[i,i] = 4
+          b[i,i+1] = b[i+1,i] = -1 if i+1 < n
+        end
+        scrambled = b.cast(:yale, :float64).permute((0...n).to_a.shuffle(random: Random.new(1)))
+
+        perm = scrambled.ordering(:rcm)
+        expect(perm.sort).to eq((0...n).to_a)
+
+        bandwidth = 0
+        scrambled.permute(perm).each_stored_with_indices { |v,i,j| bandwidth = [bandwidth, (i-j).abs].max if v != 0 }
+        expect(bandwidth).to eq(1)
+      end
+
+      it "orders each connected component" do
+        g = NMatrix.new([5,5], [0,0,0,1,0, 0,0,0,0,1, 0,0,0,0,0, 1,0,0,0,0, 0,1,0,0,0], dtype: :int64).cast(:yale, :int64)
+        expect(g.ordering(:rcm).sort).to eq((0...5).to_a)
+        expect(g.ordering(:natural)).to eq((0...5).to_a)
+      end
+    end
+
+    context "#spgemm_plan" do
+      let(:a) { NMatrix.new([3,4], [2,0,1,0, 0,0,0,3, 1,0,0,0], dtype: :float64).cast(:yale, :float64) }
+      let(:b) { NMatrix.new([4,3], [1,0,0, 0,5,0, 0,1,2, 0,0,4], dtype: :float64).cast(:yale, :float64) }
+
+      it "multiplies with the planned pattern" do
+        plan = NMatrix.spgemm_plan(a, b)
+        c    = plan.multiply(a, b)
+        expect(c.stype).to eq(:yale)
+        expect(c.cast(:dense, :float64)).to eq(a.cast(:dense, :float64).dot(b.cast(:dense, :float64)))
+      end
+
+      it "reuses the result's storage for new values" do
+        plan = NMatrix.spgemm_plan(a, b)
+        c    = plan.multiply(a, b)
+        a2   = a * 3
+        b2   = b - b * 2
+
+        expect(plan.multiply!(a2, b2, into: c)).to equal(c)
+        expect(c.cast(:dense, :float64)).to eq(a2.cast(:dense, :float64).dot(b2.cast(:dense, :float64)))
+      end
+
+      it "raises when an entry is outside the planned pattern" do
+        plan = NMatrix.spgemm_plan(a, b)
+        c    = plan.multiply(a, b)
+        a2   = a.clone
+        a2[2,2] = 7
+        expect { plan.multiply!(a2, b, into: c) }.to raise_error(ArgumentError)
+        expect { plan.multiply!(a, b, into: NMatrix.new([3,3], stype: :yale, dtype: :float64)) }.to raise_error(ArgumentError)
+      end
+
+      it "leaves entries deleted lazily out of the plan" do
+        d = a.clone
+        d.dead_space_threshold = 0.9
+        d[0,2] = 0
+        e = NMatrix.new([3,4], [2,0,0,0, 0,0,0,3, 1,0,0,0], dtype: :float64).cast(:yale, :float64)
+
+        plan = NMatrix.spgemm_plan(d, b)
+        expect(plan.size).to eq(NMatrix.spgemm_plan(e, b).size)
+        expect(plan.multiply(d, b)).to eq(e.dot(b))
+      end
+
+      it "raises on a nonzero default value" do
+        d = NMatrix.new([3,4], 1, stype: :yale, dtype: :float64)
+        expect { NMatrix.spgemm_plan(d, b) }.to raise_error(NotImplementedError)
+        expect { NMatrix.spgemm_plan(a, b).multiply(d, b) }.to raise_error(NotImplementedError)
+      end
+    end
+
     it "calculates the row key intersections of two matrices" do
       a = NMatrix.new([3,9], [0,1], stype: :yale, dtype: :byte, default: 0)
       b = NMatrix.new([3,9], [0,0,1,0,1], stype: :yale, dtype: :byte, default: 0)
@@ -301,3 +301,29 @@ describe "NMatrix::LAPACK functions implemented with LAPACKE interface" do
     end
   end
 end
+
+describe "NMatrix#solve with nmatrix-lapacke loaded" do
+  [:float32, :float64, :complex64, :complex128].each do |dtype|
+    context dtype do
+      err = [:float32, :complex64].include?(dtype) ? 1e-3 : 1e-7
+
+      before do
+        @a = NMatrix.new([3,3], [4,1,0, 1,4,1, 0,1,4], dtype: dtype)
+        @b = NMatrix.new([3,2], [6,5, 12,7, 14,9], dtype: dtype)
+        @x = NMatrix.new([3,2], [1,1, 2,1, 3,2], dtype: dtype)
+      end
+
+      it "solves dense systems with LAPACKE" do
+        expect(@a.solve(@b)).to be_within(err).of(@x)
+      end
+
+      it "hands Yale matrices and solve options to the core implementation" do
+        y = @a.cast(:yale, dtype)
+        expect(y.solve(@b)).to be_within(err).of(@x)
+        expect(y.solve(@b, method: :cg, tol: 1e-10)).to be_within(err).of(@x)
+        expect(y.solve(@b, method: :bicgstab, preconditioner: y.preconditioner(:ilu))).to be_within(err).of(@x)
+        expect(y.solve(@b, method: :lu)).to be_within(err).of(@x)
+      end
+    end
+  end
+end